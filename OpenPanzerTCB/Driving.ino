@@ -445,6 +445,22 @@ void StopDriveMotors()
     TankSound->SetVehicleSpeed(0);
 }
 
+// Serial motor controllers are set up in the background after power-up (see OP_Motors) and refuse any speed but zero until then. 
+// The main loop holds the drive in stop until they are ready, so the vehicle doesn't pick up speed in software and then lurch when they come up. 
+boolean DriveMotorsReady()
+{
+    switch (eeprom.ramcopy.DriveType)
+    {
+        case DT_TANK:       return (RightTread->isReady() && LeftTread->isReady());
+        case DT_HALFTRACK:  return (RightTread->isReady() && LeftTread->isReady());
+        case DT_CAR:        return DriveMotor->isReady();
+        case DT_DKLM:       // Fall through
+        case DT_DMD:        return (DriveMotor->isReady() && SteeringMotor->isReady());
+        case DT_DIRECT:     return (RightTread->isReady() && LeftTread->isReady());
+        default:            return true;
+    }
+}
+
 void StopEverything()
 {   // We use this in the event of a radio failsafe event, or just as a quick way to stop all movement. 
     // Stop drive motor(s) and any sound associated with them
@@ -462,4 +478,6 @@ void StopEverything()
     TurretRotation->stop();
     // Stop smoker
     StopSmoker();
+    // And any macros, or their next steps would start things up again
+    StopAllMacros();
 }
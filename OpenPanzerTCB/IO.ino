@@ -99,12 +99,11 @@ void PortA_ReadValue(void)
         {   // If the user set this to "digital" input (dataType = 1), anything over 1/2 counts as 0 (because we have pullups turned on), 
             // and anything below counts as 1. In other words, the input will automatically be off (high). The user has to 
             // specifically tie the input to ground to set the input on (low). 
-            analogRead(pin_IO_A) > 512 ? IO_Pin[IOA].inputValue = 0 : IO_Pin[IOA].inputValue = 1;
+            OP_ADC::read(IO_Pin[IOA].adcChannel) > 512 ? IO_Pin[IOA].inputValue = 0 : IO_Pin[IOA].inputValue = 1;
         }
         else
-        {   // In this case we want to save the actual analog reading.
-            // We may want to filter this (take an average) to eliminate noise, but that is not yet implemented.
-            IO_Pin[IOA].inputValue = analogRead(pin_IO_A);
+        {   // In this case we want to save the actual analog reading. OP_ADC has already run it through a light filter to reduce noise.
+            IO_Pin[IOA].inputValue = OP_ADC::read(IO_Pin[IOA].adcChannel);
         }
         // Only set the updated flag if the value has changed. 
         IO_Pin[IOA].inputValue == oldVal ? IO_Pin[IOA].updated = false : IO_Pin[IOA].updated = true;   
@@ -172,12 +171,11 @@ void PortB_ReadValue(void)
         {   // If the user set this to "digital" input (dataType = 1), anything over 1/2 counts as 0 (because we have pullups turned on), 
             // and anything below counts as 1. In other words, the input will automatically be off (high). The user has to 
             // specifically tie the input to ground to set the input on (low). 
-            analogRead(pin_IO_B) > 512 ? IO_Pin[IOB].inputValue = 0 : IO_Pin[IOB].inputValue = 1;
+            OP_ADC::read(IO_Pin[IOB].adcChannel) > 512 ? IO_Pin[IOB].inputValue = 0 : IO_Pin[IOB].inputValue = 1;
         }
         else
-        {   // In this case we want to save the actual analog reading.
-            // We may want to filter this (take an average) to eliminate noise, but that is not yet implemented.
-            IO_Pin[IOB].inputValue = analogRead(pin_IO_B);
+        {   // In this case we want to save the actual analog reading. OP_ADC has already run it through a light filter to reduce noise.
+            IO_Pin[IOB].inputValue = OP_ADC::read(IO_Pin[IOB].adcChannel);
         }
         // Only set the updated flag if the value has changed. 
         IO_Pin[IOB].inputValue == oldVal ? IO_Pin[IOB].updated = false : IO_Pin[IOB].updated = true;
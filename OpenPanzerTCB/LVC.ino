@@ -23,6 +23,7 @@ void CheckVoltage(void)
         {
             LVC = true;
             HavePower = false;
+            OP_BattleLog::log(LOG_EVENT_LVC, 0, 0, (uint8_t)(Battery.restingVoltage_mV() / 100));
             if (DEBUG) 
             {
                 DebugSerial->print(F("LVC threshold reached! ("));
@@ -37,6 +38,7 @@ void CheckVoltage(void)
             // Restore power
             LVC = false;
             HavePower = true;
+            OP_BattleLog::log(LOG_EVENT_LVC_EXIT, 0, 0, (uint8_t)(Battery.restingVoltage_mV() / 100));
             if (DEBUG) DebugSerial->println(F("LVC Exit - Voltage Restored"));
         }
     }
@@ -52,11 +54,79 @@ void DisableRoutineVoltageCheck(void)
     if (timer.isEnabled(LVC_TimerID)) timer.deleteTimer(LVC_TimerID);
 }
 
+
+// BATTERY ESTIMATOR
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+void EnableBatteryEstimator(void)
+{
+    Battery.begin(eeprom.ramcopy.LVC_Cutoff_mV, eeprom.ramcopy.BatteryType, eeprom.ramcopy.BatteryCells);
+    UpdateBattery();                                    // First sample now so the estimate is ready before the first LVC check
+    timer.setInterval(BATTERY_SAMPLE_mS, UpdateBattery);
+}
+
+void UpdateBattery(void)
+{
+    Battery.update(ReadVoltage_mV(), MotorLoad(), millis());
+
+    // Let the user trigger a function (a warning sound for example) when the charge gets low
+    if (Battery.lowWarning()) 
+    {
+        bitSet(AdHocTriggers, ADHOCT_BIT_BATTERY_LOW);
+        if (DEBUG) 
+        {
+            DebugSerial->print(F("Battery low ("));
+            DebugSerial->print(Battery.stateOfCharge());
+            DebugSerial->println(F("%)"));
+        }
+    }
+
+    // Pass the fresh numbers along to the transmitter, if the radio supports telemetry
+    UpdateRadioTelemetry();
+}
+
+uint8_t MotorLoad(void)
+{
+scout_telemetry st;
+
+    // How hard the drive motors are working, 0-255. For tracked vehicles the average of the two treads. 
+    // If the drive motors are on a Scout that reports its motor current, use that instead of the speed command. Current is what actually 
+    // sags the battery, so a tank climbing a slope or pushing into a wall counts as heavy load even at low speed. 
+    if (eeprom.ramcopy.DriveMotors == OP_SCOUT && OP_Scout::getTelemetry(OPScout_DRIVE_Address, st)) return ScoutLoad(st);
+
+    switch (eeprom.ramcopy.DriveType)
+    {
+        case DT_TANK:
+        case DT_HALFTRACK:
+            if (RightTread && LeftTread) return (uint8_t)(((uint16_t)RightTread->getLoad() + LeftTread->getLoad()) / 2);
+            break;
+        default:
+            if (DriveMotor) return DriveMotor->getLoad();
+            break;
+    }
+    return 0;
+}
+
+uint8_t ScoutLoad(scout_telemetry &st)
+{
+uint32_t limit_mA;
+uint32_t current_mA;
+
+    // Current as a fraction of the current limit. The Scout's limit is per motor, so with two motors in use we compare their average to it. 
+    limit_mA = (uint32_t)constrain(eeprom.ramcopy.ScoutCurrentLimit, 1, SCOUT_MAXIMUM_CURRENT_LIMIT) * 1000;
+    switch (eeprom.ramcopy.DriveType)
+    {
+        case DT_CAR:    current_mA = st.Current_mA[0];                                      break;     // Car only uses M1
+        default:        current_mA = ((uint32_t)st.Current_mA[0] + st.Current_mA[1]) / 2;  break;
+    }
+    if (current_mA >= limit_mA) return 255;
+    return (uint8_t)((current_mA * 255) / limit_mA);
+}
+
 boolean IsBatteryUnplugged(void)
 {
     // If the voltage reading is really low, the issue probably isn't a dead battery, but more likely the
     // user is running from USB power alone. That is fine, but we still want to know about it. 
-    if (ReadVoltage() < 2.0)    // We consider anything below 2 volts to be unplugged
+    if (ReadVoltage_mV() < 2000)    // We consider anything below 2 volts to be unplugged
     {
         return true;
     }
@@ -68,13 +138,10 @@ boolean IsBatteryUnplugged(void)
 
 boolean BatteryBelowCutoff(void)
 {
-uint16_t milliVolts;
-
-    // Read voltage, convert it to millivolts since that's what we're actually going to use to compare to the cutoff
-    milliVolts = static_cast<uint16_t>(ReadVoltage() * 1000.0);
-
-    // Check voltage against cutoff. 
-    if (milliVolts < eeprom.ramcopy.LVC_Cutoff_mV)
+    // Check voltage against cutoff. We use the battery estimator rather than the raw reading, because the raw reading sags under load and 
+    // would otherwise trip LVC every time the model accelerates hard on a battery that still has plenty of charge. The estimator will still 
+    // report below cutoff if the raw reading falls a long way under the cutoff, whatever the load. 
+    if (Battery.belowCutoff())
     {
         return true;
     }
@@ -84,14 +151,8 @@ uint16_t milliVolts;
     }
 }
 
-float ReadVoltage(void)
+uint16_t ReadVoltage_mV(void)
 {
-int voltSense;                  // What we read on the analog pin
-float unFilteredVoltage;        // Converted to voltage on pin
-static float filteredVoltage;   // Voltage on pin after being run through a simple low-pass filter
-float Voltage;                  // Pin voltage converted to battery voltage
-static boolean firstPass = true;       
-
 // We are using this voltage divider:
 // 
 // GND |-----/\/\/\-----------------/\/\/\-------> +V Batt
@@ -100,36 +161,24 @@ static boolean firstPass = true;
 //                      Measure
 
 // The voltage we measure on the pin isn't the actual outside voltage of the battery, it is the battery voltage divided by some number
-//multiplier = (4.7 + 10) / 4.7 = 3.1277
-const float multiplier = 3.1277;    // Multiply this by our measured voltage and we will have battery voltage
+// multiplier = (4.7 + 10) / 4.7 = 3.1277
+// A count from the ADC is worth 5000 mV / 1024, so combining the two, battery millivolts = count * (5000 * 3.1277) / 1024
+const uint32_t multiplier = 15639;  
 
 // But wait! Our input polarity protection diode also drops at least 0.3 volts, and up to 0.5 volts at 5A draw (max 0.7 volts but we shouldn't be running that much current through it). 
 // (These are specs for the Vishay V12P10-M3/86A)
 // Most of the time we will probably be at the low end of that scale, and that is also more conservative for LVC purposes. 
-const float vAdj = 0.3;         // Our adjustment factor 
-
-// To reduce the effect of noise, we run our voltage through a low-pass filter.
-// With an alpha of 0.9, it is like giving the voltage reading a weight of 10%, and past readings a weight of 90%
-const float alpha = 0.9;
-
-    // Ok, here we go: first take an analog reading (will give us a number between 0-1023)
-        voltSense = analogRead(pin_BattVoltage);
-    //Convert the reading to actual voltage read (0 - 5 Vdc)
-        unFilteredVoltage = (voltSense / 1024.0) * 5.0;
-    // Now run it through low-pass filter
-        if (firstPass) { filteredVoltage = unFilteredVoltage; firstPass = false; }
-        filteredVoltage = alpha * filteredVoltage + (1.0 - alpha) * unFilteredVoltage;
-    // Now convert the measured voltage to the external battery voltage by accounting for our voltage divider
-        Voltage = filteredVoltage * multiplier;
-    // Now also add our adjustment factor to account for the voltage drop on the input polarity diode
-        Voltage += vAdj;
-
-    // In testing this results in a pretty accurate reading
-    // Takes about 700 microSeconds (0.7 mS = 0.0007 seconds)
-        //DebugSerial->print("Voltage: ");
-        //DebugSerial->println(Voltage,2);
-
-    return Voltage;
+const uint16_t vAdj_mV = 300;       // Our adjustment factor 
+
+    // The pin is sampled in the background by OP_ADC, which also runs it through a low-pass filter to reduce the effect of noise 
+    // (see ADC_FILTER_BATTERY). So all we have to do is scale the latest filtered reading, no waiting on the ADC and no floats. 
+    return (uint16_t)(((uint32_t)OP_ADC::read(BattVoltage_ADC) * multiplier) >> 10) + vAdj_mV;
+}
+
+float ReadVoltage(void)
+{
+    // Floating point version, only for printing
+    return (float)ReadVoltage_mV() / 1000.0;
 }
 
 
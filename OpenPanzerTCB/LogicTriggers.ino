@@ -0,0 +1,120 @@
+// Logic Triggers - compound triggers made by combining two other triggers
+
+// ----------------------------------------------------------------------------------------------------------------------------------------------->>
+// LOGIC TRIGGERS
+// ----------------------------------------------------------------------------------------------------------------------------------------------->>
+// Each logic trigger in eeprom.ramcopy.SF_Logic (see OP_FunctionsTriggers.h) watches two on/off conditions, each given as the Trigger ID it would
+// have as an ordinary trigger. The conditions are sampled each time through the loop, but that is only a compare each. The rest of the work - the
+// AND/OR, the hold time and the edge - is only done for a logic trigger when one of its conditions has changed or its hold time is running,
+// and once for all of them on the first pass.
+// When a logic trigger fires we set its bit in LogicTriggersFired, and the main loop runs any function assigned to that logic trigger's ID,
+// the same way it does for the ad-hoc triggers.
+
+// Is the on/off condition with this Trigger ID true right now. The driving variables we need are local to loop() so they are passed in.
+boolean LogicConditionState(uint16_t TriggerID, uint8_t speedPct, boolean braking, int turnCommand)
+{
+    // Turret stick positions
+    if (TriggerID > 0 && TriggerID <= MAX_SPEC_POS)
+    {
+        return (Radio.UsingSpecialPositions && Radio.SpecialStick.Position == TriggerID);
+    }
+    // Digital external inputs. The ones digit is the state (0/1).
+    else if (TriggerID >= trigger_id_multiplier_ports && TriggerID < trigger_id_multiplier_auxchannel)
+    {
+        uint8_t io = (TriggerID / trigger_id_multiplier_ports) - 1;
+        if (io >= NUM_IO_PORTS || IO_Pin[io].Settings.dataDirection != 0 || IO_Pin[io].Settings.dataType == false) return false;
+        return (IO_Pin[io].inputValue == (TriggerID % trigger_id_multiplier_ports));
+    }
+    // Digital aux channel switch positions
+    else if (TriggerID >= trigger_id_multiplier_auxchannel && TriggerID < trigger_id_adhoc_start)
+    {
+        uint8_t a = (TriggerID / trigger_id_multiplier_auxchannel) - 1;
+        if (a >= AUXCHANNELS || Radio.AuxChannel[a].Settings->Digital == false) return false;
+        return (TriggerID == (trigger_id_multiplier_auxchannel * (a+1)) + (switch_pos_multiplier * Radio.AuxChannel[a].Settings->numPositions) + Radio.AuxChannel[a].switchPos);
+    }
+    // Ad-hoc triggers. Where the event marks the start of a state we use the state, otherwise it is only true the moment it happens.
+    else if (TriggerID >= trigger_id_adhoc_start && TriggerID < (trigger_id_adhoc_start + COUNT_ADHOC_TRIGGERS))
+    {
+        switch (TriggerID)
+        {
+            case ADHOC_TRIGGER_BRAKES_APPLIED:  return braking;
+            case ADHOC_TRIGGER_ENGINE_START:    return EngineRunning;
+            case ADHOC_TRIGGER_ENGINE_STOP:     return !EngineRunning;
+            case ADHOC_TRIGGER_MOVE_FORWARD:    return (DriveModeActual == FORWARD);
+            case ADHOC_TRIGGER_MOVE_REVERSE:    return (DriveModeActual == REVERSE);
+            case ADHOC_TRIGGER_VEHICLE_STOP:    return (DriveModeActual == STOP);
+            case ADHOC_TRIGGER_RIGHT_TURN:      return (turnCommand > 0);
+            case ADHOC_TRIGGER_LEFT_TURN:       return (turnCommand < 0);
+            case ADHOC_TRIGGER_NO_TURN:         return (turnCommand == 0);
+            default:                            return bitRead(AdHocTriggers, TriggerID - trigger_id_adhoc_start);
+        }
+    }
+    // Vehicle speed above/below a percent
+    else if (TriggerID >= trigger_id_speed_increase && TriggerID < (trigger_id_speed_increase + trigger_id_speed_range))
+    {
+        return (speedPct > (TriggerID - trigger_id_speed_increase));
+    }
+    else if (TriggerID >= trigger_id_speed_decrease && TriggerID < (trigger_id_speed_decrease + trigger_id_speed_range))
+    {
+        return (speedPct < (TriggerID - trigger_id_speed_decrease));
+    }
+
+    // Anything else (variable triggers, other logic triggers) can't be used as a condition
+    return false;
+}
+
+// Called from the main loop, before the function triggers are checked
+void UpdateLogicTriggers(uint8_t speedPct, boolean braking, int turnCommand)
+{
+    _logicTrigger * lt;
+    boolean a, b, result;
+
+    // On the first pass (and after a radio failsafe) the other triggers are run for whatever state they are in, so do the same here: 
+    // forget what we thought each logic trigger was and evaluate them all. Any that are true now will fire, including a NOT condition 
+    // that was already true at boot, which would otherwise never see a change. 
+    if (ForceTriggersOnFirstPass) { Logic_Output = 0; Logic_Holding = 0; }
+
+    for (uint8_t n = 0; n < MAX_LOGIC_TRIGGERS; n++)
+    {
+        lt = &eeprom.ramcopy.SF_Logic[n];
+        if (lt->ConditionA == 0) continue;                      // Not in use
+
+        a = LogicConditionState(lt->ConditionA, speedPct, braking, turnCommand);
+        b = (lt->ConditionB == 0) ? false : LogicConditionState(lt->ConditionB, speedPct, braking, turnCommand);
+
+        // Nothing more to do unless a condition changed or we are timing a hold
+        if (a == bitRead(Logic_StateA, n) && b == bitRead(Logic_StateB, n) && !bitRead(Logic_Holding, n) && !ForceTriggersOnFirstPass) continue;
+        bitWrite(Logic_StateA, n, a);
+        bitWrite(Logic_StateB, n, b);
+
+        if (lt->Flags & LOGIC_NOT_A) a = !a;
+        if (lt->Flags & LOGIC_NOT_B) b = !b;
+        if      (lt->ConditionB == 0)   result = a;
+        else if (lt->Flags & LOGIC_OR)  result = (a || b);
+        else                            result = (a && b);
+
+        if (result)
+        {
+            if (bitRead(Logic_Output, n)) continue;             // Already true
+
+            if (lt->Hold_mS > 0)
+            {
+                // Start timing the first time we see it true, after that it has to stay true until the hold time is up
+                if (!bitRead(Logic_Holding, n)) { bitSet(Logic_Holding, n); Logic_TrueSince[n] = millis(); continue; }
+                if ((millis() - Logic_TrueSince[n]) < lt->Hold_mS) continue;
+                bitClear(Logic_Holding, n);
+            }
+            bitSet(Logic_Output, n);
+            if (!(lt->Flags & LOGIC_FIRE_ON_FALSE) || (lt->Flags & LOGIC_FIRE_ON_BOTH)) bitSet(LogicTriggersFired, n);
+        }
+        else
+        {
+            bitClear(Logic_Holding, n);
+            if (!bitRead(Logic_Output, n)) continue;            // Already false
+
+            bitClear(Logic_Output, n);
+            if (lt->Flags & (LOGIC_FIRE_ON_FALSE | LOGIC_FIRE_ON_BOTH)) bitSet(LogicTriggersFired, n);
+        }
+    }
+}
+
@@ -0,0 +1,75 @@
+// Macros - user-defined sequences of special functions
+
+// ----------------------------------------------------------------------------------------------------------------------------------------------->>
+// MACROS
+// ----------------------------------------------------------------------------------------------------------------------------------------------->>
+// Each macro is a list of up to MACRO_STEPS special functions saved in eeprom.ramcopy.SF_Macro (see OP_FunctionsTriggers.h), and edited from the
+// PC like any other EEPROM setting. A macro is started by its own special function (SF_MACRO1_RUN, etc.), which can be assigned to any trigger.
+// After that UpdateMacros() runs each step once its delay is up. Nothing here blocks, several macros can run at the same time, and starting a
+// macro that is already running starts it over from the first step.
+
+void StartMacro(uint8_t m)
+{
+    if (m >= MAX_MACROS) return;
+
+    Macro_NextStep[m] = 0;
+    Macro_StepTime[m] = millis();
+    Macro_Running[m] = true;
+    if (DEBUG) { DebugSerial->print(F("Macro ")); DebugSerial->print(m + 1); DebugSerial->println(F(" Start")); }
+}
+
+void StopAllMacros()
+{
+    for (uint8_t m = 0; m < MAX_MACROS; m++) Macro_Running[m] = false;
+    if (DEBUG) { DebugSerial->println(F("Macros Stopped")); }
+}
+
+boolean isMacroFunction(_special_function sf)
+{
+    return (sf >= SF_MACRO1_RUN && sf <= SF_MACRO4_RUN);
+}
+
+// Called from UpdateSimpleTimers()
+void UpdateMacros()
+{
+    static boolean busy = false;
+    special_function_def def;
+    _macroStep * step;
+
+    // Some functions keep the timers running while they wait, which would bring us back in here before the step has finished
+    if (busy) return;
+    busy = true;
+
+    for (uint8_t m = 0; m < MAX_MACROS; m++)
+    {
+        // Run every step that is due. There can be several at once if they have no delay between them.
+        while (Macro_Running[m])
+        {
+            if (Macro_NextStep[m] >= MACRO_STEPS) { Macro_Running[m] = false; break; }
+
+            step = &eeprom.ramcopy.SF_Macro[m].Step[Macro_NextStep[m]];
+            if (step->Function == SF_NULL_FUNCTION) { Macro_Running[m] = false; break; }    // End of the list
+            if ((millis() - Macro_StepTime[m]) < step->Delay_mS) break;                     // Not yet
+
+            Macro_StepTime[m] += step->Delay_mS;
+            Macro_NextStep[m] += 1;
+
+            // A macro can't start another macro (or itself), that way there are no loops
+            if (isMacroFunction(step->Function)) continue;
+
+            // Same hardware check as LoadFunctionTriggers
+            def = getSpecialFunctionDef(step->Function);
+            if ((OP_Devices::capabilities().Flags & def.Requires) == def.Requires) def.Callback(step->Value);
+        }
+    }
+
+    busy = false;
+}
+
+// Special function versions
+void SF_Macro1_Run(uint16_t ignoreMe)           { StartMacro(0);            }
+void SF_Macro2_Run(uint16_t ignoreMe)           { StartMacro(1);            }
+void SF_Macro3_Run(uint16_t ignoreMe)           { StartMacro(2);            }
+void SF_Macro4_Run(uint16_t ignoreMe)           { StartMacro(3);            }
+void SF_MacroStopAll(uint16_t ignoreMe)         { StopAllMacros();          }
+
@@ -9,8 +9,8 @@ void InstantiateMotorObjects()
     RCOutput2_Available = true;    
     RCOutput3_Available = true;    
     RCOutput4_Available = true;    
-    MotorA_Available = true;
-    MotorB_Available = true;
+    MotorA_Available = OP_Devices::has(DEVCAP_ONBOARD_ESC);    // Without onboard motor pins there is nothing to give out
+    MotorB_Available = OP_Devices::has(DEVCAP_ONBOARD_ESC);
     uint8_t SteeringServoNum = 255; // Initialize to value that means nothing
 
    
@@ -30,12 +30,12 @@ void InstantiateMotorObjects()
         {
             case OP_SCOUT:
                 // For a single rear drive motor (or a single propulsion motor), connect it to M1
-                DriveMotor = new OPScout_SerialESC (SIDEA,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_DRIVE_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, false, eeprom.ramcopy.ScoutCurrentLimit);    
+                DriveMotor = new OPScout_SerialESC (SIDEA,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_DRIVE_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, false, eeprom.ramcopy.ScoutCurrentLimit, eeprom.ramcopy.ScoutTelemetry);    
                 DriveMotor->begin();
                 
                 // For ancient Tamiya gearboxes, the DKLM "Propulsion Dynamic" gearboxes, and any others that use a single motor for drive and a secondary motor to shift power from one tread to the other, 
                 // we have a "SteeringMotor" which will be the otherwise unused second output of the dual-motor serial controller 
-                SteeringMotor = new OPScout_SerialESC (SIDEB,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_DRIVE_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, false, eeprom.ramcopy.ScoutCurrentLimit);
+                SteeringMotor = new OPScout_SerialESC (SIDEB,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_DRIVE_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, false, eeprom.ramcopy.ScoutCurrentLimit, eeprom.ramcopy.ScoutTelemetry);
                 SteeringMotor->begin();    
                 break;
                 
@@ -133,8 +133,8 @@ void InstantiateMotorObjects()
         {
             case OP_SCOUT:
                 // Left drive to M1, Right drive to M2. 
-                LeftTread = new OPScout_SerialESC (SIDEA,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_DRIVE_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, eeprom.ramcopy.DragInnerTrack, eeprom.ramcopy.ScoutCurrentLimit);    
-                RightTread = new OPScout_SerialESC (SIDEB,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_DRIVE_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, eeprom.ramcopy.DragInnerTrack, eeprom.ramcopy.ScoutCurrentLimit);
+                LeftTread = new OPScout_SerialESC (SIDEA,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_DRIVE_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, eeprom.ramcopy.DragInnerTrack, eeprom.ramcopy.ScoutCurrentLimit, eeprom.ramcopy.ScoutTelemetry);    
+                RightTread = new OPScout_SerialESC (SIDEB,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_DRIVE_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, eeprom.ramcopy.DragInnerTrack, eeprom.ramcopy.ScoutCurrentLimit, eeprom.ramcopy.ScoutTelemetry);
                 break;
                 
             case SABERTOOTH:
@@ -225,7 +225,7 @@ void InstantiateMotorObjects()
     switch (eeprom.ramcopy.TurretRotationMotor)
     {
         case OP_SCOUT:      // M1
-            TurretRotation = new OPScout_SerialESC (SIDEA,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_TURRET_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, false, eeprom.ramcopy.ScoutCurrentLimit);
+            TurretRotation = new OPScout_SerialESC (SIDEA,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_TURRET_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, false, eeprom.ramcopy.ScoutCurrentLimit, eeprom.ramcopy.ScoutTelemetry);
             break;
         case SABERTOOTH:    // M1
             TurretRotation = new Sabertooth_SerialESC (SIDEA,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,Sabertooth_TURRET_Address,&MotorSerial);
@@ -289,7 +289,7 @@ void InstantiateMotorObjects()
     switch (eeprom.ramcopy.TurretElevationMotor)
     {
         case OP_SCOUT:      // M2
-            TurretElevation = new OPScout_SerialESC (SIDEB,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_TURRET_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, false, eeprom.ramcopy.ScoutCurrentLimit);
+            TurretElevation = new OPScout_SerialESC (SIDEB,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,OPScout_TURRET_Address,&MotorSerial,&eeprom.ramcopy.MotorSerialBaud, false, eeprom.ramcopy.ScoutCurrentLimit, eeprom.ramcopy.ScoutTelemetry);
             break;
         case SABERTOOTH:    // M2
             TurretElevation = new Sabertooth_SerialESC (SIDEB,MOTOR_MAX_REVSPEED,MOTOR_MAX_FWDSPEED,0,Sabertooth_TURRET_Address,&MotorSerial);
@@ -615,7 +615,8 @@ void SetupPins()
         // But if they want a full analog range, don't use pullups because it will prevent us from going all the way to ground (0)
         if (IO_Pin[IOA].Settings.dataType) pinMode(pin_IO_A, INPUT_PULLUP); 
         else pinMode(pin_IO_A, INPUT); 
-        PortA_ReadValue();  // Get the present value
+        // Add it to the background ADC sampler. Digital inputs are read raw, analog inputs get a little smoothing
+        IO_Pin[IOA].adcChannel = OP_ADC::addChannel(pin_IO_A, IO_Pin[IOA].Settings.dataType ? ADC_FILTER_NONE : ADC_FILTER_IO);
     }
     // IO "B" setup
     IO_Pin[IOB].Settings = eeprom.ramcopy.PortB_Settings;
@@ -629,11 +630,17 @@ void SetupPins()
         // But if they want a full analog range, don't use pullups because it will prevent us from going all the way to ground (0)
         if (IO_Pin[IOB].Settings.dataType) pinMode(pin_IO_B, INPUT_PULLUP);
         else pinMode(pin_IO_B, INPUT);        
-        PortB_ReadValue(); // Get the present value
+        IO_Pin[IOB].adcChannel = OP_ADC::addChannel(pin_IO_B, IO_Pin[IOB].Settings.dataType ? ADC_FILTER_NONE : ADC_FILTER_IO);
     }
 
 // Voltage sensor
     pinMode(pin_BattVoltage, INPUT);
+    BattVoltage_ADC = OP_ADC::addChannel(pin_BattVoltage, ADC_FILTER_BATTERY);
+
+// Analog inputs are all sampled in the background from here on. Take the first round now and get the present value of any IO inputs.
+    OP_ADC::begin();
+    if (!isPortA_Output()) PortA_ReadValue();
+    if (!isPortB_Output()) PortB_ReadValue();
                                                 
 // Dipswitch pins
     // These are held to ground when On, but left floating when Off - so we use the input pullups to keep them high when Off
@@ -667,8 +674,8 @@ void SetupPins()
     // This one is PNP, so logic high is off
     digitalWrite(pin_MuzzleFlash, HIGH);
     pinMode(pin_MuzzleFlash, OUTPUT);	    // Output	- Trigger output for Taigen High Intensity muzzle flash unit
-    // Machine gun LED has to be manipulated directly, we can't use the Arduino functions
-    MG_DDR |= (1 << MG_PORTPIN);            // Output   - Machine gun - set the port pin to output ("or" that bit of the data direction register with a 1)
+    // Machine gun LED has to be manipulated directly, we can't use the Arduino functions. Which port pin it is depends on the board. 
+    OP_Devices::setPinOutput(OP_Devices::capabilities().MG_Port, OP_Devices::capabilities().MG_Bit, LOW);    // Output, initially off
 
     // Initialize all these outputs to off
     // These are NPN MOSFETs, logic low is off
@@ -676,7 +683,6 @@ void SetupPins()
     digitalWrite(pin_Light2, LOW);
     digitalWrite(pin_Brakelights, LOW);
     digitalWrite(pin_HitNotifyLEDs, LOW);
-    MG_PORT &= ~(1 << MG_PORTPIN);          // Machine Gun LED must be set directly. We "and-not" the port pin bit with 1 to set it to 0, this turns it off
 
     // Aux Output
     pinMode(pin_AuxOutput, OUTPUT);         // Output   - Aux output. PWM capable. Has flyback diode, can drive a relay directly or a (very small) motor 
@@ -686,15 +692,21 @@ void SetupPins()
     if (isFunctionAssigned(SF_AUXOUT_INV_FLASH))    digitalWrite(pin_AuxOutput, HIGH); 
     else                                            digitalWrite(pin_AuxOutput, LOW);       
 
-    // Onboard motorized outputs
-    pinMode(OB_MA_PWM, OUTPUT);             // Motor A
-    pinMode(OB_MB_PWM, OUTPUT);             // Motor B
-    pinMode(OB_SMOKER_PWM, OUTPUT);         // Smoker
+    // Onboard motorized outputs, if this board has them
+    if (OP_Devices::has(DEVCAP_ONBOARD_ESC))
+    {
+        pinMode(OB_MA_PWM, OUTPUT);         // Motor A
+        pinMode(OB_MB_PWM, OUTPUT);         // Motor B
+    }
+    if (OP_Devices::has(DEVCAP_SMOKER)) pinMode(OB_SMOKER_PWM, OUTPUT);    // Smoker
     
     // Mechanical Recoil Trigger
-    pinMode(pin_MechRecoilMotor, OUTPUT);   // Output   - Transistor for Asiatam, Tamiya or similar mechanical recoil units
-    // Also NPN, logic low is off
-    digitalWrite(pin_MechRecoilMotor, LOW);
+    if (OP_Devices::has(DEVCAP_MECH_RECOIL))
+    {
+        pinMode(pin_MechRecoilMotor, OUTPUT);   // Output   - Transistor for Asiatam, Tamiya or similar mechanical recoil units
+        // Also NPN, logic low is off
+        digitalWrite(pin_MechRecoilMotor, LOW);
+    }
 
 // Unconnected Pins - set to Input with internal Pullups enabled
                                     // A Port dedicated to servos
@@ -724,12 +736,11 @@ void SetupPins()
     pinMode(49, INPUT_PULLUP);      // L0
                                     // AREF pin is not connected to anything either, which is correct because we are not using it. There is no setup needed for it. 
 
-    // Unused MG pin (depends on if this is the DIY version or not)
+    // Unused MG pin (depends on the board, see the DeviceCapabilities table in OP_Devices.cpp)
     // This takes care of either D1 or E2 (the other one will be the MG pin and is taken care of above)
-    UNUSED_MG_DDR  &= ~(1 << UNUSED_MG_PIN);  // Input - unusued machine gun pin, we "and-not" the data direction register slot with a 1 to set it to 0, this makes it an input
-    UNUSED_MG_PORT |=  (1 << UNUSED_MG_PIN);  // When we write a 1 to the port pin after it has been set to input, that connects the internal pull-up resistor
+    OP_Devices::setPinInputPullup(OP_Devices::capabilities().UnusedMG_Port, OP_Devices::capabilities().UnusedMG_Bit);
 
-    // D0 and E6 are taken care of in OP_Tank::begin() in OP_Tank.cpp
+    // D0 and E6 (recoil switch, see the DeviceCapabilities table) are taken care of in OP_Tank::begin() in OP_Tank.cpp
 
     // These are the remaining pins that are always unused regardless of version and which can't be access via Arduino names
     // Port D unused
@@ -28,6 +28,9 @@
 #include "src/OP_Settings/OP_Settings.h"
 #include "src/OP_FT/OP_FunctionsTriggers.h"
 #include "src/OP_IO/OP_IO.h"
+#include "src/OP_ADC/OP_ADC.h"
+#include "src/OP_RAM/OP_RAM.h"
+#include "src/OP_Battery/OP_Battery.h"
 #include "src/OP_PPMDecode/OP_PPMDecode.h"
 #include "src/OP_SBusDecode/OP_SBusDecode.h"
 #include "src/OP_IBusDecode/OP_iBusDecode.h"
@@ -86,10 +89,21 @@ void TransmissionEngage(boolean debugMsg=true);
     uint8_t triggerCount = 0;                    // How many triggers defined. Will be determined at run time. 
     uint16_t AdHocTriggers = 0x0000;             // We use individual bits of a 2-byte number to flag up to 16 different ad-hoc triggers. Initialize all to zero.
     boolean ForceTriggersOnFirstPass = true;     // This flag will force us to run through most special functions at least once on startup, even if the radio or other input doesn't show as updated
+    boolean Macro_Running[MAX_MACROS];           // Which macros are running right now (see the Macros tab)
+    uint8_t Macro_NextStep[MAX_MACROS];          // For each running macro, the step that will run next
+    uint32_t Macro_StepTime[MAX_MACROS];         // For each running macro, when the previous step was due. Delays are counted from here so steps don't drift.
+    uint8_t LogicTriggersFired = 0;              // One bit per logic trigger (see the LogicTriggers tab), set when it fires and cleared once the function triggers have been checked
+    uint8_t Logic_StateA = 0;                    // One bit per logic trigger, the last state of its first condition
+    uint8_t Logic_StateB = 0;                    // And of its second condition
+    uint8_t Logic_Output = 0;                    // Whether each logic trigger is currently true (after its hold time)
+    uint8_t Logic_Holding = 0;                   // Whether each logic trigger is true but still waiting out its hold time
+    uint32_t Logic_TrueSince[MAX_LOGIC_TRIGGERS];// When each of those went true
+    static_assert(MAX_LOGIC_TRIGGERS <= 8, "Logic trigger flags are one byte, MAX_LOGIC_TRIGGERS can't be more than 8");
 
 // I/O PINS
     external_io IO_Pin[NUM_IO_PORTS];            // Information about the general purpose I/O pins
     LedHandler IO_Output[NUM_IO_PORTS];          // These outputs are not necessarily for LEDs but the LedHandler class gives us convenient functions for controlling the ouputs.
+    static_assert(NUM_IO_PORTS + 1 <= LED_MAX_HANDLERS, "LED_MAX_HANDLERS must cover the IO outputs plus the tank's Apple LEDs");
 
 // LIGHTS/AUX OUTPUT
     boolean BrakeLightsActive = false;           // Are the brake lights on. We need to know this and running light state because they are both on the same output.
@@ -194,6 +208,8 @@ void TransmissionEngage(boolean debugMsg=true);
     boolean BatteryUnplugged = true;              // Assume unplugged to start. Try to detect if the user is running only USB power. This isn't strictly an LVC condition, but we also don't want to try running the motors. 
     int LVC_TimerID = 0;                          // This timer is used to periodically check the battery voltage level
     int LVC_BlinkTimerID = 0;                     // Timer used to blink lights when the battery voltage has got too low
+    uint8_t BattVoltage_ADC = ADC_NO_CHANNEL;     // OP_ADC channel sampling the battery voltage
+    OP_Battery Battery;                           // Estimates resting voltage, charge and runtime from the measured voltage and motor load
 
 // REPAIR / BATTLE
     #define REPAIR_NONE     0                     // No repair operation ongoing
@@ -221,9 +237,9 @@ void setup()
         Serial.begin(USB_BAUD_RATE);                               // Hardware Serial 0 - Connected to FTDI/USB connector. We also have a baud rate in EEPROM (eeprom.ramcopy.USBSerialBaud) but for now we leave this static at the baud rate set in OP_Settings.h
         AuxSerial.begin(eeprom.ramcopy.AuxSerialBaud);             // Hardware Serial 1 - alternate communication port
         MotorSerial.begin(eeprom.ramcopy.MotorSerialBaud);         // Hardware Serial 2 - reserved for serial motor controllers
-        Serial3Tx.begin(eeprom.ramcopy.Serial3TxBaud);             // Hardware Serial 3 - Receive used for serial radio receivers (SBus,iBus,etc). Tx brought out to Serial 3 connector, but Tx disabled if serial receiver detected. 
+        Serial3Tx.begin(eeprom.ramcopy.Serial3TxBaud);             // Hardware Serial 3 - Receive used for serial radio receivers (SBus,iBus,etc). Tx brought out to Serial 3 connector, but Tx disabled if serial receiver detected (or used for telemetry if CRSF). 
                                                                    //                     The original idea was to use Serial 3 for an Adafruit or Sparkfun serial LCD, and the connector is compatible with those, but no code was written for that application.
-        PCComm.begin(&eeprom, &Radio, HardwareVersion);            // Initialize the PC communication class. It needs a reference to OP_EEPROM annd OP_Radio objects which we pass by reference, also give the device ID
+        PCComm.begin(&eeprom, &Radio, HardwareVersion, &Battery);  // Initialize the PC communication class. It needs a reference to OP_EEPROM, OP_Radio and OP_Battery objects which we pass by reference, also give the device ID
         //PCComm.skipCRC();                                        // We can skip CRC checking for testing, but don't use this in production. 
         SetActiveCommPort();                                       // Check Dipswitch #5 and set the active communication port to USB if switch On, or Serial 1 if switch Off
 
@@ -243,6 +259,7 @@ void setup()
     // PINS NOT RELATED TO OBJECTS - SETUP
     // -------------------------------------------------------------------------------------------------------------------------------------------------->
         // We want to setup the pins as early as possible to put all outputs in a safe state. But remember to read EEPROM first because some EEPROM settings will determine how the pins are set. 
+        OP_Devices::begin();                                       // Load what this board has (THIS_BOARD, see OP_Devices.h). SetupPins and InstantiateMotorObjects check it.
         SetupPins();                                               // Any pin not explicitly set by a library gets initalized here. 
         RedLedOn();                                                // Keep the Red LED on solid until we are out of setup. 
 
@@ -350,6 +367,7 @@ void setup()
         BattleSettings.Use_MG_Protocol = eeprom.ramcopy.Use_MG_Protocol;
         BattleSettings.Accept_MG_Damage = eeprom.ramcopy.Accept_MG_Damage;
         BattleSettings.DamageProfile = eeprom.ramcopy.DamageProfile;
+        BattleSettings.CustomDamage = eeprom.ramcopy.CustomDamageProfile;
         BattleSettings.SendTankID = eeprom.ramcopy.SendTankID;
         BattleSettings.TankID = eeprom.ramcopy.TankID;
         // Now pass the battle settings and other settings
@@ -464,7 +482,7 @@ void setup()
     
     // RANDOM SEED
     // -------------------------------------------------------------------------------------------------------------------------------------------------->    
-        randomSeed(analogRead(pin_RandomSeed));
+        randomSeed(OP_ADC::readBlocking(pin_RandomSeed));
         // Now we are no longer going to use this pin, enable the pull-up resistor
         pinMode(pin_RandomSeed, INPUT_PULLUP);
 
@@ -570,6 +588,9 @@ if (Startup)
     // The user can specify a minimum speed percent below which squeaks will not occur. We convert this percent to an absolute speed number. 
         MinSqueakSpeed = (uint8_t)(((float)eeprom.ramcopy.MinSqueakSpeedPct / 100.0) * (float)MOTOR_MAX_FWDSPEED);
 
+    // Start the battery estimator. It runs whether or not LVC is enabled, so the charge and runtime estimates are always available.
+        EnableBatteryEstimator();
+
     // If the user enabled LVC, check the voltage every so often
         if (eeprom.ramcopy.LVC_Enabled)
         {
@@ -734,7 +755,7 @@ if (Startup)
             // Move barrel up/down in response to user commands
             if (Radio.Sticks.Elevation.updated && (Radio.Sticks.Elevation.ignore == false)) 
             {   
-                TurretElevation->setSpeed(Radio.Sticks.Elevation.command); 
+                MotorSetSpeed(TurretElevation, Radio.Sticks.Elevation.command); 
                 // If barrel elevation sound is enabled, play or stop the sound as appropriate
                 if (eeprom.ramcopy.BarrelSound_Enabled)
                 {
@@ -749,7 +770,7 @@ if (Startup)
         {
             if (Radio.Sticks.Azimuth.updated && (Radio.Sticks.Azimuth.ignore == false))     
             {  
-                TurretRotation->setSpeed(Radio.Sticks.Azimuth.command);
+                MotorSetSpeed(TurretRotation, Radio.Sticks.Azimuth.command);
                 // If turret rotation sound is enabled, play or stop the sound as appropriate
                 if (eeprom.ramcopy.TurretSound_Enabled)
                 {
@@ -801,9 +822,9 @@ if (Startup)
             }
             
             // Get drive mode command
-            if (!TransmissionEngaged)
+            if (!TransmissionEngaged || !DriveMotorsReady())
             {   // If the transmission is not engaged, we can't command any more movement. But if it was disengaged while coasting,
-                // we allow opposite command so the user can still brake. 
+                // we allow opposite command so the user can still brake. Until the drive motor controllers are ready we treat it the same way. 
                 DriveModeCommand = DriveModeActual;
                 switch (DriveModeActual)
                 {   case FORWARD:
@@ -1114,8 +1135,8 @@ if (Startup)
                     //Finally! We send the motor commands out to the motors, but only if something has changed since last time. 
                     if ((RightSpeed_Previous != RightSpeed) || (LeftSpeed_Previous != LeftSpeed))
                     {   
-                        RightTread->setSpeed(RightSpeed);
-                        LeftTread->setSpeed(LeftSpeed);
+                        MotorSetSpeed(RightTread, RightSpeed);
+                        MotorSetSpeed(LeftTread, LeftSpeed);
                         RightSpeed_Previous = RightSpeed;    // Save these for next time
                         LeftSpeed_Previous = LeftSpeed;
                     }
@@ -1127,7 +1148,7 @@ if (Startup)
                     // Send the signal if the DriveSpeed has changed
                     if (DriveSpeed_Previous != DriveSpeed)
                     {
-                        DriveMotor->setSpeed(DriveSpeed);
+                        MotorSetSpeed(DriveMotor, DriveSpeed);
                     }
                     // We set the front wheel steering servo a bit later, outside of this code block because we want servo steering control even when the engine is not running
                     break;
@@ -1137,12 +1158,12 @@ if (Startup)
                     // In this case the gearbox / DMD physically "mixes" turning, we just need to send it a drive speed for the single propulsion motor
                     if (DriveSpeed_Previous != DriveSpeed)
                     {
-                        DriveMotor->setSpeed(DriveSpeed);
+                        MotorSetSpeed(DriveMotor, DriveSpeed);
                     }
                     // And a steering command for the steering motor
                     if (TurnCommand_Previous != TurnCommand)
                     {
-                        SteeringMotor->setSpeed(TurnCommand);   // We send TurnCommand rather than TurnSpeed because we don't want any scaling effects applied in this case. TurnCommand is just equal to the stick input. 
+                        MotorSetSpeed(SteeringMotor, TurnCommand);  // We send TurnCommand rather than TurnSpeed because we don't want any scaling effects applied in this case. TurnCommand is just equal to the stick input. 
                     }
                     break;                    
             }
@@ -1202,7 +1223,7 @@ if (Startup)
         if (Radio.Sticks.Turn.updated)
         {   
             // The servo object knows that "setSpeed" actually means "set servo position." 
-            SteeringServo->setSpeed(Radio.Sticks.Turn.command);   
+            MotorSetSpeed(SteeringServo, Radio.Sticks.Turn.command);   
         }
     }
 
@@ -1211,6 +1232,9 @@ if (Startup)
     // -------------------------------------------------------------------------------------------------------------------------------------------------->
     if (Alive && HavePower)
     {
+        // Work out which logic triggers fire this time through, they get checked along with the rest below
+        UpdateLogicTriggers(DriveSpeedPct, Braking, TurnCommand);
+
         for (uint8_t t=0; t<triggerCount; t++)
         {
             // Check for any trigger matching the current turret stick position
@@ -1297,6 +1321,15 @@ if (Startup)
                     adhct >>= 1;    // Shift to the next bit (flag)
                 }
             }
+
+            // Logic triggers. Same idea as the ad-hoc triggers, each has a bit in LogicTriggersFired and a Trigger ID of (trigger_id_logic_start + logic trigger number)
+            if (LogicTriggersFired > 0 && 
+                eeprom.ramcopy.SF_Trigger[t].TriggerID >= trigger_id_logic_start && 
+                eeprom.ramcopy.SF_Trigger[t].TriggerID < (trigger_id_logic_start + MAX_LOGIC_TRIGGERS) && 
+                bitRead(LogicTriggersFired, eeprom.ramcopy.SF_Trigger[t].TriggerID - trigger_id_logic_start))
+                {
+                    SF_Callback[t](0);
+                }
         }
         
         // Finally, sort of a one-off trigger: the user has the option of starting the engine with the throttle channel
@@ -1324,6 +1357,7 @@ if (Startup)
     {
         // Ok, having processed all ad-hoc triggers, we now reset all 16 flags so they don't trip again unless they are explicitly set once more
         AdHocTriggers = 0; 
+        LogicTriggersFired = 0;
 
         // And we can clear this, it only needs to happen once
         ForceTriggersOnFirstPass = false;
@@ -26,4 +26,10 @@ void EndFailsafe()
     }
 }
 
-
+void UpdateRadioTelemetry()
+{
+    // Only CRSF receivers can send anything back to the transmitter, the Radio class ignores this for the others.
+    // If the battery isn't connected (running off USB) we send 0 volts rather than a meaningless number. 
+    if (Battery.isPresent()) Radio.SetTelemetry(Battery.measuredVoltage_mV(), Battery.stateOfCharge(), Tank.PctDamaged(), Tank.isDestroyed);
+    else                     Radio.SetTelemetry(0, 0, Tank.PctDamaged(), Tank.isDestroyed);
+}
@@ -12,31 +12,40 @@ void UpdateSimpleTimers()
 {
     timer.run();                        // Our simple timer object, used all over the place including by various libraries.  
     Radio.Update();                     // Radio update (polls SBus and iBus)
+    OP_ADC::update();                   // Start the next round of background analog samples (battery voltage, IO inputs) when it is time
+    OP_RAM::update();                   // Every so often check how close the stack has come to the heap
     UpdateEngineStatusDelayTimer();     // Engine status delay timer, prevents engine changing states quickly if user has specified a delay
     Tank.Update();                      // Polled updates for the tank object
 
     // Now we also update the four motor objects. The motor update() routines will only do something if the motor type is a serial controller. 
     // We can use this to force serial commands be sent at set intervals even if the command hasn't changed; this keeps us from tripping the serial 
     // watchdog that for example the Scout ESC implements. 
+    // MotorUpdate() skips the call entirely for motor types that have nothing to update (see OP_Motors.h). 
     switch (eeprom.ramcopy.DriveType)
     {
-        case DT_TANK:       { RightTread->update(); LeftTread->update();     } break;
-        case DT_HALFTRACK:  { RightTread->update(); LeftTread->update();     } break;
-        case DT_CAR:        { DriveMotor->update();                          } break;
+        case DT_TANK:       { MotorUpdate(RightTread); MotorUpdate(LeftTread);     } break;
+        case DT_HALFTRACK:  { MotorUpdate(RightTread); MotorUpdate(LeftTread);     } break;
+        case DT_CAR:        { MotorUpdate(DriveMotor);                             } break;
         case DT_DKLM:       // Fall through
-        case DT_DMD:        { DriveMotor->update(); SteeringMotor->update(); } break;
-        default:                                                               break;
+        case DT_DMD:        { MotorUpdate(DriveMotor); MotorUpdate(SteeringMotor); } break;
+        default:                                                                     break;
     }    
 
-    TurretRotation->update();
-    TurretElevation->update();
+    MotorUpdate(TurretRotation);
+    MotorUpdate(TurretElevation);
 
     // We also update the smoker object because it can have special effects that require polling, 
     // or serial watchdog that requires re-sending the current speed at regular intervals
     Smoker->update(TransmissionEngaged);
 
-    // Update IO A/B if outputs
-    for (int i=0; i<NUM_IO_PORTS; i++)  { if (IO_Pin[i].Settings.dataDirection == OUTPUT) IO_Output[i].update(); }
+    // The sound object gets polled too. The TBS uses it to ramp engine speed and pace out its Prop3 sounds, the other devices do nothing here.
+    SoundUpdate(TankSound);
+
+    // Run the next step of any macros that are due. Not while we're in failsafe or the battery is too low, the same as the function triggers. 
+    if (!Failsafe && HavePower) UpdateMacros();
+
+    // Update all LED effects in one pass. This covers the IO A/B outputs (if set to output) and the tank's Apple LEDs
+    LedHandler::updateAll();
 
 }
 
@@ -89,7 +89,7 @@ void SetSmoker_Speed(int smoker_speed)
 {
     if (eeprom.ramcopy.SmokerControlAuto && SmokerEnabled)
     {   
-        Smoker->setSpeed(smoker_speed);
+        Smoker->setSpeed(smoker_speed, true);   // Engine-linked, so a quick throttle jump can give a burst
     }
 }
 void Smoker_RestoreSpeed(void)
@@ -104,7 +104,7 @@ void Smoker_SetDestroyedSpeed()
     if (eeprom.ramcopy.SmokerControlAuto && SmokerEnabled && eeprom.ramcopy.SmokerDestroyedSpeed > 0)
     {
         Smoker->restore_Speed();    // The speed range may have been diminished during battle, we want to restore the full range
-        Smoker->setSpeed(eeprom.ramcopy.SmokerDestroyedSpeed);  // Now apply the user's smoker speed setting for when the tank is destroyed
+        Smoker->Destroyed(eeprom.ramcopy.SmokerDestroyedSpeed); // Now start the destroyed plume effect around the user's smoker speed setting for when the tank is destroyed
     }
 }
 
@@ -4,11 +4,220 @@
 // We also have "fake" functions for some that re-direct to the real function but without any parameters passed. 
 
 
+// ----------------------------------------------------------------------------------------------------------------------------------------------->>
+// SPECIAL FUNCTION TABLE
+// ----------------------------------------------------------------------------------------------------------------------------------------------->>
+// One row for every _special_function (OP_FunctionsTriggers.h), in the same order as the enum, so the row number is the function number. 
+// If you add a function to the enum you must add its row here too or the sketch won't compile (see the static_asserts below). 
+// Functions the TCB doesn't implement are pointed at SF_NullFunction. 
+constexpr special_function_def SpecialFunctionTable[] PROGMEM_FAR = 
+{
+//   Function                   Callback                        Digital Requires
+    {SF_NULL_FUNCTION,          &SF_NullFunction,               1,   0},
+    {SF_ENGINE_TOGGLE,          &SF_EngineToggle,               1,   0},
+    {SF_ENGINE_ON,              &SF_EngineOn,                   1,   0},
+    {SF_ENGINE_OFF,             &SF_EngineOff,                  1,   0},
+    {SF_TRANS_TOGGLE,           &SF_TransmissionToggle,         1,   0},
+    {SF_TRANS_ON,               &SF_TransmissionEngage,         1,   0},
+    {SF_TRANS_OFF,              &SF_TransmissionDisengage,      1,   0},
+    {SF_CANNON_FIRE,            &SF_FireCannon,                 1,   0},
+    {SF_MECH_BARREL,            &SF_MechBarrel,                 1,   DEVCAP_MECH_RECOIL},
+    {SF_RECOIL_SERVO,           &SF_RecoilServo,                1,   0},
+    {SF_HI_FLASH,               &SF_HiFlash,                    1,   0},
+    {SF_MG_FIRE,                &SF_MG_Start,                   1,   0},
+    {SF_MG_OFF,                 &SF_MG_Stop,                    1,   0},
+    {SF_BARREL_ENABLE,          &SF_MechBarrel_Enable,          1,   DEVCAP_MECH_RECOIL},
+    {SF_BARREL_DISABLE,         &SF_MechBarrel_Disable,         1,   DEVCAP_MECH_RECOIL},
+    {SF_BARREL_TOGGLE,          &SF_MechBarrel_Toggle,          1,   DEVCAP_MECH_RECOIL},
+    {SF_LIGHT1_TOGGLE,          &SF_Light1Toggle,               1,   0},
+    {SF_LIGHT1_ON,              &SF_Light1On,                   1,   0},
+    {SF_LIGHT1_OFF,             &SF_Light1Off,                  1,   0},
+    {SF_LIGHT2_TOGGLE,          &SF_Light2Toggle,               1,   0},
+    {SF_LIGHT2_ON,              &SF_Light2On,                   1,   0},
+    {SF_LIGHT2_OFF,             &SF_Light2Off,                  1,   0},
+    {SF_RUNNINGLIGHTS_TOGGLE,   &SF_RunningLightsToggle,        1,   0},
+    {SF_RUNNINGLIGHTS_ON,       &SF_RunningLightsOn,            1,   0},
+    {SF_RUNNINGLIGHTS_OFF,      &SF_RunningLightsOff,           1,   0},
+    {SF_AUXOUT_TOGGLE,          &SF_AuxOutputToggle,            1,   0},
+    {SF_AUXOUT_ON,              &SF_AuxOutputOn,                1,   0},
+    {SF_AUXOUT_OFF,             &SF_AuxOutputOff,               1,   0},
+    {SF_AUXOUT_LEVEL,           &AuxOutput_SetLevel,            0,   0},
+    {SF_AUXOUT_PRESETDIM,       &SF_AuxOutput_PresetDim,        1,   0},
+    {SF_AUXOUT_FLASH,           &SF_AuxOutputFlash,             1,   0},
+    {SF_AUXOUT_BLINK,           &SF_AuxOutputBlink,             1,   0},
+    {SF_AUXOUT_TOGGLEBLINK,     &SF_AuxOutputToggleBlink,       1,   0},
+    {SF_AUXOUT_REVOLVE,         &SF_AuxOutputRevolve,           1,   0},
+    {SF_AUXOUT_TOGGLEREVOLVE,   &SF_AuxOutputToggleRevolve,     1,   0},
+    {SF_USER_SOUND1_ONCE,       &SF_TriggerUserSound1,          1,   0},
+    {SF_USER_SOUND1_RPT,        &SF_UserSound1_Repeat,          1,   0},
+    {SF_USER_SOUND1_OFF,        &SF_UserSound1_Stop,            1,   0},
+    {SF_USER_SOUND2_ONCE,       &SF_TriggerUserSound2,          1,   0},
+    {SF_USER_SOUND2_RPT,        &SF_UserSound2_Repeat,          1,   0},
+    {SF_USER_SOUND2_OFF,        &SF_UserSound2_Stop,            1,   0},
+    {SF_OUTPUT_A_TOGGLE,        &SF_PortA_Toggle,               1,   0},
+    {SF_OUTPUT_A_ON,            &SF_PortA_On,                   1,   0},
+    {SF_OUTPUT_A_OFF,           &SF_PortA_Off,                  1,   0},
+    {SF_OUTPUT_B_TOGGLE,        &SF_PortB_Toggle,               1,   0},
+    {SF_OUTPUT_B_ON,            &SF_PortB_On,                   1,   0},
+    {SF_OUTPUT_B_OFF,           &SF_PortB_Off,                  1,   0},
+    {SF_ACCEL_LEVEL,            &SF_SetAccelRampFreq,           0,   0},
+    {SF_DECEL_LEVEL,            &SF_SetDecelRampFreq,           0,   0},
+    {SF_TURNMODE_1,             &SF_TurnMode1,                  1,   0},
+    {SF_TURNMODE_2,             &SF_TurnMode2,                  1,   0},
+    {SF_TURNMODE_3,             &SF_TurnMode3,                  1,   0},
+    {SF_SMOKER,                 &Smoker_ManualControl,          0,   0},
+    {SF_MOTOR_A,                &MotorA_ManualControl,          0,   DEVCAP_ONBOARD_ESC},
+    {SF_MOTOR_B,                &MotorB_ManualControl,          0,   DEVCAP_ONBOARD_ESC},
+    {SF_RC1_PASS,               &RC_Passthrough_1,              0,   0},
+    {SF_RC2_PASS,               &RC_Passthrough_2,              0,   0},
+    {SF_RC3_PASS,               &RC_Passthrough_3,              0,   0},
+    {SF_RC4_PASS,               &RC_Passthrough_4,              0,   0},
+    {SF_RC1_PASS_PAN,           &RC_PanServo_1,                 0,   0},
+    {SF_RC2_PASS_PAN,           &RC_PanServo_2,                 0,   0},
+    {SF_RC3_PASS_PAN,           &RC_PanServo_3,                 0,   0},
+    {SF_RC4_PASS_PAN,           &RC_PanServo_4,                 0,   0},
+    {SF_BARREL_STAB_ON,         &SF_NullFunction,               1,   0},   // No IMU on the TCB, these do nothing
+    {SF_BARREL_STAB_OFF,        &SF_NullFunction,               1,   0},
+    {SF_BARREL_STAB_TOGGLE,     &SF_NullFunction,               1,   0},
+    {SF_BARREL_STAB_LEVEL,      &SF_NullFunction,               0,   0},
+    {SF_HILLS_ON,               &SF_NullFunction,               1,   0},   // No IMU on the TCB, these do nothing
+    {SF_HILLS_OFF,              &SF_NullFunction,               1,   0},
+    {SF_HILLS_TOGGLE,           &SF_NullFunction,               1,   0},
+    {SF_HILLS_LEVEL,            &SF_NullFunction,               0,   0},
+    {SF_USER_FUNC_1,            &SF_UserFunc1,                  1,   0},
+    {SF_USER_FUNC_2,            &SF_UserFunc2,                  1,   0},
+    {SF_USER_ANLG_1,            &User_Analog_Function1,         0,   0},
+    {SF_USER_ANLG_2,            &User_Analog_Function2,         0,   0},
+    {SF_DUMP_DEBUG,             &SF_DumpDebug,                  1,   0},
+    {SF_NT_ENABLE,              &SF_NT_Enable,                  1,   0},
+    {SF_NT_DISABLE,             &SF_NT_Disable,                 1,   0},
+    {SF_NT_TOGGLE,              &SF_NT_Toggle,                  1,   0},
+    {SF_DRIVEPROFILE_1,         &SF_DriveProfile_1,             1,   0},
+    {SF_DRIVEPROFILE_2,         &SF_DriveProfile_2,             1,   0},
+    {SF_DRIVEPROFILE_TOGGLE,    &SF_DriveProfile_Toggle,        1,   0},
+    {SF_SMOKER_ENABLE,          &SF_Smoker_Enable,              1,   0},
+    {SF_SMOKER_DISABLE,         &SF_Smoker_Disable,             1,   0},
+    {SF_SMOKER_TOGGLE,          &SF_Smoker_Toggle,              1,   0},
+    {SF_SET_VOLUME,             &SetVolume,                     0,   0},
+    {SF_USER_SOUND3_ONCE,       &SF_TriggerUserSound3,          1,   0},
+    {SF_USER_SOUND3_RPT,        &SF_UserSound3_Repeat,          1,   0},
+    {SF_USER_SOUND3_OFF,        &SF_UserSound3_Stop,            1,   0},
+    {SF_USER_SOUND4_ONCE,       &SF_TriggerUserSound4,          1,   0},
+    {SF_USER_SOUND4_RPT,        &SF_UserSound4_Repeat,          1,   0},
+    {SF_USER_SOUND4_OFF,        &SF_UserSound4_Stop,            1,   0},
+    {SF_RC6_PASS,               &RC_Passthrough_6,              0,   0},
+    {SF_RC7_PASS,               &RC_Passthrough_7,              0,   0},
+    {SF_RC8_PASS,               &RC_Passthrough_8,              0,   0},
+    {SF_RC6_PASS_PAN,           &RC_PanServo_6,                 0,   0},
+    {SF_RC7_PASS_PAN,           &RC_PanServo_7,                 0,   0},
+    {SF_RC8_PASS_PAN,           &RC_PanServo_8,                 0,   0},
+    {SF_INCR_VOLUME,            &SF_IncreaseVolume,             1,   0},
+    {SF_DECR_VOLUME,            &SF_DecreaseVolume,             1,   0},
+    {SF_STOP_VOLUME,            &SF_StopVolume,                 1,   0},
+    {SF_SMOKER_ON,              &SF_Smoker_ManualOn,            1,   0},
+    {SF_SMOKER_OFF,             &SF_Smoker_ManualOff,           1,   0},
+    {SF_USER_SOUND5_ONCE,       &SF_TriggerUserSound5,          1,   0},
+    {SF_USER_SOUND5_RPT,        &SF_UserSound5_Repeat,          1,   0},
+    {SF_USER_SOUND5_OFF,        &SF_UserSound5_Stop,            1,   0},
+    {SF_USER_SOUND6_ONCE,       &SF_TriggerUserSound6,          1,   0},
+    {SF_USER_SOUND6_RPT,        &SF_UserSound6_Repeat,          1,   0},
+    {SF_USER_SOUND6_OFF,        &SF_UserSound6_Stop,            1,   0},
+    {SF_OUTPUT_A_PULSE,         &SF_PortA_Pulse,                1,   0},
+    {SF_OUTPUT_B_PULSE,         &SF_PortB_Pulse,                1,   0},
+    {SF_AUXOUT_INV_FLASH,       &SF_AuxOutputInverseFlash,      1,   0},
+    {SF_MG2_FIRE,               &SF_MG2_Start,                  1,   0},
+    {SF_MG2_OFF,                &SF_MG2_Stop,                   1,   0},
+    {SF_OVERLAY_ENABLE,         &SF_OverlayEnable,              1,   0},
+    {SF_OVERLAY_DISABLE,        &SF_OverlayDisable,             1,   0},
+    {SF_MANTRANS_FWD,           &SF_ManualTransForward,         1,   0},
+    {SF_MANTRANS_REV,           &SF_ManualTransReverse,         1,   0},
+    {SF_MANTRANS_NEUTRAL,       &SF_ManualTransNeutral,         1,   0},
+    {SF_AUXOUT_TOGGLEDIM,       &SF_AuxOutput_ToggleDim,        1,   0},
+    {SF_MOTOR_A_ON,             &MotorA_On,                     1,   DEVCAP_ONBOARD_ESC},
+    {SF_MOTOR_A_OFF,            &MotorA_Off,                    1,   DEVCAP_ONBOARD_ESC},
+    {SF_MOTOR_A_TOGGLE,         &MotorA_Toggle,                 1,   DEVCAP_ONBOARD_ESC},
+    {SF_MOTOR_B_ON,             &MotorB_On,                     1,   DEVCAP_ONBOARD_ESC},
+    {SF_MOTOR_B_OFF,            &MotorB_Off,                    1,   DEVCAP_ONBOARD_ESC},
+    {SF_MOTOR_B_TOGGLE,         &MotorB_Toggle,                 1,   DEVCAP_ONBOARD_ESC},
+    {SF_USER_SOUND7_ONCE,       &SF_TriggerUserSound7,          1,   0},
+    {SF_USER_SOUND7_RPT,        &SF_UserSound7_Repeat,          1,   0},
+    {SF_USER_SOUND7_OFF,        &SF_UserSound7_Stop,            1,   0},
+    {SF_USER_SOUND8_ONCE,       &SF_TriggerUserSound8,          1,   0},
+    {SF_USER_SOUND8_RPT,        &SF_UserSound8_Repeat,          1,   0},
+    {SF_USER_SOUND8_OFF,        &SF_UserSound8_Stop,            1,   0},
+    {SF_USER_SOUND9_ONCE,       &SF_TriggerUserSound9,          1,   0},
+    {SF_USER_SOUND9_RPT,        &SF_UserSound9_Repeat,          1,   0},
+    {SF_USER_SOUND9_OFF,        &SF_UserSound9_Stop,            1,   0},
+    {SF_USER_SOUND10_ONCE,      &SF_TriggerUserSound10,         1,   0},
+    {SF_USER_SOUND10_RPT,       &SF_UserSound10_Repeat,         1,   0},
+    {SF_USER_SOUND10_OFF,       &SF_UserSound10_Stop,           1,   0},
+    {SF_USER_SOUND11_ONCE,      &SF_TriggerUserSound11,         1,   0},
+    {SF_USER_SOUND11_RPT,       &SF_UserSound11_Repeat,         1,   0},
+    {SF_USER_SOUND11_OFF,       &SF_UserSound11_Stop,           1,   0},
+    {SF_USER_SOUND12_ONCE,      &SF_TriggerUserSound12,         1,   0},
+    {SF_USER_SOUND12_RPT,       &SF_UserSound12_Repeat,         1,   0},
+    {SF_USER_SOUND12_OFF,       &SF_UserSound12_Stop,           1,   0},
+    {SF_SBA_PLAYSTOP,           &SF_Soundbank_A_PlayStop,       1,   0},
+    {SF_SBA_NEXT,               &SF_Soundbank_A_Next,           1,   0},
+    {SF_SBA_PREVIOUS,           &SF_Soundbank_A_Previous,       1,   0},
+    {SF_SBA_RANDOM,             &SF_Soundbank_A_Random,         1,   0},
+    {SF_SBB_PLAYSTOP,           &SF_Soundbank_B_PlayStop,       1,   0},
+    {SF_SBB_NEXT,               &SF_Soundbank_B_Next,           1,   0},
+    {SF_SBB_PREVIOUS,           &SF_Soundbank_B_Previous,       1,   0},
+    {SF_SBB_RANDOM,             &SF_Soundbank_B_Random,         1,   0},
+    {SF_SPEED_25,               &SF_ReduceSpeed_25,             1,   0},
+    {SF_SPEED_50,               &SF_ReduceSpeed_50,             1,   0},
+    {SF_SPEED_75,               &SF_ReduceSpeed_75,             1,   0},
+    {SF_SPEED_RESTORE,          &SF_RestoreSpeed,               1,   0},
+    {SF_OUTPUT_A_BLINK,         &SF_PortA_Blink,                1,   0},
+    {SF_OUTPUT_B_BLINK,         &SF_PortB_Blink,                1,   0},
+    {SF_IR_ENABLE,              &SF_IR_Enable,                  1,   0},
+    {SF_IR_DISABLE,             &SF_IR_Disable,                 1,   0},
+    {SF_IR_TOGGLE,              &SF_IR_Toggle,                  1,   0},
+    {SF_SMOKER_MANTOGGLE,       &SF_Smoker_ManualToggle,        1,   0},
+    {SF_USER_SOUND_ALL_OFF,     &SF_UserSound_Stop_All,         1,   0},
+    {SF_SMOKE_PREHEAT_ON,       &SF_Smoker_PreheatEnable,       1,   0},
+    {SF_SMOKE_PREHEAT_OFF,      &SF_Smoker_PreheatDisable,      1,   0},
+    {SF_SMOKE_PREHEAT_TOGGLE,   &SF_Smoker_PreheatToggle,       1,   0},
+    {SF_MACRO1_RUN,             &SF_Macro1_Run,                 1,   0},
+    {SF_MACRO2_RUN,             &SF_Macro2_Run,                 1,   0},
+    {SF_MACRO3_RUN,             &SF_Macro3_Run,                 1,   0},
+    {SF_MACRO4_RUN,             &SF_Macro4_Run,                 1,   0},
+    {SF_MACRO_STOP_ALL,         &SF_MacroStopAll,               1,   0}
+};
+static_assert(sizeof(SpecialFunctionTable) / sizeof(special_function_def) == COUNT_SPECFUNCTIONS, "SpecialFunctionTable must have one row for every special function");
+static_assert(SF_MACRO_STOP_ALL == COUNT_SPECFUNCTIONS - 1, "COUNT_SPECFUNCTIONS does not match the last special function in the enum");
+static_assert(specialFunctionTableInOrder(SpecialFunctionTable, COUNT_SPECFUNCTIONS), "SpecialFunctionTable rows must be in the same order as the _special_function enum");
+
+special_function_def getSpecialFunctionDef(_special_function sf)
+{
+    special_function_def def; 
+    
+    // Anything out of range (a garbage number in EEPROM) gets the null function
+    if (sf >= COUNT_SPECFUNCTIONS) sf = SF_NULL_FUNCTION;
+    
+    // As with our other far tables we can't index the array directly, but since the row number is the function number we can go straight to it
+    uint32_t address = pgm_get_far_address(SpecialFunctionTable) + ((uint32_t)sf * sizeof(special_function_def));
+    uint8_t * p = (uint8_t *)&def;
+    for (uint8_t j = 0; j < sizeof(special_function_def); j++) p[j] = pgm_read_byte_far(address + j);
+    return def;
+}
+
+boolean isSpecialFunctionDigital(_special_function sf)
+{
+    // Digital is the third member of the row, we only need that one byte
+    if (sf >= COUNT_SPECFUNCTIONS) return true;
+    return pgm_read_byte_far(pgm_get_far_address(SpecialFunctionTable) + ((uint32_t)sf * sizeof(special_function_def)) + offsetof(special_function_def, Digital));
+}
+
+
 // ----------------------------------------------------------------------------------------------------------------------------------------------->>
 // LOAD SPECIAL FUNCTIONS INTO SF_CALLBACK ARRAY
 // ----------------------------------------------------------------------------------------------------------------------------------------------->>
 void LoadFunctionTriggers()
 {
+    special_function_def def; 
+    
     // Here we setup the special functions list. The user can create up to MAX_FUNCTION_TRIGGERS (40 for now) pairs of Triggers-to-Functions.
     // Here we save the callback function address for each trigger. 
     for (int i = 0; i <MAX_FUNCTION_TRIGGERS; i++)
@@ -22,166 +231,16 @@ void LoadFunctionTriggers()
             
             // Assign the callback function to the same index in the FunctionTrigger array
             // that the function definition occupies in our eeprom.ramcopy.SF_Trigger array
-            switch (eeprom.ramcopy.SF_Trigger[i].specialFunction)
-            {
-                case SF_ENGINE_TOGGLE:              SF_Callback[i] = &SF_EngineToggle;                              break;
-                case SF_ENGINE_ON:                  SF_Callback[i] = &SF_EngineOn;                                  break; 
-                case SF_ENGINE_OFF:                 SF_Callback[i] = &SF_EngineOff;                                 break;
-                case SF_TRANS_TOGGLE:               SF_Callback[i] = &SF_TransmissionToggle;                        break;
-                case SF_TRANS_ON:                   SF_Callback[i] = &SF_TransmissionEngage;                        break;
-                case SF_TRANS_OFF:                  SF_Callback[i] = &SF_TransmissionDisengage;                     break;
-                case SF_CANNON_FIRE:                SF_Callback[i] = &SF_FireCannon;                                break;
-                case SF_MECH_BARREL:                SF_Callback[i] = &SF_MechBarrel;                                break;
-                case SF_RECOIL_SERVO:               SF_Callback[i] = &SF_RecoilServo;                               break;
-                case SF_HI_FLASH:                   SF_Callback[i] = &SF_HiFlash;                                   break;
-                case SF_MG_FIRE:                    SF_Callback[i] = &SF_MG_Start;                                  break;
-                case SF_MG_OFF:                     SF_Callback[i] = &SF_MG_Stop;                                   break;
-                case SF_MG2_FIRE:                   SF_Callback[i] = &SF_MG2_Start;                                 break;
-                case SF_MG2_OFF:                    SF_Callback[i] = &SF_MG2_Stop;                                  break;
-                case SF_BARREL_ENABLE:              SF_Callback[i] = &SF_MechBarrel_Enable;                         break;
-                case SF_BARREL_DISABLE:             SF_Callback[i] = &SF_MechBarrel_Disable;                        break;
-                case SF_BARREL_TOGGLE:              SF_Callback[i] = &SF_MechBarrel_Toggle;                         break;
-                case SF_IR_ENABLE:                  SF_Callback[i] = &SF_IR_Enable;                                 break;
-                case SF_IR_DISABLE:                 SF_Callback[i] = &SF_IR_Disable;                                break;
-                case SF_IR_TOGGLE:                  SF_Callback[i] = &SF_IR_Toggle;                                 break;
-                case SF_LIGHT1_TOGGLE:              SF_Callback[i] = &SF_Light1Toggle;                              break;
-                case SF_LIGHT1_ON:                  SF_Callback[i] = &SF_Light1On;                                  break;
-                case SF_LIGHT1_OFF:                 SF_Callback[i] = &SF_Light1Off;                                 break;
-                case SF_LIGHT2_TOGGLE:              SF_Callback[i] = &SF_Light2Toggle;                              break;
-                case SF_LIGHT2_ON:                  SF_Callback[i] = &SF_Light2On;                                  break;
-                case SF_LIGHT2_OFF:                 SF_Callback[i] = &SF_Light2Off;                                 break;                
-                case SF_RUNNINGLIGHTS_TOGGLE:       SF_Callback[i] = &SF_RunningLightsToggle;                       break;
-                case SF_RUNNINGLIGHTS_ON:           SF_Callback[i] = &SF_RunningLightsOn;                           break;
-                case SF_RUNNINGLIGHTS_OFF:          SF_Callback[i] = &SF_RunningLightsOff;                          break;
-                case SF_AUXOUT_TOGGLE:              SF_Callback[i] = &SF_AuxOutputToggle;                           break;
-                case SF_AUXOUT_ON:                  SF_Callback[i] = &SF_AuxOutputOn;                               break;
-                case SF_AUXOUT_OFF:                 SF_Callback[i] = &SF_AuxOutputOff;                              break;
-                case SF_AUXOUT_LEVEL:               SF_Callback[i] = &AuxOutput_SetLevel;                           break; // Analog function
-                case SF_AUXOUT_PRESETDIM:           SF_Callback[i] = &SF_AuxOutput_PresetDim;                       break;
-                case SF_AUXOUT_TOGGLEDIM:           SF_Callback[i] = &SF_AuxOutput_ToggleDim;                       break;
-                case SF_AUXOUT_FLASH:               SF_Callback[i] = &SF_AuxOutputFlash;                            break;
-                case SF_AUXOUT_INV_FLASH:           SF_Callback[i] = &SF_AuxOutputInverseFlash;                     break;
-                case SF_AUXOUT_BLINK:               SF_Callback[i] = &SF_AuxOutputBlink;                            break;
-                case SF_AUXOUT_TOGGLEBLINK:         SF_Callback[i] = &SF_AuxOutputToggleBlink;                      break;
-                case SF_AUXOUT_REVOLVE:             SF_Callback[i] = &SF_AuxOutputRevolve;                          break;
-                case SF_AUXOUT_TOGGLEREVOLVE:       SF_Callback[i] = &SF_AuxOutputToggleRevolve;                    break;                    
-                case SF_SET_VOLUME:                 SF_Callback[i] = &SetVolume;                                    break; // Analog function
-                case SF_OVERLAY_ENABLE:             SF_Callback[i] = &SF_OverlayEnable;                             break;
-                case SF_OVERLAY_DISABLE:            SF_Callback[i] = &SF_OverlayDisable;                            break;
-                case SF_USER_SOUND1_ONCE:           SF_Callback[i] = &SF_TriggerUserSound1;                         break;
-                case SF_USER_SOUND1_RPT:            SF_Callback[i] = &SF_UserSound1_Repeat;                         break;
-                case SF_USER_SOUND1_OFF:            SF_Callback[i] = &SF_UserSound1_Stop;                           break;
-                case SF_USER_SOUND2_ONCE:           SF_Callback[i] = &SF_TriggerUserSound2;                         break;
-                case SF_USER_SOUND2_RPT:            SF_Callback[i] = &SF_UserSound2_Repeat;                         break;
-                case SF_USER_SOUND2_OFF:            SF_Callback[i] = &SF_UserSound2_Stop;                           break;
-                case SF_USER_SOUND3_ONCE:           SF_Callback[i] = &SF_TriggerUserSound3;                         break;
-                case SF_USER_SOUND3_RPT:            SF_Callback[i] = &SF_UserSound3_Repeat;                         break;
-                case SF_USER_SOUND3_OFF:            SF_Callback[i] = &SF_UserSound3_Stop;                           break;
-                case SF_USER_SOUND4_ONCE:           SF_Callback[i] = &SF_TriggerUserSound4;                         break;
-                case SF_USER_SOUND4_RPT:            SF_Callback[i] = &SF_UserSound4_Repeat;                         break;
-                case SF_USER_SOUND4_OFF:            SF_Callback[i] = &SF_UserSound4_Stop;                           break;
-                case SF_USER_SOUND5_ONCE:           SF_Callback[i] = &SF_TriggerUserSound5;                         break;
-                case SF_USER_SOUND5_RPT:            SF_Callback[i] = &SF_UserSound5_Repeat;                         break;
-                case SF_USER_SOUND5_OFF:            SF_Callback[i] = &SF_UserSound5_Stop;                           break;
-                case SF_USER_SOUND6_ONCE:           SF_Callback[i] = &SF_TriggerUserSound6;                         break;
-                case SF_USER_SOUND6_RPT:            SF_Callback[i] = &SF_UserSound6_Repeat;                         break;
-                case SF_USER_SOUND6_OFF:            SF_Callback[i] = &SF_UserSound6_Stop;                           break;
-                case SF_USER_SOUND7_ONCE:           SF_Callback[i] = &SF_TriggerUserSound7;                         break;
-                case SF_USER_SOUND7_RPT:            SF_Callback[i] = &SF_UserSound7_Repeat;                         break;
-                case SF_USER_SOUND7_OFF:            SF_Callback[i] = &SF_UserSound7_Stop;                           break;
-                case SF_USER_SOUND8_ONCE:           SF_Callback[i] = &SF_TriggerUserSound8;                         break;
-                case SF_USER_SOUND8_RPT:            SF_Callback[i] = &SF_UserSound8_Repeat;                         break;
-                case SF_USER_SOUND8_OFF:            SF_Callback[i] = &SF_UserSound8_Stop;                           break;
-                case SF_USER_SOUND9_ONCE:           SF_Callback[i] = &SF_TriggerUserSound9;                         break;
-                case SF_USER_SOUND9_RPT:            SF_Callback[i] = &SF_UserSound9_Repeat;                         break;
-                case SF_USER_SOUND9_OFF:            SF_Callback[i] = &SF_UserSound9_Stop;                           break;
-                case SF_USER_SOUND10_ONCE:          SF_Callback[i] = &SF_TriggerUserSound10;                        break;
-                case SF_USER_SOUND10_RPT:           SF_Callback[i] = &SF_UserSound10_Repeat;                        break;
-                case SF_USER_SOUND10_OFF:           SF_Callback[i] = &SF_UserSound10_Stop;                          break;
-                case SF_USER_SOUND11_ONCE:          SF_Callback[i] = &SF_TriggerUserSound11;                        break;
-                case SF_USER_SOUND11_RPT:           SF_Callback[i] = &SF_UserSound11_Repeat;                        break;
-                case SF_USER_SOUND11_OFF:           SF_Callback[i] = &SF_UserSound11_Stop;                          break;
-                case SF_USER_SOUND12_ONCE:          SF_Callback[i] = &SF_TriggerUserSound12;                        break;
-                case SF_USER_SOUND12_RPT:           SF_Callback[i] = &SF_UserSound12_Repeat;                        break;
-                case SF_USER_SOUND12_OFF:           SF_Callback[i] = &SF_UserSound12_Stop;                          break;
-                case SF_USER_SOUND_ALL_OFF:         SF_Callback[i] = &SF_UserSound_Stop_All;                        break;
-                case SF_SBA_PLAYSTOP:               SF_Callback[i] = &SF_Soundbank_A_PlayStop;                      break;
-                case SF_SBA_NEXT:                   SF_Callback[i] = &SF_Soundbank_A_Next;                          break;
-                case SF_SBA_PREVIOUS:               SF_Callback[i] = &SF_Soundbank_A_Previous;                      break;
-                case SF_SBA_RANDOM:                 SF_Callback[i] = &SF_Soundbank_A_Random;                        break;
-                case SF_SBB_PLAYSTOP:               SF_Callback[i] = &SF_Soundbank_B_PlayStop;                      break;
-                case SF_SBB_NEXT:                   SF_Callback[i] = &SF_Soundbank_B_Next;                          break;
-                case SF_SBB_PREVIOUS:               SF_Callback[i] = &SF_Soundbank_B_Previous;                      break;
-                case SF_SBB_RANDOM:                 SF_Callback[i] = &SF_Soundbank_B_Random;                        break;                
-                case SF_OUTPUT_A_TOGGLE:            SF_Callback[i] = &SF_PortA_Toggle;                              break;
-                case SF_OUTPUT_A_ON:                SF_Callback[i] = &SF_PortA_On;                                  break; 
-                case SF_OUTPUT_A_OFF:               SF_Callback[i] = &SF_PortA_Off;                                 break; 
-                case SF_OUTPUT_A_PULSE:             SF_Callback[i] = &SF_PortA_Pulse;                               break;
-                case SF_OUTPUT_A_BLINK:             SF_Callback[i] = &SF_PortA_Blink;                               break;
-                case SF_OUTPUT_B_TOGGLE:            SF_Callback[i] = &SF_PortB_Toggle;                              break;
-                case SF_OUTPUT_B_ON:                SF_Callback[i] = &SF_PortB_On;                                  break; 
-                case SF_OUTPUT_B_OFF:               SF_Callback[i] = &SF_PortB_Off;                                 break; 
-                case SF_OUTPUT_B_PULSE:             SF_Callback[i] = &SF_PortB_Pulse;                               break;                                
-                case SF_OUTPUT_B_BLINK:             SF_Callback[i] = &SF_PortB_Blink;                               break;                
-                case SF_ACCEL_LEVEL:                SF_Callback[i] = &SF_SetAccelRampFreq;                          break;         
-                case SF_DECEL_LEVEL:                SF_Callback[i] = &SF_SetDecelRampFreq;                          break;
-                case SF_TURNMODE_1:                 SF_Callback[i] = &SF_TurnMode1;                                 break;                    
-                case SF_TURNMODE_2:                 SF_Callback[i] = &SF_TurnMode2;                                 break;                    
-                case SF_TURNMODE_3:                 SF_Callback[i] = &SF_TurnMode3;                                 break;                    
-                case SF_SMOKER:                     SF_Callback[i] = &Smoker_ManualControl;                         break; // Analog function for controlling speed of smoker output (could be a motor or light or whatever)
-                case SF_SMOKER_ON:                  SF_Callback[i] = &SF_Smoker_ManualOn;                           break; // Manual control of smoker output
-                case SF_SMOKER_OFF:                 SF_Callback[i] = &SF_Smoker_ManualOff;                          break; // Manual control of smoker output
-                case SF_SMOKER_MANTOGGLE:           SF_Callback[i] = &SF_Smoker_ManualToggle;                       break; // Manual control of smoker output
-                case SF_SMOKE_PREHEAT_ON:           SF_Callback[i] = &SF_Smoker_PreheatEnable;                      break;
-                case SF_SMOKE_PREHEAT_OFF:          SF_Callback[i] = &SF_Smoker_PreheatDisable;                     break;
-                case SF_SMOKE_PREHEAT_TOGGLE:       SF_Callback[i] = &SF_Smoker_PreheatToggle;                      break;
-                case SF_MOTOR_A:                    SF_Callback[i] = &MotorA_ManualControl;                         break; // Analog function
-                case SF_MOTOR_B:                    SF_Callback[i] = &MotorB_ManualControl;                         break; // Analog function
-                case SF_MOTOR_A_ON:                 SF_Callback[i] = &MotorA_On;                                    break;
-                case SF_MOTOR_A_OFF:                SF_Callback[i] = &MotorA_Off;                                   break;
-                case SF_MOTOR_A_TOGGLE:             SF_Callback[i] = &MotorA_Toggle;                                break;
-                case SF_MOTOR_B_ON:                 SF_Callback[i] = &MotorB_On;                                    break;
-                case SF_MOTOR_B_OFF:                SF_Callback[i] = &MotorB_Off;                                   break;
-                case SF_MOTOR_B_TOGGLE:             SF_Callback[i] = &MotorB_Toggle;                                break;                
-                case SF_RC1_PASS:                   SF_Callback[i] = &RC_Passthrough_1;                             break; // Analog function
-                case SF_RC2_PASS:                   SF_Callback[i] = &RC_Passthrough_2;                             break; // Analog function
-                case SF_RC3_PASS:                   SF_Callback[i] = &RC_Passthrough_3;                             break; // Analog function
-                case SF_RC4_PASS:                   SF_Callback[i] = &RC_Passthrough_4;                             break; // Analog function // No passthrough for 5 - that is always reserved for recoil
-                case SF_RC6_PASS:                   SF_Callback[i] = &RC_Passthrough_6;                             break; // Analog function
-                case SF_RC7_PASS:                   SF_Callback[i] = &RC_Passthrough_7;                             break; // Analog function
-                case SF_RC8_PASS:                   SF_Callback[i] = &RC_Passthrough_8;                             break; // Analog function
-                case SF_RC1_PASS_PAN:               SF_Callback[i] = &RC_PanServo_1;                                break; // Analog function
-                case SF_RC2_PASS_PAN:               SF_Callback[i] = &RC_PanServo_2;                                break; // Analog function
-                case SF_RC3_PASS_PAN:               SF_Callback[i] = &RC_PanServo_3;                                break; // Analog function
-                case SF_RC4_PASS_PAN:               SF_Callback[i] = &RC_PanServo_4;                                break; // Analog function  // No pan for 5 - that is always reserved for recoil
-                case SF_RC6_PASS_PAN:               SF_Callback[i] = &RC_PanServo_6;                                break; // Analog function
-                case SF_RC7_PASS_PAN:               SF_Callback[i] = &RC_PanServo_7;                                break; // Analog function
-                case SF_RC8_PASS_PAN:               SF_Callback[i] = &RC_PanServo_8;                                break; // Analog function
-                case SF_USER_FUNC_1:                SF_Callback[i] = &SF_UserFunc1;                                 break;
-                case SF_USER_FUNC_2:                SF_Callback[i] = &SF_UserFunc2;                                 break;                    
-                case SF_USER_ANLG_1:                SF_Callback[i] = &User_Analog_Function1;                        break; // Analog function
-                case SF_USER_ANLG_2:                SF_Callback[i] = &User_Analog_Function2;                        break; // Analog function
-                case SF_DUMP_DEBUG:                 SF_Callback[i] = &SF_DumpDebug;                                 break;
-                case SF_NT_ENABLE:                  SF_Callback[i] = &SF_NT_Enable;                                 break;
-                case SF_NT_DISABLE:                 SF_Callback[i] = &SF_NT_Disable;                                break;
-                case SF_NT_TOGGLE:                  SF_Callback[i] = &SF_NT_Toggle;                                 break;
-                case SF_DRIVEPROFILE_1:             SF_Callback[i] = &SF_DriveProfile_1;                            break;
-                case SF_DRIVEPROFILE_2:             SF_Callback[i] = &SF_DriveProfile_2;                            break;
-                case SF_DRIVEPROFILE_TOGGLE:        SF_Callback[i] = &SF_DriveProfile_Toggle;                       break;
-                case SF_SPEED_75:                   SF_Callback[i] = &SF_ReduceSpeed_75;                            break;
-                case SF_SPEED_50:                   SF_Callback[i] = &SF_ReduceSpeed_50;                            break;
-                case SF_SPEED_25:                   SF_Callback[i] = &SF_ReduceSpeed_25;                            break;
-                case SF_SPEED_RESTORE:              SF_Callback[i] = &SF_RestoreSpeed;                              break;
-                case SF_SMOKER_ENABLE:              SF_Callback[i] = &SF_Smoker_Enable;                             break; // Control of auto smoker function
-                case SF_SMOKER_DISABLE:             SF_Callback[i] = &SF_Smoker_Disable;                            break; // Control of auto smoker function
-                case SF_SMOKER_TOGGLE:              SF_Callback[i] = &SF_Smoker_Toggle;                             break; // Control of auto smoker function
-                case SF_INCR_VOLUME:                SF_Callback[i] = &SF_IncreaseVolume;                            break;
-                case SF_DECR_VOLUME:                SF_Callback[i] = &SF_DecreaseVolume;                            break;
-                case SF_STOP_VOLUME:                SF_Callback[i] = &SF_StopVolume;                                break;
-                case SF_MANTRANS_FWD:               SF_Callback[i] = &SF_ManualTransForward;                        break;
-                case SF_MANTRANS_REV:               SF_Callback[i] = &SF_ManualTransReverse;                        break;
-                case SF_MANTRANS_NEUTRAL:           SF_Callback[i] = &SF_ManualTransNeutral;                        break;
-            }
+            def = getSpecialFunctionDef(eeprom.ramcopy.SF_Trigger[i].specialFunction);
+            
+            // If the board doesn't have what the function needs there is nothing for it to do
+            if ((OP_Devices::capabilities().Flags & def.Requires) != def.Requires) SF_Callback[i] = &SF_NullFunction;
+            else                                                                   SF_Callback[i] = def.Callback;
+        }
+        else
+        {
+            // Never leave a slot pointing at nothing
+            SF_Callback[i] = &SF_NullFunction;
         }
     }
 }
@@ -327,6 +386,7 @@ void PrintTriggerDescription(_special_function sf, uint16_t TriggerID)
             case ADHOC_TRIGGER_RIGHT_TURN:          DebugSerial->print(F("Right Turn Started"));PrintSpaces(11); break;
             case ADHOC_TRIGGER_LEFT_TURN:           DebugSerial->print(F("Left Turn Started")); PrintSpaces(12); break;
             case ADHOC_TRIGGER_NO_TURN:             DebugSerial->print(F("Turn Stopped"));      PrintSpaces(17); break;
+            case ADHOC_TRIGGER_BATTERY_LOW:         DebugSerial->print(F("Battery Low"));       PrintSpaces(18); break;
         }        
     }
     // Vehicle speed triggers - increasing speed
@@ -383,6 +443,13 @@ void PrintTriggerDescription(_special_function sf, uint16_t TriggerID)
         DebugSerial->print(F("Barrel Elevation Command"));
         PrintSpaces(PadLength - 24);
     }    
+    // Logic triggers
+    else if (TriggerID >= trigger_id_logic_start && TriggerID < (trigger_id_logic_start + MAX_LOGIC_TRIGGERS))
+    {
+        DebugSerial->print(F("Logic Trigger "));
+        DebugSerial->print(TriggerID - trigger_id_logic_start + 1);
+        PrintSpaces(PadLength - 15);
+    }
 }
 
 // The Trigger ID for the 9 turret stick positions are not numbers 1-9, 
@@ -501,6 +568,7 @@ uint8_t getAuxChannelNumberFromTriggerID(uint16_t TriggerID)
 // for our function pointer. So to make using these functions elsewhere in the code
 // easier, we create SF_functions that take an (ignored) parameter and then just call
 // the function we actually want. 
+void SF_NullFunction(uint16_t ignoreMe)         { }                         // Placeholder for unassigned triggers and functions this board can't do
 void SF_EngineToggle(uint16_t ignoreMe)         { EngineToggle();           }
 void SF_EngineOn(uint16_t ignoreMe)             { EngineOn();               }
 void SF_EngineOff(uint16_t ignoreMe)            { EngineOff();              }
@@ -148,17 +148,35 @@ void DumpSysInfo()
     DumpBaudRates();
         PerLoopUpdates();
         DebugSerial->flush();    
+    DumpRAM();
+        PerLoopUpdates();
+        DebugSerial->flush();    
     DebugSerial->println();
     PrintDebugLine();    
 }
 
+void DumpRAM()
+{
+ram_stats rs;
+
+    OP_RAM::getStats(rs);
+    DebugSerial->println();
+    PrintDebugLine();
+    DebugSerial->println(F("RAM (bytes)"));
+    PrintDebugLine();
+    DebugSerial->print(F("Static:       ")); DebugSerial->print(rs.DataBytes + rs.BssBytes); 
+    DebugSerial->print(F(" (data ")); DebugSerial->print(rs.DataBytes); DebugSerial->print(F(", bss ")); DebugSerial->print(rs.BssBytes); DebugSerial->println(F(")"));
+    DebugSerial->print(F("Heap:         ")); DebugSerial->print(rs.HeapBytes); DebugSerial->print(F(" (max ")); DebugSerial->print(rs.HeapMax); DebugSerial->println(F(")"));
+    DebugSerial->print(F("Stack:        ")); DebugSerial->print(rs.StackBytes); DebugSerial->print(F(" (max ")); DebugSerial->print(rs.StackMax); DebugSerial->println(F(")"));
+    DebugSerial->print(F("Free:         ")); DebugSerial->print(rs.FreeBytes); DebugSerial->print(F(" (min ")); DebugSerial->print(rs.FreeMin); DebugSerial->println(F(")"));
+}
+
 void DumpVersion()
 {
     DebugSerial->println();
     PrintDebugLine();
     DebugSerial->print(F("FIRMWARE VERSION: "));
-    String str = FIRMWARE_VERSION;
-    DebugSerial->print(str);
+    DebugSerial->print(F(FIRMWARE_VERSION));
     DebugSerial->print(" (EEPROM Size: ");
     DebugSerial->print(sizeof(_eeprom_data));
     DebugSerial->println(")");    
@@ -169,6 +187,8 @@ void DumpRadioInfo()
     DumpStickInfo();
     DumpAuxChannelsInfo();
     DumpChannelsDetectedUtilized();
+    DumpRadioStats();
+    DumpLinkStats();
 }
 
 void DumpStickInfo()
@@ -216,6 +236,54 @@ void DumpChannelsDetectedUtilized()
     DebugSerial->print(F("Channels utilized: ")); DebugSerial->println(Radio.ChannelsUtilized);
 }
 
+void DumpRadioStats()
+{
+    radio_stats rs;
+    Radio.GetStats(rs);
+    
+    DebugSerial->println();
+    PrintDebugLine();
+    DebugSerial->println(F("RADIO FRAME STATISTICS"));
+    PrintDebugLine();
+    DebugSerial->print(F("Frames used:      ")); DebugSerial->print(rs.Frames); DebugSerial->print(F(" (decoded ")); DebugSerial->print(rs.DecodedFrames); DebugSerial->println(F(")"));
+    DebugSerial->print(F("Lost frames:      ")); DebugSerial->println(rs.LostFrames);
+    DebugSerial->print(F("Interval (uS):    ")); DebugSerial->print(rs.MinInterval_uS); DebugSerial->print(F(" min / ")); DebugSerial->print(rs.AvgInterval_uS); DebugSerial->print(F(" avg / ")); DebugSerial->print(rs.MaxInterval_uS); DebugSerial->println(F(" max"));
+    DebugSerial->print(F("Max latency (uS): ")); DebugSerial->println(rs.MaxLatency_uS);
+    DebugSerial->print(F("Errors:           ")); DebugSerial->print(rs.FormatErrors); DebugSerial->print(F(" format, ")); DebugSerial->print(rs.CRCErrors); DebugSerial->print(F(" checksum, ")); DebugSerial->print(rs.RxFailsafe); DebugSerial->println(F(" receiver failsafe"));
+    DebugSerial->print(F("Failsafes:        ")); DebugSerial->print(rs.Failsafes[RADIO_FS_NONE]);
+    if (rs.Failsafes[RADIO_FS_NONE] > 0) { DebugSerial->print(F(" (last: ")); DebugSerial->print(RadioFailsafeReason(rs.LastFailsafe)); DebugSerial->print(F(")")); }
+    DebugSerial->println();
+    for (uint8_t i = RADIO_FS_TIMEOUT; i < RADIO_FS_REASONS; i++)
+    {
+        if (rs.Failsafes[i] > 0) { PrintSpaces(18); DebugSerial->print(RadioFailsafeReason(i)); DebugSerial->print(F(": ")); DebugSerial->println(rs.Failsafes[i]); }
+    }
+    DebugSerial->println(F("Histogram   Interval         Latency"));
+    for (uint8_t b = 0; b < RADIO_HIST_BUCKETS; b++)
+    {
+        PrintSpaces(12);
+        if (b < RADIO_HIST_BUCKETS - 1) { DebugSerial->print(F("<")); DebugSerial->print(RadioIntervalBucket_uS(b)); } else DebugSerial->print(F("more"));
+        DebugSerial->print(F(": ")); DebugSerial->print(rs.IntervalHist[b]); DebugSerial->print(F("\t"));
+        if (b < RADIO_HIST_BUCKETS - 1) { DebugSerial->print(F("<")); DebugSerial->print(RadioLatencyBucket_uS(b)); } else DebugSerial->print(F("more"));
+        DebugSerial->print(F(": ")); DebugSerial->println(rs.LatencyHist[b]);
+    }
+}
+
+void DumpLinkStats()
+{
+    crsf_link_stats ls;
+    if (!Radio.GetLinkStats(ls)) return;    // Only CRSF receivers report these
+    
+    DebugSerial->println();
+    PrintDebugLine();
+    DebugSerial->println(F("RADIO LINK STATISTICS"));
+    PrintDebugLine();
+    DebugSerial->print(F("Uplink RSSI:      -")); DebugSerial->print(ls.UplinkRSSI1); DebugSerial->print(F(" / -")); DebugSerial->print(ls.UplinkRSSI2); DebugSerial->print(F(" dBm (antenna ")); DebugSerial->print(ls.ActiveAntenna + 1); DebugSerial->println(F(" active)"));
+    DebugSerial->print(F("Uplink LQ:        ")); DebugSerial->print(ls.UplinkLQ); DebugSerial->print(F("%  SNR ")); DebugSerial->print(ls.UplinkSNR); DebugSerial->println(F(" dB"));
+    DebugSerial->print(F("Downlink RSSI:    -")); DebugSerial->print(ls.DownlinkRSSI); DebugSerial->println(F(" dBm"));
+    DebugSerial->print(F("Downlink LQ:      ")); DebugSerial->print(ls.DownlinkLQ); DebugSerial->print(F("%  SNR ")); DebugSerial->print(ls.DownlinkSNR); DebugSerial->println(F(" dB"));
+    DebugSerial->print(F("RF mode:          ")); DebugSerial->print(ls.RFMode); DebugSerial->print(F("  TX power: ")); DebugSerial->println(ls.UplinkTXPower);
+}
+
 void DumpMotorInfo()
 {
     DebugSerial->println();
@@ -228,6 +296,7 @@ void DumpMotorInfo()
         DebugSerial->print(F(" (Current Limit: "));
         DebugSerial->print(eeprom.ramcopy.ScoutCurrentLimit);
         DebugSerial->print(F(" Amps)"));
+        if (eeprom.ramcopy.ScoutTelemetry) DebugSerial->print(F(" (Telemetry On)"));
     }
     DebugSerial->println();
     DebugSerial->print(F("Turret Rotation:   ")); DebugSerial->print(ptrDriveType(eeprom.ramcopy.TurretRotationMotor)); 
@@ -585,6 +654,21 @@ void DumpVoltage()
         DebugSerial->print(F("Voltage:          "));
         DebugSerial->print(ReadVoltage(),2);
         DebugSerial->println(F("v"));
+        if (Battery.isPresent())
+        {
+            DebugSerial->print(F("Resting Voltage:  "));
+            DebugSerial->print((float)Battery.restingVoltage_mV() / 1000.0, 2);
+            DebugSerial->print(F("v ("));
+            DebugSerial->print(Battery.cells());
+            if (Battery.type() == BATTERY_NIMH) DebugSerial->println(F(" NiMH cells)"));
+            else                                DebugSerial->println(F(" LiPo cells)"));
+            DebugSerial->print(F("Charge:           "));
+            DebugSerial->print(Battery.stateOfCharge());
+            DebugSerial->println(F("%"));
+            DebugSerial->print(F("Runtime:          "));
+            if (Battery.runtimeMinutes() == BATTERY_RUNTIME_UNKNOWN) DebugSerial->println(F("Unknown"));
+            else { DebugSerial->print(Battery.runtimeMinutes()); DebugSerial->println(F(" min")); }
+        }
     }
     DebugSerial->print(F("LVC Enabled:      "));
     PrintYesNo(eeprom.ramcopy.LVC_Enabled);
@@ -1,4 +1,4 @@
-/* OP_LedHandler.cpp    Open Panzer Led Handler - class for handling LEDs including blink effects, requires use of elapsedMillis
+/* OP_LedHandler.cpp    Open Panzer Led Handler - class for handling LEDs including blink, fade and other effects
  * Source:              openpanzer.org              
  * Authors:             Luke Middleton
  *   
@@ -20,21 +20,32 @@
 
 #include "LedHandler.h"
 
+// Static variables must be declared outside the class
+LedHandler *    LedHandler::_handlers[LED_MAX_HANDLERS];
+uint8_t         LedHandler::_numHandlers = 0;
+uint16_t        LedHandler::_tick = 0;
 
-void LedHandler::begin(byte p, boolean i /*=false*/)
+
+boolean LedHandler::begin(byte p, boolean i /*=false*/)
 {
+    uint8_t n;
+    
     _pin = p;                   // Save pin number
     _invert = i;                // Save invert status
     pinMode(_pin, OUTPUT);      // Set pin to OUTPUT
+    ClearEffect();              // Initialize
     this->pinOff();             // Start with Led off
-    _isBlinking = false;        // Initialize
-    _curStep = 0;               //
+
+    // Register with the shared tick, unless we already have been
+    for (n=0; n<_numHandlers; n++) { if (_handlers[n] == this) return true; }
+    if (_numHandlers >= LED_MAX_HANDLERS) return false;     // No room, on/off still work but blinks and fades will never advance
+    _handlers[_numHandlers++] = this;
+    return true;
 }
 
 void LedHandler::on(void)
 {
-    if (_isBlinking) this->stopBlinking();
-    if (_isFading)   this->stopFading();
+    ClearEffect();
     this->pinOn();
 }
 
@@ -46,29 +57,47 @@ boolean LedHandler::isOn(void)
 
 void LedHandler::off(void)
 {
-    if (_isBlinking) this->stopBlinking();
-    if (_isFading)   this->stopFading();
+    ClearEffect();
     this->pinOff();
 }
 
 void LedHandler::pinOn(void)
 {
     _invert ? digitalWrite(_pin, LOW) : digitalWrite(_pin, HIGH);
+    _level = 255;
 }
 
 void LedHandler::pinOff(void)
 {
     _invert ? digitalWrite(_pin, HIGH) : digitalWrite(_pin, LOW);
+    _level = 0;
+}
+
+void LedHandler::setLevel(uint8_t level)
+{
+    if      (level == 0)   this->pinOff();
+    else if (level == 255) this->pinOn();
+    else    
+    {
+        analogWrite(_pin, _invert ? 255 - level : level);
+        _level = level;
+    }
 }
 
 void LedHandler::toggle(void)
 {
     digitalWrite(_pin, !digitalRead(_pin)); 
+    _level = this->isOn() ? 255 : 0;
 }
     
 boolean LedHandler::isBlinking(void)
 {
-    return _isBlinking; 
+    return (_effect != LED_EFFECT_NONE && !_fading); 
+}
+
+boolean LedHandler::isFading(void)
+{
+    return (_effect != LED_EFFECT_NONE && _fading);
 }
 
 void LedHandler::Blink(uint16_t interval /*=DEFAULT_BLINK_INTERVAL*/)
@@ -78,19 +107,19 @@ void LedHandler::Blink(uint16_t interval /*=DEFAULT_BLINK_INTERVAL*/)
 
 void LedHandler::Blink(uint8_t times, uint16_t interval /*=DEFAULT_BLINK_INTERVAL*/)
 {
-    ClearBlinker();
-    _fixedInterval = true;
-    _nextWait = interval;
+    if (times == 0) return;             // Nothing to blink, and (0 * 2) - 1 would be a very long stream
+    ClearEffect();
+    _effect = LED_EFFECT_STREAM;
+    _fixedInterval = interval;
     _numSteps = (times * 2) - 1;        // multiply by two and minus one to add spaces between the blinks where the LED is off
-    this->pinOn();                      // Start with the Led on. User needs to call the update() function to update the next steps 
-    _time = 0;
-    _isBlinking = true;
+    _stepStart = millis();
+    this->loadStep();                   // Start with the Led on. updateAll() takes care of the next steps
 }
 
 void LedHandler::stopBlinking(void)
 {
     this->pinOff();
-    ClearBlinker();
+    ClearEffect();
 }
 
 void LedHandler::startBlinking(uint16_t on_interval, uint16_t off_interval)
@@ -104,242 +133,178 @@ void LedHandler::startBlinking(uint16_t on_interval, uint16_t off_interval)
 
 void LedHandler::DoubleTap(boolean repeat /*=false*/)
 {
-    BlinkStream bs;
-    bs.interval[0] = 50;                // On
-    bs.interval[1] = 40;                // Off
-    bs.interval[2] = 110;               // On
-    bs.interval[3] = 500;               // Off
-    bs.repeat = repeat;
-    this->StreamBlink(bs, 4);           // 4 steps in the double-tap
+    this->Play(LED_PROG_DOUBLETAP, repeat);
 }
 
 void LedHandler::TripleTap(boolean repeat /*=false*/)
 {
-    BlinkStream bs;
-    bs.interval[0] = 120;               // On
-    bs.interval[1] = 180;               // Off
-    bs.interval[2] = 120;               // On
-    bs.interval[3] = 160;               // Off
-    bs.interval[4] = 200;               // On
-    bs.interval[5] = 600;               // Off
-    bs.repeat = repeat;
-    this->StreamBlink(bs, 6);           // 6 steps in the triple-tap
+    this->Play(LED_PROG_TRIPLETAP, repeat);
+}
+
+void LedHandler::QuadTap(boolean repeat /*=false*/)
+{
+    this->Play(LED_PROG_QUADTAP, repeat);
 }
 
 void LedHandler::StreamBlink(BlinkStream bs, uint8_t numSteps)
 {
-    ClearBlinker();
-    _fixedInterval = false;
+    ClearEffect();
+    _effect = LED_EFFECT_STREAM;
+    _fixedInterval = 0;
     _blinkStream = bs;
-    _nextWait = _blinkStream.interval[0];
+    _repeat = bs.repeat;
     if (numSteps > MAX_STREAM_STEPS) numSteps = MAX_STREAM_STEPS; 
     _numSteps = numSteps; 
-    this->pinOn();                     // Start with the Led on. User needs to call the update() function to update the next steps 
-    _time = 0; 
-    _isBlinking = true;
+    _stepStart = millis();
+    this->loadStep();                   // Start with the Led on. updateAll() takes care of the next steps 
 }
 
-void LedHandler::ClearBlinker(void)
+void LedHandler::Play(uint8_t program, boolean repeat /*=false*/, uint16_t span /*=0*/)
+{
+    if (program >= LED_NUM_PROGRAMS) return;
+    
+    ClearEffect();
+    _effect = LED_EFFECT_PROGRAM;
+    _program = program;
+    _numSteps = LedProgramCount(program);
+    _repeat = repeat;
+    _span = span;
+    _stepStart = millis();
+    this->loadStep();
+}
+
+void LedHandler::ClearEffect(void)
 {
     // This will stop any active effects
+    _effect = LED_EFFECT_NONE;
     _curStep = 0;
     _numSteps = 0;
-    _nextWait = 0;
-    _time = 0;
+    _stepTime = 0;
     _expireTime = 0;
-    _isBlinking = false; 
+    _repeat = false;
+    _fading = false;
+    _ramping = false;
 }
 
 void LedHandler::ExpireIn(uint16_t expireTime)
 {
     _expireTime = expireTime;
-    _expireMe = 0;
+    _expireStart = millis();
 }
 
 
 // Will fade a LED in or out (use FADE_IN or FADE_OUT for dir)
-// Span is in milliseconds and is the length of time the fade will take,
-// with a minimum of 1/4 second (span = 250 mS) and a maximum of 65 seconds (span = ~65,000)
+// Span is in milliseconds and is the length of time the fade will take, with a maximum of about 65 seconds. If addBlinkEffect is true
+// a fade-in will be followed by a double-tap, and a fade-out will be preceded by a double-blip. 
 void LedHandler::Fade(uint8_t dir, uint16_t span, boolean addBlinkEffect)
 {
-    // See: https://www.sparkfun.com/tutorials/329
-    // Full brightness = 90  degress = 1.570 radians (pi * 0.5)
-    // Half brightness = 180 degrees = 3.141 radians (pi * 1  )
-    // Off             = 270 degrees = 4.712 radians (pi * 1.5)
-
-    // Start clear
-    ClearFader();
-    
-    // Set the blink effect flag, which will add two blinks after the fade-in or before the fade-out
-    _fadeBlinkEffect = addBlinkEffect; 
-
-    // Determine delay between updates
-    _numSteps = NUM_FADE_UPDATES;           // See LedHandler.h
-    if (span < _numSteps) span = _numSteps; // Don't allow fades shorter than the number of updates, it would just result in 1 mS or 0 mS updates
-    _fadeInterval = span / _numSteps;       // Interval between each fade update
-    _nextWait = _fadeInterval;
-
-    // The _isFading flag will tell us more than that we are fading, but also in which direction. 
-    _isFading = dir;
-
-    // If dir = 1 then fade in starting from off, otherwise if dir = 2 fade out starting from on
     if (dir != FADE_IN && dir != FADE_OUT) dir = FADE_IN;   // Constrain
-    switch (dir)
-    {
-        case FADE_IN:
-            this->pinOff(); 
-            _invert ? _fadeStart = 1.57  : _fadeStart = 4.712;
-            break; 
-            
-        case FADE_OUT:
-            _invert ? _fadeStart = 4.712 : _fadeStart = 1.57;
-            this->pinOn();
-            if (_fadeBlinkEffect)
-            {
-                // We need to start with a double-blip, and then after complete the fade-out
-                _isFading = 0;  // Pretend like we're not fading, the _fadeBlinkEffect flag will save us later
-                BlinkStream bs;
-                bs.interval[0] = 110;      // On
-                bs.interval[1] = 40;       // Off
-                bs.interval[2] = 60;       // On
-                bs.repeat = false;
-                this->StreamBlink(bs, 3);   
-                return;
-            }
-            break;
-    }
-
-    // Reset the ellapsedMillis time
-    _time = 0;
+    if (span == LED_SPAN) span -= 1;                        // Don't let the span be confused with the placeholder
+    
+    if (dir == FADE_IN) this->Play(addBlinkEffect ? LED_PROG_FADEIN_BLIP  : LED_PROG_FADEIN,  false, span);
+    else                this->Play(addBlinkEffect ? LED_PROG_BLIP_FADEOUT : LED_PROG_FADEOUT, false, span);
+    _fading = true;
 }
 
 void LedHandler::stopFading(void)
 {
-    ClearFader();
-}
-
-void LedHandler::ClearFader(void)
-{
-    _expireTime = 0;
-    _curStep = 0;
-    _numSteps = 0;
-    _nextWait = 0;
-    _time = 0;
-    _fadeBlinkEffect = false;
-    _isFading = 0;    
+    ClearEffect();
 }
 
-boolean LedHandler::isFading(void)
+void LedHandler::loadStep(void)
 {
-    if (_isFading > 0) return true;
-    else               return false;
+    uint8_t level; 
+    uint8_t s;
+    boolean ramp = false;
+    
+    if (_effect == LED_EFFECT_STREAM)
+    {   // Even steps are on, odd steps are off
+        level = (_curStep & 1) ? 0 : 255;
+        _stepTime = _fixedInterval ? _fixedInterval : _blinkStream.interval[_curStep];
+    }
+    else
+    {
+        s = LedProgramFirst(_program) + _curStep;
+        _stepTime = LedStepTime(s);
+        if (_stepTime == LED_SPAN) _stepTime = _span;
+        level = LedStepLevel(s);
+        ramp = LedStepRamp(s);
+    }
+    
+    if (ramp && _stepTime > 0)
+    {   // advance() will move us along the curve
+        _fromLevel = _level;
+        _toLevel = level;
+        _ramping = true;
+    }
+    else
+    {
+        _ramping = false;
+        if (level != _level) this->setLevel(level);
+    }
 }
 
-void LedHandler::update(void)
+void LedHandler::advance(void)
 {
-    if (_isFading > 0)  // We're in the middle of a fading operation
+    uint16_t elapsed;
+    uint16_t pos;
+    uint8_t  idx, c, level;
+    
+    if (_effect == LED_EFFECT_NONE) return;
+    
+    if (_expireTime > 0 && (uint16_t)(_tick - _expireStart) > _expireTime)
+    {
+        // The user only wanted this effect to be active for a set length of time, which is now expired. Stop.
+        this->pinOff();
+        ClearEffect();
+        return;
+    }
+    
+    // Move past any steps that are finished. Zero length steps pass instantly, but we never go through more than the length of the effect
+    // in one pass so a repeating effect made only of zero length steps can't hang us here. 
+    for (uint16_t i=0; i<=_numSteps; i++)
     {
-        if (_nextWait > 0 && _time > _nextWait)
+        elapsed = _tick - _stepStart;
+        if (elapsed < _stepTime) break;
+        
+        if (_ramping && _level != _toLevel) this->setLevel(_toLevel);     // Make sure a ramp lands exactly where it was going
+        _stepStart += _stepTime;
+        
+        if (++_curStep >= _numSteps)
         {
-            _curStep += 1; 
-            if (_curStep < _numSteps)
-            {
-                _fadeStart = _fadeStart + (PI / (float)_numSteps);
-                analogWrite(_pin, (sin(_fadeStart) * 127.5) + 127.5);  
-                _time = 0;
-            }
+            if (_repeat) _curStep = 0;
             else
-            {
-                // We're done
-                switch (_isFading)
-                {
-                    // Fading-out ends with off
-                    case FADE_OUT: 
-                        this->pinOff(); 
-                        this->ClearFader(); 
-                        break;   
-                    
-                    // Fading-in ends with on
-                    case FADE_IN:  
-                    default:
-                        if (_fadeBlinkEffect)   
-                        {   // We want to add two blips to close-out
-                            this->ClearFader();         // Clear out the fader, we have to do this after the _fadeBlinkEffect check
-                            BlinkStream bs;
-                            bs.interval[0] = 50;        // On
-                            bs.interval[1] = 40;        // Off
-                            bs.interval[2] = 110;       // On
-                            bs.interval[3] = 500;       // Off
-                            bs.repeat = false;
-                            this->StreamBlink(bs, 4);   // 4 steps in the double-tap
-                        }
-                        else this->ClearFader();
-                        break;                        
-                }
+            {   // We're done. Blink streams always end with the LED off, programs are left where their last step put them. 
+                if (_effect == LED_EFFECT_STREAM) this->pinOff();
+                ClearEffect();
+                return;
             }
         }
+        this->loadStep();
     }
-    else    // If we're not fading, we're blinking
+    
+    if (_ramping)
     {
-        if (_expireTime > 0 && _expireMe > _expireTime)
-        {
-            // The user only wanted this blinker to be active for a set length of time, which is now expired. Stop blinking.
-            this->pinOff();
-            ClearBlinker();
-            ClearFader();
-        }
-        else 
-        {
-            if (_nextWait > 0 && _time > _nextWait)
-            {
-                _curStep += 1; 
-                if (_curStep < _numSteps)
-                {
-                    // If we are not fading we are either turning the LED on or off
-                    if (_curStep & 1) { this->pinOff(); }  // Odd numbers get turned off
-                    else              { this->pinOn();  }  // Even numbers get turned on
+        // Position along the curve in 8.8 fixed point. Ramping down runs the curve backwards so the fade still looks even. 
+        pos = ((uint32_t)(_tick - _stepStart) * (LED_CURVE_STEPS << 8)) / _stepTime;
+        if (_toLevel < _fromLevel) pos = (LED_CURVE_STEPS << 8) - pos;
+        idx = pos >> 8;
+        if (idx >= LED_CURVE_STEPS) c = GetLedCurve(LED_CURVE_STEPS);
+        else                        c = GetLedCurve(idx) + (((uint16_t)(GetLedCurve(idx + 1) - GetLedCurve(idx)) * (pos & 0xFF)) >> 8);
         
-                    // Calculate time to next change
-                    if (!_fixedInterval)
-                    {
-                        if   (_curStep > MAX_STREAM_STEPS) { this->pinOff(); ClearBlinker(); }    // This shouldn't happen, but if it does, stop the blinker
-                        else { _nextWait = _blinkStream.interval[_curStep]; _time = 0;   }        // Otherwise reset the time and wait for the next interval
-                    }
-                    else
-                    {
-                        _time = 0;  // In this case we just leave the next interval to what it was before (it's a fixed interval). But we do need to reset the time
-                    }
-                }
-                else
-                {
-                    // We're done
-                    if (_blinkStream.repeat) 
-                    {   // Start over
-                        _nextWait = _blinkStream.interval[0];
-                        _curStep = 0;
-                        this->pinOn();
-                        _time = 0;
-                    }
-                    else if (_fadeBlinkEffect)
-                    {
-                        // In this case we want to start a fade-out after the blink portion is done
-                        _fadeBlinkEffect = false;       // Clear this flag
-                        _isFading = FADE_OUT;           // Set the fadeout flag
-                        ClearBlinker();                 // Clear out the blinker
-                        _numSteps = NUM_FADE_UPDATES;   // Setup the fade-out (some of it was already set up in the original Fade call
-                        _nextWait = _fadeInterval;
-                    }
-                    else
-                    {   
-                        // Turn off lights and wrapup
-                        this->pinOff(); 
-                        ClearBlinker();
-                    }
-                }    
-            }
-        }
+        if (_toLevel >= _fromLevel) level = _fromLevel + (((uint16_t)(_toLevel - _fromLevel) * c) / 255);
+        else                        level = _toLevel   + (((uint16_t)(_fromLevel - _toLevel) * c) / 255);
+        
+        if (level != _level) this->setLevel(level);
     }
 }
 
-
-
+void LedHandler::updateAll(void)
+{
+    // One pass over every LED on a shared tick. LEDs with no effect running return straight away. 
+    uint16_t now = millis();
+    if ((uint16_t)(now - _tick) < LED_UPDATE_mS) return;
+    _tick = now;
+    
+    for (uint8_t i=0; i<_numHandlers; i++) _handlers[i]->advance();
+}
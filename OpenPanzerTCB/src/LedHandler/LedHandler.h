@@ -1,4 +1,4 @@
-/* OP_LedHandler.h      Open Panzer Led Handler - class for handling LEDs including blink effects, requires use of elapsedMillis
+/* OP_LedHandler.h      Open Panzer Led Handler - class for handling LEDs including blink, fade and other effects
  * Source:              openpanzer.org              
  * Authors:             Luke Middleton
  *   
@@ -22,33 +22,138 @@
 
 #include <Arduino.h>
 #include "../OP_Settings/OP_Settings.h"
-#include "../elapsedMillis/elapsedMillis.h"
 
 #define FADE_IN                            1
 #define FADE_OUT                           2
-#define NUM_FADE_UPDATES                 100
 
 #define DEFAULT_BLINK_INTERVAL           200
-#define MAX_STREAM_STEPS                  10            // A stream consists of a pattern of on/off blinks separated by user-specified lengths of time. A single blink (on/off) takes 2 steps. 
+#define MAX_STREAM_STEPS                  10            // A stream consists of a pattern of on/off blinks separated by user-specified lengths of time. A single blink (on/off) takes 2 steps.
 typedef struct                                          // This struct holds an array of blink patterns, and a flag to indicate if it should repeat or not
 {
     uint16_t        interval[MAX_STREAM_STEPS];
     boolean         repeat;
 } BlinkStream;
 
+#define LED_UPDATE_mS                      2            // All LedHandler objects are advanced together from a single shared tick, see LedHandler::updateAll()
+#define LED_MAX_HANDLERS                   6            // How many LedHandler objects can be registered with the shared tick. The TCB uses 3 (IO A/B and the Apple LEDs), the sketch checks this at compile time.
+
+
+// LED CURVE
+// -------------------------------------------------------------------------------------------------------------------------------------------->>
+// Ramps follow an eased sine curve (the same shape the old sin() fade produced) that has also been gamma corrected (2.2) so the change in
+// brightness looks even to the eye. The table runs from off (0) to full (64), positions in between are interpolated.
+#define LED_CURVE_STEPS                   64
+const uint8_t LedCurve[LED_CURVE_STEPS + 1] PROGMEM_FAR =
+{   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   2,   2,   3,
+    4,   5,   6,   8,   9,  11,  14,  16,  19,  22,  26,  30,  34,  39,  44,  50,
+   55,  62,  68,  75,  82,  90,  97, 105, 113, 121, 130, 138, 147, 155, 164, 172,
+  180, 188, 196, 203, 210, 217, 223, 229, 234, 239, 243, 247, 250, 252, 254, 255,
+  255 };
+#define GetLedCurve(i)      pgm_read_byte_far(pgm_get_far_address(LedCurve) + (i))
+
+
+// LED PROGRAMS
+// -------------------------------------------------------------------------------------------------------------------------------------------->>
+// An effect program is a list of steps. Each step sets the LED to a level (0-255) and lasts Time_mS. If Ramp is set the LED travels along the
+// curve above from its prior level to the new one over the length of the step, otherwise it jumps there at the start of the step.
+// When a program finishes the LED is left at the level of its last step (unless it was told to repeat).
+// A time of LED_SPAN means "use the span passed to Play()", this lets one program serve fades of any length.
+// New effects can be added by appending steps to LedSteps and a line to LedPrograms - no changes to the code are needed.
+#define LED_SPAN                      0xFFFF
+typedef struct {
+    uint16_t Time_mS;       // Length of the step
+    uint8_t  Level;         // Level to set or ramp to
+    uint8_t  Ramp;          // 1 to ramp, 0 to jump
+} LedStep;
+
+#define LED_NUM_STEPS                     32
+const LedStep LedSteps[LED_NUM_STEPS] PROGMEM_FAR = {
+// Double-tap - 0
+{50,       255, 0},     // 0    On
+{40,         0, 0},     // 1    Off
+{110,      255, 0},     // 2    On
+{500,        0, 0},     // 3    Off
+// Triple-tap - 4
+{120,      255, 0},     // 4    On
+{180,        0, 0},     // 5    Off
+{120,      255, 0},     // 6    On
+{160,        0, 0},     // 7    Off
+{200,      255, 0},     // 8    On
+{600,        0, 0},     // 9    Off
+// Quad-tap - 10
+{60,       255, 0},     // 10   On
+{60,         0, 0},     // 11   Off
+{60,       255, 0},     // 12   On
+{60,         0, 0},     // 13   Off
+{60,       255, 0},     // 14   On
+{60,         0, 0},     // 15   Off
+{110,      255, 0},     // 16   On
+{500,        0, 0},     // 17   Off
+// Fade in - 18
+{LED_SPAN, 255, 1},     // 18
+// Fade in, then double-tap - 19
+{LED_SPAN, 255, 1},     // 19
+{50,       255, 0},     // 20   On
+{40,         0, 0},     // 21   Off
+{110,      255, 0},     // 22   On
+{500,        0, 0},     // 23   Off
+// Fade out - 24
+{0,        255, 0},     // 24   Start from full on
+{LED_SPAN,   0, 1},     // 25
+// Double-blip, then fade out - 26
+{110,      255, 0},     // 26   On
+{40,         0, 0},     // 27   Off
+{60,       255, 0},     // 28   On
+{LED_SPAN,   0, 1},     // 29
+// Breathe - 30
+{LED_SPAN, 255, 1},     // 30   Up
+{LED_SPAN,   0, 1}      // 31   Down
+};
+#define LedStepTime(s)      pgm_read_word_far(pgm_get_far_address(LedSteps) + ((s)*4))
+#define LedStepLevel(s)     pgm_read_byte_far(pgm_get_far_address(LedSteps) + ((s)*4) + 2)
+#define LedStepRamp(s)      pgm_read_byte_far(pgm_get_far_address(LedSteps) + ((s)*4) + 3)
+
+// Where each program lives in LedSteps
+#define LED_PROG_DOUBLETAP                 0
+#define LED_PROG_TRIPLETAP                 1
+#define LED_PROG_QUADTAP                   2
+#define LED_PROG_FADEIN                    3
+#define LED_PROG_FADEIN_BLIP               4
+#define LED_PROG_FADEOUT                   5
+#define LED_PROG_BLIP_FADEOUT              6
+#define LED_PROG_BREATHE                   7
+#define LED_NUM_PROGRAMS                   8
+typedef struct {
+    uint8_t First;          // First step
+    uint8_t Count;          // Number of steps
+} LedProgram;
+const LedProgram LedPrograms[LED_NUM_PROGRAMS] PROGMEM_FAR = {
+{0,  4},                // Double-tap
+{4,  6},                // Triple-tap
+{10, 8},                // Quad-tap
+{18, 1},                // Fade in
+{19, 5},                // Fade in, then double-tap
+{24, 2},                // Fade out
+{26, 4},                // Double-blip, then fade out
+{30, 2}                 // Breathe
+};
+#define LedProgramFirst(p)  pgm_read_byte_far(pgm_get_far_address(LedPrograms) + ((p)*2))
+#define LedProgramCount(p)  pgm_read_byte_far(pgm_get_far_address(LedPrograms) + ((p)*2) + 1)
+
+
 class LedHandler
 {   public:
-        LedHandler() {}; 
-        
-        void begin (byte p, boolean i=false); 
+        LedHandler() {};
+
+        boolean begin (byte p, boolean i=false);                               // Returns false if the shared tick is full (LED_MAX_HANDLERS), the pin still works but effects won't run
         void on(void);
         boolean isOn(void);
         void off(void);
         void toggle(void);
-        void update(void);                                                      // Update blinking effect
+        static void updateAll(void);                                            // Advance every LED from the shared tick (replaces the per-object update). The sketch should call this every loop
         boolean isBlinking(void);
         boolean isFading(void);
-        void ExpireIn(uint16_t); 
+        void ExpireIn(uint16_t);
         void Blink(uint16_t interval=DEFAULT_BLINK_INTERVAL);                   // Blinks once at set interval
         void Blink(uint8_t times, uint16_t  interval=DEFAULT_BLINK_INTERVAL);   // Overload - Blinks N times at set interval
         void startBlinking(uint16_t on_interval=DEFAULT_BLINK_INTERVAL, uint16_t off_interval=DEFAULT_BLINK_INTERVAL);   // Starts a continuous blink at the set intervals, to stop call stopBlinking() or Off()
@@ -59,29 +164,40 @@ class LedHandler
         void StreamBlink(BlinkStream bs, uint8_t numSteps);
         void Fade(uint8_t fade_in, uint16_t span, boolean AddBlinkEffect);
         void stopFading(void);
-        
+        void Play(uint8_t program, boolean repeat=false, uint16_t span=0);     // Run one of the LedPrograms, span is used for any steps with a time of LED_SPAN
+
     private:
-        void ClearBlinker(void);
-        void ClearFader(void);
+        typedef enum { LED_EFFECT_NONE = 0, LED_EFFECT_STREAM, LED_EFFECT_PROGRAM } led_effect_t;
+        static LedHandler * _handlers[LED_MAX_HANDLERS];                        // Every LedHandler that has been begun
+        static uint8_t      _numHandlers;
+        static uint16_t     _tick;                                              // Shared time (lower 16 bits of millis) of the last pass
+
+        void ClearEffect(void);
+        void loadStep(void);
+        void advance(void);
+        void setLevel(uint8_t level);
         void pinOn(void);
         void pinOff(void);
-        elapsedMillis   _time;
-        elapsedMillis   _expireMe;
-        uint16_t        _expireTime; 
         byte            _pin;
         boolean         _invert;
-        boolean         _isBlinking;
-        uint8_t         _isFading;
+        led_effect_t    _effect;
+        boolean         _repeat;
+        boolean         _fading;
+        uint8_t         _program;                                               // For LED_EFFECT_PROGRAM - which program
         uint16_t        _curStep;
-        uint16_t        _numSteps;
-        uint16_t        _nextWait;
-        boolean         _fixedInterval;
+        uint16_t        _numSteps;                                              // Blink(255) takes 509
+        uint8_t         _level;                                                 // Present output level 0-255
+        uint8_t         _fromLevel;                                             // Level at the start of a ramp
+        uint8_t         _toLevel;                                               // Level at the end of a ramp
+        boolean         _ramping;
+        uint16_t        _span;                                                  // Substituted for LED_SPAN step times
+        uint16_t        _stepTime;                                              // Length of the current step
+        uint16_t        _stepStart;                                             // Shared tick when the current step began
+        uint16_t        _expireTime;
+        uint16_t        _expireStart;
+        uint16_t        _fixedInterval;                                         // For LED_EFFECT_STREAM - if non-zero, every step lasts this long and _blinkStream is ignored
         BlinkStream     _blinkStream;
-        float           _fadeStart;
-        boolean         _fadeBlinkEffect;
-        uint16_t        _fadeInterval;
-     
 };
 
 
-#endif 
+#endif
@@ -0,0 +1,121 @@
+/* OP_ADC.cpp       Open Panzer ADC - background sampling of the analog inputs (battery voltage and IO ports)
+ * Source:          openpanzer.org              
+ * Authors:         Luke Middleton
+ *   
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */ 
+ 
+#include "OP_ADC.h"
+
+uint8_t                 OP_ADC::NumChannels = 0;
+uint8_t                 OP_ADC::Mux[ADC_MAX_CHANNELS];
+uint8_t                 OP_ADC::Shift[ADC_MAX_CHANNELS];
+volatile uint32_t       OP_ADC::Filtered[ADC_MAX_CHANNELS];
+volatile uint8_t        OP_ADC::Seeded = 0;
+volatile uint8_t        OP_ADC::Current = 0;
+volatile boolean        OP_ADC::Busy = false;
+uint32_t                OP_ADC::LastRound_mS = 0;
+
+
+uint8_t OP_ADC::addChannel(uint8_t pin, uint8_t filterShift)
+{
+    if (NumChannels >= ADC_MAX_CHANNELS) return ADC_NO_CHANNEL;
+    
+    if (pin >= A0) pin -= A0;                           // Convert the Arduino pin number to an ADC mux channel, same as analogRead does
+    if (filterShift > ADC_FRAC_BITS) filterShift = ADC_FRAC_BITS;
+    
+    Mux[NumChannels] = pin;
+    Shift[NumChannels] = filterShift;
+    Filtered[NumChannels] = 0;
+    return NumChannels++;
+}
+
+void OP_ADC::begin(void)
+{
+    // The Arduino core has already enabled the ADC and set the prescaler (128, 125kHz ADC clock). We only take over the interrupt.
+    // Run one round now and wait for it, so nobody reads a channel before it has a value. 
+    if (NumChannels == 0) return;
+    startRound();
+    while (Busy) ;
+}
+
+void OP_ADC::update(void)
+{
+    if (!Busy && NumChannels > 0 && (millis() - LastRound_mS >= ADC_ROUND_mS)) startRound();
+}
+
+void OP_ADC::startRound(void)
+{
+    LastRound_mS = millis();
+    Busy = true;
+    Current = 0;
+    selectChannel(0);
+    ADCSRA |= (1 << ADIF) | (1 << ADIE) | (1 << ADSC);  // Clear any stale flag (written as 1), enable the interrupt and start the first conversion
+}
+
+void OP_ADC::selectChannel(uint8_t channel)
+{
+    // Channels 8-15 (A8-A15) need the MUX5 bit in ADCSRB. Reference is AVcc, same as the Arduino DEFAULT. 
+    if (Mux[channel] & 0x08) ADCSRB |=  (1 << MUX5);
+    else                     ADCSRB &= ~(1 << MUX5);
+    ADMUX = (1 << REFS0) | (Mux[channel] & 0x07);
+}
+
+uint16_t OP_ADC::read(uint8_t channel)
+{
+    uint32_t f;
+    
+    if (channel >= NumChannels) return 0;
+    
+    uint8_t sreg = SREG;                                // Save interrupt register
+    cli();                                              // Disable interrupts, a 32 bit read isn't atomic
+    f = Filtered[channel];
+    SREG = sreg;                                        // Restore register
+    
+    return (f + (1UL << (ADC_FRAC_BITS - 1))) >> ADC_FRAC_BITS;     // Round to the nearest whole count
+}
+
+uint16_t OP_ADC::readBlocking(uint8_t pin)
+{
+    // Wait for any round to finish. The interrupt is only enabled during a round, so analogRead will work normally after. 
+    while (Busy) ;
+    return analogRead(pin);
+}
+
+ISR(ADC_vect)
+{
+    OP_ADC::ADC_ISR();
+}
+
+void OP_ADC::ADC_ISR(void)
+{
+    uint32_t sample = (uint32_t)ADC << ADC_FRAC_BITS;
+    uint8_t c = Current; 
+    
+    if (Seeded & (1 << c)) Filtered[c] = Filtered[c] - (Filtered[c] >> Shift[c]) + (sample >> Shift[c]);
+    else                 { Filtered[c] = sample; Seeded |= (1 << c); }  // First reading starts the filter off at the right place
+    
+    if (++c < NumChannels)
+    {
+        Current = c;
+        selectChannel(c);
+        ADCSRA |= (1 << ADSC);                          // Start the next conversion
+    }
+    else
+    {
+        ADCSRA &= ~(1 << ADIE);                         // Round is done, leave the ADC free until the next one
+        Busy = false;
+    }
+}
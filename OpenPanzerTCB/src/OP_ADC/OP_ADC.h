@@ -0,0 +1,74 @@
+/* OP_ADC.h         Open Panzer ADC - background sampling of the analog inputs (battery voltage and IO ports)
+ * Source:          openpanzer.org              
+ * Authors:         Luke Middleton
+ *
+ * Every ADC_ROUND_mS the sketch's call to update() starts a round of conversions. Each channel is converted in turn, and the ADC interrupt 
+ * stores the result, runs it through that channel's low-pass filter, and starts the conversion of the next channel. When the last channel is 
+ * done the round ends and the ADC sits idle until the next one. Nothing waits on the ADC, and reading a channel just returns the latest filtered value. 
+ *
+ * The filter is an integer IIR: filtered = filtered - filtered/2^k + sample/2^k, where k is the filter shift given for the channel. 
+ * A shift of 0 means no filtering at all. Values are kept with 16 fractional bits so that heavy filtering doesn't lose resolution. 
+ * The time constant of the filter is roughly 2^k * ADC_ROUND_mS. 
+ *   
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */ 
+
+#ifndef OP_ADC_H
+#define OP_ADC_H
+
+#include <Arduino.h>
+#include <inttypes.h>
+#include <avr/interrupt.h>
+#include "../OP_Settings/OP_Settings.h"
+
+
+#define ADC_MAX_CHANNELS        4                       // Battery voltage, IO A, IO B, and one spare
+#define ADC_NO_CHANNEL          0xFF                    // Returned by addChannel if there is no room
+#define ADC_ROUND_mS            4                       // How often to sample all channels. Each conversion takes about 110 uS, but none of that time is spent waiting. 
+#define ADC_FRAC_BITS           16                      // Fractional bits kept by the filter
+
+// Filter shifts. With a round every 4 mS these give time constants of about 64 mS (battery), 16 mS (analog IO) and none (digital IO).
+// The battery filter only takes out noise, it has to stay quick enough that OP_Battery can see the voltage sag when the load changes. 
+// OP_Battery does the long-term smoothing itself. 
+#define ADC_FILTER_NONE         0
+#define ADC_FILTER_IO           2
+#define ADC_FILTER_BATTERY      4
+
+
+class OP_ADC
+{
+    public:
+        static uint8_t                  addChannel(uint8_t pin, uint8_t filterShift);  // Add an analog pin (A0-A15) to the round. Returns the channel number to use with read()
+        static void                     begin(void);                    // Take the first round of samples (waits for it to finish) so every channel has a value
+        static void                     update(void);                   // Call every loop, starts a new round when it is time
+        static uint16_t                 read(uint8_t channel);          // Latest filtered reading (0-1023) for a channel
+        static uint16_t                 readBlocking(uint8_t pin);      // Old-fashioned blocking analogRead of some pin that is not in the round, without upsetting the round
+        static void                     ADC_ISR(void);                  // The actual ISR will call this public member function, in order that it can access class variables
+
+    private:
+        static void                     startRound(void);
+        static void                     selectChannel(uint8_t channel);
+        static uint8_t                  NumChannels;
+        static uint8_t                  Mux[ADC_MAX_CHANNELS];          // ADC mux channel (0-15) for each of our channels
+        static uint8_t                  Shift[ADC_MAX_CHANNELS];        // Filter shift for each channel
+        static volatile uint32_t        Filtered[ADC_MAX_CHANNELS];     // Filtered readings, with ADC_FRAC_BITS fractional bits
+        static volatile uint8_t         Seeded;                         // Bit flags, set once a channel has its first sample
+        static volatile uint8_t         Current;                        // Channel being converted
+        static volatile boolean         Busy;                           // Is a round in progress
+        static uint32_t                 LastRound_mS;
+};
+
+
+#endif 
@@ -0,0 +1,180 @@
+/* OP_Battery.cpp       Open Panzer Battery - estimates resting voltage, state of charge and remaining runtime of the drive battery
+ * Source:              openpanzer.org
+ * Authors:             Luke Middleton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "OP_Battery.h"
+
+
+void OP_Battery::begin(uint16_t cutoff_mV, uint8_t type, uint8_t cells)
+{
+    _cutoff_mV = cutoff_mV;
+    _type = (type < BATTERY_TYPES) ? type : BATTERY_LIPO;
+    _setCells = cells;
+    _seeded = false;
+    _cells = 0;
+    _measured_x16 = 0;
+    _resting_x16 = 0;
+    _sag_x16 = (int32_t)BATTERY_DEFAULT_SAG_mV << 4;
+    _socTenths = 0;
+    _rate_x16 = 0;
+    _haveRate = false;
+    _low = false;
+    _lowEvent = false;
+}
+
+void OP_Battery::update(uint16_t measured_mV, uint8_t load, uint32_t now_mS)
+{
+int32_t rest_mV;
+
+    if (measured_mV < BATTERY_PRESENT_mV)
+    {   // No battery. If one gets plugged in later we start over from scratch
+        _seeded = false;
+        return;
+    }
+
+    if (!_seeded)
+    {   // First sample. Count the cells, and start every filter at the present value so we don't have to wait for them to settle.
+        if (_setCells > 0)              _cells = _setCells;
+        else if (_type == BATTERY_NIMH) _cells = (measured_mV + (BATTERY_NIMH_CELL_MID_mV / 2)) / BATTERY_NIMH_CELL_MID_mV;
+        else                            _cells = (measured_mV + BATTERY_LIPO_CELL_MAX_mV - 1) / BATTERY_LIPO_CELL_MAX_mV;
+        rest_mV = (int32_t)measured_mV + (((_sag_x16 >> 4) * load) / 255);
+        _measured_x16 = (int32_t)measured_mV << 4;
+        _resting_x16 = rest_mV << 4;
+        _seeded = true;
+        _sagSteps = 0;                              // It may not be the same pack, relearn the sag quickly
+        // A pack plugged in after another was unplugged starts its own discharge rate. The rate period has to be restarted before 
+        // updateCharge looks at it, or the old pack's period and rate would be folded in. 
+        _rateStart_mS = now_mS;
+        _rate_x16 = 0;
+        _haveRate = false;
+        updateCharge(now_mS);
+        _rateStartTenths = _socTenths;
+        _low = false;                               // Don't warn until the charge actually falls below the level
+        if (_socTenths < (BATTERY_LOW_PCT * 10)) _low = true;
+    }
+    else
+    {
+        // Learn the sag. If the load jumped since the last sample, almost all of the change in voltage is due to resistance, the charge can't
+        // have changed much in the meantime. Scale the change up to what it would be for a full (255) change in load.
+        int16_t dLoad = (int16_t)load - _lastLoad;
+        if ((dLoad >= BATTERY_LOAD_STEP || dLoad <= -BATTERY_LOAD_STEP) && (now_mS - _lastSample_mS) <= (2 * BATTERY_SAMPLE_mS))
+        {
+            int32_t sag = (((int32_t)_lastMeasured_mV - measured_mV) * 255) / dLoad;
+            if (sag >= 0 && sag <= BATTERY_MAX_SAG_mV)
+            {
+                // Until we have a filter's worth of steps, average them so the starting guess is gone after the first one. 
+                // A worn pack can sag three times the default, and at 1/8th a step that took minutes to learn. 
+                if (_sagSteps < (1 << BATTERY_SAG_SHIFT)) { _sagSteps++; _sag_x16 += ((sag << 4) - _sag_x16) / _sagSteps; }
+                else _sag_x16 += ((sag << 4) - _sag_x16) >> BATTERY_SAG_SHIFT;
+            }
+        }
+
+        // Add the sag for the present load back on to get the resting voltage, then filter it
+        rest_mV = (int32_t)measured_mV + (((_sag_x16 >> 4) * load) / 255);
+        _resting_x16 += ((rest_mV << 4) - _resting_x16) >> BATTERY_REST_SHIFT;
+        _measured_x16 += (((int32_t)measured_mV << 4) - _measured_x16) >> BATTERY_MEASURED_SHIFT;
+        updateCharge(now_mS);
+    }
+
+    _lastMeasured_mV = measured_mV;
+    _lastLoad = load;
+    _lastSample_mS = now_mS;
+}
+
+void OP_Battery::updateCharge(uint32_t now_mS)
+{
+uint16_t zero;
+uint16_t raw;
+
+    // Charge straight off the curve, then rescale so the cutoff is 0%. Otherwise a user with a conservative cutoff would hit LVC
+    // with the gauge still showing a healthy charge.
+    raw = curveTenths(restingVoltage_mV() / _cells);
+    zero = curveTenths(_cutoff_mV / _cells);
+    if (raw <= zero || zero >= 1000) _socTenths = 0;
+    else _socTenths = (uint16_t)(((uint32_t)(raw - zero) * 1000) / (1000 - zero));
+
+    // Discharge rate. Once a period, see how far the charge has fallen and fold that into the running rate.
+    if (now_mS - _rateStart_mS >= BATTERY_RATE_mS)
+    {
+        int32_t drop = (int32_t)_rateStartTenths - _socTenths;
+        if (drop < 0) drop = 0;                     // Recovering after a hard run, or charging - either way not a real rate
+        if (_haveRate) _rate_x16 += ((drop << 4) - _rate_x16) >> BATTERY_RATE_SHIFT;
+        else           _rate_x16 = drop << 4;
+        _haveRate = true;
+        _rateStartTenths = _socTenths;
+        _rateStart_mS = now_mS;
+    }
+
+    // Low battery warning, with some hysteresis so a charge hovering around the level doesn't keep setting it off
+    if (!_low && _socTenths < (BATTERY_LOW_PCT * 10))
+    {
+        _low = true;
+        _lowEvent = true;
+    }
+    else if (_low && _socTenths >= ((BATTERY_LOW_PCT + BATTERY_LOW_HYST_PCT) * 10))
+    {
+        _low = false;
+    }
+}
+
+uint16_t OP_Battery::curveTenths(uint16_t cell_mV)
+{
+uint16_t lo, hi;
+
+    if (cell_mV <= BatteryCurve_mV(_type, 0)) return 0;
+    if (cell_mV >= BatteryCurve_mV(_type, BATTERY_CURVE_POINTS - 1)) return 1000;
+
+    for (uint8_t i = 1; i < BATTERY_CURVE_POINTS; i++)
+    {
+        hi = BatteryCurve_mV(_type, i);
+        if (cell_mV < hi)
+        {
+            lo = BatteryCurve_mV(_type, i - 1);
+            return ((i - 1) * 100) + (uint16_t)(((uint32_t)(cell_mV - lo) * 100) / (hi - lo));
+        }
+    }
+    return 1000;
+}
+
+uint16_t OP_Battery::runtimeMinutes(void)
+{
+uint32_t minutes;
+
+    if (!_seeded || !_haveRate || _rate_x16 <= 0) return BATTERY_RUNTIME_UNKNOWN;
+    minutes = ((uint32_t)_socTenths << 4) / (uint32_t)_rate_x16;
+    if (minutes >= BATTERY_RUNTIME_UNKNOWN) minutes = BATTERY_RUNTIME_UNKNOWN - 1;
+    return (uint16_t)minutes;
+}
+
+boolean OP_Battery::belowCutoff(void)
+{
+    if (!_seeded) return false;
+    if (restingVoltage_mV() < _cutoff_mV) return true;
+    if (measuredVoltage_mV() < (uint16_t)(((uint32_t)_cutoff_mV * BATTERY_FLOOR_PCT) / 100)) return true;
+    return false;
+}
+
+boolean OP_Battery::lowWarning(void)
+{
+    if (_lowEvent)
+    {
+        _lowEvent = false;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,125 @@
+/* OP_Battery.h         Open Panzer Battery - estimates resting voltage, state of charge and remaining runtime of the drive battery
+ * Source:              openpanzer.org
+ * Authors:             Luke Middleton
+ *
+ * The voltage we measure at the battery terminals sags whenever the motors draw current, so on its own it says as much about how hard the
+ * model is working as about how full the battery is. This class is given the measured voltage along with the present motor load (0-255)
+ * and works out how much the voltage sags at full load. It does this by watching how the voltage changes when the load changes quickly,
+ * which is mostly due to the internal resistance of the battery and wiring. With that it can add the sag back to the measured voltage
+ * to estimate the resting (no-load) voltage, which is what the state of charge is judged from.
+ *
+ * State of charge is looked up per-cell from a typical discharge curve for the battery's chemistry (LiPo or NiMH), but rescaled so that 0% 
+ * falls on the user's LVC cutoff.
+ * Remaining runtime is predicted from how fast the state of charge has been falling over the last few minutes.
+ *
+ * Nothing in here touches the hardware, the sketch reads the voltage and motor load and passes them in.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef OP_BATTERY_H
+#define OP_BATTERY_H
+
+#include <Arduino.h>
+#include "../OP_Settings/OP_Settings.h"
+
+
+#define BATTERY_SAMPLE_mS           250         // How often the sketch should call update()
+#define BATTERY_PRESENT_mV          2000        // Anything below this and we assume there is no battery (running from USB)
+#define BATTERY_DEFAULT_SAG_mV      600         // Starting guess for the sag at full load, until we have learned the real value
+#define BATTERY_MAX_SAG_mV          4000        // Sag estimates above this are assumed to be noise and ignored
+#define BATTERY_LOAD_STEP           64          // The load must change by at least this much (out of 255) between samples before we learn anything about sag
+#define BATTERY_SAG_SHIFT           3           // Filter shift for the sag estimate (each new estimate counts 1/8th)
+#define BATTERY_REST_SHIFT          3           // Filter shift for the resting voltage, about 2 seconds at BATTERY_SAMPLE_mS
+#define BATTERY_MEASURED_SHIFT      2           // Filter shift for the measured voltage, about 1 second at BATTERY_SAMPLE_mS
+#define BATTERY_RATE_mS             60000       // How often we look at the drop in state of charge to work out the discharge rate
+#define BATTERY_RATE_SHIFT          2           // Filter shift for the discharge rate, so runtime reflects the last few minutes of driving
+#define BATTERY_LOW_PCT             20          // Below this percent we raise the low battery warning
+#define BATTERY_LOW_HYST_PCT        5           // And the charge must recover this much above it before the warning can be raised again
+#define BATTERY_FLOOR_PCT           85          // Even under load, a measured voltage below this percent of the cutoff counts as below cutoff
+#define BATTERY_RUNTIME_UNKNOWN     0xFFFF      // Returned by runtimeMinutes() until we have seen the battery drain for a while
+
+
+// CHEMISTRY
+// -------------------------------------------------------------------------------------------------------------------------------------------->>
+// Set by BatteryType in OP_EEPROM_Struct.h
+#define BATTERY_LIPO                0
+#define BATTERY_NIMH                1
+#define BATTERY_TYPES               2
+
+// Cell counting. A LiPo cell only runs from 3.3 to 4.2 volts, so for the packs we see (up to 4S) dividing by the highest charged voltage and 
+// rounding up always gives the right count. A NiMH cell runs from 1.1 to 1.45 volts, and with six or more cells in series the same trick 
+// can be out by one either way. So NiMH users should set BatteryCells; if they leave it at 0 we have to guess from the mid-curve voltage 
+// and the charge will be off if the guess is. 
+#define BATTERY_LIPO_CELL_MAX_mV    4250        // Highest voltage of a single charged LiPo cell, used to count cells
+#define BATTERY_NIMH_CELL_MID_mV    1250        // Resting voltage of a half-charged NiMH cell, used to guess the count when not given
+
+// DISCHARGE CURVES
+// -------------------------------------------------------------------------------------------------------------------------------------------->>
+// Resting voltage of a single cell at 0%, 10%, 20% ... 100% charge, one row per chemistry. Voltages in between are interpolated.
+// NiMH is much flatter through the middle than LiPo, so the same sag error costs more percent. 
+#define BATTERY_CURVE_POINTS        11
+const uint16_t BatteryCurve[BATTERY_TYPES][BATTERY_CURVE_POINTS] PROGMEM_FAR =
+{
+    { 3300, 3680, 3740, 3770, 3790, 3820, 3870, 3920, 3980, 4060, 4200 },      // BATTERY_LIPO
+    { 1100, 1180, 1200, 1215, 1225, 1235, 1245, 1260, 1280, 1320, 1400 }       // BATTERY_NIMH
+};
+#define BatteryCurve_mV(t,i)    pgm_read_word_far(pgm_get_far_address(BatteryCurve) + ((((t) * BATTERY_CURVE_POINTS) + (i)) * 2))
+
+
+class OP_Battery
+{   public:
+        OP_Battery() {};
+
+        void        begin(uint16_t cutoff_mV, uint8_t type = BATTERY_LIPO, uint8_t cells = 0);  // Pass the LVC cutoff, this becomes 0% charge. Cells 0 counts them. 
+        void        update(uint16_t measured_mV, uint8_t load, uint32_t now_mS);// Call every BATTERY_SAMPLE_mS with the measured voltage and present motor load (0-255)
+        boolean     isPresent(void)             { return _seeded; }
+        uint16_t    measuredVoltage_mV(void)    { return (uint16_t)(_measured_x16 >> 4); }
+        uint16_t    restingVoltage_mV(void)     { return (uint16_t)(_resting_x16 >> 4); }
+        uint16_t    sag_mV(void)                { return (uint16_t)(_sag_x16 >> 4); }   // Sag at full load
+        uint8_t     cells(void)                 { return _cells; }
+        uint8_t     type(void)                  { return _type; }
+        uint8_t     stateOfCharge(void)         { return (uint8_t)((_socTenths + 5) / 10); }    // Percent
+        uint16_t    runtimeMinutes(void);                                       // Predicted minutes of driving left, or BATTERY_RUNTIME_UNKNOWN
+        boolean     belowCutoff(void);                                          // Resting voltage below cutoff, or measured voltage so far below it that load can't explain it
+        boolean     isLow(void)                 { return _low; }
+        boolean     lowWarning(void);                                           // Returns true once each time the charge drops below BATTERY_LOW_PCT
+
+    private:
+        uint16_t    curveTenths(uint16_t cell_mV);                              // Charge in tenths of a percent from the curve for our chemistry
+        void        updateCharge(uint32_t now_mS);
+        boolean     _seeded;
+        uint16_t    _cutoff_mV;
+        uint8_t     _type;
+        uint8_t     _setCells;                                                  // As given to begin(), 0 to count them
+        uint8_t     _cells;
+        uint16_t    _lastMeasured_mV;
+        uint8_t     _lastLoad;
+        uint32_t    _lastSample_mS;
+        int32_t     _measured_x16;                                              // Filtered values are kept x16 so the filters don't lose resolution
+        int32_t     _resting_x16;
+        int32_t     _sag_x16;
+        uint8_t     _sagSteps;                                                  // Load steps learned from since the battery was plugged in, up to 1 << BATTERY_SAG_SHIFT
+        uint16_t    _socTenths;
+        uint16_t    _rateStartTenths;                                           // Charge at the start of the current rate period
+        uint32_t    _rateStart_mS;
+        int32_t     _rate_x16;                                                  // Tenths of a percent per minute, x16
+        boolean     _haveRate;
+        boolean     _low;
+        boolean     _lowEvent;
+};
+
+
+#endif
@@ -0,0 +1,158 @@
+/* OP_BattleLog.cpp     Open Panzer Battle Log - a timestamped record of hits, shots, repairs, destruction and LVC events
+ * Source:              openpanzer.org
+ * Authors:             Luke Middleton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "OP_BattleLog.h"
+
+
+// Static variables must be declared outside the class
+BattleEvent     OP_BattleLog::_ram[BATTLELOG_RAM_EVENTS];
+uint8_t         OP_BattleLog::_ramHead = 0;
+uint8_t         OP_BattleLog::_ramCount = 0;
+uint16_t        OP_BattleLog::_nextSeq = 0;
+boolean         OP_BattleLog::_spill = BATTLELOG_SPILL_DEFAULT;
+uint8_t         OP_BattleLog::_eepromHead = 0;
+uint8_t         OP_BattleLog::_spillPending = 0;
+uint8_t         OP_BattleLog::_spillByte = 0;
+
+
+void OP_BattleLog::begin(void)
+{
+uint16_t seq;
+boolean found = false;
+
+    // Find the newest record in EEPROM. Sequence numbers wrap, so compare by signed difference rather than by size.
+    // Records are only ever a few dozen apart, so this is never confused.
+    _eepromHead = 0;
+    _nextSeq = 0;
+    for (uint8_t i = 0; i < BATTLELOG_EEPROM_EVENTS; i++)
+    {
+        seq = eeprom_read_word((uint16_t *)(BATTLELOG_EEPROM_START + (i * sizeof(BattleEvent))));
+        if (seq >= BATTLELOG_SEQ_WRAP) continue;   // Empty, or was being written when the power went off
+        if (!found || (int16_t)(seq - (_nextSeq - 1)) > 0)
+        {
+            found = true;
+            _nextSeq = seq + 1;
+            _eepromHead = (i + 1) % BATTLELOG_EEPROM_EVENTS;
+        }
+    }
+    if (_nextSeq >= BATTLELOG_SEQ_WRAP) _nextSeq = 0;
+
+    log(LOG_EVENT_BOOT);
+}
+
+void OP_BattleLog::log(uint8_t type, uint8_t protocol, uint8_t team, uint8_t info)
+{
+BattleEvent * e = &_ram[_ramHead];
+
+    e->Seq = _nextSeq++;
+    if (_nextSeq >= BATTLELOG_SEQ_WRAP) _nextSeq = 0;
+    e->Time_mS = millis();
+    e->Type = type;
+    e->Protocol = protocol;
+    e->Team = team;
+    e->Info = info;
+
+    if (++_ramHead >= BATTLELOG_RAM_EVENTS) _ramHead = 0;
+    if (_ramCount < BATTLELOG_RAM_EVENTS) _ramCount++;
+
+    if (_spill)
+    {
+        if (_spillPending < BATTLELOG_RAM_EVENTS) _spillPending++;
+        else _spillByte = 0;        // We just overwrote the event that was part-way to EEPROM, start again on the next oldest
+    }
+}
+
+void OP_BattleLog::update(void)
+{
+uint8_t index;
+uint8_t b;
+uint8_t val;
+
+    // Write at most one byte, and only if the EEPROM is done with the last one, so we never wait
+    if (_spillPending == 0 || !eeprom_is_ready()) return;
+
+    // The power can go off between any two bytes, and the sequence number (first two bytes, low byte first) must never be left half old
+    // and half new or the record could be taken for the newest on the next boot. So the high byte is first set to 0xFF, which marks the
+    // slot empty however the low byte reads. Then the rest of the record, then the low byte, and last the real high byte. 
+    index = (_ramHead + BATTLELOG_RAM_EVENTS - _spillPending) % BATTLELOG_RAM_EVENTS;
+    if (_spillByte == 0)
+    {
+        b = 1;
+        val = 0xFF;
+    }
+    else
+    {
+        b = (_spillByte + 1) % sizeof(BattleEvent);
+        val = ((uint8_t *)&_ram[index])[b];
+    }
+    eeprom_update_byte((uint8_t *)(BATTLELOG_EEPROM_START + (_eepromHead * sizeof(BattleEvent)) + b), val);
+
+    if (++_spillByte > sizeof(BattleEvent))
+    {
+        _spillByte = 0;
+        _spillPending--;
+        if (++_eepromHead >= BATTLELOG_EEPROM_EVENTS) _eepromHead = 0;
+    }
+}
+
+uint8_t OP_BattleLog::countEEPROM(void)
+{
+uint8_t count = 0;
+
+    for (uint8_t i = 0; i < BATTLELOG_EEPROM_EVENTS; i++)
+    {
+        if (eeprom_read_word((uint16_t *)(BATTLELOG_EEPROM_START + (i * sizeof(BattleEvent)))) < BATTLELOG_SEQ_WRAP) count++;
+    }
+    return count;
+}
+
+boolean OP_BattleLog::readRAM(uint8_t n, BattleEvent &e)
+{
+    if (n >= _ramCount) return false;
+    e = _ram[(_ramHead + BATTLELOG_RAM_EVENTS - _ramCount + n) % BATTLELOG_RAM_EVENTS];
+    return true;
+}
+
+boolean OP_BattleLog::readEEPROM(uint8_t n, BattleEvent &e)
+{
+uint8_t count = countEEPROM();
+
+    if (n >= count) return false;
+    readEEPROMSlot((_eepromHead + BATTLELOG_EEPROM_EVENTS - count + n) % BATTLELOG_EEPROM_EVENTS, e);
+    return true;
+}
+
+void OP_BattleLog::readEEPROMSlot(uint8_t slot, BattleEvent &e)
+{
+    eeprom_read_block(&e, (const void *)(BATTLELOG_EEPROM_START + (slot * sizeof(BattleEvent))), sizeof(BattleEvent));
+}
+
+void OP_BattleLog::clear(void)
+{
+    // Only the sequence number needs erasing to mark a slot empty. This blocks for about half a second so only do it when the vehicle is stopped.
+    for (uint8_t i = 0; i < BATTLELOG_EEPROM_EVENTS; i++)
+    {
+        eeprom_update_word((uint16_t *)(BATTLELOG_EEPROM_START + (i * sizeof(BattleEvent))), BATTLELOG_NO_SEQ);
+    }
+    _eepromHead = 0;
+    _spillPending = 0;
+    _spillByte = 0;
+    _ramHead = 0;
+    _ramCount = 0;
+}
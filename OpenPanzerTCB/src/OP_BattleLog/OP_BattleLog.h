@@ -0,0 +1,98 @@
+/* OP_BattleLog.h       Open Panzer Battle Log - a timestamped record of hits, shots, repairs, destruction and LVC events
+ * Source:              openpanzer.org
+ * Authors:             Luke Middleton
+ *
+ * Events are kept in a small ring buffer in RAM, so the most recent BATTLELOG_RAM_EVENTS are always available. If spilling is enabled, each
+ * event is also copied into a ring in a reserved region at the top of EEPROM, so the history survives a power cycle. Writing EEPROM takes
+ * over 3 mS per byte, so rather than waiting we write one byte at a time, only when the EEPROM is ready for it, each time update() is called.
+ *
+ * Every event carries a sequence number that keeps counting across power cycles. On boot we find the newest record in EEPROM by its sequence
+ * number and carry on from there, so we never need to store a head pointer (which would wear out one EEPROM cell very quickly). A BOOT event
+ * is logged at every startup, and since times are in milliseconds since startup, that is what separates one session from the next.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef OP_BATTLELOG_H
+#define OP_BATTLELOG_H
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+
+
+#define BATTLELOG_RAM_EVENTS        24          // How many events we keep in RAM
+#define BATTLELOG_EEPROM_EVENTS     64          // How many events we keep in EEPROM
+#define BATTLELOG_SPILL_DEFAULT     true        // Copy events to EEPROM unless told not to
+#define BATTLELOG_NO_SEQ            0xFFFF      // Erased EEPROM reads this
+#define BATTLELOG_SEQ_WRAP          0xFF00      // Sequence numbers wrap here, so a slot whose high byte is 0xFF is always empty (see update())
+
+// Event types
+#define LOG_EVENT_BOOT              0           // Device started
+#define LOG_EVENT_HIT_CANNON        1           // Took a cannon hit (protocol, team)
+#define LOG_EVENT_HIT_MG            2           // Took a machine gun hit (protocol)
+#define LOG_EVENT_HIT_FRIENDLY      3           // Cannon signal from our own team, ignored (protocol, team)
+#define LOG_EVENT_REPAIR_START      4           // Began receiving a repair (protocol)
+#define LOG_EVENT_REPAIR_DONE       5           // Repair completed
+#define LOG_EVENT_REPAIR_CANCEL     6           // Repair cancelled by enemy fire or shutdown
+#define LOG_EVENT_SHOT_CANNON       7           // Fired the cannon (protocol, team)
+#define LOG_EVENT_SHOT_MG           8           // Started firing the machine gun (protocol)
+#define LOG_EVENT_SHOT_REPAIR       9           // Sent a repair signal, repair tanks only (protocol)
+#define LOG_EVENT_DESTROYED         10          // Vehicle destroyed
+#define LOG_EVENT_RECOVERED         11          // Vehicle recovered after being destroyed
+#define LOG_EVENT_LVC               12          // Entered low voltage cutoff (Info = resting voltage / 100 mV)
+#define LOG_EVENT_LVC_EXIT          13          // Voltage restored (Info = resting voltage / 100 mV)
+#define LOG_EVENT_REGEN             14          // Damage profile regenerated some health
+
+typedef struct {
+    uint16_t Seq;           // Sequence number, keeps counting across power cycles
+    uint32_t Time_mS;       // Milliseconds since startup
+    uint8_t  Type;          // LOG_EVENT_
+    uint8_t  Protocol;      // IR protocol (IRTYPES) for hits and shots, otherwise 0
+    uint8_t  Team;          // IR team (IRTEAMS) for hits and shots, otherwise 0
+    uint8_t  Info;          // Damage percent after the event, or for LVC events, the voltage in tenths
+} BattleEvent;
+
+// The log lives at the very top of EEPROM, out of the way of the _eeprom_data struct which starts at the bottom
+#define BATTLELOG_EEPROM_BYTES      (BATTLELOG_EEPROM_EVENTS * sizeof(BattleEvent))
+#define BATTLELOG_EEPROM_START      (E2END + 1 - BATTLELOG_EEPROM_BYTES)
+
+
+class OP_BattleLog
+{   public:
+        static void         begin(void);                                    // Find where we left off in EEPROM and log the BOOT event
+        static void         update(void);                                   // Call every loop, copies pending events to EEPROM a byte at a time
+        static void         log(uint8_t type, uint8_t protocol = 0, uint8_t team = 0, uint8_t info = 0);
+        static void         spillToEEPROM(boolean spill)   { _spill = spill; }
+        static boolean      isSpilling(void)                { return _spill; }
+        static uint8_t      countRAM(void)                  { return _ramCount; }
+        static uint8_t      countEEPROM(void);
+        static boolean      readRAM(uint8_t n, BattleEvent &e);             // Event n, oldest first. Returns false if there is no such event
+        static boolean      readEEPROM(uint8_t n, BattleEvent &e);          // Same but from EEPROM
+        static void         clear(void);                                    // Empty both logs
+
+    private:
+        static void         readEEPROMSlot(uint8_t slot, BattleEvent &e);
+        static BattleEvent  _ram[BATTLELOG_RAM_EVENTS];
+        static uint8_t      _ramHead;                                       // Where the next event goes
+        static uint8_t      _ramCount;
+        static uint16_t     _nextSeq;
+        static boolean      _spill;
+        static uint8_t      _eepromHead;                                    // EEPROM slot the next event goes in
+        static uint8_t      _spillPending;                                  // How many RAM events still need to be written to EEPROM
+        static uint8_t      _spillByte;                                     // Next byte of the event being written
+};
+
+
+#endif
@@ -0,0 +1,43 @@
+/* OP_CRC16.h       Open Panzer CRC16 - table driven CRC-16 (polynomial 0x1021, initial value 0) for serial protocols
+ * Source:          openpanzer.org
+ * Authors:         Luke Middleton
+ *
+ * This is the same CRC OP_PCComm has always put on its sentences (the "XMODEM" variant of CRC-16/CCITT), but worked a byte at a time 
+ * from a 256 entry table in far flash instead of a bit at a time. That is about 15 cycles a byte instead of 100 or so. 
+ * The table takes 512 bytes of flash and no RAM.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef OP_CRC16_h
+#define OP_CRC16_h
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include "../OP_Settings/OP_Settings.h"
+
+
+#define CRC16_INIT              0x0000          // Starting value
+
+
+class OP_CRC16
+{
+    public:
+        static uint16_t     update(uint16_t crc, uint8_t b);                        // Add one byte to a running CRC
+        static uint16_t     calc(const char *ptr, uint16_t count, uint16_t crc = CRC16_INIT);   // CRC of count bytes, or add them to a running CRC
+};
+
+
+#endif
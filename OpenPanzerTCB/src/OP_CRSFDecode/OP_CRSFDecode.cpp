@@ -0,0 +1,390 @@
+/* OP_CRSFDecode.cpp Open Panzer CRSF Decoder - a library for decoding TBS Crossfire / ExpressLRS (CRSF) serial radio data
+ * Source:           openpanzer.org
+ * Authors:          Luke Middleton
+ *
+ * See OP_CRSFDecode.h for a description of the protocol.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "OP_CRSFDecode.h"
+
+HardwareSerial        * CRSFDecode::_serial;                            // Hardware serial port
+uint8_t                 CRSFDecode::CRSFData[CRSF_MAX_FRAME_BYTES];     // Up to 64 bytes in a CRSF frame
+uint8_t                 CRSFDecode::crsf_pointer;                       // Pointer to CRSFData array
+uint8_t                 CRSFDecode::frameBytes;                         // Length of the frame being received
+uint8_t                 CRSFDecode::crc;                                // Running CRC
+uint16_t                CRSFDecode::Pulses[CRSF_CHANNELS];              // 16 channel pulse widths
+uint8_t                 CRSFDecode::stateCount;                         // counts the number of times this state has been repeated
+decodeState_t           CRSFDecode::State;                              // The current state
+boolean                 CRSFDecode::NewFrame;                           // Boolean variable to indicate a new complete frame has arrived or been read.
+uint8_t                 CRSFDecode::frameCount;                         //
+uint8_t                 CRSFDecode::framesToDiscard;                    // How many frames to skip for every one read
+decoder_stats           CRSFDecode::Stats;                              // Frame and error counters
+crsf_link_stats         CRSFDecode::LinkStats;                          // Latest link statistics
+boolean                 CRSFDecode::HaveLinkStats;
+uint16_t                CRSFDecode::TelemVoltage_mV;
+uint8_t                 CRSFDecode::TelemChargePct;
+uint8_t                 CRSFDecode::TelemDamagePct;
+boolean                 CRSFDecode::TelemDestroyed;
+boolean                 CRSFDecode::TelemReady;
+boolean                 CRSFDecode::TelemSendDamage;
+uint32_t                CRSFDecode::LastTelemetry_mS;
+
+// Constructor
+CRSFDecode::CRSFDecode(){}
+
+
+void CRSFDecode::begin()
+{
+    // Set Rx pin to input
+    CRSF_DDR &= ~(1 << CRSF_RXPIN);         // Input is selected when Data DiRection bit is cleared
+    // Set pullup
+    CRSF_PORT |= (1 << CRSF_RXPIN);         // Pullups selected when port pin bit set
+
+    // Initialize Arduino Serial port
+    _serial = &CRSF_SERIAL;
+    _serial->begin(CRSF_BAUD, SERIAL_8N1);  // 400k baud, 8 data bits, no parity, 1 stop bit
+
+    // But because we also like to do things manually for educational purposes, here is the explicit setup:
+
+    // Make sure power reduction hasn't turned off this serial port
+    PRR1 &= ~(1 << CRSF_PRUSART);
+    //Set baud rate
+    CRSF_UBRRH = (unsigned char)(UBRR_CRSF>>8);
+    CRSF_UBRRL = (unsigned char)UBRR_CRSF;
+    // Set frame format
+    CRSF_UCSRC = 0x06;                  // mode normal (asynchronous USART), no parity , 1 stop bit, 8 bits data, no polarity for asynchronous
+
+    // Clear flags, set double speed mode, disable multi-processor mode
+    CRSF_UCSRA = 0xFE;                  // Flags are cleared by writing 1. U2Xn set to 1 for double USART speed, MPCMn off (0)
+
+    // Enable receiver, and unlike SBus and iBus, also the transmitter so we can send telemetry
+    CRSF_UCSRB = (1 << CRSF_RXCIE) | (1 << CRSF_RXEN) | (1 << CRSF_TXEN);   // Rx interrupt enabled, Rx enabled, Tx enabled, only 8 bits
+
+    // Unlike SBus and iBus we don't need Timer 1 to find the start of a frame, the length byte and CRC take care of that
+
+    // Other initializations
+    State = NOT_SYNCHED_state;                          // Decoder not yet synched
+    stateCount = 0;                                     // Repeated a state 0 times
+    frameCount = 0;                                     // 0 frames received
+    NewFrame = false;                                   // We haven't received a frame yet, so it hasn't been read either
+    HaveLinkStats = false;
+    TelemReady = false;
+    TelemSendDamage = false;
+    LastTelemetry_mS = 0;
+
+    // Initialize pulses to Center for safety
+    for(uint8_t i = 0; i<CRSF_CHANNELS; i++)
+    {
+        Pulses[i] = DEFAULT_PULSE_CENTER;
+    }
+
+    // Start frame at zero
+    crsf_pointer = 0;
+
+    // Set the number of frames to skip to the default
+    defaultSpeed();
+}
+
+void CRSFDecode::shutdown()
+{   // If we end up using PPM input instead, we will want to disable the serial function of this pin
+    // otherwise the PPM could be setting it off
+    _serial->end();
+    CRSF_UCSRB &= ~(1 << CRSF_RXCIE);   // Disable receive interrupts
+    CRSF_UCSRB &= ~(1 << CRSF_RXEN);    // Disable receiver
+    CRSF_UCSRB &= ~(1 << CRSF_TXEN);    // Disable transmitter
+    CRSF_UCSRA = 0x00;                  // Clear all interrupt flags
+}
+
+
+// Read all received data and calculate channel data
+void CRSFDecode::update()
+{
+uint8_t b;
+uint8_t UART_error;
+
+    while (_serial->available())
+    {
+        UART_error = CRSF_UCSRA & 0x1C;                 // Save error
+        b = _serial->read();                            // Get data from serial Rx
+
+        if ( UART_error )
+        {
+            crsf_pointer = 0;                           // If there is a receive error, reset the frame
+            Stats.CRCErrors++;
+            continue;
+        }
+
+        if (crsf_pointer == 0)                          // Sync byte
+        {
+            if (b == CRSF_SYNCBYTE) CRSFData[crsf_pointer++] = b;
+        }
+        else if (crsf_pointer == 1)                     // Length byte
+        {
+            if (b < CRSF_MIN_LENGTH || b > (CRSF_MAX_FRAME_BYTES - 2))
+            {   // Can't be a real frame, we must have synched on a data byte that happened to equal the sync byte. Start looking again.
+                crsf_pointer = 0;
+                Stats.FormatErrors++;
+            }
+            else
+            {
+                CRSFData[crsf_pointer++] = b;
+                frameBytes = b + 2;                     // Length doesn't count the sync byte or itself
+                crc = 0;
+            }
+        }
+        else
+        {
+            CRSFData[crsf_pointer++] = b;
+            if (crsf_pointer < frameBytes)
+            {
+                crc = CRSF_CRC8(crc, b);                // Keep a running CRC as the bytes come in, so we don't have to do it all at the end
+            }
+            else                                        // Last byte is the CRC
+            {
+                crsf_pointer = 0;                       // Regardless of the outcome, start the next frame
+                if (crc == b) ProcessFrame();
+                else          Stats.CRCErrors++;
+            }
+        }
+    }
+}
+
+void CRSFDecode::ProcessFrame(void)
+{
+    switch (CRSFData[2])
+    {
+        case CRSF_FRAMETYPE_RC_CHANNELS:
+            if (CRSFData[1] != CRSF_RC_PAYLOAD_BYTES + 2)
+            {
+                Stats.FormatErrors++;
+                return;
+            }
+            Stats.FrameTime_uS = micros();
+            Stats.Frames++;
+            if (State == NOT_SYNCHED_state)
+            {                                           // NOT_SYNCHED_STATE is the state we are initialized to. That means this is our first frame.
+                State = ACQUIRING_state;                // Set state to ACQUIRING and start collecting channel data.
+                stateCount = 0;                         // We keep acquiring and incrementing stateCount until we have enough valid frames to consider ourselves stable.
+            }
+            if (State == ACQUIRING_state)
+            {   // Keep collecting until we have ACQUISITION count of frames under our belt.
+                if (++stateCount >= CRSF_ACQUISITION_COUNT) State = READY_state;
+            }
+            else if (!HaveLinkStats || LinkStats.UplinkLQ > 0)
+            {   // Valid frame, keep at Ready. But if the last link statistics said the link is down, these are the receiver's own
+                // failsafe values (some receivers keep sending channels when the link is lost) and we stay in failsafe.
+                State = READY_state;
+            }
+
+            if (++frameCount > framesToDiscard)
+            {
+                NewFrame = true;
+                ConvertCRSF_to_PWM();
+                frameCount = 0;
+            }
+            else
+            {
+                NewFrame = false;
+            }
+
+            // Right after a channels frame is the receiver's time to listen, so this is when we send telemetry
+            SendTelemetry();
+            break;
+
+        case CRSF_FRAMETYPE_LINK_STATISTICS:
+            if (CRSFData[1] != CRSF_LINK_PAYLOAD_BYTES + 2)
+            {
+                Stats.FormatErrors++;
+                return;
+            }
+            memcpy(&LinkStats, &CRSFData[3], CRSF_LINK_PAYLOAD_BYTES);    // The struct is laid out in the same order as the payload, all single bytes
+            HaveLinkStats = true;
+            if (LinkStats.UplinkLQ == 0 && State == READY_state)
+            {   // Receiver has lost the transmitter
+                State = FAILSAFE_state;
+                Stats.RxFailsafe++;
+            }
+            break;
+
+        default:
+            // Some other frame type we don't care about (device info, etc.)
+            break;
+    }
+}
+
+void CRSFDecode::ConvertCRSF_to_PWM()
+{
+    // The channels are packed exactly as SBus, 11 bits each, least significant bit first. See ConvertSBus_to_PWM in OP_SBusDecode.cpp
+    // CRSF values run from 172 (988 uS) through 992 (1500 uS) to 1811 (2012 uS), the same scale as SBus.
+    uint8_t inputbitsavailable = 0;
+    uint32_t inputbits = 0;
+    uint8_t *crsf = &CRSFData[3];   // Skip sync, length and type
+    for ( uint8_t i = 0 ; i < CRSF_CHANNELS ; i += 1 )
+    {
+        uint16_t temp;
+        while ( inputbitsavailable < 11 )
+        {
+            inputbits |= (uint32_t)*crsf++ << inputbitsavailable;
+            inputbitsavailable += 8;
+        }
+
+        temp = ( (int16_t)( inputbits & 0x7FF ) - 0x3E0 ) * 5 / 8 + 1500;
+
+        // If the pulse is valid, save it. Otherwise the result is that we keep the last value. See OP_RadioDefines.h for min and max pulsewidths.
+        if (( temp > MIN_POSSIBLE_PULSE) && (temp < MAX_POSSIBLE_PULSE)) { Pulses[i] = temp; }
+
+        inputbitsavailable -= 11 ;
+        inputbits >>= 11 ;
+    }
+}
+
+void CRSFDecode::GetCRSF_Frame( int16_t pulseArray[], int16_t chanCount)
+{
+    // This copies as many channels as are requested from a CRSF frame to the array that is passed as a parameter
+    byte sregRestore = SREG;        // Save interrupt register
+    cli();                          // Disable interrupts
+    for (uint8_t i=0; i<chanCount; i++)
+    {
+        pulseArray[i] = Pulses[i];
+    }
+    SREG = sregRestore;             // Restore interrupt register
+
+    NewFrame = false;               // We've read this frame, so it's no longer new
+}
+
+boolean CRSFDecode::getLinkStats(crsf_link_stats &ls)
+{
+    ls = LinkStats;
+    return HaveLinkStats;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------------------------------------->>
+// TELEMETRY
+// ---------------------------------------------------------------------------------------------------------------------------------------------------->>
+void CRSFDecode::setTelemetry(uint16_t voltage_mV, uint8_t chargePct, uint8_t damagePct, boolean destroyed)
+{
+    TelemVoltage_mV = voltage_mV;
+    TelemChargePct = chargePct;
+    TelemDamagePct = damagePct;
+    TelemDestroyed = destroyed;
+    TelemReady = true;
+}
+
+void CRSFDecode::SendTelemetry(void)
+{
+    if (!TelemReady || (millis() - LastTelemetry_mS) < CRSF_TELEMETRY_mS) return;
+
+    // Never wait on the serial port. If the transmit buffer doesn't have room for a whole frame, skip it and try again after the next channels frame.
+    if (_serial->availableForWrite() < (CRSF_FLIGHT_MODE_CHARS + 5)) return;
+
+    if (TelemSendDamage) SendDamage();
+    else                 SendBattery();
+    TelemSendDamage = !TelemSendDamage;
+    LastTelemetry_mS = millis();
+}
+
+void CRSFDecode::SendBattery(void)
+{
+uint8_t payload[CRSF_BATTERY_PAYLOAD_BYTES];
+uint16_t dV;
+
+    // All multi-byte values in CRSF are big endian
+    dV = (TelemVoltage_mV + 50) / 100;              // Voltage is sent in tenths of a volt
+    payload[0] = highByte(dV);
+    payload[1] = lowByte(dV);
+    payload[2] = 0;                                 // Current, we don't measure it
+    payload[3] = 0;
+    payload[4] = 0;                                 // Capacity used (3 bytes), don't know that either
+    payload[5] = 0;
+    payload[6] = 0;
+    payload[7] = TelemChargePct;                    // Percent remaining
+    SendFrame(CRSF_FRAMETYPE_BATTERY, payload, CRSF_BATTERY_PAYLOAD_BYTES);
+}
+
+void CRSFDecode::SendDamage(void)
+{
+uint8_t text[CRSF_FLIGHT_MODE_CHARS + 1];
+uint8_t len = 0;
+uint8_t pct;
+
+    // The flight mode is a null-terminated string, the transmitter shows it as-is. "OK", "DMG 40%" or "DESTROYED"
+    if (TelemDestroyed)
+    {
+        strcpy_P((char *)text, PSTR("DESTROYED"));
+        len = 9;
+    }
+    else if (TelemDamagePct == 0)
+    {
+        strcpy_P((char *)text, PSTR("OK"));
+        len = 2;
+    }
+    else
+    {
+        strcpy_P((char *)text, PSTR("DMG "));
+        len = 4;
+        pct = TelemDamagePct > 99 ? 99 : TelemDamagePct;
+        if (pct >= 10) text[len++] = '0' + (pct / 10);
+        text[len++] = '0' + (pct % 10);
+        text[len++] = '%';
+    }
+    text[len++] = '\0';
+    SendFrame(CRSF_FRAMETYPE_FLIGHT_MODE, text, len);
+}
+
+void CRSFDecode::SendFrame(uint8_t type, const uint8_t *payload, uint8_t len)
+{
+uint8_t c;
+
+    _serial->write(CRSF_SYNCBYTE);
+    _serial->write(len + 2);                        // Type + payload + CRC
+    _serial->write(type);
+    c = CRSF_CRC8(0, type);
+    for (uint8_t i = 0; i < len; i++)
+    {
+        _serial->write(payload[i]);
+        c = CRSF_CRC8(c, payload[i]);
+    }
+    _serial->write(c);
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------------------------------------->>
+// UTILITIES
+// ---------------------------------------------------------------------------------------------------------------------------------------------------->>
+decodeState_t CRSFDecode::getState()
+{
+    return State;
+}
+
+uint8_t CRSFDecode::getChanCount()
+{
+    return CRSF_CHANNELS;
+}
+
+void CRSFDecode::slowDownForPCComm(void)
+{
+    // Discard even more frames so that streaming data to the PC doesn't bog down
+    framesToDiscard = CRSF_PCCOMM_DISCARD_FRAMES;
+}
+
+void CRSFDecode::defaultSpeed(void)
+{
+    // Revert to the default number of discarded frames CRSF_DEFAULT_DISCARD_FRAMES,
+    // this gives us maximum responsiveness when in normal operation
+    framesToDiscard = CRSF_DEFAULT_DISCARD_FRAMES;
+}
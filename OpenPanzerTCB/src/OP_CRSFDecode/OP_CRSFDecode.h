@@ -0,0 +1,242 @@
+/* OP_CRSFDecode.h  Open Panzer CRSF Decoder - a library for decoding TBS Crossfire / ExpressLRS (CRSF) serial radio data
+ * Source:          openpanzer.org              
+ * Authors:         Luke Middleton
+ *
+ * CRSF is the serial protocol used between Crossfire and ExpressLRS receivers and the flight controller (in our case, the TCB). Unlike SBus and iBus 
+ * the frames are not a fixed length and are not separated by a gap, instead each frame carries its own length and a CRC: 
+ * 
+ *      byte 0          Sync/address byte, 0xC8 for frames going to or coming from the flight controller
+ *      byte 1          Length of the rest of the frame (type + payload + CRC), not including these first two bytes
+ *      byte 2          Frame type
+ *      byte 3...       Payload
+ *      last byte       CRC8 (DVB-S2, polynomial 0xD5) of the type and payload bytes
+ *
+ * We are interested in two frame types from the receiver: RC_CHANNELS_PACKED (16 channels of 11 bits each, packed the same way as SBus) and 
+ * LINK_STATISTICS (signal strength and link quality). Everything else is ignored. 
+ * 
+ * CRSF is also two-way. If the Serial 3 Tx line is connected to the receiver's Rx pin, we send telemetry frames back to the transmitter: 
+ * battery voltage and charge (shown on the transmitter as the usual battery sensor) and the damage state of the vehicle (sent as the "flight mode" 
+ * text, since that is displayed on every transmitter without any setup). As the CRSF spec suggests, telemetry is only sent right after a channels 
+ * frame arrives, so we are never talking at the same time as a receiver that uses a single wire for both directions. 
+ *
+ * CRSF is nominally 420,000 baud, 8N1, not inverted. The ATmega2560 at 16 MHz can't get closer to 420k than 400k (-4.8%), which is at the very edge of what 
+ * a UART will tolerate, so we run at exactly 400,000 baud instead. ExpressLRS receivers let you choose 400k in their options. Frames can arrive at up to 
+ * 500 Hz, and as with SBus and iBus we read them out of the Arduino serial buffer, which only holds 64 bytes (a little over 1.5 mS of data at this speed). 
+ * The main loop has no trouble keeping up with packet rates of 150 Hz and below, higher than that and the occasional frame may be lost to buffer 
+ * overruns (they will show up as CRC errors in the radio statistics). A tank gains nothing from 500 Hz anyway. 
+ *   
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */ 
+
+#ifndef OP_CRSFDecode_H
+#define OP_CRSFDecode_H
+
+#include <Arduino.h>
+#include "../OP_Settings/OP_Settings.h"
+#include "../OP_Radio/OP_RadioDefines.h"
+
+
+// Uncomment only ONE of the below, to indicate which hardware serial the CRSF will receive data on.
+//#define CRSF_SERIAL_0     0
+//#define CRSF_SERIAL_1     1
+//#define CRSF_SERIAL_2     2
+#define CRSF_SERIAL_3       3       // For the TCB, we want Serial 3
+
+// Now we will save the appropriate registers for the selected serial port
+// THIS IS ONLY GUARANTEED TO WORK FOR THE ATmega2560! 
+#if defined (CRSF_SERIAL_0)
+    #define CRSF_UBRRH      UBRR0H
+    #define CRSF_UBRRL      UBRR0L
+    #define CRSF_UCSRA      UCSR0A
+    #define CRSF_UCSRB      UCSR0B
+    #define CRSF_UCSRC      UCSR0C
+    #define CRSF_UDR        UDR0
+    #define CRSF_SERIAL     Serial0
+    #define CRSF_PRUSART    PRUSART0
+    #define CRSF_RXEN       RXEN0
+    #define CRSF_TXEN       TXEN0
+    #define CRSF_RXC        RXC0
+    #define CRSF_RXCIE      RXCIE0
+    #define CRSF_PORT       PORTE
+    #define CRSF_DDR        DDRE
+    #define CRSF_RXPIN      PE0
+#elif defined (CRSF_SERIAL_1)
+    #define CRSF_UBRRH      UBRR1H
+    #define CRSF_UBRRL      UBRR1L
+    #define CRSF_UCSRA      UCSR1A
+    #define CRSF_UCSRB      UCSR1B
+    #define CRSF_UCSRC      UCSR1C
+    #define CRSF_UDR        UDR1
+    #define CRSF_SERIAL     Serial1
+    #define CRSF_PRUSART    PRUSART1
+    #define CRSF_RXEN       RXEN1
+    #define CRSF_TXEN       TXEN1
+    #define CRSF_RXC        RXC1
+    #define CRSF_RXCIE      RXCIE1
+    #define CRSF_PORT       PORTD
+    #define CRSF_DDR        DDRD
+    #define CRSF_RXPIN      PD2
+#elif defined (CRSF_SERIAL_2)
+    #define CRSF_UBRRH      UBRR2H
+    #define CRSF_UBRRL      UBRR2L
+    #define CRSF_UCSRA      UCSR2A
+    #define CRSF_UCSRB      UCSR2B
+    #define CRSF_UCSRC      UCSR2C
+    #define CRSF_UDR        UDR2
+    #define CRSF_SERIAL     Serial2
+    #define CRSF_PRUSART    PRUSART2
+    #define CRSF_RXEN       RXEN2
+    #define CRSF_TXEN       TXEN2
+    #define CRSF_RXC        RXC2
+    #define CRSF_RXCIE      RXCIE2
+    #define CRSF_PORT       PORTH
+    #define CRSF_DDR        DDRH
+    #define CRSF_RXPIN      PH0
+#else defined (CRSF_SERIAL_3)
+    #define CRSF_UBRRH      UBRR3H
+    #define CRSF_UBRRL      UBRR3L
+    #define CRSF_UCSRA      UCSR3A
+    #define CRSF_UCSRB      UCSR3B
+    #define CRSF_UCSRC      UCSR3C
+    #define CRSF_UDR        UDR3
+    #define CRSF_SERIAL     Serial3
+    #define CRSF_PRUSART    PRUSART3
+    #define CRSF_RXEN       RXEN3
+    #define CRSF_TXEN       TXEN3
+    #define CRSF_RXC        RXC3
+    #define CRSF_RXCIE      RXCIE3
+    #define CRSF_PORT       PORTJ
+    #define CRSF_DDR        DDRJ
+    #define CRSF_RXPIN      PJ0
+#endif
+
+// CRSF is 420k baud, but the closest we can get is 400k. Pre-calculate the UBBRn setting that will give us this baud rate.
+#define UBRR_CRSF                   4           // In normal speed mode there is no UBRR anywhere near 400k, so we use double-speed mode where the formula is: 
+                                                // (F_CPU / (8 * BAUD) ) -1 = (16,000,000 / (8 * 400,000) ) - 1 = 4 exactly. 
+                                                // 420k would be 3.76, and either 3 (500k) or 4 (400k) is too far off to be reliable. 
+                                                // We then need to make sure we select double speed mode by setting U2Xn = 1, see begin() in OP_CRSFDecode.cpp. 
+#define CRSF_BAUD                   400000
+
+#define CRSF_SYNCBYTE               0xC8        // Address of the flight controller, first byte of every frame to or from us
+#define CRSF_MAX_FRAME_BYTES        64          // Longest possible frame including sync and length bytes
+#define CRSF_MIN_LENGTH             2           // Shortest possible value for the length byte (type + CRC, no payload)
+
+// Frame types
+#define CRSF_FRAMETYPE_BATTERY          0x08    // Battery sensor (telemetry we send)
+#define CRSF_FRAMETYPE_LINK_STATISTICS  0x14    // Link statistics (from the receiver)
+#define CRSF_FRAMETYPE_RC_CHANNELS      0x16    // RC channels packed (from the receiver)
+#define CRSF_FRAMETYPE_FLIGHT_MODE      0x21    // Flight mode text (telemetry we send)
+
+#define CRSF_RC_PAYLOAD_BYTES       22          // 16 channels x 11 bits = 176 bits = 22 bytes
+#define CRSF_LINK_PAYLOAD_BYTES     10
+#define CRSF_BATTERY_PAYLOAD_BYTES  8           // Voltage (2), current (2), capacity used (3), percent remaining (1)
+#define CRSF_FLIGHT_MODE_CHARS      16          // Longest flight mode string we will send, not including the terminating null
+#define CRSF_CHANNELS               16          // Number of CRSF channels
+
+#define CRSF_ACQUISITION_COUNT      4           // Must have this many consecutive valid frames to transition to the ready state.
+
+#define CRSF_DEFAULT_DISCARD_FRAMES 0           // Keep every frame. CRSF is the low-latency protocol, there's no point throwing that away. 
+#define CRSF_PCCOMM_DISCARD_FRAMES  4           // While streaming to OP Config keep only one frame in 5. At a typical 150 Hz packet rate that is still 30 Hz, 
+                                                // which is plenty for the Radio Setup routine and leaves time to send each sentence (see the notes in OP_SBusDecode.h). 
+
+#define CRSF_TELEMETRY_mS           100         // Send a telemetry frame no more often than this. We alternate between battery and damage so each updates every 200 mS. 
+
+// CRSF CRC8 (DVB-S2, polynomial 0xD5)
+const uint8_t CRSF_CRC8Table[256] PROGMEM_FAR =
+{
+    0x00, 0xD5, 0x7F, 0xAA, 0xFE, 0x2B, 0x81, 0x54, 0x29, 0xFC, 0x56, 0x83, 0xD7, 0x02, 0xA8, 0x7D,
+    0x52, 0x87, 0x2D, 0xF8, 0xAC, 0x79, 0xD3, 0x06, 0x7B, 0xAE, 0x04, 0xD1, 0x85, 0x50, 0xFA, 0x2F,
+    0xA4, 0x71, 0xDB, 0x0E, 0x5A, 0x8F, 0x25, 0xF0, 0x8D, 0x58, 0xF2, 0x27, 0x73, 0xA6, 0x0C, 0xD9,
+    0xF6, 0x23, 0x89, 0x5C, 0x08, 0xDD, 0x77, 0xA2, 0xDF, 0x0A, 0xA0, 0x75, 0x21, 0xF4, 0x5E, 0x8B,
+    0x9D, 0x48, 0xE2, 0x37, 0x63, 0xB6, 0x1C, 0xC9, 0xB4, 0x61, 0xCB, 0x1E, 0x4A, 0x9F, 0x35, 0xE0,
+    0xCF, 0x1A, 0xB0, 0x65, 0x31, 0xE4, 0x4E, 0x9B, 0xE6, 0x33, 0x99, 0x4C, 0x18, 0xCD, 0x67, 0xB2,
+    0x39, 0xEC, 0x46, 0x93, 0xC7, 0x12, 0xB8, 0x6D, 0x10, 0xC5, 0x6F, 0xBA, 0xEE, 0x3B, 0x91, 0x44,
+    0x6B, 0xBE, 0x14, 0xC1, 0x95, 0x40, 0xEA, 0x3F, 0x42, 0x97, 0x3D, 0xE8, 0xBC, 0x69, 0xC3, 0x16,
+    0xEF, 0x3A, 0x90, 0x45, 0x11, 0xC4, 0x6E, 0xBB, 0xC6, 0x13, 0xB9, 0x6C, 0x38, 0xED, 0x47, 0x92,
+    0xBD, 0x68, 0xC2, 0x17, 0x43, 0x96, 0x3C, 0xE9, 0x94, 0x41, 0xEB, 0x3E, 0x6A, 0xBF, 0x15, 0xC0,
+    0x4B, 0x9E, 0x34, 0xE1, 0xB5, 0x60, 0xCA, 0x1F, 0x62, 0xB7, 0x1D, 0xC8, 0x9C, 0x49, 0xE3, 0x36,
+    0x19, 0xCC, 0x66, 0xB3, 0xE7, 0x32, 0x98, 0x4D, 0x30, 0xE5, 0x4F, 0x9A, 0xCE, 0x1B, 0xB1, 0x64,
+    0x72, 0xA7, 0x0D, 0xD8, 0x8C, 0x59, 0xF3, 0x26, 0x5B, 0x8E, 0x24, 0xF1, 0xA5, 0x70, 0xDA, 0x0F,
+    0x20, 0xF5, 0x5F, 0x8A, 0xDE, 0x0B, 0xA1, 0x74, 0x09, 0xDC, 0x76, 0xA3, 0xF7, 0x22, 0x88, 0x5D,
+    0xD6, 0x03, 0xA9, 0x7C, 0x28, 0xFD, 0x57, 0x82, 0xFF, 0x2A, 0x80, 0x55, 0x01, 0xD4, 0x7E, 0xAB,
+    0x84, 0x51, 0xFB, 0x2E, 0x7A, 0xAF, 0x05, 0xD0, 0xAD, 0x78, 0xD2, 0x07, 0x53, 0x86, 0x2C, 0xF9
+};
+#define CRSF_CRC8(crc, b)   pgm_read_byte_far(pgm_get_far_address(CRSF_CRC8Table) + ((crc) ^ (b)))
+
+// Link statistics as reported by the receiver
+typedef struct crsf_link_stats {
+    uint8_t UplinkRSSI1;                        // Uplink (transmitter to receiver) signal strength at each antenna, in -dBm (so 60 means -60 dBm)
+    uint8_t UplinkRSSI2;
+    uint8_t UplinkLQ;                           // Uplink link quality, percent of packets received
+    int8_t  UplinkSNR;                          // Uplink signal to noise ratio, dB
+    uint8_t ActiveAntenna;
+    uint8_t RFMode;                             // Packet rate, the meaning depends on the radio system
+    uint8_t UplinkTXPower;                      // Transmitter power, enumerated (0 = 0 mW, 1 = 10 mW, 2 = 25 mW, 3 = 100 mW ...)
+    uint8_t DownlinkRSSI;                       // Downlink (telemetry back to the transmitter) signal strength, -dBm
+    uint8_t DownlinkLQ;
+    int8_t  DownlinkSNR;
+} crsf_link_stats;
+
+class CRSFDecode
+{
+    public:
+        CRSFDecode(); //Constructor
+        void                    begin();
+        void                    shutdown(void);                 // Turn the receiver off
+        decodeState_t           getState(void);                 
+        uint8_t                 getChanCount(void);             // Channel count - will always return CRSF_CHANNELS
+        void                    GetCRSF_Frame(int16_t pulseArray[], int16_t chanCount);  // Copy a complete frame of pulses 
+        static boolean          NewFrame;                       // Has an unread frame of data arrived? 
+        void                    update(void);
+        void                    slowDownForPCComm(void);        // Adjust on the fly how many frames we choose to discard, this will set it to CRSF_PCCOMM_DISCARD_FRAMES
+        void                    defaultSpeed(void);             // Revert to the default number of discarded frames CRSF_DEFAULT_DISCARD_FRAMES
+        void                    getStats(decoder_stats &ds) { ds = Stats; }     // Copy out the frame and error counters
+        boolean                 getLinkStats(crsf_link_stats &ls);              // Copy out the latest link statistics, returns false if the receiver hasn't sent any yet
+        void                    setTelemetry(uint16_t voltage_mV, uint8_t chargePct, uint8_t damagePct, boolean destroyed); // Values to send back to the transmitter
+        
+    private:
+        static void             ProcessFrame(void);             // Act on a complete frame that passed CRC
+        static void             ConvertCRSF_to_PWM(void);       // Convert the packed channels to pulse-widths
+        static void             SendTelemetry(void);            // Send the next telemetry frame, if it is time to
+        static void             SendBattery(void);
+        static void             SendDamage(void);
+        static void             SendFrame(uint8_t type, const uint8_t *payload, uint8_t len);
+        
+        static HardwareSerial   *_serial;                       // Hardware serial pointer
+        static uint8_t          CRSFData[CRSF_MAX_FRAME_BYTES]; // Array to hold frame bytes
+        static uint8_t          crsf_pointer;                   // Pointer to current position of array
+        static uint8_t          frameBytes;                     // Total bytes in the frame being received, taken from the length byte
+        static uint8_t          crc;                            // Running CRC of the frame being received
+        static uint16_t         Pulses[CRSF_CHANNELS];          // Array to hold pulse widths for all channels
+    
+        static uint8_t          stateCount;                     // counts the number of times this state has been repeated  
+        static decodeState_t    State;                          // The current state
+        static uint8_t          frameCount;                     // Used to keep track of frames for the purpose of discarding some
+        static uint8_t          framesToDiscard;                // How many frames to discard for each frame we read
+        static decoder_stats    Stats;                          // Frame and error counters
+        static crsf_link_stats  LinkStats;                      // Latest link statistics from the receiver
+        static boolean          HaveLinkStats;
+
+        static uint16_t         TelemVoltage_mV;                // Telemetry values given to us by the sketch
+        static uint8_t          TelemChargePct;
+        static uint8_t          TelemDamagePct;
+        static boolean          TelemDestroyed;
+        static boolean          TelemReady;                     // Have we been given anything to send
+        static boolean          TelemSendDamage;                // Which frame goes next, battery or damage
+        static uint32_t         LastTelemetry_mS;
+};
+
+
+#endif 
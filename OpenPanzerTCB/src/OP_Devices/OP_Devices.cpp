@@ -0,0 +1,94 @@
+/* OP_Devices.cpp   Open Panzer Devices - capabilities of the boards this firmware runs on
+ * Source:          openpanzer.org
+ * Authors:         Luke Middleton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "OP_Devices.h"
+
+// One row per board. Pins that code toggles in a hurry (the machine gun LED in the tank class, the recoil switch interrupt) are still
+// compile-time defines in OP_Settings.h and OP_Tank.cpp, the table has to agree with them. 
+// Both boards are an ATmega2560 with the same timers, serial ports and IO ports, so those aren't listed. They can't change at runtime anyway, 
+// the ISR vectors, HardwareSerial objects and IO_Pin array are all fixed when the firmware is compiled.
+const device_capabilities DeviceCapabilities[] PROGMEM_FAR = {
+//   Device             Flags                                                                 MG        Unused MG  Recoil Sw  Unused Sw
+    {DEVICE_TCB_MKI,    DEVCAP_ONBOARD_ESC | DEVCAP_SMOKER | DEVCAP_MECH_RECOIL | DEVCAP_I2C,   'E', 2,   'D', 1,    'E', 6,    'D', 0},
+    {DEVICE_TCB_DIY,    DEVCAP_ONBOARD_ESC | DEVCAP_SMOKER | DEVCAP_MECH_RECOIL,                'D', 1,   'E', 2,    'D', 0,    'E', 6}
+};
+#define NUM_DEVICE_CAPABILITIES     (sizeof(DeviceCapabilities) / sizeof(device_capabilities))
+
+// Static variables must be declared outside the class
+device_capabilities OP_Devices::Board;
+
+
+boolean OP_Devices::getCapabilities(DEVICE d, device_capabilities * dc)
+{
+    uint32_t address = pgm_get_far_address(DeviceCapabilities);
+
+    for (uint8_t i = 0; i < NUM_DEVICE_CAPABILITIES; i++)
+    {
+        // As with our other far tables we can't index the array directly, so we step through it a byte at a time
+        if (pgm_read_byte_far(address) == d)
+        {
+            uint8_t * p = (uint8_t *)dc;
+            for (uint8_t j = 0; j < sizeof(device_capabilities); j++) p[j] = pgm_read_byte_far(address + j);
+            return true;
+        }
+        address += sizeof(device_capabilities);
+    }
+    return false;
+}
+
+void OP_Devices::begin(DEVICE d)
+{
+    if (!getCapabilities(d, &Board)) getCapabilities(DEVICE_TCB_MKI, &Board);
+}
+
+volatile uint8_t * OP_Devices::portRegister(char port)
+{
+    switch (port)
+    {
+        case 'A': return &PORTA;
+        case 'B': return &PORTB;
+        case 'C': return &PORTC;
+        case 'D': return &PORTD;
+        case 'E': return &PORTE;
+        case 'F': return &PORTF;
+        case 'G': return &PORTG;
+        case 'H': return &PORTH;
+        case 'J': return &PORTJ;
+        case 'K': return &PORTK;
+        case 'L': return &PORTL;
+        default:  return NULL;
+    }
+}
+
+void OP_Devices::setPinOutput(char port, uint8_t bit, boolean high)
+{
+    volatile uint8_t * p = portRegister(port);
+    if (p == NULL) return;
+    if (high) *p |= (1 << bit);     // Set the level first so the pin doesn't glitch the other way when it becomes an output
+    else      *p &= ~(1 << bit);
+    *(p - 1) |= (1 << bit);         // DDRx
+}
+
+void OP_Devices::setPinInputPullup(char port, uint8_t bit)
+{
+    volatile uint8_t * p = portRegister(port);
+    if (p == NULL) return;
+    *(p - 1) &= ~(1 << bit);        // DDRx bit to 0 is input
+    *p |= (1 << bit);               // Writing a 1 to an input connects the internal pull-up
+}
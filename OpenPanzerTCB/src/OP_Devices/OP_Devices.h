@@ -4,6 +4,9 @@
 #ifndef OP_DEVICES_H
 #define OP_DEVICES_H
 
+#include <Arduino.h>
+#include "../OP_Settings/OP_Settings.h"
+
 // ------------------------------------------------------------------------------------------------------------------------------------------------------->>
 // OPEN PANZER DEVICES
 // ------------------------------------------------------------------------------------------------------------------------------------------------------->>
@@ -22,4 +25,52 @@
 	#define DEVICE_ATMEGA2560   11
 
 
+// ------------------------------------------------------------------------------------------------------------------------------------------------------->>
+// BOARD CAPABILITIES
+// ------------------------------------------------------------------------------------------------------------------------------------------------------->>
+	// Which board this firmware is being compiled for. Only the TCB boards run this firmware, the other devices above are things OP Config talks to.
+	// Note this is not necessarily the same as HardwareVersion in the sketch, which is what we report to OP Config.
+#ifdef TCB_DIY
+	#define THIS_BOARD          DEVICE_TCB_DIY
+#else
+	#define THIS_BOARD          DEVICE_TCB_MKI
+#endif
+
+	// What is physically on a board. Setup code asks OP_Devices::has() rather than testing for a particular board, so a new variant
+	// only needs a row in the DeviceCapabilities table (OP_Devices.cpp).
+	#define DEVCAP_ONBOARD_ESC  0x01                // Pins for a dual motor driver (Motor A & B, see OB_MA/OB_MB in OP_Settings.h). On the TCB this is the L298, on the DIY board you wire your own
+	#define DEVCAP_SMOKER       0x02                // Heng Long smoker output (OB_SMOKER_PWM)
+	#define DEVCAP_MECH_RECOIL  0x04                // Mechanical recoil / airsoft motor output
+	#define DEVCAP_I2C          0x08                // I2C port free for use. The DIY board gives its I2C pins to the machine gun LED and recoil switch.
+
+	typedef struct {
+		DEVICE   Device;
+		uint8_t  Flags;                             // DEVCAP_ bits
+		char     MG_Port;                           // Machine gun LED port letter and bit. This pin has no Arduino number on the TCB so it can only be set directly.
+		uint8_t  MG_Bit;
+		char     UnusedMG_Port;                     // The machine gun pin on the other board variant, unused on this one, gets set to input with pullup
+		uint8_t  UnusedMG_Bit;
+		char     RecoilSw_Port;                     // Mechanical recoil / airsoft switch input, and the other variant's switch pin which is left unused. 
+		uint8_t  RecoilSw_Bit;                      // The switch's external interrupt still has to be picked at compile time (see OP_Tank.cpp). 
+		char     UnusedRecoilSw_Port;
+		uint8_t  UnusedRecoilSw_Bit;
+	} device_capabilities;
+
+
+class OP_Devices
+{
+	public:
+		static void                 begin(DEVICE d = THIS_BOARD);       // Load the capabilities of this board, falls back to DEVICE_TCB_MKI if d isn't in the table
+		static boolean              getCapabilities(DEVICE d, device_capabilities * dc);  // Copy out any board's capabilities from the table, returns false if the board isn't listed
+		static const device_capabilities & capabilities(void) { return Board; }
+		static boolean              has(uint8_t flag)   { return (Board.Flags & flag); }
+		static void                 setPinOutput(char port, uint8_t bit, boolean high);   // Direct port pin setup, for pins with no Arduino number
+		static void                 setPinInputPullup(char port, uint8_t bit);
+
+	private:
+		static volatile uint8_t *   portRegister(char port);            // PORTx for a port letter. DDRx is always the address just below it.
+		static device_capabilities  Board;
+};
+
+
 #endif
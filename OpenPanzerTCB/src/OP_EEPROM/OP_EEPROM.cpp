@@ -19,6 +19,7 @@
 
 
 #include "OP_EEPROM.h"
+#include "../OP_BattleLog/OP_BattleLog.h"
 
 
 // Static variables must be declared outside the class
@@ -70,7 +71,7 @@ boolean OP_EEPROM::readSerialEEPROM_byID(uint16_t ID, char *chrArray, uint8_t bu
 {
     _storage_var_info svi;
     uint16_t arrayPos;  
-    String str;  // Yes, we are using the dreaded string object
+    boolean fits;
 
     // Get the data info for this variable, it is stored in svi if successful
     arrayPos = findStorageVarInfo(svi, ID);
@@ -95,6 +96,9 @@ boolean OP_EEPROM::readSerialEEPROM_byID(uint16_t ID, char *chrArray, uint8_t bu
     }
     else
     {
+        // Convert the number straight into the array that was passed, the length goes back in stringlength
+        stringlength = 0;
+        chrArray[0] = '\0';
         switch (svi.varType)
         {
             case varNULL:
@@ -106,18 +110,14 @@ boolean OP_EEPROM::readSerialEEPROM_byID(uint16_t ID, char *chrArray, uint8_t bu
             case varUINT8:  // Unsigned 8 bit
                 {
                     uint8_t myUint8 = EEPROM.readByte(svi.varOffset);
-                    str = String(myUint8);
-                    str.toCharArray(chrArray, bufflen);
-                    stringlength = str.length();    // Return the actual string length
+                    fits = OP_Format::appendUInt(chrArray, bufflen, stringlength, myUint8);
                 }
                 break;
             
             case varINT8:   // Signed 8 bit
                 {
                     int8_t myInt8 = EEPROM.readByte(svi.varOffset);
-                    str = String(myInt8);
-                    str.toCharArray(chrArray, bufflen); 
-                    stringlength = str.length();    // Return the actual string length
+                    fits = OP_Format::appendInt(chrArray, bufflen, stringlength, myInt8);
                 }
                 break;
                 
@@ -125,36 +125,28 @@ boolean OP_EEPROM::readSerialEEPROM_byID(uint16_t ID, char *chrArray, uint8_t bu
             case varINT16:  // Signed 16 bit
                 {
                     int16_t myInt16 = (int16_t)EEPROM.readInt(svi.varOffset);
-                    str = String(myInt16);
-                    str.toCharArray(chrArray, bufflen);
-                    stringlength = str.length();    // Return the actual string length
+                    fits = OP_Format::appendInt(chrArray, bufflen, stringlength, myInt16);
                 }
                 break;          
             
             case varUINT16: // Unsigned 16 bit
                 {
                     uint16_t myUint16 = (uint16_t)EEPROM.readInt(svi.varOffset);
-                    str = String(myUint16, DEC);
-                    str.toCharArray(chrArray, bufflen);
-                    stringlength = str.length();    // Return the actual string length
+                    fits = OP_Format::appendUInt(chrArray, bufflen, stringlength, myUint16);
                 }
                 break;
 
             case varINT32:  // Signed 32 bit
                 {
                     int32_t myInt32 = (int32_t)EEPROM.readLong(svi.varOffset);
-                    str = String(myInt32, DEC);
-                    str.toCharArray(chrArray, bufflen);
-                    stringlength = str.length();    // Return the actual string length
+                    fits = OP_Format::appendInt(chrArray, bufflen, stringlength, myInt32);
                 }
                 break;
 
             case varUINT32: // Unsigned 32 bit
                 {
                     uint32_t myUint32 = (uint32_t)EEPROM.readLong(svi.varOffset);
-                    str = String(myUint32, DEC);
-                    str.toCharArray(chrArray, bufflen);
-                    stringlength = str.length();    // Return the actual string length
+                    fits = OP_Format::appendUInt(chrArray, bufflen, stringlength, myUint32);
                 }
                 break;
 
@@ -163,7 +155,7 @@ boolean OP_EEPROM::readSerialEEPROM_byID(uint16_t ID, char *chrArray, uint8_t bu
         }
     }
 
-    return 1;
+    return fits;                    // False if the number didn't fit in bufflen
 
 }
 
@@ -351,6 +343,8 @@ void OP_EEPROM::Initialize_EEPROM(void)
     ramcopy.InitStamp = EEPROM_INIT;                    // Set the InitStamp
     EEPROM.updateBlock(EEPROM_START_ADDRESS, ramcopy);  // Now write it all to EEPROM. We use the "update" function so as not to 
                                                         // unnecessarily writebytes that haven't changed. 
+    OP_BattleLog::clear();                              // The battle log ring at the top of EEPROM may hold leftovers from an older layout (or never have been written), 
+                                                        // mark every slot empty so they aren't read back as events
 }
 
 // THIS IS WHERE EEPROM DEFAULT VALUES ARE SET
@@ -421,6 +415,26 @@ void OP_EEPROM::Initialize_RAMcopy(void)
         ramcopy.SF_Trigger[2].specialFunction = SF_CANNON_FIRE;
         ramcopy.SF_Trigger[3].TriggerID = BR;
         ramcopy.SF_Trigger[3].specialFunction = SF_LIGHT1_TOGGLE;
+
+    // Macros - all empty
+        for (int i=0; i<MAX_MACROS; i++)
+        {
+            for (int j=0; j<MACRO_STEPS; j++)
+            {
+                ramcopy.SF_Macro[i].Step[j].Function = SF_NULL_FUNCTION;
+                ramcopy.SF_Macro[i].Step[j].Value = 0;
+                ramcopy.SF_Macro[i].Step[j].Delay_mS = 0;
+            }
+        }
+
+    // Logic triggers - none in use
+        for (int i=0; i<MAX_LOGIC_TRIGGERS; i++)
+        {
+            ramcopy.SF_Logic[i].ConditionA = 0;
+            ramcopy.SF_Logic[i].ConditionB = 0;
+            ramcopy.SF_Logic[i].Flags = 0;
+            ramcopy.SF_Logic[i].Hold_mS = 0;
+        }
         
     // 4 main motor drive types. We default motors to the OP Scout ESC and turret to onboard
         ramcopy.DriveMotors = OP_SCOUT;
@@ -556,6 +570,7 @@ void OP_EEPROM::Initialize_RAMcopy(void)
         ramcopy.SendTankID = false;                     // Default to not sending the tank ID
         ramcopy.TankID = 1;                             // Tank ID number, default to 1
         ramcopy.IR_Team = IR_TEAM_NONE;                 // Default to NO team (default protocol of Tamiya doesn't have teams)
+        LoadDamageProfile(TAMIYA_DAMAGE, &ramcopy.CustomDamageProfile);   // Custom damage profile starts out as a copy of the Tamiya one
 
     // Board settings
         ramcopy.USBSerialBaud = USB_BAUD_RATE;
@@ -564,6 +579,8 @@ void OP_EEPROM::Initialize_RAMcopy(void)
         ramcopy.Serial3TxBaud = DEFAULTBAUDRATE;
         ramcopy.LVC_Enabled = false;
         ramcopy.LVC_Cutoff_mV = 6400;
+        ramcopy.BatteryType = BATTERY_LIPO;
+        ramcopy.BatteryCells = 0;                       // Count them
 
     // Light settings
         ramcopy.RunningLightsAlwaysOn = false;
@@ -583,6 +600,7 @@ void OP_EEPROM::Initialize_RAMcopy(void)
 
     // Scout settings
         ramcopy.ScoutCurrentLimit = 12;                 // Default to 12 amps
+        ramcopy.ScoutTelemetry = false;                 // Default to off until released Scout firmware answers telemetry requests
 
     // Program settings
         ramcopy.PrintDebug = true;                      // Default to debugging on
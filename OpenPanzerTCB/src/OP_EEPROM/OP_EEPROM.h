@@ -31,9 +31,11 @@
 #include "../OP_Radio/OP_RadioDefines.h"
 #include "../OP_Sound/OP_Sound.h"
 #include "../OP_Motors/OP_Motors.h"
+#include "../OP_Battery/OP_Battery.h"
 #include "../OP_Smoker/OP_Smoker.h"
 #include "../OP_Driver/OP_Driver.h"
 #include "../OP_Settings/OP_Settings.h"
+#include "../OP_Format/OP_Format.h"
 #include "../EEPROMex/EEPROMex.h"   // We use the extended version, not Arduino's built-in EEPROM library. 
 // This one is important. It has the definition of our eeprom struct
 #include "OP_EEPROM_Struct.h"
@@ -49,7 +51,7 @@
 // In that case EEPROM data corruption WILL occur and the sketch will exhibit unstable behavior!
 // 
 
-    #define EEPROM_INIT             0x9BC8          // Modified with 00.94.04 on 02/03/2026
+    #define EEPROM_INIT             0x9BCD          // Modified with 00.94.04 on 10/19/2026
 //
 //
 //=======================================================================================================================================>>
@@ -31,6 +31,8 @@ struct _eeprom_data {
 
 // Special function triggers
     _functionTrigger SF_Trigger[MAX_FUNCTION_TRIGGERS]; // Info for each trigger, up to MAX_FUNCTION_TRIGGERS
+    _functionMacro SF_Macro[MAX_MACROS];                // User-defined sequences of functions, run with SF_MACRO1_RUN, etc.
+    _logicTrigger SF_Logic[MAX_LOGIC_TRIGGERS];         // Compound triggers made from two other triggers, see OP_FunctionsTriggers.h
 
 // 4 main motor drive types
     Drive_t DriveMotors;                       // (in fact a char)
@@ -176,6 +178,7 @@ struct _eeprom_data {
     boolean SendTankID;                        // Do we include the Tank ID in the cannon IR transmission
     uint16_t TankID;                           // Tank ID number  
     IRTEAMS IR_Team;                           // Does the tank belong to a team. Only applies to a few protocols.
+    damageProfile CustomDamageProfile;         // User custom damage profile, used when DamageProfile is CUSTOM_DAMAGE
 
 // Board settings
     uint32_t USBSerialBaud;                    // Hardware Serial 0
@@ -184,6 +187,8 @@ struct _eeprom_data {
     uint32_t Serial3TxBaud;                    // Hardware Serial 3. Tx only. And disabled completely if using SBus.
     boolean  LVC_Enabled;                      // Enable low-voltage cutoff 
     uint16_t LVC_Cutoff_mV;                    // Minimum voltage level (in millivolts)
+    uint8_t  BatteryType;                      // Chemistry of the drive battery, for the charge estimate. BATTERY_LIPO or BATTERY_NIMH (see OP_Battery.h)
+    uint8_t  BatteryCells;                     // Cells in series, or 0 to count them from the voltage (reliable for LiPo, a guess for NiMH)
         
 // Light settings
     boolean  RunningLightsAlwaysOn;            // If true, brake light output will always be on at the DIM level, unless braking, then it will bright. If false, user can turn this on/off with some input
@@ -203,6 +208,7 @@ struct _eeprom_data {
 
 // Scout Settings
     uint8_t  ScoutCurrentLimit;                // Accepts values from 1-30, represents current limit in Amps beyond which Scout will turn off motors.     
+    boolean  ScoutTelemetry;                   // If true, poll the Scout for current, temperature, voltage and faults. Off by default, see SCOUT_CMD_GET_TELEMETRY in OP_Scout.h
                 
 // Program setting
     boolean PrintDebug;                        // If true, TCB will print debugging messages out the DebugSerial serial port
@@ -8,7 +8,7 @@
 //=======================================================================================================================================>>
 // You must make sure this number equals the number of variables defined in the __eeprom_data struct (including the unused FirstVar)
 // 
-    #define NUM_STORED_VARS         334
+    #define NUM_STORED_VARS         465
 
 // THIS NUMBER CAN BE CALCULATED BY THE EXCEL REFERENCE SHEET - AS CAN THE ENTIRE PROGMEM STATEMENT BELOW
 // Don't bother trying to do it by hand!
@@ -246,144 +246,275 @@ const _storage_var_info STORAGEVARS[NUM_STORED_VARS] PROGMEM_FAR = {
     {1488, 283, varUINT8},        // SF_Trigger[38].specialFunction
     {1489, 284, varUINT16},        // SF_Trigger[39].TriggerID
     {1490, 286, varUINT8},        // SF_Trigger[39].specialFunction
-    {1611, 287, varUINT8},        // DriveMotors
-    {1612, 288, varUINT8},        // TurretRotationMotor
-    {1613, 289, varUINT8},        // TurretElevationMotor
-    {1811, 290, varINT16},        // TurretElevation_EPMin
-    {1812, 292, varINT16},        // TurretElevation_EPMax
-    {1813, 294, varBOOL},        // TurretElevation_Reversed
-    {1814, 295, varUINT8},        // TurretElevation_MaxSpeedPct
-    {1815, 296, varUINT8},        // TurretRotation_MaxSpeedPct
-    {1816, 297, varINT16},        // TurretRotation_EPMin
-    {1817, 299, varINT16},        // TurretRotation_EPMax
-    {1818, 301, varBOOL},        // TurretRotation_Reversed
-    {1911, 302, varINT16},        // SteeringServo_EPMin
-    {1912, 304, varINT16},        // SteeringServo_EPMax
-    {1913, 306, varBOOL},        // SteeringServo_Reversed
-    {2011, 307, varBOOL},        // Airsoft
-    {2012, 308, varBOOL},        // MechanicalBarrelWithCannon
-    {2013, 309, varINT16},        // RecoilDelay
-    {2014, 311, varBOOL},        // RecoilReversed
-    {2015, 312, varBOOL},        // ServoRecoilWithCannon
-    {2016, 313, varINT16},        // RecoilServo_Recoil_mS
-    {2017, 315, varINT16},        // RecoilServo_Return_mS
-    {2018, 317, varINT16},        // RecoilServo_EPMin
-    {2019, 319, varINT16},        // RecoilServo_EPMax
-    {2020, 321, varUINT8},        // RecoilServo_PresetNum
-    {2211, 322, varBOOL},        // SmokerControlAuto
-    {2212, 323, varINT16},        // SmokerIdleSpeed
-    {2213, 325, varINT16},        // SmokerFastIdleSpeed
-    {2214, 327, varINT16},        // SmokerMaxSpeed
-    {2215, 329, varINT16},        // SmokerDestroyedSpeed
-    {2216, 331, varUINT8},        // SmokerDeviceType
-    {2217, 332, varUINT8},        // SmokerPreHeat_Sec
-    {2218, 333, varINT16},        // SmokerHeatIdleAmt
-    {2219, 335, varINT16},        // SmokerHeatFastIdleAmt
-    {2220, 337, varINT16},        // SmokerHeatMaxAmt
-    {2221, 339, varUINT8},        // HotStartTimeout_Sec
-    {2411, 340, varBOOL},        // AccelRampEnabled_1
-    {2412, 341, varUINT8},        // AccelSkipNum_1
-    {2413, 342, varUINT8},        // AccelPreset_1
-    {2414, 343, varBOOL},        // DecelRampEnabled_1
-    {2415, 344, varUINT8},        // DecelSkipNum_1
-    {2416, 345, varUINT8},        // DecelPreset_1
-    {2417, 346, varBOOL},        // AccelRampEnabled_2
-    {2418, 347, varUINT8},        // AccelSkipNum_2
-    {2419, 348, varUINT8},        // AccelPreset_2
-    {2420, 349, varBOOL},        // DecelRampEnabled_2
-    {2421, 350, varUINT8},        // DecelSkipNum_2
-    {2422, 351, varUINT8},        // DecelPreset_2
-    {2423, 352, varUINT8},        // BrakeSensitivityPct
-    {2424, 353, varUINT16},        // TimeToShift_mS
-    {2425, 355, varUINT16},        // EnginePauseTime_mS
-    {2426, 357, varUINT16},        // TransmissionDelay_mS
-    {2427, 359, varBOOL},        // NeutralTurnAllowed
-    {2428, 360, varUINT8},        // NeutralTurnPct
-    {2429, 361, varUINT8},        // TurnMode
-    {2430, 362, varUINT8},        // DriveType
-    {2431, 363, varUINT8},        // MaxForwardSpeedPct
-    {2432, 364, varUINT8},        // MaxReverseSpeedPct
-    {2433, 365, varUINT8},        // HalftrackTreadTurnPct
-    {2434, 366, varBOOL},        // EngineAutoStart
-    {2435, 367, varINT32},        // EngineAutoStopTime_mS
-    {2436, 371, varUINT8},        // MotorNudgePct
-    {2437, 372, varUINT16},        // NudgeTime_mS
-    {2438, 374, varBOOL},        // DragInnerTrack
-    {2439, 375, varBOOL},        // EnableTrackRecoil
-    {2440, 376, varUINT8},        // TrackRecoilKickbackSpeed
-    {2441, 377, varUINT8},        // TrackRecoilDecelerateFactor
-    {2442, 378, varBOOL},        // EnableTrackRecoil_IRHit
-    {2511, 379, varBOOL},        // EnableBarrelStabilize
-    {2512, 380, varUINT8},        // BarrelSensitivity
-    {2513, 381, varBOOL},        // EnableHillPhysics
-    {2514, 382, varUINT8},        // HillSensitivity
-    {2711, 383, varINT16},        // IgnoreTurretDelay_mS
-    {2811, 385, varUINT8},        // SoundDevice
-    {2812, 386, varUINT16},        // Squeak1_MinInterval_mS
-    {2813, 388, varUINT16},        // Squeak1_MaxInterval_mS
-    {2814, 390, varUINT16},        // Squeak2_MinInterval_mS
-    {2815, 392, varUINT16},        // Squeak2_MaxInterval_mS
-    {2816, 394, varUINT16},        // Squeak3_MinInterval_mS
-    {2817, 396, varUINT16},        // Squeak3_MaxInterval_mS
-    {2818, 398, varBOOL},        // Squeak1_Enabled
-    {2819, 399, varBOOL},        // Squeak2_Enabled
-    {2820, 400, varBOOL},        // Squeak3_Enabled
-    {2821, 401, varUINT8},        // MinSqueakSpeed
-    {2822, 402, varBOOL},        // HeadlightSound_Enabled
-    {2823, 403, varBOOL},        // TurretSound_Enabled
-    {2824, 404, varBOOL},        // BarrelSound_Enabled
-    {2825, 405, varUINT16},        // Squeak4_MinInterval_mS
-    {2826, 407, varUINT16},        // Squeak4_MaxInterval_mS
-    {2827, 409, varUINT16},        // Squeak5_MinInterval_mS
-    {2828, 411, varUINT16},        // Squeak5_MaxInterval_mS
-    {2829, 413, varUINT16},        // Squeak6_MinInterval_mS
-    {2830, 415, varUINT16},        // Squeak6_MaxInterval_mS
-    {2831, 417, varBOOL},        // Squeak4_Enabled
-    {2832, 418, varBOOL},        // Squeak5_Enabled
-    {2833, 419, varBOOL},        // Squeak6_Enabled
-    {2834, 420, varUINT8},        // VolumeEngine
-    {2835, 421, varUINT8},        // VolumeTrackOverlay
-    {2836, 422, varUINT8},        // VolumeEffects
-    {2837, 423, varBOOL},        // HeadlightSound2_Enabled
-    {2838, 424, varBOOL},        // SoundBankA_Loop
-    {2839, 425, varBOOL},        // SoundBankB_Loop
-    {3011, 426, varUINT8},        // IR_FireProtocol
-    {3012, 427, varUINT8},        // IR_HitProtocol_2
-    {3013, 428, varUINT8},        // IR_RepairProtocol
-    {3014, 429, varUINT8},        // IR_MGProtocol
-    {3015, 430, varBOOL},        // Use_MG_Protocol
-    {3016, 431, varBOOL},        // Accept_MG_Damage
-    {3017, 432, varUINT8},        // DamageProfile
-    {3018, 433, varUINT16},        // CustomClassSettings.reloadTime
-    {3019, 435, varUINT16},        // CustomClassSettings.recoveryTime
-    {3020, 437, varUINT8},        // CustomClassSettings.maxHits
-    {3021, 438, varUINT8},        // CustomClassSettings.maxMGHits
-    {3022, 439, varBOOL},        // SendTankID
-    {3023, 440, varUINT16},        // TankID
-    {3024, 442, varUINT8},        // IR_Team
-    {3211, 443, varUINT32},        // USBSerialBaud
-    {3212, 447, varUINT32},        // AuxSerialBaud
-    {3213, 451, varUINT32},        // MotorSerialBaud
-    {3214, 455, varUINT32},        // Serial3TxBaud
-    {3215, 459, varBOOL},        // LVC_Enabled
-    {3216, 460, varUINT16},        // LVC_Cutoff_mV
-    {3411, 462, varBOOL},        // RunningLightsAlwaysOn
-    {3412, 463, varUINT8},        // RunningLightsDimLevelPct
-    {3413, 464, varBOOL},        // BrakesAutoOnAtStop
-    {3414, 465, varUINT16},        // AuxLightFlashTime_mS
-    {3415, 467, varUINT16},        // AuxLightBlinkOnTime_mS
-    {3416, 469, varUINT16},        // AuxLightBlinkOffTime_mS
-    {3417, 471, varUINT8},        // AuxLightPresetDim
-    {3418, 472, varUINT8},        // MGLightBlink_mS
-    {3419, 473, varBOOL},        // FlashLightsWhenSignalLost
-    {3420, 474, varBOOL},        // HiFlashWithCannon
-    {3421, 475, varBOOL},        // AuxFlashWithCannon
-    {3422, 476, varUINT8},        // SecondMGLightBlink_mS
-    {3423, 477, varBOOL},        // CannonReloadBlink
-    {3424, 478, varBOOL},        // FlickerLightsOnEngineStart
-    {3611, 479, varUINT8},        // ScoutCurrentLimit
-    {9011, 480, varBOOL},        // PrintDebug
-    {9999, 481, varUINT32}        // InitStamp
+    {1511, 287, varUINT8},        // SF_Macro[0].Step[0].Function
+    {1512, 288, varUINT16},        // SF_Macro[0].Step[0].Value
+    {1513, 290, varUINT16},        // SF_Macro[0].Step[0].Delay_mS
+    {1514, 292, varUINT8},        // SF_Macro[0].Step[1].Function
+    {1515, 293, varUINT16},        // SF_Macro[0].Step[1].Value
+    {1516, 295, varUINT16},        // SF_Macro[0].Step[1].Delay_mS
+    {1517, 297, varUINT8},        // SF_Macro[0].Step[2].Function
+    {1518, 298, varUINT16},        // SF_Macro[0].Step[2].Value
+    {1519, 300, varUINT16},        // SF_Macro[0].Step[2].Delay_mS
+    {1520, 302, varUINT8},        // SF_Macro[0].Step[3].Function
+    {1521, 303, varUINT16},        // SF_Macro[0].Step[3].Value
+    {1522, 305, varUINT16},        // SF_Macro[0].Step[3].Delay_mS
+    {1523, 307, varUINT8},        // SF_Macro[0].Step[4].Function
+    {1524, 308, varUINT16},        // SF_Macro[0].Step[4].Value
+    {1525, 310, varUINT16},        // SF_Macro[0].Step[4].Delay_mS
+    {1526, 312, varUINT8},        // SF_Macro[0].Step[5].Function
+    {1527, 313, varUINT16},        // SF_Macro[0].Step[5].Value
+    {1528, 315, varUINT16},        // SF_Macro[0].Step[5].Delay_mS
+    {1529, 317, varUINT8},        // SF_Macro[1].Step[0].Function
+    {1530, 318, varUINT16},        // SF_Macro[1].Step[0].Value
+    {1531, 320, varUINT16},        // SF_Macro[1].Step[0].Delay_mS
+    {1532, 322, varUINT8},        // SF_Macro[1].Step[1].Function
+    {1533, 323, varUINT16},        // SF_Macro[1].Step[1].Value
+    {1534, 325, varUINT16},        // SF_Macro[1].Step[1].Delay_mS
+    {1535, 327, varUINT8},        // SF_Macro[1].Step[2].Function
+    {1536, 328, varUINT16},        // SF_Macro[1].Step[2].Value
+    {1537, 330, varUINT16},        // SF_Macro[1].Step[2].Delay_mS
+    {1538, 332, varUINT8},        // SF_Macro[1].Step[3].Function
+    {1539, 333, varUINT16},        // SF_Macro[1].Step[3].Value
+    {1540, 335, varUINT16},        // SF_Macro[1].Step[3].Delay_mS
+    {1541, 337, varUINT8},        // SF_Macro[1].Step[4].Function
+    {1542, 338, varUINT16},        // SF_Macro[1].Step[4].Value
+    {1543, 340, varUINT16},        // SF_Macro[1].Step[4].Delay_mS
+    {1544, 342, varUINT8},        // SF_Macro[1].Step[5].Function
+    {1545, 343, varUINT16},        // SF_Macro[1].Step[5].Value
+    {1546, 345, varUINT16},        // SF_Macro[1].Step[5].Delay_mS
+    {1547, 347, varUINT8},        // SF_Macro[2].Step[0].Function
+    {1548, 348, varUINT16},        // SF_Macro[2].Step[0].Value
+    {1549, 350, varUINT16},        // SF_Macro[2].Step[0].Delay_mS
+    {1550, 352, varUINT8},        // SF_Macro[2].Step[1].Function
+    {1551, 353, varUINT16},        // SF_Macro[2].Step[1].Value
+    {1552, 355, varUINT16},        // SF_Macro[2].Step[1].Delay_mS
+    {1553, 357, varUINT8},        // SF_Macro[2].Step[2].Function
+    {1554, 358, varUINT16},        // SF_Macro[2].Step[2].Value
+    {1555, 360, varUINT16},        // SF_Macro[2].Step[2].Delay_mS
+    {1556, 362, varUINT8},        // SF_Macro[2].Step[3].Function
+    {1557, 363, varUINT16},        // SF_Macro[2].Step[3].Value
+    {1558, 365, varUINT16},        // SF_Macro[2].Step[3].Delay_mS
+    {1559, 367, varUINT8},        // SF_Macro[2].Step[4].Function
+    {1560, 368, varUINT16},        // SF_Macro[2].Step[4].Value
+    {1561, 370, varUINT16},        // SF_Macro[2].Step[4].Delay_mS
+    {1562, 372, varUINT8},        // SF_Macro[2].Step[5].Function
+    {1563, 373, varUINT16},        // SF_Macro[2].Step[5].Value
+    {1564, 375, varUINT16},        // SF_Macro[2].Step[5].Delay_mS
+    {1565, 377, varUINT8},        // SF_Macro[3].Step[0].Function
+    {1566, 378, varUINT16},        // SF_Macro[3].Step[0].Value
+    {1567, 380, varUINT16},        // SF_Macro[3].Step[0].Delay_mS
+    {1568, 382, varUINT8},        // SF_Macro[3].Step[1].Function
+    {1569, 383, varUINT16},        // SF_Macro[3].Step[1].Value
+    {1570, 385, varUINT16},        // SF_Macro[3].Step[1].Delay_mS
+    {1571, 387, varUINT8},        // SF_Macro[3].Step[2].Function
+    {1572, 388, varUINT16},        // SF_Macro[3].Step[2].Value
+    {1573, 390, varUINT16},        // SF_Macro[3].Step[2].Delay_mS
+    {1574, 392, varUINT8},        // SF_Macro[3].Step[3].Function
+    {1575, 393, varUINT16},        // SF_Macro[3].Step[3].Value
+    {1576, 395, varUINT16},        // SF_Macro[3].Step[3].Delay_mS
+    {1577, 397, varUINT8},        // SF_Macro[3].Step[4].Function
+    {1578, 398, varUINT16},        // SF_Macro[3].Step[4].Value
+    {1579, 400, varUINT16},        // SF_Macro[3].Step[4].Delay_mS
+    {1580, 402, varUINT8},        // SF_Macro[3].Step[5].Function
+    {1581, 403, varUINT16},        // SF_Macro[3].Step[5].Value
+    {1582, 405, varUINT16},        // SF_Macro[3].Step[5].Delay_mS
+    {1711, 407, varUINT16},        // SF_Logic[0].ConditionA
+    {1712, 409, varUINT16},        // SF_Logic[0].ConditionB
+    {1713, 411, varUINT8},        // SF_Logic[0].Flags
+    {1714, 412, varUINT16},        // SF_Logic[0].Hold_mS
+    {1715, 414, varUINT16},        // SF_Logic[1].ConditionA
+    {1716, 416, varUINT16},        // SF_Logic[1].ConditionB
+    {1717, 418, varUINT8},        // SF_Logic[1].Flags
+    {1718, 419, varUINT16},        // SF_Logic[1].Hold_mS
+    {1719, 421, varUINT16},        // SF_Logic[2].ConditionA
+    {1720, 423, varUINT16},        // SF_Logic[2].ConditionB
+    {1721, 425, varUINT8},        // SF_Logic[2].Flags
+    {1722, 426, varUINT16},        // SF_Logic[2].Hold_mS
+    {1723, 428, varUINT16},        // SF_Logic[3].ConditionA
+    {1724, 430, varUINT16},        // SF_Logic[3].ConditionB
+    {1725, 432, varUINT8},        // SF_Logic[3].Flags
+    {1726, 433, varUINT16},        // SF_Logic[3].Hold_mS
+    {1727, 435, varUINT16},        // SF_Logic[4].ConditionA
+    {1728, 437, varUINT16},        // SF_Logic[4].ConditionB
+    {1729, 439, varUINT8},        // SF_Logic[4].Flags
+    {1730, 440, varUINT16},        // SF_Logic[4].Hold_mS
+    {1731, 442, varUINT16},        // SF_Logic[5].ConditionA
+    {1732, 444, varUINT16},        // SF_Logic[5].ConditionB
+    {1733, 446, varUINT8},        // SF_Logic[5].Flags
+    {1734, 447, varUINT16},        // SF_Logic[5].Hold_mS
+    {1735, 449, varUINT16},        // SF_Logic[6].ConditionA
+    {1736, 451, varUINT16},        // SF_Logic[6].ConditionB
+    {1737, 453, varUINT8},        // SF_Logic[6].Flags
+    {1738, 454, varUINT16},        // SF_Logic[6].Hold_mS
+    {1739, 456, varUINT16},        // SF_Logic[7].ConditionA
+    {1740, 458, varUINT16},        // SF_Logic[7].ConditionB
+    {1741, 460, varUINT8},        // SF_Logic[7].Flags
+    {1742, 461, varUINT16},        // SF_Logic[7].Hold_mS
+    {1611, 463, varUINT8},        // DriveMotors
+    {1612, 464, varUINT8},        // TurretRotationMotor
+    {1613, 465, varUINT8},        // TurretElevationMotor
+    {1811, 466, varINT16},        // TurretElevation_EPMin
+    {1812, 468, varINT16},        // TurretElevation_EPMax
+    {1813, 470, varBOOL},        // TurretElevation_Reversed
+    {1814, 471, varUINT8},        // TurretElevation_MaxSpeedPct
+    {1815, 472, varUINT8},        // TurretRotation_MaxSpeedPct
+    {1816, 473, varINT16},        // TurretRotation_EPMin
+    {1817, 475, varINT16},        // TurretRotation_EPMax
+    {1818, 477, varBOOL},        // TurretRotation_Reversed
+    {1911, 478, varINT16},        // SteeringServo_EPMin
+    {1912, 480, varINT16},        // SteeringServo_EPMax
+    {1913, 482, varBOOL},        // SteeringServo_Reversed
+    {2011, 483, varBOOL},        // Airsoft
+    {2012, 484, varBOOL},        // MechanicalBarrelWithCannon
+    {2013, 485, varINT16},        // RecoilDelay
+    {2014, 487, varBOOL},        // RecoilReversed
+    {2015, 488, varBOOL},        // ServoRecoilWithCannon
+    {2016, 489, varINT16},        // RecoilServo_Recoil_mS
+    {2017, 491, varINT16},        // RecoilServo_Return_mS
+    {2018, 493, varINT16},        // RecoilServo_EPMin
+    {2019, 495, varINT16},        // RecoilServo_EPMax
+    {2020, 497, varUINT8},        // RecoilServo_PresetNum
+    {2211, 498, varBOOL},        // SmokerControlAuto
+    {2212, 499, varINT16},        // SmokerIdleSpeed
+    {2213, 501, varINT16},        // SmokerFastIdleSpeed
+    {2214, 503, varINT16},        // SmokerMaxSpeed
+    {2215, 505, varINT16},        // SmokerDestroyedSpeed
+    {2216, 507, varUINT8},        // SmokerDeviceType
+    {2217, 508, varUINT8},        // SmokerPreHeat_Sec
+    {2218, 509, varINT16},        // SmokerHeatIdleAmt
+    {2219, 511, varINT16},        // SmokerHeatFastIdleAmt
+    {2220, 513, varINT16},        // SmokerHeatMaxAmt
+    {2221, 515, varUINT8},        // HotStartTimeout_Sec
+    {2411, 516, varBOOL},        // AccelRampEnabled_1
+    {2412, 517, varUINT8},        // AccelSkipNum_1
+    {2413, 518, varUINT8},        // AccelPreset_1
+    {2414, 519, varBOOL},        // DecelRampEnabled_1
+    {2415, 520, varUINT8},        // DecelSkipNum_1
+    {2416, 521, varUINT8},        // DecelPreset_1
+    {2417, 522, varBOOL},        // AccelRampEnabled_2
+    {2418, 523, varUINT8},        // AccelSkipNum_2
+    {2419, 524, varUINT8},        // AccelPreset_2
+    {2420, 525, varBOOL},        // DecelRampEnabled_2
+    {2421, 526, varUINT8},        // DecelSkipNum_2
+    {2422, 527, varUINT8},        // DecelPreset_2
+    {2423, 528, varUINT8},        // BrakeSensitivityPct
+    {2424, 529, varUINT16},        // TimeToShift_mS
+    {2425, 531, varUINT16},        // EnginePauseTime_mS
+    {2426, 533, varUINT16},        // TransmissionDelay_mS
+    {2427, 535, varBOOL},        // NeutralTurnAllowed
+    {2428, 536, varUINT8},        // NeutralTurnPct
+    {2429, 537, varUINT8},        // TurnMode
+    {2430, 538, varUINT8},        // DriveType
+    {2431, 539, varUINT8},        // MaxForwardSpeedPct
+    {2432, 540, varUINT8},        // MaxReverseSpeedPct
+    {2433, 541, varUINT8},        // HalftrackTreadTurnPct
+    {2434, 542, varBOOL},        // EngineAutoStart
+    {2435, 543, varINT32},        // EngineAutoStopTime_mS
+    {2436, 547, varUINT8},        // MotorNudgePct
+    {2437, 548, varUINT16},        // NudgeTime_mS
+    {2438, 550, varBOOL},        // DragInnerTrack
+    {2439, 551, varBOOL},        // EnableTrackRecoil
+    {2440, 552, varUINT8},        // TrackRecoilKickbackSpeed
+    {2441, 553, varUINT8},        // TrackRecoilDecelerateFactor
+    {2442, 554, varBOOL},        // EnableTrackRecoil_IRHit
+    {2511, 555, varBOOL},        // EnableBarrelStabilize
+    {2512, 556, varUINT8},        // BarrelSensitivity
+    {2513, 557, varBOOL},        // EnableHillPhysics
+    {2514, 558, varUINT8},        // HillSensitivity
+    {2711, 559, varINT16},        // IgnoreTurretDelay_mS
+    {2811, 561, varUINT8},        // SoundDevice
+    {2812, 562, varUINT16},        // Squeak1_MinInterval_mS
+    {2813, 564, varUINT16},        // Squeak1_MaxInterval_mS
+    {2814, 566, varUINT16},        // Squeak2_MinInterval_mS
+    {2815, 568, varUINT16},        // Squeak2_MaxInterval_mS
+    {2816, 570, varUINT16},        // Squeak3_MinInterval_mS
+    {2817, 572, varUINT16},        // Squeak3_MaxInterval_mS
+    {2818, 574, varBOOL},        // Squeak1_Enabled
+    {2819, 575, varBOOL},        // Squeak2_Enabled
+    {2820, 576, varBOOL},        // Squeak3_Enabled
+    {2821, 577, varUINT8},        // MinSqueakSpeed
+    {2822, 578, varBOOL},        // HeadlightSound_Enabled
+    {2823, 579, varBOOL},        // TurretSound_Enabled
+    {2824, 580, varBOOL},        // BarrelSound_Enabled
+    {2825, 581, varUINT16},        // Squeak4_MinInterval_mS
+    {2826, 583, varUINT16},        // Squeak4_MaxInterval_mS
+    {2827, 585, varUINT16},        // Squeak5_MinInterval_mS
+    {2828, 587, varUINT16},        // Squeak5_MaxInterval_mS
+    {2829, 589, varUINT16},        // Squeak6_MinInterval_mS
+    {2830, 591, varUINT16},        // Squeak6_MaxInterval_mS
+    {2831, 593, varBOOL},        // Squeak4_Enabled
+    {2832, 594, varBOOL},        // Squeak5_Enabled
+    {2833, 595, varBOOL},        // Squeak6_Enabled
+    {2834, 596, varUINT8},        // VolumeEngine
+    {2835, 597, varUINT8},        // VolumeTrackOverlay
+    {2836, 598, varUINT8},        // VolumeEffects
+    {2837, 599, varBOOL},        // HeadlightSound2_Enabled
+    {2838, 600, varBOOL},        // SoundBankA_Loop
+    {2839, 601, varBOOL},        // SoundBankB_Loop
+    {3011, 602, varUINT8},        // IR_FireProtocol
+    {3012, 603, varUINT8},        // IR_HitProtocol_2
+    {3013, 604, varUINT8},        // IR_RepairProtocol
+    {3014, 605, varUINT8},        // IR_MGProtocol
+    {3015, 606, varBOOL},        // Use_MG_Protocol
+    {3016, 607, varBOOL},        // Accept_MG_Damage
+    {3017, 608, varUINT8},        // DamageProfile
+    {3018, 609, varUINT16},        // CustomClassSettings.reloadTime
+    {3019, 611, varUINT16},        // CustomClassSettings.recoveryTime
+    {3020, 613, varUINT8},        // CustomClassSettings.maxHits
+    {3021, 614, varUINT8},        // CustomClassSettings.maxMGHits
+    {3022, 615, varBOOL},        // SendTankID
+    {3023, 616, varUINT16},        // TankID
+    {3024, 618, varUINT8},        // IR_Team
+    {3025, 619, varUINT8},        // CustomDamageProfile.CannonHit
+    {3026, 620, varUINT8},        // CustomDamageProfile.MGHit
+    {3027, 621, varUINT8},        // CustomDamageProfile.TwoShotPct
+    {3028, 622, varUINT8},        // CustomDamageProfile.DestroyPct
+    {3029, 623, varUINT8},        // CustomDamageProfile.Repair
+    {3030, 624, varUINT8},        // CustomDamageProfile.RegenPct
+    {3031, 625, varUINT16},        // CustomDamageProfile.RegenInterval_S
+    {3032, 627, varUINT8},        // CustomDamageProfile.Flags
+    {3033, 628, varUINT8},        // CustomDamageProfile.Tier[0].AbovePct
+    {3034, 629, varUINT8},        // CustomDamageProfile.Tier[0].DriveCutPct
+    {3035, 630, varUINT8},        // CustomDamageProfile.Tier[0].RotationCutPct
+    {3036, 631, varUINT8},        // CustomDamageProfile.Tier[0].ElevationCutPct
+    {3037, 632, varUINT8},        // CustomDamageProfile.Tier[1].AbovePct
+    {3038, 633, varUINT8},        // CustomDamageProfile.Tier[1].DriveCutPct
+    {3039, 634, varUINT8},        // CustomDamageProfile.Tier[1].RotationCutPct
+    {3040, 635, varUINT8},        // CustomDamageProfile.Tier[1].ElevationCutPct
+    {3041, 636, varUINT8},        // CustomDamageProfile.Tier[2].AbovePct
+    {3042, 637, varUINT8},        // CustomDamageProfile.Tier[2].DriveCutPct
+    {3043, 638, varUINT8},        // CustomDamageProfile.Tier[2].RotationCutPct
+    {3044, 639, varUINT8},        // CustomDamageProfile.Tier[2].ElevationCutPct
+    {3045, 640, varUINT8},        // CustomDamageProfile.Tier[3].AbovePct
+    {3046, 641, varUINT8},        // CustomDamageProfile.Tier[3].DriveCutPct
+    {3047, 642, varUINT8},        // CustomDamageProfile.Tier[3].RotationCutPct
+    {3048, 643, varUINT8},        // CustomDamageProfile.Tier[3].ElevationCutPct
+    {3211, 644, varUINT32},        // USBSerialBaud
+    {3212, 648, varUINT32},        // AuxSerialBaud
+    {3213, 652, varUINT32},        // MotorSerialBaud
+    {3214, 656, varUINT32},        // Serial3TxBaud
+    {3215, 660, varBOOL},        // LVC_Enabled
+    {3216, 661, varUINT16},        // LVC_Cutoff_mV
+    {3217, 663, varUINT8},        // BatteryType
+    {3218, 664, varUINT8},        // BatteryCells
+    {3411, 665, varBOOL},        // RunningLightsAlwaysOn
+    {3412, 666, varUINT8},        // RunningLightsDimLevelPct
+    {3413, 667, varBOOL},        // BrakesAutoOnAtStop
+    {3414, 668, varUINT16},        // AuxLightFlashTime_mS
+    {3415, 670, varUINT16},        // AuxLightBlinkOnTime_mS
+    {3416, 672, varUINT16},        // AuxLightBlinkOffTime_mS
+    {3417, 674, varUINT8},        // AuxLightPresetDim
+    {3418, 675, varUINT8},        // MGLightBlink_mS
+    {3419, 676, varBOOL},        // FlashLightsWhenSignalLost
+    {3420, 677, varBOOL},        // HiFlashWithCannon
+    {3421, 678, varBOOL},        // AuxFlashWithCannon
+    {3422, 679, varUINT8},        // SecondMGLightBlink_mS
+    {3423, 680, varBOOL},        // CannonReloadBlink
+    {3424, 681, varBOOL},        // FlickerLightsOnEngineStart
+    {3611, 682, varUINT8},        // ScoutCurrentLimit
+    {3612, 683, varBOOL},        // ScoutTelemetry
+    {9011, 684, varBOOL},        // PrintDebug
+    {9999, 685, varUINT32}        // InitStamp
 };
 
 
@@ -36,7 +36,7 @@
 #define ANALOG_SPECFUNCTION_CENTER_VAL      511     // scale, it will need to be mapped to this range before it can control an analog function. 
 #define ANALOG_SPECFUNCTION_MIN_VAL         0
 
-const byte COUNT_SPECFUNCTIONS  = 166;   // Count of special functions. 
+const byte COUNT_SPECFUNCTIONS  = 171;   // Count of special functions. 
 
 // Each function has a number and an enum name. 
 // We don't want Arduino turning these into ints, so use " : byte" to keep the enum to bytes (chars)
@@ -207,34 +207,16 @@ enum _special_function : byte {
     SF_USER_SOUND_ALL_OFF = 162,    // 162
     SF_SMOKE_PREHEAT_ON = 163,      // 163
     SF_SMOKE_PREHEAT_OFF= 164,      // 164
-    SF_SMOKE_PREHEAT_TOGGLE = 165   // 165  
+    SF_SMOKE_PREHEAT_TOGGLE = 165,  // 165  
+    SF_MACRO1_RUN       = 166,      // 166  -- run a user-defined sequence of functions, see SF_Macro in the eeprom struct and the Macros tab of the sketch
+    SF_MACRO2_RUN       = 167,      // 167
+    SF_MACRO3_RUN       = 168,      // 168
+    SF_MACRO4_RUN       = 169,      // 169
+    SF_MACRO_STOP_ALL   = 170       // 170
 };
 
-// This is really kludgy, and it makes no difference to the running of the program, but we do use it
-// to help print the function triggers out the serial port. For each function trigger above, we create
-// an array with 1 in the slot if the function is digital, and 0 in the slot if the function is analog. 
-const boolean DigitalFunctionsTable[COUNT_SPECFUNCTIONS] PROGMEM_FAR =
-{
- 1,1,1,1,1,1,1,1,1,1,   // 0-9
- 1,1,1,1,1,1,1,1,1,1,   // 10-19
- 1,1,1,1,1,1,1,1,0,1,   // 20-29    28 analog
- 1,1,1,1,1,1,1,1,1,1,   // 30-39    
- 1,1,1,1,1,1,1,0,0,1,   // 40-49    47,48 analog
- 1,1,0,0,0,0,0,0,0,0,   // 50-59    52-59 analog
- 0,0,0,1,1,1,0,1,1,1,   // 60-69    60-62,66 analog
- 0,1,1,0,0,1,1,1,1,1,   // 70-79    70,73,74 analog
- 1,1,1,1,1,0,1,1,1,1,   // 80-89    85 analog
- 1,1,0,0,0,0,0,0,1,1,   // 90-99    92-97 analog    
- 1,1,1,1,1,1,1,1,1,1,   // 100-109  
- 1,1,1,1,1,1,1,1,1,1,   // 110-119
- 1,1,1,1,1,1,1,1,1,1,   // 120-129
- 1,1,1,1,1,1,1,1,1,1,   // 130-139
- 1,1,1,1,1,1,1,1,1,1,   // 140-149
- 1,1,1,1,1,1,1,1,1,1,   // 150-159
- 1,1,1,1,1,1            // 160-165
- };
-// This macro lets us pass a _special_function number and it will return 1 if the function is a digital function, 0 if analog
-#define isSpecialFunctionDigital(f) pgm_read_byte_far(pgm_get_far_address(DigitalFunctionsTable) + (uint32_t)f);
+// Whether each function is digital or analog, which callback it runs and what hardware it needs are all kept in one table, SpecialFunctionTable
+// on the SpecFunctions tab of the sketch, since that is where the callbacks are visible. See special_function_def below. 
 
 // Friendly names for each function, stored in PROGMEM. Used for printint out the serial port. 
 // The FUNCNAME_CHARS set to 41 means each string must be 40 chars or less (the compiler will "helpfully" null-terminate each string, which adds one extra byte). 
@@ -411,7 +393,12 @@ const char _FunctionNames_[COUNT_SPECFUNCTIONS][FUNCNAME_CHARS] PROGMEM_FAR =
     "User Sounds - Stop All",                    // 162
     "Smoker Preheat - Enable",                   // 163
     "Smoker Preheat - Disable",                  // 164
-    "Smoker Preheat - Toggle"                    // 165
+    "Smoker Preheat - Toggle",                   // 165
+    "Macro 1 - Run",                             // 166
+    "Macro 2 - Run",                             // 167
+    "Macro 3 - Run",                             // 168
+    "Macro 4 - Run",                             // 169
+    "Macros - Stop All"                          // 170
 };
 
 
@@ -432,7 +419,8 @@ const char _FunctionNames_[COUNT_SPECFUNCTIONS][FUNCNAME_CHARS] PROGMEM_FAR =
 // 20000 - 20999        20000 - 20090       Speed increase triggers (when speed rises above a certain level)
 // 21000 - 21999        21001 - 21100       Speed decrease triggers (when speed falls below a certain level)
 // 22000 - 22999        22001 - 22003       Variable (analog) triggers for throttle command (22001), engine speed (22002) and vehicle speed (22003).
-// 23000 - 65535                            Unallocated
+// 23000 - 23999        23000 - 23007       Logic triggers 1-8 (two other triggers combined, see below)
+// 24000 - 65535                            Unallocated
 
 // Some range definitions
 #define trigger_id_multiplier_ports         100         // External ports input trigger ID is defined as: (multipler_ports * port number) + 0/1 (off/on)
@@ -455,6 +443,8 @@ const char _FunctionNames_[COUNT_SPECFUNCTIONS][FUNCNAME_CHARS] PROGMEM_FAR =
 #define trigger_id_rotation_command         22005       // Variable trigger synchronous with turret rotation (stick position)
 #define trigger_id_elevation_command        22006       // Variable trigger synchronous with barrel elevation (stick position)
 
+#define trigger_id_logic_start              23000       // Trigger IDs for logic triggers (see below). Range FROM trigger_id_logic_start TO (trigger_id_logic_start + MAX_LOGIC_TRIGGERS - 1)
+
 
 // Function/Trigger Pair Definition
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------->>
@@ -469,6 +459,52 @@ typedef struct _functionTrigger
 };
 
 
+// Macros
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------->>
+// A macro is a short list of special functions that run one after another, each after its own delay. The whole list is started by a single trigger 
+// (SF_MACRO1_RUN, etc.), so compound effects like "flicker the lights, start the engine, then a burst of smoke" don't need a trigger for every step 
+// or a hand-written function. Macros are saved in EEPROM and run in the background from the Macros tab of the sketch. 
+#define MAX_MACROS          4               // Number of macros we can save
+#define MACRO_STEPS         6               // Maximum steps in each macro. A step with SF_NULL_FUNCTION ends the macro early. 
+
+typedef struct _macroStep
+{
+    _special_function Function;             // Function to run. Macro functions (SF_MACRO1_RUN, etc.) are skipped so a macro can't start itself. 
+    uint16_t Value;                         // Passed to the function. Analog functions expect 0-1023, digital functions ignore it.
+    uint16_t Delay_mS;                      // How long to wait after the previous step (or the start of the macro) before running this one
+};
+
+typedef struct _functionMacro
+{
+    _macroStep Step[MACRO_STEPS];
+};
+
+
+// Logic Triggers
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------->>
+// A logic trigger combines two on/off trigger IDs from the list above (turret stick positions, digital aux channel positions, digital I/O inputs, 
+// speed above/below a percent, and the ad-hoc events) with AND or OR, optionally inverting either one, and optionally requiring the result to 
+// stay true for a hold time. Function triggers use it like any other trigger, with Trigger ID (trigger_id_logic_start + logic trigger number). 
+// For example "aux 3 position 2 AND vehicle stopped for 2 seconds" is ConditionA = 3032, ConditionB = ADHOC_TRIGGER_VEHICLE_STOP, Hold_mS = 2000. 
+// Ad-hoc events that describe a state (engine running, moving forward/reverse or stopped, turning left/right or not, braking) count as true for as long 
+// as that state lasts, the others (cannon hit, cannon reloaded, vehicle destroyed, battery low) are only true at the moment they happen. 
+#define MAX_LOGIC_TRIGGERS  8               // Number of logic triggers we can save. Can't be more than 8, their run-time state is kept in byte-wide flags. 
+
+#define LOGIC_OR            0x01            // Combine the two conditions with OR. If not set they are combined with AND. 
+#define LOGIC_NOT_A         0x02            // Invert condition A
+#define LOGIC_NOT_B         0x04            // Invert condition B
+#define LOGIC_FIRE_ON_FALSE 0x08            // Fire when the result goes false instead of when it goes true
+#define LOGIC_FIRE_ON_BOTH  0x10            // Fire both when the result goes true and when it goes false
+
+typedef struct _logicTrigger
+{
+    uint16_t ConditionA;                    // Trigger ID of the first condition. 0 means this logic trigger isn't used. 
+    uint16_t ConditionB;                    // Trigger ID of the second condition, 0 to use condition A alone
+    uint8_t  Flags;                         // LOGIC_ flags above
+    uint16_t Hold_mS;                       // How long the result must stay true before it counts as true, 0 for no wait. Going false is always immediate. 
+};
+
+
 // Trigger Sources
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------->>
 // Trigger sources: these are not needed in TCB firmware but are used by OP Config, we keep a copy here for the fun of it. 
@@ -509,7 +545,7 @@ enum _trigger_source : byte {
     TS_ADHC_RIGHT_TURN,    // Ad-hoc - right turn started
     TS_ADHC_LEFT_TURN,     // Ad-hoc - left turn started
     TS_ADHC_NO_TURN,       // Ad-hoc - no turn
-    TS_ADHC_UNUSED_13,     // Ad-hoc - unused      
+    TS_ADHC_BATTERY_LOW,   // Ad-hoc - battery charge low
     TS_ADHC_UNUSED_14,     // Ad-hoc - unused      
     TS_ADHC_UNUSED_15,     // Ad-hoc - unused      
     TS_ADHC_UNUSED_16      // Ad-hoc - unused          
@@ -580,7 +616,7 @@ enum _trigger_source : byte {
 // But in time, who knows, we may think of new events that we want for triggers, so it's good to have a process to implement them. 
 
 // Count of active Ad-Hoc triggers
-#define COUNT_ADHOC_TRIGGERS            12          // This number can not get higher than 16 unless you want to change some methods in the sketch
+#define COUNT_ADHOC_TRIGGERS            13          // This number can not get higher than 16 unless you want to change some methods in the sketch
 
 // Ad-Hoc trigger Flag Masks
 // We don't anticipate needing many ad hoc trigger events. In the Sketch we will use a single 2-byte integer for 16 flags. The sketch sets the appropriate bit when an event occurs, 
@@ -597,6 +633,7 @@ enum _trigger_source : byte {
 #define ADHOCT_BIT_RIGHT_TURN           9           // Right turn begun
 #define ADHOCT_BIT_LEFT_TURN            10          // Left turn begun
 #define ADHOCT_BIT_NO_TURN              11          // Vehicle is no longer turning
+#define ADHOCT_BIT_BATTERY_LOW          12          // Estimated battery charge has dropped below BATTERY_LOW_PCT
 
 // Ad-Hoc trigger Triggger IDs 
 // The trigger IDs must start at trigger_id_adhoc_start and go up from there, but not exceed (trigger_id_adhoc_start + trigger_id_adhoc_range - 1)
@@ -613,7 +650,7 @@ enum _trigger_source : byte {
 #define ADHOC_TRIGGER_RIGHT_TURN        trigger_id_adhoc_start + ADHOCT_BIT_RIGHT_TURN          // Ad-Hoc Trigger ID 10 - right turn            19009
 #define ADHOC_TRIGGER_LEFT_TURN         trigger_id_adhoc_start + ADHOCT_BIT_LEFT_TURN           // Ad-Hoc Trigger ID 11 - left turn             19010
 #define ADHOC_TRIGGER_NO_TURN           trigger_id_adhoc_start + ADHOCT_BIT_NO_TURN             // Ad-Hoc Trigger ID 12 - no turn               19011
-//                                      19012                                                   // Ad-Hoc Trigger ID 13
+#define ADHOC_TRIGGER_BATTERY_LOW       trigger_id_adhoc_start + ADHOCT_BIT_BATTERY_LOW         // Ad-Hoc Trigger ID 13 - battery low           19012
 //                                      19013                                                   // Ad-Hoc Trigger ID 14
 //                                      19014                                                   // Ad-Hoc Trigger ID 15
 //                                      19015                                                   // Ad-Hoc Trigger ID 16
@@ -636,6 +673,22 @@ enum _trigger_source : byte {
 // but values passed must be scaled to that range and the function must be expecting that range. 
 typedef void(*void_FunctionPointer_uint16)(uint16_t);
 
+// One row of the special function table (SpecialFunctionTable on the SpecFunctions tab). There is one row for every _special_function, in enum order, 
+// so the row for a function can be found directly from its number instead of searching. 
+typedef struct {
+    _special_function           Function;       // Must equal the row number, checked at compile time by specialFunctionTableInOrder()
+    void_FunctionPointer_uint16 Callback;       // Function to run when the trigger occurs
+    boolean                     Digital;        // 1 if digital, 0 if analog (see the explanation at the top of this file)
+    uint8_t                     Requires;       // DEVCAP_ bits (OP_Devices.h) the board must have for this function to do anything, 0 if none
+} special_function_def;
+
+// Compile-time check that every row of the table is in its proper place. Together with a check on the size of the table this means no function 
+// can be left out, added twice, or put in the wrong order without the sketch failing to compile. 
+constexpr bool specialFunctionTableInOrder(const special_function_def * table, uint8_t count, uint8_t row = 0)
+{
+    return (row >= count) ? true : (table[row].Function == row && specialFunctionTableInOrder(table, count, row + 1));
+}
+
 
 
 
@@ -0,0 +1,77 @@
+/* OP_Format.cpp    Open Panzer Format - bounded number and text formatting into fixed char buffers
+ * Source:          openpanzer.org
+ * Authors:         Luke Middleton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "OP_Format.h"
+
+
+boolean OP_Format::appendInt(char *buf, uint8_t buffLen, uint8_t &len, int32_t val)
+{
+char num[FORMAT_NUMBER_BUFF];
+
+    ltoa(val, num, 10);
+    return appendStr(buf, buffLen, len, num);
+}
+
+boolean OP_Format::appendUInt(char *buf, uint8_t buffLen, uint8_t &len, uint32_t val)
+{
+char num[FORMAT_NUMBER_BUFF];
+
+    ultoa(val, num, 10);
+    return appendStr(buf, buffLen, len, num);
+}
+
+boolean OP_Format::appendChar(char *buf, uint8_t buffLen, uint8_t &len, char c)
+{
+    if (len + 1 >= buffLen) 
+    {
+        if (len < buffLen) buf[len] = '\0';
+        return false;
+    }
+    buf[len++] = c;
+    buf[len] = '\0';
+    return true;
+}
+
+boolean OP_Format::appendStr(char *buf, uint8_t buffLen, uint8_t &len, const char *str)
+{
+size_t n = strlen(str);                            // Not uint8_t, a string longer than 255 would wrap and look like it fits
+
+    if (len + n >= buffLen) 
+    {
+        if (len < buffLen) buf[len] = '\0';
+        return false;
+    }
+    memcpy(&buf[len], str, n + 1);                  // Includes the null
+    len += n;
+    return true;
+}
+
+boolean OP_Format::appendStr_P(char *buf, uint8_t buffLen, uint8_t &len, PGM_P str)
+{
+size_t n = strlen_P(str);
+
+    if (len + n >= buffLen) 
+    {
+        if (len < buffLen) buf[len] = '\0';
+        return false;
+    }
+    memcpy_P(&buf[len], str, n + 1);
+    len += n;
+    return true;
+}
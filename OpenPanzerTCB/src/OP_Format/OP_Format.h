@@ -0,0 +1,49 @@
+/* OP_Format.h      Open Panzer Format - bounded number and text formatting into fixed char buffers
+ * Source:          openpanzer.org
+ * Authors:         Luke Middleton
+ *
+ * These replace the Arduino String object wherever we build sentences or values for the serial port. String allocates from the heap 
+ * and reallocates every time it grows, and with only 8K of RAM a long session in OP Config could fragment the heap badly enough to crash. 
+ * Everything here works in a buffer the caller owns, usually on the stack. 
+ *
+ * Each append function adds to the end of buf, which is buffLen bytes long and presently holds len characters. If what we are adding fits 
+ * (along with the terminating null) it is added, len is updated and the function returns true. If it doesn't fit nothing is added and it returns false. 
+ * Either way buf is left null-terminated. 
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef OP_Format_h
+#define OP_Format_h
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+
+#define FORMAT_NUMBER_BUFF      12      // Longest number we can print is "-2147483648", plus the null
+
+
+class OP_Format
+{
+    public:
+        static boolean  appendInt(char *buf, uint8_t buffLen, uint8_t &len, int32_t val);      // Signed number in decimal
+        static boolean  appendUInt(char *buf, uint8_t buffLen, uint8_t &len, uint32_t val);    // Unsigned number in decimal
+        static boolean  appendChar(char *buf, uint8_t buffLen, uint8_t &len, char c);          // A single character, usually a delimiter
+        static boolean  appendStr(char *buf, uint8_t buffLen, uint8_t &len, const char *str);  // A string in RAM
+        static boolean  appendStr_P(char *buf, uint8_t buffLen, uint8_t &len, PGM_P str);      // A string in flash, eg PSTR("text")
+};
+
+
+#endif
@@ -44,6 +44,7 @@ decodeState_t           iBusDecode::State;                              // The c
 boolean                 iBusDecode::NewFrame;                           // Boolean variable to indicate a new complete PPM frame has arrived or been read. 
 uint8_t                 iBusDecode::frameCount;                         // 
 uint8_t                 iBusDecode::framesToDiscard;                    // How many frames to skip for every one read
+decoder_stats           iBusDecode::Stats;                              // Frame and error counters
 
 // Constructor
 iBusDecode::iBusDecode(){}
@@ -153,6 +154,7 @@ uint16_t temp;
         {   
             iBus_pointer = 0;                           // If there is a receive error, reset the frame
             State = FAILSAFE_state;                     // Set state to Failsafe
+            Stats.CRCErrors++;
         }
         else
         { 
@@ -177,6 +179,7 @@ uint16_t temp;
                     // reset the count and start looking for start byte again. 
                     iBus_pointer = 0 ;                  // Reset the frame
                     State = FAILSAFE_state;             // Set state to Failsafe
+                    Stats.FormatErrors++;
                 }
                 else                                    // Second byte
                 {                                       
@@ -214,9 +217,11 @@ uint16_t temp;
                             if (chksum != rxsum) 
                             {   // iBus signal failed
                                 State = FAILSAFE_state; 
+                                Stats.CRCErrors++;
                             }
                             else    // No iBus error, checksums match                        
                             {                       
+                                Stats.Frames++;
                                 if ( State == ACQUIRING_state)  
                                 {   // If we are in ACQUIRING_state we have been collecting channel data. We keep collecting until we have ACQUISITION count of frames under our belt.
                                     // We are only in Acquiring state once - when the program first boots. After that we will only be either READY or FAILSAFE
@@ -234,6 +239,7 @@ uint16_t temp;
                                 {
                                     // Set the new frame flag
                                     NewFrame = true;
+                                    Stats.FrameTime_uS = micros();          // Only frames we pass on are timed, the sketch measures latency and intervals from this
                                     
                                     // Convert iBus data to individual channel pulse-widths
                                     
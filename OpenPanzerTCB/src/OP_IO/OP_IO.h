@@ -36,6 +36,7 @@ typedef struct external_io{
     boolean inputActive;    // If input, hast his been assigned as a trigger to any function?
     uint16_t inputValue;    // If input, what is the analog reading (0-1023 if analog) or digital reading (0/1 if digital)
     boolean updated;        // If input, has the input value changed since last time? 
+    uint8_t adcChannel;     // If input, which OP_ADC channel is sampling it
     external_io_settings Settings;  // Settings
 };
 
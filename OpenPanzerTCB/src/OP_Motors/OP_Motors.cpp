@@ -83,30 +83,99 @@ void Motor::set_MaxSpeedPct(uint8_t max_pct)
 // ------------------------------------------------------------------------------------------------------------------>>
 // OPEN PANZER SCOUT ESC 
 // ------------------------------------------------------------------------------------------------------------------>>
+// Scout telemetry replies and Qik error bytes would arrive on the same receive line, and the Qik's carry no address. 
+// If there is a Scout on the port we leave its telemetry running and don't poll Qik errors. 
+static boolean ScoutTelemetryOnPort = false;
+
+// Baud Rates
+// The Scout always initializes to a baud rate of 38400. It can function at any baud rate up to 115200 but in order to command it to a different baud, we need to tell it 
+// to change and that message needs to go at 38400. Every Scout on the port has to be told, and the port is shared, so this is done once for all of them in the steps 
+// below, run from update() so nothing waits on it. The Serial Smoker does its own change in setup(), before these steps start. 
+#define SCOUTPORT_IDLE          0       // No Scout has asked yet
+#define SCOUTPORT_AT_38400      1       // Port switched to 38400, waiting for it to settle
+#define SCOUTPORT_SENT          2       // Baud commands sent, waiting for them to go out
+#define SCOUTPORT_SWITCHED      3       // Port switched to the desired rate, waiting for the Scouts to change too
+#define SCOUTPORT_READY         4
+#define SCOUTPORT_SETTLE_mS     20      
+#define SCOUTPORT_SEND_mS       5       // Two four-byte commands take about 2 mS at 38400
+static uint8_t  ScoutPortStep = SCOUTPORT_IDLE;
+static uint32_t ScoutPortStep_mS;
+static uint8_t  ScoutBaudAddresses = 0;         // Bit 0 address A, bit 1 address B
+
+// Serial controllers of other types may share the port, they must not send anything while it is temporarily at 38400
+static boolean MotorPortSettled(void) { return (ScoutPortStep == SCOUTPORT_IDLE || ScoutPortStep == SCOUTPORT_READY); }
+
+static byte ScoutBaudCode(uint32_t baud)
+{
+    switch (baud)
+    {
+        case 2400:   return SCOUT_BAUD_CODE_2400;
+        case 9600:   return SCOUT_BAUD_CODE_9600;
+        case 19200:  return SCOUT_BAUD_CODE_19200;
+        case 57600:  return SCOUT_BAUD_CODE_57600;
+        case 115200: return SCOUT_BAUD_CODE_115200;
+        default:     return 0;                      // 38400 (which the Scout already booted to) or something it can't do
+    }
+}
+
+void OPScout_SerialESC::portStep(uint32_t baud)
+{
+    uint32_t now = millis();
+    switch (ScoutPortStep)
+    {
+        case SCOUTPORT_IDLE:
+            if (baud == 38400) { ScoutPortStep = SCOUTPORT_READY; break; }      // The Scout already booted to that, so no change is needed
+            MotorSerial.begin(38400);       // Temporarily change serial motor baud rate on the TCB to 38400, so we can communicate with the Scout.
+            ScoutPortStep_mS = now;
+            ScoutPortStep = SCOUTPORT_AT_38400;
+            break;
+
+        case SCOUTPORT_AT_38400:
+            if (now - ScoutPortStep_mS < SCOUTPORT_SETTLE_mS) break;
+            if (ScoutBaudCode(baud))        // Now at a rate of 38400, tell each Scout what baud rate we want it to actually go to. 
+            {
+                for (uint8_t i = 0; i < SCOUT_MAX_BOARDS; i++)
+                {
+                    if (bitRead(ScoutBaudAddresses, i)) OP_Scout(SCOUT_ADDRESS_A + i, &MotorSerial).command(SCOUT_CMD_BAUD_RATE, ScoutBaudCode(baud));
+                }
+            }
+            ScoutPortStep_mS = now;
+            ScoutPortStep = SCOUTPORT_SENT;
+            break;
+
+        case SCOUTPORT_SENT:
+            if (now - ScoutPortStep_mS < SCOUTPORT_SEND_mS) break;
+            MotorSerial.begin(baud);        // Now return the TCB to our originally-desired baud rate (which the Scouts should also have switched to)
+            ScoutPortStep_mS = now;
+            ScoutPortStep = SCOUTPORT_SWITCHED;
+            break;
+
+        case SCOUTPORT_SWITCHED:
+            if (now - ScoutPortStep_mS < SCOUTPORT_SETTLE_mS) break;    // Give the Scouts time to change rates
+            ScoutPortStep = SCOUTPORT_READY;
+            break;
+    }
+}
+
 void OPScout_SerialESC::begin(void)
 {
     // Initialize motor serial
+    // Nothing is sent yet, see startup(). Until then the Scout refuses any speed but zero. 
+    ready = false;
+    if (address() >= SCOUT_ADDRESS_A && address() < SCOUT_ADDRESS_A + SCOUT_MAX_BOARDS) bitSet(ScoutBaudAddresses, address() - SCOUT_ADDRESS_A);
 
-    // Baud Rates
-    // The Scout always initializes to a baud rate of 38400. It can function at any baud rate up to 115200 but in order to command it to a different baud, we need to tell it 
-    // to change and that message needs to go at 38400. 
-    if (*motorbaud != 38400)            // If the desired rate is 38400 we know the Scout already booted to that, so no change is needed. Otherwise proceed. 
-    {
-        MotorSerial.begin(38400);       // Temporarily change serial motor baud rate on the TCB to 38400, so we can communicate with the Scout.
-        delay(20);
-        switch (*motorbaud)             // Now at a rate of 38400, tell the Scout what baud rate we want it to actually go to. 
-        {
-            case 2400:   OPScout_SerialESC::command(SCOUT_CMD_BAUD_RATE,SCOUT_BAUD_CODE_2400);   break;
-            case 9600:   OPScout_SerialESC::command(SCOUT_CMD_BAUD_RATE,SCOUT_BAUD_CODE_9600);   break;
-            case 19200:  OPScout_SerialESC::command(SCOUT_CMD_BAUD_RATE,SCOUT_BAUD_CODE_19200);  break;
-          //case 38400:  OPScout_SerialESC::command(SCOUT_CMD_BAUD_RATE,SCOUT_BAUD_CODE_38400);  break; // This case is unnecessary because we already checked above to make see if the baud was anything but 38400
-            case 57600:  OPScout_SerialESC::command(SCOUT_CMD_BAUD_RATE,SCOUT_BAUD_CODE_57600);  break;
-            case 115200: OPScout_SerialESC::command(SCOUT_CMD_BAUD_RATE,SCOUT_BAUD_CODE_115200); break;
-        }
-        MotorSerial.flush();            // Wait for transmission to complete
-        MotorSerial.begin(*motorbaud);  // Now return the TCB to our originally-desired baud rate (which the Scout should also have switched to)
-        delay(20);                      // Give the Scout time to change rates
-    }                                   // We can now proceed at the new rate and the Scout should be on the same page
+    // Set the internal speed range (min, max). The Scout accepts speed commands from -127 to 127 with a middle point of 0
+    set_InternalRange(-127,127, 0);
+    set_DefaultInternalRange(-127,127, 0);
+
+    ScoutTelemetryOnPort = true;
+}
+
+void OPScout_SerialESC::startup(void)
+{
+    // Get the port to the right baud rate first
+    portStep(*motorbaud);
+    if (ScoutPortStep != SCOUTPORT_READY) return;
 
     // SerialWatchdog 
     // We want to enable the serial timeout feature on the Scout. The function for converting watchdog time to command data is Value = desired time in mS / 100 
@@ -124,18 +193,31 @@ void OPScout_SerialESC::begin(void)
     // The Scout has an adjustable current limit from 1 to 30 amps, pass the desired value here
     OPScout_SerialESC::SetMaxCurrent(currentLimit);
 
-    // Set the internal speed range (min, max). The Scout accepts speed commands from -127 to 127 with a middle point of 0
-    set_InternalRange(-127,127, 0);
-    set_DefaultInternalRange(-127,127, 0);
+    // Start asking the Scout for current, temperature, voltage and faults, if the user has turned that on. It is off by default because no released 
+    // Scout firmware answers yet (see SCOUT_CMD_GET_TELEMETRY in OP_Scout.h). If its firmware doesn't answer we soon stop asking, and nothing else changes. 
+    // Left off, the port is never read, getTelemetry always returns false, and the derating, the Scout load in LVC and PCCMD_READ_SCOUT all sit idle. 
+    if (telemetry) OPScout_SerialESC::enableTelemetry();
+
+    ready = true;
+    OPScout_SerialESC::setSpeed(0);
 }
 
 void OPScout_SerialESC::setSpeed(int s)
 {
+    // Nothing but stopped until the Scout is ready, and we don't send anything until then either
+    if (!ready) { curspeed = 0; return; }
+
+    // If this is a new stop, send it once more shortly (see SerialStop_Repeat_mS in OP_Settings.h)
+    if (s == 0 && curspeed != 0) stopRepeat = true;
+
     // save current speed
     curspeed = s;
     
     // make sure we are using the internal range
     s = map_Range(s);
+
+    // Back off if the Scout is getting hot
+    s = (int)(((long)s * deratePct()) / 100);
     
     if (ESC_Position == SIDEA)
     {   //SIDEA - Shown as "M1" on the Scout board
@@ -153,25 +235,53 @@ void OPScout_SerialESC::setSpeed(int s)
 
 void OPScout_SerialESC::stop(void)
 {
+    if (!ready) { curspeed = 0; return; }
+    if (curspeed != 0) stopRepeat = true;
     curspeed = 0;
     OPScout_SerialESC::allStop();
     LastUpdate_mS = millis();           // Save the time
 }
 
 void OPScout_SerialESC::update(void)
-{   // MotorSignal_Repeat_mS is defined in OP_Settings.h
-    if (millis() - LastUpdate_mS > MotorSignal_Repeat_mS)
+{   
+    if (!ready) { startup(); return; }
+
+    // Read any telemetry reply that has arrived and ask for the next item when it's time. This never waits on the port. 
+    OP_Scout::pollTelemetry();
+
+    // Not every Scout answers telemetry, so we can't count on hearing about a lost stop. Send it twice. 
+    if (stopRepeat && millis() - LastUpdate_mS > SerialStop_Repeat_mS)
+    {
+        stopRepeat = false;
+        OPScout_SerialESC::setSpeed(curspeed);
+    }
+    // MotorSignal_Repeat_mS is defined in OP_Settings.h
+    // The repeat also applies any change in derating while the speed command is held steady
+    else if (millis() - LastUpdate_mS > MotorSignal_Repeat_mS)
     {
         OPScout_SerialESC::setSpeed(curspeed);
     }
 }
 
+uint8_t OPScout_SerialESC::deratePct(void)
+{
+scout_telemetry t;
+
+    if (!OPScout_SerialESC::getTelemetry(t)) return 100;
+    if (t.Faults & SCOUT_FAULT_OVERTEMP)      return OPScout_DerateMin_Pct;
+    if (t.Temperature_C <= OPScout_DerateStart_C) return 100;
+    if (t.Temperature_C >= OPScout_DerateFull_C)  return OPScout_DerateMin_Pct;
+    return 100 - (uint8_t)(((long)(t.Temperature_C - OPScout_DerateStart_C) * (100 - OPScout_DerateMin_Pct)) / (OPScout_DerateFull_C - OPScout_DerateStart_C));
+}
+
 
 
 // ------------------------------------------------------------------------------------------------------------------>>
 // DIMENSION ENGINEERING SABERTOOTH CONTROLLERS
 // ------------------------------------------------------------------------------------------------------------------>>
 boolean Sabertooth_SerialESC::sentAutobaud = false;     // Declare static variables globally
+boolean Sabertooth_SerialESC::sentReautobaud = false;
+uint32_t Sabertooth_SerialESC::autobaud_mS;
 
 void Sabertooth_SerialESC::begin(void)
 {
@@ -183,14 +293,8 @@ void Sabertooth_SerialESC::begin(void)
     // 9600 is the default baud rate for Sabertooth packet serial for all their products, however, it does not work well with Arduino! 
     // 38400 works fine in testing. 19200 may also work but faster is better. 
     // For purposes of Open Panzer, 38400 is the recommended baud rate (for all serial controllers).
-        if (!sentAutobaud)  // We might have multiple Sabertooth objects, but we only need to do this part once. 
-        {
-            Sabertooth_SerialESC::autobaud(true);   // This will ONLY take care of Sabertooth 2x5, 2x10, and 2x25 V1 devices. 
-            sentAutobaud = true;                    // For those with Sabertooth 2x12, 2x25 V2, or 2x60 the baud rate must be set (once) using the utility provided on the Misc tab of OP Config. 
-        }
-
-    // Some Sabertooth devices have the option of a serial timeout watchdog, which we enable (2x12, 2x25 V2, 2x32, or 2x60). If we are connected to 2x5 this command will have no effect.
-    Sabertooth_SerialESC::command(SABERTOOTH_CMD_SERIALTIMEOUT, (byte)((constrain(Sabertooth_WatchdogTimeout_mS, 0, 12700) + 99) / 100));
+    // The autobaud character and the rest of the setup are sent from update(), see startup(). Until then the Sabertooth refuses any speed but zero. 
+    ready = false;
 
     // Set the internal speed range (min, max). Sabertooth serial devices using packetized serial
     // accept commands from -127 to 127 with a middle point of 0
@@ -198,8 +302,33 @@ void Sabertooth_SerialESC::begin(void)
     set_DefaultInternalRange(-127,127, 0);
 }
 
+void Sabertooth_SerialESC::startup(void)
+{
+    if (!MotorPortSettled()) return;
+
+    if (!sentAutobaud)  // We might have multiple Sabertooth objects, but we only need to do this part once. 
+    {
+        Sabertooth_SerialESC::autobaud(true);   // This will ONLY take care of Sabertooth 2x5, 2x10, and 2x25 V1 devices. 
+        sentAutobaud = true;                    // For those with Sabertooth 2x12, 2x25 V2, or 2x60 the baud rate must be set (once) using the utility provided on the Misc tab of OP Config. 
+        autobaud_mS = millis();
+    }
+    if (millis() - autobaud_mS < SerialESC_Settle_mS) return;
+
+    // Some Sabertooth devices have the option of a serial timeout watchdog, which we enable (2x12, 2x25 V2, 2x32, or 2x60). If we are connected to 2x5 this command will have no effect.
+    Sabertooth_SerialESC::command(SABERTOOTH_CMD_SERIALTIMEOUT, (byte)((constrain(Sabertooth_WatchdogTimeout_mS, 0, 12700) + 99) / 100));
+    
+    ready = true;
+    Sabertooth_SerialESC::setSpeed(0);
+}
+
 void Sabertooth_SerialESC::setSpeed(int s)  
 {
+    // Nothing but stopped until the Sabertooth is ready, and we don't send anything until then either
+    if (!ready) { curspeed = 0; return; }
+
+    // If this is a new stop, send it once more shortly (see SerialStop_Repeat_mS in OP_Settings.h)
+    if (s == 0 && curspeed != 0) stopRepeat = true;
+
     // save current speed
     curspeed = s;
     
@@ -217,30 +346,62 @@ void Sabertooth_SerialESC::setSpeed(int s)
         Sabertooth_SerialESC::motor(2, s);
     }
     
+    sentCount++;
     LastUpdate_mS = millis();           // Save the time
 }
 
 void Sabertooth_SerialESC::stop(void)
 {
+    if (!ready) { curspeed = 0; return; }
+    if (curspeed != 0) stopRepeat = true;
     curspeed = 0;
     Sabertooth_SerialESC::allStop();
+    sentCount++;
     LastUpdate_mS = millis();           // Save the time
 }
 
 void Sabertooth_SerialESC::update(void)
 {
-    if (millis() - LastUpdate_mS > MotorSignal_Repeat_mS)
+    if (!ready) { startup(); return; }
+
+    // A V1 Sabertooth that was still booting when we sent the autobaud character missed it, so send it once more (a Sabertooth that already has it ignores it)
+    if (!sentReautobaud && millis() > SerialESC_Reautobaud_mS && MotorPortSettled())
+    {
+        OP_Sabertooth::autobaud(port(), true);
+        sentReautobaud = true;
+    }
+
+    // Sabertooths never answer, so the best we can do about a lost stop is to send it twice
+    if (stopRepeat && millis() - LastUpdate_mS > SerialStop_Repeat_mS)
+    {
+        stopRepeat = false;
+        resentCount++;
+        Sabertooth_SerialESC::setSpeed(curspeed);
+    }
+    else if (millis() - LastUpdate_mS > MotorSignal_Repeat_mS)
     {   // MotorSignal_Repeat_mS is defined in OP_Settings.h
         Sabertooth_SerialESC::setSpeed(curspeed);
     }
 }
 
+boolean Sabertooth_SerialESC::getLinkStats(motor_link_stats &ls)
+{
+    ls.Sent = sentCount;
+    ls.Resent = resentCount;
+    ls.Errors = 0;
+    ls.LastError = 0;
+    ls.Readback = false;
+    return true;
+}
+
 
 
 // ------------------------------------------------------------------------------------------------------------------>>
 // POLOLU QIK CONTROLLERS
 // ------------------------------------------------------------------------------------------------------------------>>
 boolean Pololu_SerialESC::sendAutobaud = false;     // Declare static variables globally
+boolean Pololu_SerialESC::sentReautobaud = false;
+uint32_t Pololu_SerialESC::autobaud_mS;
 void Pololu_SerialESC::begin(void)
 {
     // Initialize motor serial
@@ -248,11 +409,11 @@ void Pololu_SerialESC::begin(void)
     // jumpers. On the 2s12v10 the jumper can select 9600, 38400, or 115200. On the 2s9v1, the jumper will only select 38400. 
     // For purposes of Open Panzer, 38400 is the recommended baud rate (for all serial controllers).
     // It is easier to tell the user not to worry about jumpers, and we will just send the autobaud command. 
-    if (!sendAutobaud)  // We might have multiple Pololu objects, but we only need to do this part once. 
-    {
-        Pololu_SerialESC::autobaud(true);  // This simply sends 0xAA. The "true" means skip the long waiting. 
-        sendAutobaud = true;
-    }
+    // The autobaud character is sent from update(), see startup(). Until then the Qik refuses any speed but zero. 
+    ready = false;
+
+    // Read the Qik's error byte in the background so we know when it has thrown a command away or shut a motor down
+    Pololu_SerialESC::enableErrorPolling();
 
     // Set the internal speed range (min, max). Pololu Qik devices in 7-bit mode accept commands from -127 to 127
     // Although the Pololu Qik controllers also have an 8 bit mode, we use 7-bit for consistency with the Sabertooth,
@@ -262,8 +423,30 @@ void Pololu_SerialESC::begin(void)
     set_DefaultInternalRange(-127,127, 0);
 }
 
+void Pololu_SerialESC::startup(void)
+{
+    if (!MotorPortSettled()) return;
+
+    if (!sendAutobaud)  // We might have multiple Pololu objects, but we only need to do this part once. 
+    {
+        Pololu_SerialESC::autobaud(true);  // This simply sends 0xAA. The "true" means skip the long waiting. 
+        sendAutobaud = true;
+        autobaud_mS = millis();
+    }
+    if (millis() - autobaud_mS < SerialESC_Settle_mS) return;
+
+    ready = true;
+    Pololu_SerialESC::setSpeed(0);
+}
+
 void Pololu_SerialESC::setSpeed(int s)  
 {
+    // Nothing but stopped until the Qik is ready, and we don't send anything until then either
+    if (!ready) { curspeed = 0; return; }
+
+    // If this is a new stop, send it once more shortly (see SerialStop_Repeat_mS in OP_Settings.h)
+    if (s == 0 && curspeed != 0) stopRepeat = true;
+
     // save current speed
     curspeed = s;
     
@@ -281,24 +464,60 @@ void Pololu_SerialESC::setSpeed(int s)
         Pololu_SerialESC::motor(2, s);
     }
     
+    sentCount++;
     LastUpdate_mS = millis();           // Save the time
 }
 
 void Pololu_SerialESC::stop(void)
 {
+    if (!ready) { curspeed = 0; return; }
+    if (curspeed != 0) stopRepeat = true;
     curspeed = 0;
     Pololu_SerialESC::allStop();
+    sentCount++;
     LastUpdate_mS = millis();           // Save the time
 }
 
 void Pololu_SerialESC::update(void)
 {
-    if (millis() - LastUpdate_mS > MotorSignal_Repeat_mS)
+qik_error_stats qs;
+
+    if (!ready) { startup(); return; }
+    if (!ScoutTelemetryOnPort) OP_PololuQik::pollErrors();
+
+    // If the Qik isn't answering error polls by now it may have still been booting when we sent the autobaud character, so send it once more. 
+    // We don't do this to a Qik that is answering because a stray 0xAA can cost it the next command. 
+    if (!sentReautobaud && millis() > SerialESC_Reautobaud_mS && MotorPortSettled())
+    {
+        if (!Pololu_SerialESC::getErrorStats(qs)) OP_PololuQik::autobaud(port(), true);
+        sentReautobaud = true;
+    }
+
+    // If the Qik reported an error that may have cost us our last command, or shut this motor down, send the speed again now
+    if (Pololu_SerialESC::takeResend(ESC_Position == SIDEA ? 1 : 2) || (stopRepeat && millis() - LastUpdate_mS > SerialStop_Repeat_mS))
+    {
+        stopRepeat = false;
+        resentCount++;
+        Pololu_SerialESC::setSpeed(curspeed);
+    }
+    else if (millis() - LastUpdate_mS > MotorSignal_Repeat_mS)
     {   // MotorSignal_Repeat_mS is defined in OP_Settings.h
         Pololu_SerialESC::setSpeed(curspeed);
     }
 }
 
+boolean Pololu_SerialESC::getLinkStats(motor_link_stats &ls)
+{
+qik_error_stats qs;
+
+    ls.Sent = sentCount;
+    ls.Resent = resentCount;
+    ls.Readback = Pololu_SerialESC::getErrorStats(qs);
+    ls.Errors = qs.SerialErrors + qs.MotorFaults[ESC_Position == SIDEA ? 0 : 1];
+    ls.LastError = qs.LastError;
+    return true;
+}
+
 
 
 // ------------------------------------------------------------------------------------------------------------------>>
@@ -81,8 +81,19 @@ typedef char Drive_t;
 const __FlashStringHelper *ptrDriveType(Drive_t dType); //Returns a character string that is name of drive type (see OP_Motors.cpp)
 
 
+// Serial controllers count the speed commands they send, and those that can report errors back count those too
+typedef struct {
+    uint16_t Sent;          // Speed commands sent
+    uint16_t Resent;        // Sent again because the last one may have been lost
+    uint16_t Errors;        // Errors the controller reported
+    uint8_t  LastError;     // Most recent error code, controller specific (0 if none)
+    boolean  Readback;      // The controller is answering, so Errors and LastError mean something
+} motor_link_stats;
+
+
 class Motor {
   protected:
+    const Drive_t motorType;                        // Which class this really is (POLOLU, ONBOARD, SERVO_ESC...), see MotorSetSpeed() below
     ESC_POS_t ESC_Position;
     int e_minspeed, e_maxspeed, e_middlespeed;      // We have external speed range, and internal. External is the range of numbers that will be passed
                                                     // to the motor object from our main sketch. These are likely to be -255 to 255
@@ -95,7 +106,9 @@ class Motor {
 
   public:
     // Constructor, set member ESC_Position, external speed range, and reversed status
-    Motor (ESC_POS_t pos, int min, int max, int middle, boolean rev=false) : ESC_Position(pos), e_minspeed(min), e_maxspeed(max), e_middlespeed(middle), reversed(rev) {}
+    Motor (Drive_t type, ESC_POS_t pos, int min, int max, int middle, boolean rev=false) : motorType(type), ESC_Position(pos), e_minspeed(min), e_maxspeed(max), e_middlespeed(middle), reversed(rev) {}
+    
+    Drive_t getType(void) { return this->motorType; }
     
     // This is the internal range of values that is specific to each motor driver.
     void set_InternalRange (int min, int max, int middle)
@@ -138,55 +151,98 @@ class Motor {
     }   
     
     int getSpeed(void) { return this->curspeed; }
+
+    // How hard the motor is being driven regardless of direction, 0 (stopped) to 255 (full speed either way)
+    uint8_t getLoad(void)
+    {   long span;
+        long s = (long)this->curspeed - this->e_middlespeed;
+        if (s >= 0) { span = (long)this->e_maxspeed - this->e_middlespeed; }
+        else        { span = (long)this->e_middlespeed - this->e_minspeed; s = -s; }
+        if (span <= 0) return 0;
+        s = (s * 255) / span;
+        return (s > 255) ? 255 : (uint8_t)s;
+    }
+
     virtual void setSpeed(int) =0;                  // Purely virtual
     virtual void begin(void) =0;
     virtual void stop(void) =0;
     virtual void update(void) =0;
+
+    // Only serial controllers have anything to report, the rest return false
+    virtual boolean getLinkStats(motor_link_stats &) { return false; }
+
+    // Serial controllers are set up in the background after begin(), and refuse any speed but zero until they are ready
+    virtual boolean isReady(void) { return true; }
 };
 
 
 
 class OPScout_SerialESC: public Motor, public OP_Scout {
   public:
-    OPScout_SerialESC(ESC_POS_t pos, int min, int max, int middle, byte addr, HardwareSerial *hwSerial, uint32_t *baud, boolean drag, uint8_t cl) : Motor(pos,min,max,middle), OP_Scout(addr,hwSerial), motorbaud(baud), dragInnerTrack(drag), currentLimit(cl) {}
+    OPScout_SerialESC(ESC_POS_t pos, int min, int max, int middle, byte addr, HardwareSerial *hwSerial, uint32_t *baud, boolean drag, uint8_t cl, boolean telem) : Motor(OP_SCOUT,pos,min,max,middle), OP_Scout(addr,hwSerial), ready(false), motorbaud(baud), dragInnerTrack(drag), currentLimit(cl), telemetry(telem), stopRepeat(false) {}
     void setSpeed(int s);
     void begin(void);
     void stop(void);
     void update(void);
+    uint8_t deratePct(void);        // Percent of full speed allowed at the Scout's present temperature
+    boolean isReady(void) { return ready; }
   private:
+    void startup(void);
+    static void portStep(uint32_t baud);
+    boolean ready;
     uint32_t LastUpdate_mS;
     uint32_t *motorbaud;
     boolean dragInnerTrack;
     uint8_t currentLimit;
+    boolean telemetry;                  // Poll the Scout for telemetry, see ScoutTelemetry in OP_EEPROM_Struct.h
+    boolean stopRepeat;                 // Send the stop once more, see SerialStop_Repeat_mS
 };
 
 class Sabertooth_SerialESC: public Motor, public OP_Sabertooth {
   public:
-    Sabertooth_SerialESC(ESC_POS_t pos, int min, int max, int middle, byte addr, HardwareSerial *hwSerial) : Motor(pos,min,max,middle), OP_Sabertooth(addr,hwSerial) {}
+    Sabertooth_SerialESC(ESC_POS_t pos, int min, int max, int middle, byte addr, HardwareSerial *hwSerial) : Motor(SABERTOOTH,pos,min,max,middle), OP_Sabertooth(addr,hwSerial), ready(false), sentCount(0), resentCount(0), stopRepeat(false) {}
     void setSpeed(int s);
     void begin(void);
     void stop(void);
     void update(void);
+    boolean getLinkStats(motor_link_stats &);
+    boolean isReady(void) { return ready; }
   private:
+    void startup(void);
     static boolean sentAutobaud;
+    static boolean sentReautobaud;
+    boolean ready;
+    static uint32_t autobaud_mS;
     uint32_t LastUpdate_mS;    
+    uint16_t sentCount;
+    uint16_t resentCount;
+    boolean stopRepeat;                 // Send the stop once more, see SerialStop_Repeat_mS
 };
 
 class Pololu_SerialESC: public Motor, public OP_PololuQik {
   public:
-    Pololu_SerialESC(ESC_POS_t pos, int min, int max, int middle, byte deviceID, HardwareSerial *hwSerial) : Motor(pos,min,max,middle), OP_PololuQik(deviceID,hwSerial) {}
+    Pololu_SerialESC(ESC_POS_t pos, int min, int max, int middle, byte deviceID, HardwareSerial *hwSerial) : Motor(POLOLU,pos,min,max,middle), OP_PololuQik(deviceID,hwSerial), ready(false), sentCount(0), resentCount(0), stopRepeat(false) {}
     void setSpeed(int s);
     void begin(void);
     void stop(void);
     void update(void);
+    boolean getLinkStats(motor_link_stats &);
+    boolean isReady(void) { return ready; }
   private:
+    void startup(void);
     static boolean sendAutobaud;
+    static boolean sentReautobaud;
+    boolean ready;
+    static uint32_t autobaud_mS;
     uint32_t LastUpdate_mS;        
+    uint16_t sentCount;
+    uint16_t resentCount;
+    boolean stopRepeat;                 // Send the stop once more, see SerialStop_Repeat_mS
 };
 
 class Onboard_ESC: public Motor {
   public:
-    Onboard_ESC(ESC_POS_t pos, int min, int max, int middle) : Motor(pos,min,max,middle) {}
+    Onboard_ESC(ESC_POS_t pos, int min, int max, int middle) : Motor(ONBOARD,pos,min,max,middle) {}
     void setSpeed(int s);
     void begin(void);   
     void stop(void);
@@ -195,7 +251,7 @@ class Onboard_ESC: public Motor {
 
 class Servo_ESC: public Motor, public OP_Servos {
   public:
-    Servo_ESC(ESC_POS_t pos, int min, int max, int middle) : Motor(pos,min,max,middle) {}
+    Servo_ESC(ESC_POS_t pos, int min, int max, int middle) : Motor(SERVO_ESC,pos,min,max,middle) {}
     void setPos(int s); 
     void setSpeed(int s) { setPos(s); } // We keep this for compatibility with the other motor classes, but in this case, it actually sets the servo *position* directly, it has nothing to do with speed.
     void begin(void);
@@ -205,7 +261,7 @@ class Servo_ESC: public Motor, public OP_Servos {
 
 class Servo_PAN: public Motor, public OP_Servos {
   public:
-    Servo_PAN(ESC_POS_t pos, int min, int max, int middle) : Motor(pos,min,max,middle) {}
+    Servo_PAN(ESC_POS_t pos, int min, int max, int middle) : Motor(SERVO_PAN,pos,min,max,middle) {}
     void setLimits(uint16_t, uint16_t); // Set end-point limits on the servo object, not the motor
     void setSpeed(int s);   // This will actually set the speed at which the servo *pans*
     void setPos(int s);     // This sets an actual position directly, rather than the speed. 
@@ -228,7 +284,7 @@ const __FlashStringHelper *ptrRecoilPreset(RecoilPreset rs); //Returns a charact
 
 class Servo_RECOIL: public Motor, public OP_Servos {
   public:
-    Servo_RECOIL(ESC_POS_t pos, int min, int max, int middle, uint16_t mS_Recoil, uint16_t mS_Return, uint8_t Reversed) : Motor(pos,min,max,middle), _RecoilmS(mS_Recoil), _ReturnmS(mS_Return), _Reversed(Reversed) {}
+    Servo_RECOIL(ESC_POS_t pos, int min, int max, int middle, uint16_t mS_Recoil, uint16_t mS_Return, uint8_t Reversed) : Motor(SERVO_RECOIL,pos,min,max,middle), _RecoilmS(mS_Recoil), _ReturnmS(mS_Return), _Reversed(Reversed) {}
     void setSpeed(int); // This doesn't do anything for this particular derived class
     void setLimits(uint16_t, uint16_t); // Set end-point limits on the servo object, not the motor
     void begin(void);
@@ -245,7 +301,7 @@ class Servo_RECOIL: public Motor, public OP_Servos {
 // This sub-class is empty and does nothing. 
 class Null_Motor: public Motor {
   public:
-    Null_Motor() : Motor(ESC_POS_t(0),0,0,0) {}
+    Null_Motor() : Motor(DRIVE_DETACHED,ESC_POS_t(0),0,0,0) {}
     void setSpeed(int s) { return; }
     void begin(void)     { return; }  
     void stop(void)      { return; }
@@ -253,6 +309,38 @@ class Null_Motor: public Motor {
 };
 
 
+// The drive and turret motors are picked once at boot (InstantiateMotorObjects) and after that we call them every time through the loop. 
+// These call the right class's function directly from the motor's type tag instead of going through the virtual table, which saves the 
+// indirect call and lets the compiler inline the small ones (the servo classes, map_Range). For update() only the serial controllers 
+// have any work to do, so for everything else it costs one compare and no call at all. 
+// The virtual functions still work as before, use these where speed matters. 
+inline void MotorSetSpeed(Motor * m, int s)
+{
+    switch (m->getType())
+    {
+        case OP_SCOUT:      static_cast<OPScout_SerialESC *>(m)->OPScout_SerialESC::setSpeed(s);       break;
+        case SABERTOOTH:    static_cast<Sabertooth_SerialESC *>(m)->Sabertooth_SerialESC::setSpeed(s); break;
+        case POLOLU:        static_cast<Pololu_SerialESC *>(m)->Pololu_SerialESC::setSpeed(s);         break;
+        case ONBOARD:       static_cast<Onboard_ESC *>(m)->Onboard_ESC::setSpeed(s);                   break;
+        case SERVO_ESC:     static_cast<Servo_ESC *>(m)->Servo_ESC::setSpeed(s);                       break;
+        case SERVO_PAN:     static_cast<Servo_PAN *>(m)->Servo_PAN::setSpeed(s);                       break;
+        case DRIVE_DETACHED:                                                                            break;
+        default:            m->setSpeed(s);                                                             break;     // Anything else, the long way
+    }
+}
+
+inline void MotorUpdate(Motor * m)
+{
+    switch (m->getType())
+    {
+        case OP_SCOUT:      static_cast<OPScout_SerialESC *>(m)->OPScout_SerialESC::update();          break;
+        case SABERTOOTH:    static_cast<Sabertooth_SerialESC *>(m)->Sabertooth_SerialESC::update();    break;
+        case POLOLU:        static_cast<Pololu_SerialESC *>(m)->Pololu_SerialESC::update();            break;
+        default:                                                                                        break;     // Nothing to do for onboard, servo or detached motors
+    }
+}
+
+
 #endif //OP_Motors_h
 
 
@@ -24,6 +24,7 @@
 OP_EEPROM       * OP_PCComm::_op_eeprom;
 HardwareSerial  * OP_PCComm::_serial;
 OP_Radio        * OP_PCComm::_radio;
+OP_Battery      * OP_PCComm::_battery;
 uint8_t			  OP_PCComm::_hardwareDevice;
 uint32_t          OP_PCComm::WatchdogStartTime;
 boolean           OP_PCComm::Timeout;
@@ -39,10 +40,11 @@ DataSentence      OP_PCComm::SentenceIN;
 //------------------------------------------------------------------------------------------------------------------------>>
 OP_PCComm::OP_PCComm(void) {}                                       // Constructor
 
-void OP_PCComm::begin(OP_EEPROM * opeeprom, OP_Radio * radio, DEVICE device)       // Begin
+void OP_PCComm::begin(OP_EEPROM * opeeprom, OP_Radio * radio, DEVICE device, OP_Battery * battery)       // Begin
 {
     _op_eeprom = opeeprom;
     _radio = radio;
+    _battery = battery;
 	_hardwareDevice = device;
     _serial = &DEFAULT_SERIAL_PORT; // Initialize to default set in OP_PCComm.h
     Timeout = false;
@@ -67,9 +69,7 @@ boolean OP_PCComm::CheckPC(void)
 {
 char CharIn;
 static char input_line[VALUE_BUFF];
-static char init_array[VALUE_BUFF];
-const String Init = INIT_STRING;            // The string we're looking for
-const uint8_t InitLength = Init.length();   // Number of characters in INIT_STRING
+const uint8_t InitLength = sizeof(INIT_STRING) - 1; // Number of characters in INIT_STRING (less the null)
 static boolean startCharReceived = false;   // Have we got a character that matches the first character of INIT_STRING? 
 static uint8_t numBytes = 0;                // Number of bytes received once we get a character match
 boolean returnval = false;                  // Not static, starts false every time we enter this routine
@@ -92,7 +92,6 @@ boolean returnval = false;                  // Not static, starts false every ti
 
     if (numBytes >= InitLength)
     {
-        Init.toCharArray(init_array, VALUE_BUFF);
         returnval = true;   // Start off true, if any characters don't match, we'll change to false
         for (int i=0; i<InitLength; i++)
         {
@@ -164,6 +163,7 @@ void OP_PCComm::ListenToPC(void)
         // Update the watchdog timer
         updateTimer();
         _radio->Update();
+        OP_Scout::pollTelemetry();
         
         // If we have too many errors, or the watchdog timer has expired, take our leave
         if (numErrors >= MAX_COMM_ERRORCOUNT || Timeout) 
@@ -355,6 +355,13 @@ char pulseString[SENTENCE_BUFF];
 uint8_t pulseStrLength = 0;
 uint8_t strLen = 0;
 
+// And these for the packed radio stream
+static int16_t streamPulses[COUNT_OP_CHANNELS];     // Static so they don't take up stack again each time we recurse into ProcessCommand while streaming
+uint16_t streamPeriod;
+uint8_t seq;
+uint8_t frames;
+uint16_t crc;
+
 // Used for Pololu Qik configuration
 OP_PololuQik * Qik;
 
@@ -465,6 +472,7 @@ OP_PololuQik * Qik;
                         if (_radio->getChannelCount() > 8) HiLo == LOW ? HiLo = HIGH : HiLo = LOW;
                     }
                     _radio->Update();                   // Update the radio
+                    OP_Scout::pollTelemetry();          // Keep Scout telemetry current, the PC can ask for it while streaming
                     updateTimer();                      // Update the PC comm watchdog timer
                     if (ReadData()) ProcessCommand();   // recursive - so we know when the PC tells us to stop
                 } while (!Disconnect && StreamRadio && !Timeout && numErrors < MAX_COMM_ERRORCOUNT);
@@ -474,6 +482,73 @@ OP_PololuQik * Qik;
             _radio->defaultSpeed();
             break;
             
+        case PCCMD_STARTSTREAM_PACKED:
+            // Same as above, OP Config will have asked for PCCMD_NUM_CHANNELS first so we don't wait for the radio here. 
+            if (_radio->Status() != READY_state) 
+            {
+                sendNullValueSentence(DVCMD_RADIO_NOTREADY);
+            }
+            else
+            {
+                // Unlike the stream above this one goes out at a fixed rate rather than once per radio frame, and there is only one short sentence 
+                // however many channels there are. So there is no need to slow the radio down. We run the radio through GetCommands just like the sketch
+                // does, so the PC sees the stick and switch positions the sketch would act on, and have it copy every channel into streamPulses as it goes. 
+                if (!_radio->hasBegun()) _radio->begin(&_op_eeprom->ramcopy);  
+                streamPeriod = SentenceIN.Value == 0 ? RADIOSTREAM_PACKED_mS : constrain(SentenceIN.Value, RADIOSTREAM_MIN_mS, RADIOSTREAM_MAX_mS);
+                for (uint8_t i=0; i<COUNT_OP_CHANNELS; i++) streamPulses[i] = 0;
+                _radio->CaptureFrame(streamPulses);
+                StreamRadio = true;
+                seq = 0;
+                frames = 0;
+
+                // Construct the prefix once rather than each time through the loop
+                s.Command = DVCMD_RETURN_VALUE;
+                s.ID = DVID_RADIOSTREAM_PACKED;
+                prefixToByteArray(s, prefixString, VALUE_BUFF, prefixLength);
+
+                lastTime = millis() - streamPeriod;                 // Send the first one right away
+                do 
+                {
+                    if (_radio->NewFrame())
+                    {
+                        _radio->GetCommands();
+                        if (frames < 15) frames++;
+                    }
+                    
+                    if (millis() - lastTime >= streamPeriod)
+                    {
+                        lastTime += streamPeriod;                   // Keep a steady rate, but if we've fallen more than a whole period behind don't try to catch up
+                        if (millis() - lastTime >= streamPeriod) lastTime = millis();
+
+                        strcpy(arrOut, prefixString);
+                        strLen = prefixLength;
+                        strLen += PackRadioFrame(&arrOut[strLen], seq++, frames, streamPulses, _radio->getChannelCount());
+                        arrOut[strLen++] = DELIMITER;
+                        crc = calcrc(arrOut, strLen);
+                        arrOut[strLen++] = ((crc >> 12) & 0x0F) + RADIOSTREAM_CHAR_OFFSET;     // Checksum in three characters, see OP_PCComm.h
+                        arrOut[strLen++] = ((crc >> 6) & 0x3F) + RADIOSTREAM_CHAR_OFFSET;
+                        arrOut[strLen++] = (crc & 0x3F) + RADIOSTREAM_CHAR_OFFSET;
+                        arrOut[strLen++] = NEWLINE;
+                        arrOut[strLen] = '\0';                      // Mark the end of the array
+
+                        // Never wait on the serial port, that would only hold up the radio. If the whole sentence won't fit in the transmit buffer 
+                        // skip it - seq has already moved on so the PC knows, and frames keeps counting until one does go out. 
+                        if (_serial->availableForWrite() >= strLen)
+                        {
+                            _serial->print(arrOut);
+                            frames = 0;
+                        }
+                    }
+                    _radio->Update();                   // Update the radio
+                    OP_Scout::pollTelemetry();          // Keep Scout telemetry current, the PC can ask for it while streaming
+                    updateTimer();                      // Update the PC comm watchdog timer
+                    if (ReadData()) ProcessCommand();   // recursive - so we know when the PC tells us to stop
+                } while (!Disconnect && StreamRadio && !Timeout && numErrors < MAX_COMM_ERRORCOUNT);
+                _radio->CaptureFrame(NULL);
+                _serial->flush();
+            }
+            break;
+
         case PCCMD_STOPSTREAM_RADIO:
             // PC wants us to stop the streaming. Set the stream flag to false.
             StreamRadio = false;
@@ -587,6 +662,36 @@ OP_PololuQik * Qik;
         case PCCMD_READ_EEPROM:         // Here the computer wants to know what the value is at a certain address.
             GivePC_Value_byID(SentenceIN.ID);
             break;
+
+        case PCCMD_READ_BATTERY:        // Computer wants one of the battery estimates
+            GivePC_Battery(SentenceIN.ID);
+            break;
+
+        case PCCMD_READ_LOG:            // Computer wants an event from the battle log, or wants the log cleared
+            if (SentenceIN.ID == DVID_LOG_CLEAR)
+            {
+                OP_BattleLog::clear();
+                AskForNextSentence();
+            }
+            else GivePC_LogEvent(SentenceIN.ID, SentenceIN.Value);
+            break;
+
+        case PCCMD_READ_RAM:            // Computer wants one of the RAM usage figures
+            GivePC_RAM(SentenceIN.ID);
+            break;
+
+        case PCCMD_READ_SCOUT:          // Computer wants one of the Scout telemetry values
+            GivePC_Scout(SentenceIN.ID);
+            break;
+
+        case PCCMD_READ_RADIOSTATS:     // Computer wants some of the radio frame statistics, or wants them cleared
+            if (SentenceIN.ID == DVID_RADIOSTATS_CLEAR)
+            {
+                _radio->ClearStats();
+                if (!StreamRadio) AskForNextSentence();
+            }
+            else GivePC_RadioStats(SentenceIN.ID);
+            break;
         
         case PCCMD_READ_VERSION:            // Computer wants to know what firmware version we are running
             if (SentenceIN.ID == SentenceIN.Command)    // On commands with no value ID, the command should be repeated in the ID slot
@@ -662,10 +767,7 @@ SentencePrefix s;
 
 void OP_PCComm::GivePC_Int(uint16_t returnID, int32_t val)
 {
-String str = "";
 char sentenceOut[SENTENCE_BUFF];
-char value[VALUE_BUFF]; 
-uint8_t valueStrLen = 0;
 uint8_t strLen = 0;
 SentencePrefix s;
 
@@ -674,20 +776,216 @@ SentencePrefix s;
     s.ID = returnID;                                            // ID - ID of the value we are sending
     prefixToByteArray(s, sentenceOut, SENTENCE_BUFF, strLen);   // Construct the sentence prefix: "Command|ID|"
     
-    // Append value
-    str = String(val, DEC);
-    str.toCharArray(value, VALUE_BUFF);
-    valueStrLen = str.length(); 
-    strcat(sentenceOut, value);                                 // Now add the value char array that we got from readSerialEEPROM_byID
-    strLen += valueStrLen;                                      // String length is now this long
-    sentenceOut[strLen++] = DELIMITER;                          // Add final delimiter
-    sentenceOut[strLen] = '\0';                                 // Mark the end of the array
+    // Append value and final delimiter
+    OP_Format::appendInt(sentenceOut, SENTENCE_BUFF, strLen, val);
+    OP_Format::appendChar(sentenceOut, SENTENCE_BUFF, strLen, DELIMITER);
     _serial->print(sentenceOut);                                // Now print: Command | ID | Value |
     _serial->print(calcrc(sentenceOut, strLen));                // Calculate the CRC for all the above and print that
     _serial->print(NEWLINE);                                    // End sentence
     _serial->flush();   
 }
 
+void OP_PCComm::GivePC_Battery(uint16_t ID)
+{
+    // Note these are the estimates as of when the PC connected, the estimator isn't updated while we are talking to the PC
+    if (_battery == NULL || !_battery->isPresent()) 
+    {
+        sendNullValueSentence(DVCMD_NOSUCH_VALUE);
+        return;
+    }
+
+    switch (ID)
+    {
+        case DVID_BATTERY_VOLTAGE:  GivePC_Int(ID, _battery->measuredVoltage_mV());   break;
+        case DVID_BATTERY_RESTING:  GivePC_Int(ID, _battery->restingVoltage_mV());    break;
+        case DVID_BATTERY_SAG:      GivePC_Int(ID, _battery->sag_mV());               break;
+        case DVID_BATTERY_CHARGE:   GivePC_Int(ID, _battery->stateOfCharge());        break;
+        case DVID_BATTERY_RUNTIME:  GivePC_Int(ID, _battery->runtimeMinutes());       break;
+        case DVID_BATTERY_CELLS:    GivePC_Int(ID, _battery->cells());                break;
+        default:                    sendNullValueSentence(DVCMD_NOSUCH_VALUE);        break;
+    }
+}
+
+void OP_PCComm::GivePC_LogEvent(uint16_t ID, uint16_t n)
+{
+char sentenceOut[SENTENCE_BUFF];
+uint8_t strLen = 0;
+SentencePrefix s;
+BattleEvent e;
+boolean found;
+    
+    if (ID == DVID_LOG_RAM)         found = (n <= 0xFF) && OP_BattleLog::readRAM(n, e);
+    else if (ID == DVID_LOG_EEPROM) found = (n <= 0xFF) && OP_BattleLog::readEEPROM(n, e);
+    else                            found = false;
+    if (!found)
+    {
+        sendNullValueSentence(DVCMD_NOSUCH_VALUE);
+        return;
+    }
+
+    // Prefix
+    s.Command = DVCMD_RETURN_VALUE;                             // Command - tell PC we are returning a value
+    s.ID = ID;                                                  // ID - which log this came from
+    prefixToByteArray(s, sentenceOut, SENTENCE_BUFF, strLen);   // Construct the sentence prefix: "Command|ID|"
+    
+    // Each field followed by a delimiter, like a radio stream sentence: Seq|Time|Type|Protocol|Team|Info|
+    utoa(e.Seq, &sentenceOut[strLen], 10);          strLen += strlen(&sentenceOut[strLen]);     sentenceOut[strLen++] = DELIMITER;
+    ultoa(e.Time_mS, &sentenceOut[strLen], 10);     strLen += strlen(&sentenceOut[strLen]);     sentenceOut[strLen++] = DELIMITER;
+    utoa(e.Type, &sentenceOut[strLen], 10);         strLen += strlen(&sentenceOut[strLen]);     sentenceOut[strLen++] = DELIMITER;
+    utoa(e.Protocol, &sentenceOut[strLen], 10);     strLen += strlen(&sentenceOut[strLen]);     sentenceOut[strLen++] = DELIMITER;
+    utoa(e.Team, &sentenceOut[strLen], 10);         strLen += strlen(&sentenceOut[strLen]);     sentenceOut[strLen++] = DELIMITER;
+    utoa(e.Info, &sentenceOut[strLen], 10);         strLen += strlen(&sentenceOut[strLen]);     sentenceOut[strLen++] = DELIMITER;
+    sentenceOut[strLen] = '\0';                                 // Mark the end of the array
+    _serial->print(sentenceOut);                                // Now print: Command | ID | Values |
+    _serial->print(calcrc(sentenceOut, strLen));                // Calculate the CRC for all the above and print that
+    _serial->print(NEWLINE);                                    // End sentence
+    _serial->flush();   
+}
+
+void OP_PCComm::GivePC_RadioStats(uint16_t ID)
+{
+char sentenceOut[SENTENCE_BUFF];
+uint8_t strLen = 0;
+uint16_t values[RADIO_HIST_BUCKETS];
+uint8_t count = 0;
+SentencePrefix s;
+radio_stats rs;
+
+    _radio->GetStats(rs);
+    switch (ID)
+    {
+        case DVID_RADIOSTATS_SUMMARY:
+            // Frames is 32 bits so it goes in on its own below
+            values[0] = rs.LostFrames;      values[1] = rs.MinInterval_uS;  values[2] = rs.AvgInterval_uS; 
+            values[3] = rs.MaxInterval_uS;  values[4] = rs.MaxLatency_uS;   count = 5;
+            break;
+        case DVID_RADIOSTATS_INTERVAL:  memcpy(values, rs.IntervalHist, sizeof(rs.IntervalHist));   count = RADIO_HIST_BUCKETS;     break;
+        case DVID_RADIOSTATS_LATENCY:   memcpy(values, rs.LatencyHist, sizeof(rs.LatencyHist));     count = RADIO_HIST_BUCKETS;     break;
+        case DVID_RADIOSTATS_ERRORS:
+            values[0] = rs.DecodedFrames;   values[1] = rs.FormatErrors;    values[2] = rs.CRCErrors;
+            values[3] = rs.RxFailsafe;      values[4] = rs.LastFailsafe;    count = 5;
+            break;
+        case DVID_RADIOSTATS_FAILSAFE:  memcpy(values, rs.Failsafes, sizeof(rs.Failsafes));         count = RADIO_FS_REASONS;       break;
+        default:
+            sendNullValueSentence(DVCMD_NOSUCH_VALUE);
+            return;
+    }
+
+    // Prefix
+    s.Command = DVCMD_RETURN_VALUE;                             // Command - tell PC we are returning a value
+    s.ID = ID;                                                  // ID - which group of statistics this is
+    prefixToByteArray(s, sentenceOut, SENTENCE_BUFF, strLen);   // Construct the sentence prefix: "Command|ID|"
+
+    // Each value followed by a delimiter, like a radio stream sentence. At 8 values of 5 digits we are well inside SENTENCE_BUFF. 
+    if (ID == DVID_RADIOSTATS_SUMMARY) { ultoa(rs.Frames, &sentenceOut[strLen], 10); strLen += strlen(&sentenceOut[strLen]); sentenceOut[strLen++] = DELIMITER; }
+    for (uint8_t i = 0; i < count; i++)
+    {
+        utoa(values[i], &sentenceOut[strLen], 10);  strLen += strlen(&sentenceOut[strLen]);     sentenceOut[strLen++] = DELIMITER;
+    }
+    sentenceOut[strLen] = '\0';                                 // Mark the end of the array
+    _serial->print(sentenceOut);                                // Now print: Command | ID | Values |
+    _serial->print(calcrc(sentenceOut, strLen));                // Calculate the CRC for all the above and print that
+    _serial->print(NEWLINE);                                    // End sentence
+    _serial->flush();   
+}
+
+void OP_PCComm::GivePC_RAM(uint16_t ID)
+{
+ram_stats rs;
+
+    // These are as of right now, while we are talking to the PC, which is itself a fairly deep point in the stack
+    OP_RAM::getStats(rs);
+    switch (ID)
+    {
+        case DVID_RAM_DATA:         GivePC_Int(ID, rs.DataBytes);     break;
+        case DVID_RAM_BSS:          GivePC_Int(ID, rs.BssBytes);      break;
+        case DVID_RAM_HEAP:         GivePC_Int(ID, rs.HeapBytes);     break;
+        case DVID_RAM_HEAPMAX:      GivePC_Int(ID, rs.HeapMax);       break;
+        case DVID_RAM_STACK:        GivePC_Int(ID, rs.StackBytes);    break;
+        case DVID_RAM_STACKMAX:     GivePC_Int(ID, rs.StackMax);      break;
+        case DVID_RAM_FREE:         GivePC_Int(ID, rs.FreeBytes);     break;
+        case DVID_RAM_FREEMIN:      GivePC_Int(ID, rs.FreeMin);       break;
+        default:                    sendNullValueSentence(DVCMD_NOSUCH_VALUE);
+    }
+}
+
+void OP_PCComm::GivePC_Scout(uint16_t ID)
+{
+scout_telemetry st;
+byte address;
+uint8_t item;
+
+    if      (ID >= DVID_SCOUT_DRIVE  && ID < DVID_SCOUT_DRIVE  + DVID_SCOUT_COUNT) { address = OPScout_DRIVE_Address;  item = ID - DVID_SCOUT_DRIVE;  }
+    else if (ID >= DVID_SCOUT_TURRET && ID < DVID_SCOUT_TURRET + DVID_SCOUT_COUNT) { address = OPScout_TURRET_Address; item = ID - DVID_SCOUT_TURRET; }
+    else
+    {
+        sendNullValueSentence(DVCMD_NOSUCH_VALUE);
+        return;
+    }
+
+    if (!OP_Scout::getTelemetry(address, st))
+    {
+        sendNullValueSentence(DVCMD_NOSUCH_VALUE);
+        return;
+    }
+
+    switch (item)
+    {
+        case DVID_SCOUT_CURRENT_M1:     GivePC_Int(ID, st.Current_mA[0]);   break;
+        case DVID_SCOUT_CURRENT_M2:     GivePC_Int(ID, st.Current_mA[1]);   break;
+        case DVID_SCOUT_TEMPERATURE:    GivePC_Int(ID, st.Temperature_C);   break;
+        case DVID_SCOUT_VOLTAGE:        GivePC_Int(ID, st.Voltage_mV);      break;
+        case DVID_SCOUT_FAULTS:         GivePC_Int(ID, st.Faults);          break;
+        case DVID_SCOUT_REPLIES:        GivePC_Int(ID, st.Replies);         break;
+        case DVID_SCOUT_MISSES:         GivePC_Int(ID, st.Misses);          break;
+        case DVID_SCOUT_BADPACKETS:     GivePC_Int(ID, st.BadPackets);      break;
+    }
+}
+
+uint8_t OP_PCComm::PackRadioFrame(char *out, uint8_t seq, uint8_t frames, int16_t *pulses, uint8_t count)
+{
+uint16_t bitPos = 0;
+uint8_t len;
+int16_t p;
+    // See the field list with DVID_RADIOSTREAM_PACKED in OP_PCComm.h
+    if (count > COUNT_OP_CHANNELS) count = COUNT_OP_CHANNELS;
+    PackBits(out, bitPos, seq, 8);
+    PackBits(out, bitPos, frames, 4);
+    PackBits(out, bitPos, _radio->InFailsafe, 1);
+    PackBits(out, bitPos, _radio->Status() == READY_state, 1);
+    PackBits(out, bitPos, count, 5);
+    for (uint8_t i=0; i<count; i++)
+    {
+        p = constrain(pulses[i], MIN_POSSIBLE_PULSE, MIN_POSSIBLE_PULSE + 2047) - MIN_POSSIBLE_PULSE;
+        PackBits(out, bitPos, p, 11);
+    }
+    PackBits(out, bitPos, _radio->Sticks.Throttle.command + 256, 9);
+    PackBits(out, bitPos, _radio->Sticks.Turn.command + 256, 9);
+    PackBits(out, bitPos, _radio->Sticks.Elevation.command + 256, 9);
+    PackBits(out, bitPos, _radio->Sticks.Azimuth.command + 256, 9);
+    PackBits(out, bitPos, _radio->SpecialStick.Position, 6);
+    for (uint8_t i=0; i<AUXCHANNELS; i++)
+    {
+        PackBits(out, bitPos, (_radio->AuxChannel[i].present && _radio->AuxChannel[i].Settings->Digital) ? _radio->AuxChannel[i].switchPos : 0, 4);
+    }
+
+    // Now make each character printable
+    len = (bitPos + 5) / 6;
+    for (uint8_t i=0; i<len; i++) out[i] += RADIOSTREAM_CHAR_OFFSET;
+    return len;
+}
+
+void OP_PCComm::PackBits(char *out, uint16_t &bitPos, uint16_t value, uint8_t bits)
+{
+    while (bits > 0)
+    {
+        bits--;
+        if (bitPos % 6 == 0) out[bitPos / 6] = 0;                       // Starting a new character
+        if (value & (1 << bits)) out[bitPos / 6] |= 0x20 >> (bitPos % 6);
+        bitPos++;
+    }
+}
+
 // Give the PC our firmware version
 void OP_PCComm::GivePC_FirmwareVersion(void)
 {
@@ -699,7 +997,6 @@ void OP_PCComm::GivePC_FirmwareVersion(void)
     // but we have to handle this one a bit different to correctly determine the CRC
     
     char sentenceOut[SENTENCE_BUFF];        // buffer for sentence
-    char fValue[VALUE_BUFF];                // smaller buffer for firmware version string
     uint8_t strLen;                         // total string length
 
     // The firmware version does not have an ID number like our other values in EEPROM
@@ -713,13 +1010,8 @@ void OP_PCComm::GivePC_FirmwareVersion(void)
     // Now convert the command | ID | to a byte array
     prefixToByteArray(s, sentenceOut, SENTENCE_BUFF, strLen);
 
-    String str = FIRMWARE_VERSION;          // Now convert firmware version string to char array
-    str += DELIMITER;                       // add final delimiter
-    strLen += str.length();                 // Add to the string length
-    fValue[0] = '\0';                       // Convert the string to a char array in fValue
-    str.toCharArray(fValue, VALUE_BUFF);    
-    strcat(sentenceOut, fValue);            // Concatenate the arrays
-    sentenceOut[strLen] = '\0';             // Mark the end of the array
+    OP_Format::appendStr_P(sentenceOut, SENTENCE_BUFF, strLen, PSTR(FIRMWARE_VERSION));    // Now add the firmware version string
+    OP_Format::appendChar(sentenceOut, SENTENCE_BUFF, strLen, DELIMITER);                   // add final delimiter
 
     _serial->print(sentenceOut);            // Now print command | ID | 0 |
     _serial->print(calcrc(sentenceOut, strLen));    // Calculate the CRC for all the above and print that
@@ -738,7 +1030,6 @@ void OP_PCComm::GivePC_HardwareVersion(void)
     // but we have to handle this one a bit different to correctly determine the CRC
     
     char sentenceOut[SENTENCE_BUFF];        // buffer for sentence
-    char fValue[VALUE_BUFF];                // smaller buffer for hardware version string
     uint8_t strLen;                         // total string length
 
     // The hardware version does not have an ID number like our other values in EEPROM
@@ -752,13 +1043,8 @@ void OP_PCComm::GivePC_HardwareVersion(void)
     // Now convert the command | ID | to a byte array
     prefixToByteArray(s, sentenceOut, SENTENCE_BUFF, strLen);
 
-    String str = String(_hardwareDevice, DEC);	// Now convert hardware version to string	
-    str += DELIMITER;                       // add final delimiter
-    strLen += str.length();                 // Add to the string length
-    fValue[0] = '\0';                       // Convert the string to a char array in fValue
-    str.toCharArray(fValue, VALUE_BUFF);    
-    strcat(sentenceOut, fValue);            // Concatenate the arrays
-    sentenceOut[strLen] = '\0';             // Mark the end of the array
+    OP_Format::appendUInt(sentenceOut, SENTENCE_BUFF, strLen, _hardwareDevice);   // Now add the hardware version number
+    OP_Format::appendChar(sentenceOut, SENTENCE_BUFF, strLen, DELIMITER);          // add final delimiter
 
     _serial->print(sentenceOut);            // Now print command | ID | 0 |
     _serial->print(calcrc(sentenceOut, strLen));    // Calculate the CRC for all the above and print that
@@ -777,7 +1063,6 @@ void OP_PCComm::GivePC_MinOPCVersion(void)
     // but we have to handle this one a bit different to correctly determine the CRC
     
     char sentenceOut[SENTENCE_BUFF];        // buffer for sentence
-    char fValue[VALUE_BUFF];                // smaller buffer for firmware version string
     uint8_t strLen;                         // total string length
 
     // The firmware version does not have an ID number like our other values in EEPROM
@@ -791,13 +1076,8 @@ void OP_PCComm::GivePC_MinOPCVersion(void)
     // Now convert the command | ID | to a byte array
     prefixToByteArray(s, sentenceOut, SENTENCE_BUFF, strLen);
 
-    String str = MIN_OPCONFIG_VERSION;      // Now convert minimum OP Cofig version string to char array
-    str += DELIMITER;                       // add final delimiter
-    strLen += str.length();                 // Add to the string length
-    fValue[0] = '\0';                       // Convert the string to a char array in fValue
-    str.toCharArray(fValue, VALUE_BUFF);    
-    strcat(sentenceOut, fValue);            // Concatenate the arrays
-    sentenceOut[strLen] = '\0';             // Mark the end of the array
+    OP_Format::appendStr_P(sentenceOut, SENTENCE_BUFF, strLen, PSTR(MIN_OPCONFIG_VERSION)); // Now add the minimum OP Config version string
+    OP_Format::appendChar(sentenceOut, SENTENCE_BUFF, strLen, DELIMITER);                   // add final delimiter
 
     _serial->print(sentenceOut);            // Now print command | ID | 0 |
     _serial->print(calcrc(sentenceOut, strLen));    // Calculate the CRC for all the above and print that
@@ -855,21 +1135,15 @@ void OP_PCComm::sendNullValueSentence(uint8_t command, boolean setValueFlag /*=f
 
 void OP_PCComm::prefixToByteArray(SentencePrefix s, char *prefix, uint8_t prefixBUFF, uint8_t &returnStrLen)
 {
-// Clear to begin
-prefix[0] = '\0';
-returnStrLen = 0;
-
-String str;
-str = String(s.Command, DEC);
-str += DELIMITER;
-str += String(s.ID, DEC);
-str += DELIMITER;
-
-// Set the passed length to the string length
-returnStrLen = str.length();
-// Convert the string to a char array, stored in the array passed
-str.toCharArray(prefix, prefixBUFF);
-
+    // Clear to begin
+    prefix[0] = '\0';
+    returnStrLen = 0;
+
+    // "Command|ID|", the length is returned in returnStrLen
+    OP_Format::appendUInt(prefix, prefixBUFF, returnStrLen, s.Command);
+    OP_Format::appendChar(prefix, prefixBUFF, returnStrLen, DELIMITER);
+    OP_Format::appendUInt(prefix, prefixBUFF, returnStrLen, s.ID);
+    OP_Format::appendChar(prefix, prefixBUFF, returnStrLen, DELIMITER);
 }
 
 
@@ -912,23 +1186,9 @@ int32_t OP_PCComm::constructNumber(char *c, int numBytes)
 // This will calculate a CRC value from a character string
 int16_t OP_PCComm::calcrc(char *ptr, int16_t count) 
 { 
-    int16_t crc; 
-    uint8_t i; 
-    
-    crc = 0; 
-    while (--count >= 0) 
-    { 
-        crc = crc ^ (int16_t) *ptr++ << 8; 
-        i = 8; 
-        do 
-        { 
-            if (crc & 0x8000) 
-                crc = crc << 1 ^ 0x1021; 
-            else 
-                crc = crc << 1; 
-        } while(--i); 
-    } 
-    return (crc); 
+    // CRC-16, polynomial 0x1021, starting from 0. This used to be worked out a bit at a time right here, now it uses the table in OP_CRC16
+    if (count <= 0) return 0;
+    return (int16_t)OP_CRC16::calc(ptr, count);
 }
 
 // Turn on/off CRC checking
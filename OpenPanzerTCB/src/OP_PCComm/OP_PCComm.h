@@ -123,6 +123,12 @@
 #include "../EEPROMex/EEPROMex.h"
 #include "../OP_EEPROM/OP_EEPROM.h"
 #include "../OP_Radio/OP_Radio.h"
+#include "../OP_Battery/OP_Battery.h"
+#include "../OP_BattleLog/OP_BattleLog.h"
+#include "../OP_CRC16/OP_CRC16.h"
+#include "../OP_Format/OP_Format.h"
+#include "../OP_RAM/OP_RAM.h"
+#include "../OP_Scout/OP_Scout.h"
 #include "../OP_Settings/OP_Settings.h"
 
 
@@ -134,6 +140,10 @@
 // Commands received from PC
 #define INIT_STRING             "OPZ"   // The initialization string that tells us to start communicating with the PC
                                         // Can't be more characters than VALUE_BUFF - 1 
+#define PCCMD_READ_SCOUT        114     // PC wants one of the Scout ESC telemetry values, the ID says which (see DVID_SCOUT_ below). Can be sent while streaming radio data. Only answers if ScoutTelemetry is on.
+#define PCCMD_READ_RAM          115     // PC wants one of the RAM usage figures, the ID says which (see DVID_RAM_ below)
+#define PCCMD_STARTSTREAM_PACKED 116    // The PC wants the packed radio stream (see DVID_RADIOSTREAM_PACKED below). The value is the period in mS, 0 for the default. Stop it with PCCMD_STOPSTREAM_RADIO
+#define PCCMD_READ_RADIOSTATS   117     // PC wants some of the radio frame statistics, the ID says which (see DVID_RADIOSTATS_ below). Can be sent while streaming radio data.
 #define PCCMD_SABERTOOTH_BAUD   118     // PC wants us to set the baud rate on certain Sabertooth devices connected to Serial 2
 #define PCCMD_CONFPOLOLU_DRIVE  119     // PC wants us to configure a Pololu device connected to Serial 2 for use with drive motors
 #define PCCMD_CONFPOLOLU_TURRET 120     // PC wants us to configure a Pololu device connected to Serial 2 for use with turret motors
@@ -141,7 +151,9 @@
 #define PCCMD_STARTSTREAM_RADIO 122     // The PC wants us to stream channel pulse-widths
 #define PCCMD_STOPSTREAM_RADIO  123     // The PC wants us to stop streaming channel data
 #define PCCMD_UPDATE_EEPROM     124     // PC has given us a value to write to EEPROM
+#define PCCMD_READ_BATTERY      125     // PC wants one of the battery estimates, the ID says which (see DVID_BATTERY_ below)
 #define PCCMD_READ_EEPROM       126     // PC wants us to read EEPROM and return value
+#define PCCMD_READ_LOG          127     // PC wants an event from the battle log, the ID says which log (see DVID_LOG_ below), the value which event (0 = oldest)
 #define PCCMD_READ_VERSION      128     // PC wants to know what firmware version we're running
 #define PCCMD_STAY_AWAKE        129     // PC is tellings us to stay on the line
 #define PCCMD_MINOPC_VERSION    130     // PC requests the minimum version of OP Config the current version of TCB firmware requires
@@ -161,6 +173,77 @@
 // But radio streaming is an exception. 
 #define DVID_RADIOSTREAM_LO     401
 #define DVID_RADIOSTREAM_HI     402
+#define DVID_RADIOSTREAM_PACKED 403
+
+// Packed radio stream
+// Sent every period mS as Command|403|Data|Checksum, whether or not a new radio frame has arrived. Data is a bit stream, most significant bit first, 
+// six bits to a character, and each character has RADIOSTREAM_CHAR_OFFSET added so it prints ('0' to 'o', which never includes the delimiter). 
+// Field                Bits
+// Sequence             8       Counts up by one each sentence, so the PC can tell if it missed any
+// Frames               4       Radio frames received since the last sentence (stops at 15)
+// Failsafe             1       Radio is in failsafe
+// Ready                1       Radio decoder is in the ready state
+// Channel count        5       Number of channel pulses that follow
+// Pulses               11 each Pulse width in uS, minus MIN_POSSIBLE_PULSE
+// Sticks               9 each  Throttle, Turn, Elevation, Azimuth commands, plus 256
+// Special position     6       Turret stick special position (see turretStick_Positions in OP_RadioDefines.h)
+// Switches             4 each  Switch position of all AUXCHANNELS aux channels, 0 if not present or not a switch
+// With 16 channels that is 285 bits, or 48 characters. The checksum is the usual CRC but sent as three characters in the same six-bit code 
+// (four bits, then six, then six) rather than as a number, which could take six. The longest sentence is then 8 prefix + 48 data + delimiter 
+// + 3 checksum + newline = 61 bytes, inside the 63 that Arduino's 64 byte transmit buffer can hold. If the buffer hasn't got room for the 
+// whole sentence when it comes due (something else is still going out) that sentence is skipped rather than waited on, the PC sees the gap
+// in Sequence. 
+#define RADIOSTREAM_PACKED_mS   50      // Default period
+#define RADIOSTREAM_MIN_mS      20      // Sending the longest sentence takes about 5.3 mS at 115200, this leaves plenty of time for everything else
+#define RADIOSTREAM_MAX_mS      1000
+#define RADIOSTREAM_CHAR_OFFSET '0'
+
+// IDs the PC sends with PCCMD_READ_BATTERY. The device returns the value with the same ID. 
+#define DVID_BATTERY_VOLTAGE    410     // Measured voltage (mV)
+#define DVID_BATTERY_RESTING    411     // Estimated resting (no-load) voltage (mV)
+#define DVID_BATTERY_SAG        412     // Estimated voltage sag at full motor load (mV)
+#define DVID_BATTERY_CHARGE     413     // Estimated state of charge (percent)
+#define DVID_BATTERY_RUNTIME    414     // Predicted minutes of runtime left (BATTERY_RUNTIME_UNKNOWN if not yet known)
+#define DVID_BATTERY_CELLS      415     // Number of cells detected
+
+// IDs the PC sends with PCCMD_READ_LOG. The device returns the event with the same ID, as Seq|Time_mS|Type|Protocol|Team|Info in the value slot
+// (see OP_BattleLog.h). Asking for an event past the end of the log returns DVCMD_NOSUCH_VALUE, so the PC just keeps asking until it gets that. 
+#define DVID_LOG_RAM            420     // Events from this session (RAM)
+#define DVID_LOG_EEPROM         421     // Events saved to EEPROM, across power cycles
+#define DVID_LOG_CLEAR          422     // Empty both logs (the value is ignored)
+
+// IDs the PC sends with PCCMD_READ_RADIOSTATS. The device returns a group of values with the same ID, each followed by a delimiter (see radio_stats in OP_Radio.h)
+#define DVID_RADIOSTATS_SUMMARY 430     // Frames|LostFrames|MinInterval_uS|AvgInterval_uS|MaxInterval_uS|MaxLatency_uS|
+#define DVID_RADIOSTATS_INTERVAL 431    // Interval histogram, RADIO_HIST_BUCKETS counts
+#define DVID_RADIOSTATS_LATENCY 432     // Latency histogram, RADIO_HIST_BUCKETS counts
+#define DVID_RADIOSTATS_ERRORS  433     // DecodedFrames|FormatErrors|CRCErrors|RxFailsafe|LastFailsafe|
+#define DVID_RADIOSTATS_FAILSAFE 434    // Failsafe counts by reason, RADIO_FS_REASONS counts starting with the total
+#define DVID_RADIOSTATS_CLEAR   435     // Start the statistics over (the value is ignored)
+
+// IDs the PC sends with PCCMD_READ_RAM. The device returns the value in bytes with the same ID (see ram_stats in OP_RAM.h)
+#define DVID_RAM_DATA           440     // Initialized static variables
+#define DVID_RAM_BSS            441     // Zeroed static variables
+#define DVID_RAM_HEAP           442     // Heap in use now
+#define DVID_RAM_HEAPMAX        443     // Most heap ever in use
+#define DVID_RAM_STACK          444     // Stack in use now
+#define DVID_RAM_STACKMAX       445     // Deepest the stack has been
+#define DVID_RAM_FREE           446     // Gap between heap and stack now
+#define DVID_RAM_FREEMIN        447     // Smallest the gap has ever been
+
+// IDs the PC sends with PCCMD_READ_SCOUT. The device returns the value with the same ID, or DVCMD_NOSUCH_VALUE if that Scout isn't answering telemetry requests. 
+// The drive Scout (address A) uses the IDs starting at DVID_SCOUT_DRIVE, the turret Scout (address B) the same offsets from DVID_SCOUT_TURRET (see scout_telemetry in OP_Scout.h)
+// Telemetry keeps being polled while we talk to the PC, but with the motors stopped the currents will read zero. 
+#define DVID_SCOUT_DRIVE        450
+#define DVID_SCOUT_TURRET       460
+#define DVID_SCOUT_CURRENT_M1   0       // Motor 1 current (mA)
+#define DVID_SCOUT_CURRENT_M2   1       // Motor 2 current (mA)
+#define DVID_SCOUT_TEMPERATURE  2       // Board temperature (degrees C)
+#define DVID_SCOUT_VOLTAGE      3       // Input voltage (mV)
+#define DVID_SCOUT_FAULTS       4       // Fault flags (SCOUT_FAULT_ in OP_Scout.h)
+#define DVID_SCOUT_REPLIES      5       // Good replies received
+#define DVID_SCOUT_MISSES       6       // Requests that got no reply
+#define DVID_SCOUT_BADPACKETS   7       // Replies with a bad checksum
+#define DVID_SCOUT_COUNT        8
 
 // IDs returned by device that ARE EEPROM
 #define MIN_EEPROM_ID           1000    // Any ID over this number will be the ID of an eeprom variable. Any ID below it will be something else
@@ -204,7 +287,7 @@ struct DataSentence {
 class OP_PCComm
 {   public:
         OP_PCComm(void);                            // Constructor
-        static void begin(OP_EEPROM *, OP_Radio *, DEVICE); // Begin
+        static void begin(OP_EEPROM *, OP_Radio *, DEVICE, OP_Battery *); // Begin
         
         // Functions 
         static boolean CheckPC(void);               // Did the PC talk to us? 
@@ -228,6 +311,13 @@ class OP_PCComm
         static void TellPC_Goodbye(void);
         static void GivePC_Value_byID(uint16_t ID);                 // Sends an eeprom value by eeprom variable ID
         static void GivePC_Int(uint16_t returnID, int32_t val);     // Sends an arbitrary value up to int32
+        static void GivePC_Battery(uint16_t ID);                    // Sends one of the battery estimates
+        static void GivePC_LogEvent(uint16_t ID, uint16_t n);       // Sends one event from the battle log
+        static void GivePC_RadioStats(uint16_t ID);                 // Sends a group of the radio frame statistics
+        static void GivePC_RAM(uint16_t ID);                        // Sends one of the RAM usage figures
+        static void GivePC_Scout(uint16_t ID);                      // Sends one of the Scout ESC telemetry values
+        static uint8_t PackRadioFrame(char *out, uint8_t seq, uint8_t frames, int16_t *pulses, uint8_t count);    // Builds the data of a packed radio stream sentence, returns its length
+        static void PackBits(char *out, uint16_t &bitPos, uint16_t value, uint8_t bits);                            // Adds a field to it
         static void GivePC_FirmwareVersion(void);
 		static void GivePC_HardwareVersion(void);		
         static void GivePC_MinOPCVersion(void); 
@@ -251,6 +341,7 @@ class OP_PCComm
         static OP_EEPROM        *_op_eeprom;
         static HardwareSerial   *_serial;
         static OP_Radio         *_radio;
+        static OP_Battery       *_battery;
 		static uint8_t			_hardwareDevice;
         static uint32_t         WatchdogStartTime;
         static boolean          Timeout;
@@ -38,6 +38,13 @@ volatile decodeState_t  PPMDecode::State;                           // The curre
 volatile uint8_t        PPMDecode::NbrChannels;                     // the total number of channels detected in a complete frame
 volatile uint16_t       PPMDecode::tickStamp;                       // Timestamp
 volatile boolean        PPMDecode::NewFrame;                        // Boolean variable to indicate a new complete PPM frame has arrived or been read. 
+volatile decoder_stats  PPMDecode::Stats;                           // Frame and error counters
+volatile uint16_t       PPMDecode::FrameTicks;                      // Sum of the channel pulses received so far in this frame
+volatile uint16_t       PPMDecode::MinFrameTicks;                   // Shortest valid frame for the number of channels we have
+int16_t                 PPMDecode::History[MAX_PPM_CHANNELS][2];    // Previous two raw samples for each channel (oldest first)
+int16_t                 PPMDecode::Filtered[MAX_PPM_CHANNELS];      // Filter output
+boolean                 PPMDecode::FilterPrimed;                    // Has the history been filled yet
+uint16_t                PPMDecode::Glitches;                        // Spikes and dropped channels
 
 // Constructor
 PPMDecode::PPMDecode(){}
@@ -52,6 +59,7 @@ void PPMDecode::begin()
     State = NOT_SYNCHED_state;                                      // PPM decoder not yet synched
     NewFrame = false;                                               // We haven't received a frame yet, so it hasn't been read either
     clearTicks();                                                   // Set all tick counts to 0
+    resetFilter();                                                  // Start the glitch filter over
 
 
     // SETUP EXTERNAL INTERRUPT
@@ -120,6 +128,15 @@ void PPMDecode::clearTicks()
     }
     // Ticks has one extra element for the sync pulse, so we need to add one more initialization
     Ticks[MAX_PPM_CHANNELS] = 0;
+    FrameTicks = 0;
+}
+
+void PPMDecode::resetFilter()
+{
+    // The history gets filled from the first frame that comes through
+    FilterPrimed = false;
+    Glitches = 0;
+    for (uint8_t i=0; i<MAX_PPM_CHANNELS; i++) Filtered[i] = History[i][0] = History[i][1] = 0;
 }
 
 void PPMDecode::shutdown()
@@ -133,6 +150,7 @@ void PPMDecode::shutdown()
     State = NOT_SYNCHED_state;          // PPM decoder not synched
     NewFrame = false;                   //  No new data
     clearTicks();       
+    resetFilter();
 }
 
 // This is Atmega external Interrupt 5 on Atmega2560 pin 7 (TQFP). Arduino would call it external Interrupt 1 on Arduino pin 3. But they are the same thing.
@@ -161,10 +179,17 @@ void PPMDecode::INT5_PPM_ISR()
             if( Channel != NbrChannels)                         // If the number of channels is unstable, go into failsafe
             {                    
                 State = FAILSAFE_state;
+                Stats.FormatErrors++;
+            }
+            else if ((uint32_t)FrameTicks + elapsedTicks < MinFrameTicks || (uint32_t)FrameTicks + elapsedTicks > PPM_MAX_FRAME_TICKLEN)
+            {                                                   // Right number of channels but the frame is the wrong length, most likely a glitch 
+                Stats.FormatErrors++;                           // split or merged some pulses. Drop the frame but stay ready, the next one will probably be fine.
             }
             else                                                // In this case we have completed a full frame of channel data
             {
                 NewFrame = true;
+                Stats.FrameTime_uS = micros();                  // Safe to call here, it only reads the Timer 0 count
+                Stats.Frames++;
             }
         }
         else{                                                   // We're not running yet - should we be? 
@@ -179,6 +204,7 @@ void PPMDecode::INT5_PPM_ISR()
                 {   
                     State = READY_state;                        // Ok, we have enough complete frames, we think we know what we're doing now, so let's roll! 
                     NbrChannels = Channel;                      // Save the number of channels detected from this last frame of the acquisition period. This becomes our channel count. 
+                    MinFrameTicks = PPM_MIN_FRAME_TICKLEN(NbrChannels); // Worked out once here rather than on every frame
                 }                                               // Channel count will not change until the program is rebooted and the acquisition is run once again during startup
             }
             else if ( State == FAILSAFE_state)                  // We were in Failsafe, but if Channel == NbrChannels we read good pulses on 
@@ -191,6 +217,7 @@ void PPMDecode::INT5_PPM_ISR()
         }
         // Whenever we have a pulse this long, it is a signal to reset the channel number
         Channel = 0;                                            // Reset the channel counter to the beginning 
+        FrameTicks = 0;                                         // And the frame length
     }
     // Not a sync pulse, this is a channel pulse, so add em up.
     else if(Channel < MAX_PPM_CHANNELS) 
@@ -198,11 +225,13 @@ void PPMDecode::INT5_PPM_ISR()
         if( (elapsedTicks >= MIN_PPM_TICKLEN)  && (elapsedTicks <= MAX_PPM_TICKLEN) )   // Check for valid channel data
         { 
             Ticks[++Channel] = elapsedTicks;                    // Good pulse, save it. We'll do the math to convert Ticks to microseconds some other time, outside the ISR
+            FrameTicks += elapsedTicks;                         // Add it to the frame length
         }
         else if (State == READY_state)                          // This pulse does not fall into a valid range, go to failsafe
         {                       
             State = FAILSAFE_state;                             // Use fail safe values if input data invalid  
             Channel = 0;                                        // Reset the channel count, we'll start over next round
+            Stats.FormatErrors++;
         }
     }
 }
@@ -222,15 +251,89 @@ uint8_t PPMDecode::getChanCount()
 
 void PPMDecode::GetPPM_Frame( int16_t pulseArray[], int16_t chanCount)
 {
+int16_t raw[MAX_PPM_CHANNELS];
+boolean fresh;
+
+    if (chanCount > MAX_PPM_CHANNELS) chanCount = MAX_PPM_CHANNELS;
+
     byte sregRestore = SREG;                                    // Save interrupt register
     cli();                                                      // Disable interrupts
-    for (uint8_t i=0; i<chanCount; i++)
+    for (uint8_t i=0; i<MAX_PPM_CHANNELS; i++)
     {
-        pulseArray[i] = Ticks[i+1] / PPM_TICKS_PER_uS;          // Divide Ticks by number of ticks in a uS to convert to uS. We add 1 to Ticks array to skip the sync pulse which we don't care about here. 
+        raw[i] = Ticks[i+1] / PPM_TICKS_PER_uS;                 // Divide Ticks by number of ticks in a uS to convert to uS. We add 1 to Ticks array to skip the sync pulse which we don't care about here. 
     }
+    fresh = NewFrame;
+    NewFrame = false;                                           // We've read this frame, so it's no longer new
     SREG = sregRestore;                                         // Restore interrupt register
     
-    NewFrame = false;                                           // We've read this frame, so it's no longer new
+    // Only frames we haven't seen before go into the filter history, otherwise reading the same frame twice would count it twice. 
+    // The filter runs here rather than in the ISR so it doesn't add latency to the servo and other interrupts. 
+    if (fresh || !FilterPrimed) FilterFrame(raw);
+
+    for (uint8_t i=0; i<chanCount; i++) pulseArray[i] = Filtered[i];
+}
+
+void PPMDecode::FilterFrame(int16_t raw[])
+{
+int16_t a, b, c, m, d;
+
+    // Per channel this is a handful of 16-bit compares and moves, with no multiply or divide. tools/ppm_filter_test.cpp checks it and 
+    // times it on the PC (about 4 nS a channel there); it has not been timed on the Atmega2560 itself. 
+    for (uint8_t i=0; i<MAX_PPM_CHANNELS; i++)
+    {
+        c = raw[i];
+        a = History[i][0];
+        b = History[i][1];
+
+        // Range validation. The ISR won't store an out-of-range pulse, but a channel that never arrived in this frame still holds 
+        // whatever was there before (or zero). Repeat the last good sample instead.
+        if (c < MIN_POSSIBLE_PULSE || c > MAX_POSSIBLE_PULSE) { c = b; if (FilterPrimed) Glitches++; }
+
+        if (!FilterPrimed)
+        {   // First frame, fill the history with it
+            History[i][0] = History[i][1] = Filtered[i] = c;
+            continue;
+        }
+
+        // The middle sample is a glitch if it stood well out from the samples either side of it, in the same direction. We only know 
+        // that now it has neighbours on both sides, so a switch flip or the slew limit on a fast stick never counts. 
+        d = b - a; m = b - c;
+        if ((d > PPM_GLITCH_uS && m > PPM_GLITCH_uS) || (d < -PPM_GLITCH_uS && m < -PPM_GLITCH_uS)) Glitches++;
+
+        // Median of the last three samples
+        if (a > b) { d = a; a = b; b = d; }                     // Now a <= b
+        if (c <= a)      m = a;
+        else if (c >= b) m = b;
+        else             m = c;
+
+        History[i][0] = History[i][1];                          // Shift the history
+        History[i][1] = c;
+
+        // Limit how far the output can move in a single frame
+        d = m - Filtered[i];
+        if (d > PPM_MAX_DELTA_uS)        m = Filtered[i] + PPM_MAX_DELTA_uS;
+        else if (d < -PPM_MAX_DELTA_uS)  m = Filtered[i] - PPM_MAX_DELTA_uS;
+
+        Filtered[i] = m;
+    }
+    FilterPrimed = true;
+}
+
+uint16_t PPMDecode::getGlitchCount()
+{
+    return Glitches;
+}
+
+void PPMDecode::getStats(decoder_stats &ds)
+{
+    byte sregRestore = SREG;                                    // The ISR updates these, so copy them with interrupts off
+    cli();
+    ds.FrameTime_uS = Stats.FrameTime_uS;
+    ds.Frames = Stats.Frames;
+    ds.FormatErrors = Stats.FormatErrors;
+    ds.CRCErrors = Stats.CRCErrors;
+    ds.RxFailsafe = Stats.RxFailsafe;
+    SREG = sregRestore;
 }
 
 
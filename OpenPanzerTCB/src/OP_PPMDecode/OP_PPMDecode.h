@@ -60,6 +60,19 @@
 #define MAX_PPM_TICKLEN     (MAX_POSSIBLE_PULSE * PPM_TICKS_PER_uS)     // Maximum valid pulse width, converted to timer ticks
 #define SYNC_GAP_TICKLEN    (3000 * PPM_TICKS_PER_uS)       // we assume a space at least 3000uS is sync. Some use longer, but this would be the minimum (it exceeds the maximum possible pulse)
 
+// Glitch filtering
+// A complete frame (channel pulses plus the sync gap) must fall within these lengths or it is discarded and counted as a format error. 
+// Typical radios send a frame every 18-22.5 mS, but some encoders with few channels send much shorter ones, so the minimum is worked out from 
+// the channel count: every channel at the shortest possible pulse plus the shortest sync gap. The maximum is kept under the 32.7 mS it takes 
+// Timer 1 to wrap at 2 ticks per uS. 
+#define PPM_MIN_FRAME_TICKLEN(n) ((uint16_t)(n) * MIN_PPM_TICKLEN + SYNC_GAP_TICKLEN)
+#define PPM_MAX_FRAME_uS        32000
+#define PPM_MAX_FRAME_TICKLEN   ((uint32_t)PPM_MAX_FRAME_uS * PPM_TICKS_PER_uS)
+// Each channel is passed through a 3-sample median, which removes any single-frame spike at the cost of one frame of latency, 
+// and then slew-limited to this many uS of change per frame. A full-throw switch flip still gets through in two frames. 
+#define PPM_MAX_DELTA_uS        500
+#define PPM_GLITCH_uS           100                     // getGlitchCount() counts samples that stand out more than this from both neighbours, and dropped channels
+
 
 class PPMDecode
 {
@@ -73,14 +86,26 @@ class PPMDecode
         uint8_t                         getChanCount();                 // Returns the number of channels in a full frame
         static void                     INT5_PPM_ISR(void);             // The actual ISR will call this public member function, in order that it can access class variables
         static volatile boolean         NewFrame;                       // Has an unread frame of data arrived? 
+        void                            getStats(decoder_stats &ds);    // Copy out the frame and error counters
+        uint16_t                        getGlitchCount();               // Number of spikes and dropped channels seen by the glitch filter (see PPM_GLITCH_uS)
+        
         
     private:
+        static void                     FilterFrame(int16_t raw[]);     // Run the median and slew filter over a newly arrived frame
+        static void                     resetFilter();
+        static int16_t                  History[MAX_PPM_CHANNELS][2];   // Previous two raw samples for each channel (oldest first)
+        static int16_t                  Filtered[MAX_PPM_CHANNELS];     // Filter output, what GetPPM_Frame hands out
+        static boolean                  FilterPrimed;                   // Has the history been filled yet
+        static uint16_t                 Glitches;                       // Spikes and dropped channels
+        static volatile uint16_t        FrameTicks;                     // Sum of the channel pulses received so far in this frame
+        static volatile uint16_t        MinFrameTicks;                  // Shortest valid frame for NbrChannels, see PPM_MIN_FRAME_TICKLEN
         static volatile uint16_t        Ticks[MAX_PPM_CHANNELS + 1];    // Array holding the channel tick count. We have +1 since 0 will be our sync pulse, rest are channels
         static volatile uint8_t         Channel;                        // number of channels detected so far in the frame (first channel is 1)
         static volatile uint8_t         stateCount;                     // Counts the number of times this state has been repeated  
         static volatile decodeState_t   State;                          // The current state
         static volatile uint8_t         NbrChannels;                    // the total number of channels detected in a complete frame
         static volatile uint16_t        tickStamp;  
+        static volatile decoder_stats   Stats;                          // Frame and error counters
 };
 
 
@@ -240,6 +240,147 @@ void OP_PololuQik::clearError()
     this->sendMessage(message, 1);
 }
 
+
+
+// ------------------------------------------------------------------------------------------------------------------>>
+// ERROR POLLING
+// ------------------------------------------------------------------------------------------------------------------>>
+HardwareSerial  *OP_PololuQik::_pollPort = NULL;
+byte             OP_PololuQik::_pollID[QIK_MAX_DEVICES];
+uint8_t          OP_PololuQik::_pollCount = 0;
+boolean          OP_PololuQik::_answering[QIK_MAX_DEVICES];
+uint8_t          OP_PololuQik::_missRun[QIK_MAX_DEVICES];
+uint32_t         OP_PololuQik::_lastTry_mS[QIK_MAX_DEVICES];
+uint32_t         OP_PololuQik::_lastRestart_mS[QIK_MAX_DEVICES][2];
+uint8_t          OP_PololuQik::_resend[QIK_MAX_DEVICES];
+qik_error_stats  OP_PololuQik::_stats[QIK_MAX_DEVICES];
+int8_t           OP_PololuQik::_pendingSlot = -1;
+uint8_t          OP_PololuQik::_lastSlot;
+uint32_t         OP_PololuQik::_request_mS;
+
+int8_t OP_PololuQik::slotOf(byte deviceID)
+{
+    for (uint8_t i = 0; i < _pollCount; i++)
+    {
+        if (_pollID[i] == deviceID) return i;
+    }
+    return -1;
+}
+
+void OP_PololuQik::enableErrorPolling(byte deviceID, HardwareSerial *port)
+{
+    if (slotOf(deviceID) >= 0 || _pollCount >= QIK_MAX_DEVICES) return;     // Both motor objects of a Qik will ask
+    _pollPort = port;
+    _pollID[_pollCount] = deviceID;
+    _answering[_pollCount] = true;      // Until it misses QIK_ERROR_MISSES in a row
+    _pollCount++;
+}
+
+void OP_PololuQik::pollErrors(void)
+{
+uint32_t now;
+
+    if (_pollPort == NULL) return;
+
+    now = millis();
+    if (_pendingSlot >= 0)
+    {
+        if (_pollPort->available())
+        {
+            errorReply(_pollPort->read());
+            while (_pollPort->available()) _pollPort->read();   // Anything more isn't ours
+        }
+        else if (now - _request_mS >= QIK_ERROR_TIMEOUT_mS)
+        {
+            _stats[_pendingSlot].Misses++;
+            if (_missRun[_pendingSlot] < 255) _missRun[_pendingSlot]++;
+            if (_missRun[_pendingSlot] >= QIK_ERROR_MISSES) _answering[_pendingSlot] = false;
+            _pendingSlot = -1;
+        }
+        return;
+    }
+
+    // Nothing outstanding, so anything in the buffer is noise
+    while (_pollPort->available()) _pollPort->read();
+
+    if (now - _request_mS < QIK_ERROR_POLL_mS) return;
+    _request_mS = now;
+    for (uint8_t i = 1; i <= _pollCount; i++)
+    {
+        uint8_t slot = (_lastSlot + i) % _pollCount;
+        if (!_answering[slot] && (now - _lastTry_mS[slot] < QIK_ERROR_RETRY_mS)) continue;
+
+        // Full protocol, so only the Qik with this device ID answers. The command byte has its high bit cleared. 
+        unsigned char message[] = { QIK_INIT_COMMAND, _pollID[slot], QIK_GET_ERROR_BYTE & 0x7F };
+        unsigned char crc = 0;
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            crc = GetCRC((crc ^ message[j]));
+            _pollPort->write(message[j]);
+        }
+        _pollPort->write(crc);
+
+        _pendingSlot = slot;
+        _lastSlot = slot;
+        _lastTry_mS[slot] = now;
+        return;
+    }
+}
+
+void OP_PololuQik::errorReply(uint8_t err)
+{
+    int8_t slot = _pendingSlot;
+    uint32_t now = millis();
+    qik_error_stats &st = _stats[slot];
+
+    _pendingSlot = -1;
+    _answering[slot] = true;
+    _missRun[slot] = 0;
+    st.Polls++;
+    if (err == 0) return;
+    
+    st.LastError = err;
+    if (err & QIK_ERROR_SERIAL)
+    {   // A command since the last poll may have been thrown away, we can't tell which
+        st.SerialErrors++;
+        _resend[slot] |= 0x03;
+    }
+    for (uint8_t m = 1; m <= 2; m++)
+    {
+        if (err & QIK_ERROR_MOTOR(m))
+        {
+            st.MotorFaults[m-1]++;
+            if (now - _lastRestart_mS[slot][m-1] >= QIK_FAULT_RETRY_mS)
+            {
+                _lastRestart_mS[slot][m-1] = now;
+                _resend[slot] |= (1 << (m-1));
+            }
+        }
+    }
+}
+
+boolean OP_PololuQik::takeResend(byte motor) const
+{
+    int8_t slot = slotOf(_deviceID);
+    if (slot < 0 || motor < 1 || motor > 2) return false;
+    uint8_t bit = 1 << (motor - 1);
+    if (!(_resend[slot] & bit)) return false;
+    _resend[slot] &= ~bit;
+    return true;
+}
+
+boolean OP_PololuQik::getErrorStats(qik_error_stats &s) const
+{
+    int8_t slot = slotOf(_deviceID);
+    if (slot < 0)
+    {
+        memset(&s, 0, sizeof(qik_error_stats));
+        return false;
+    }
+    s = _stats[slot];
+    return (_answering[slot] && _stats[slot].Polls > 0);
+}
+
 // This one is commented out because we are not presently reading anything on the motor serial port, only transmitting
 /*
 byte OP_PololuQik::getConfigurationParameter(byte parameter)
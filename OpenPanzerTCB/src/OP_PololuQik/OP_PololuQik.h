@@ -72,6 +72,38 @@
 #define QIK_MOTOR_M1_BRAKE               0x07
 #define QIK_MOTOR_BRAKE_LEVEL            0x7F   // Maximum = 127
 
+// Error byte, returned by QIK_GET_ERROR_BYTE. Reading it clears it (and the red LED). Bits 0-3 only exist on the 2s12v10. 
+#define QIK_ERROR_M0_FAULT               0x01   // Motor 0 driver fault
+#define QIK_ERROR_M1_FAULT               0x02   // Motor 1 driver fault
+#define QIK_ERROR_M0_OVERCURRENT         0x04   // Motor 0 over current
+#define QIK_ERROR_M1_OVERCURRENT         0x08   // Motor 1 over current
+#define QIK_ERROR_SERIAL_HARDWARE        0x10   // Framing error or buffer overrun
+#define QIK_ERROR_CRC                    0x20   // A packet failed its CRC and was thrown away
+#define QIK_ERROR_FORMAT                 0x40   // A packet made no sense and was thrown away
+#define QIK_ERROR_TIMEOUT                0x80   // Serial timeout (we leave this disabled)
+#define QIK_ERROR_SERIAL                 (QIK_ERROR_SERIAL_HARDWARE | QIK_ERROR_CRC | QIK_ERROR_FORMAT)
+#define QIK_ERROR_MOTOR(m)               ((m) == 1 ? (QIK_ERROR_M0_FAULT | QIK_ERROR_M0_OVERCURRENT) : (QIK_ERROR_M1_FAULT | QIK_ERROR_M1_OVERCURRENT))
+
+// Error polling
+// The Qik only speaks when spoken to, and its reply is a single byte with no address. So we ask one Qik at a time and never send the next question until the 
+// first has been answered or has timed out. A serial error means a command sent since the last poll may have been thrown away, so both motors are flagged to 
+// have their speed sent again. A motor fault or over current shuts the motor down until the next speed command, so that motor is flagged too, but no more 
+// often than QIK_FAULT_RETRY_mS so a stalled motor isn't hammered. 
+#define QIK_MAX_DEVICES                  2      // Drive and turret
+#define QIK_ERROR_POLL_mS               50      // How often we ask for the next error byte
+#define QIK_ERROR_TIMEOUT_mS            10      // How long we wait for it. The reply takes well under 1 mS at 38400
+#define QIK_ERROR_MISSES                 5      // Unanswered requests in a row before we decide the Qik isn't answering (receive line not connected, for example)
+#define QIK_ERROR_RETRY_mS            2000      // How often we ask a Qik that isn't answering
+#define QIK_FAULT_RETRY_mS             500      // Least time between restarts of a faulted motor
+
+typedef struct {
+    uint8_t  LastError;                         // Most recent non-zero error byte
+    uint16_t Polls;                             // Error bytes received
+    uint16_t SerialErrors;                      // Replies reporting a CRC, format or serial hardware error
+    uint16_t MotorFaults[2];                    // Replies reporting a fault or over current, motor 1 (M0) and 2 (M1)
+    uint16_t Misses;                            // Requests that got no reply
+} qik_error_stats;
+
 // CRC7 lookup table, takes up 256 bytes, stick it in PROGMEM
 const unsigned char CRC7Table[256] PROGMEM_FAR = 
 {
@@ -161,6 +193,29 @@ class OP_PololuQik
     */
     boolean configurePololu(byte SetDeviceID);
 
+    /*!
+    Adds this Qik to the devices whose error byte is polled. Shared by all Qiks on the port. 
+    */
+    inline void enableErrorPolling() const { enableErrorPolling(_deviceID, _port); }
+    static void enableErrorPolling(byte deviceID, HardwareSerial *port);
+
+    /*!
+    Reads any reply that has arrived and asks the next Qik for its error byte when it is time. Never waits on the port. 
+    */
+    static void pollErrors(void);
+
+    /*!
+    Returns true once if the motor's last speed command should be sent again, because the Qik reported an error that may have cost us that command.
+    \param motor The motor number, 1 or 2.
+    */
+    boolean takeResend(byte motor) const;
+
+    /*!
+    Copies the error counts for this Qik.
+    \return True if the Qik is answering error polls. 
+    */
+    boolean getErrorStats(qik_error_stats &s) const;
+
 
   private:
     void sendMessage(unsigned char message[], unsigned int length); // Sends a message of any length, including CRC
@@ -172,9 +227,26 @@ class OP_PololuQik
     //byte getConfigurationParameter(byte parameter);       // Presently we are only transmitting, not receiving. 
     byte setConfigurationParameter(byte parameter, byte value);
 
+    static int8_t slotOf(byte deviceID);
+    static void   errorReply(uint8_t err);
+
   private:
     const byte      _deviceID;  
     HardwareSerial *_port;  
+
+    // Error polling, shared by all Qiks
+    static HardwareSerial  *_pollPort;
+    static byte             _pollID[QIK_MAX_DEVICES];
+    static uint8_t          _pollCount;
+    static boolean          _answering[QIK_MAX_DEVICES];
+    static uint8_t          _missRun[QIK_MAX_DEVICES];
+    static uint32_t         _lastTry_mS[QIK_MAX_DEVICES];
+    static uint32_t         _lastRestart_mS[QIK_MAX_DEVICES][2];
+    static uint8_t          _resend[QIK_MAX_DEVICES];        // Bit 0 motor 1, bit 1 motor 2
+    static qik_error_stats  _stats[QIK_MAX_DEVICES];
+    static int8_t           _pendingSlot;                    // -1 if no request outstanding
+    static uint8_t          _lastSlot;
+    static uint32_t         _request_mS;
 };
 
 
@@ -0,0 +1,120 @@
+/* OP_RAM.cpp       Open Panzer RAM - stack and heap high-water tracking
+ * Source:          openpanzer.org
+ * Authors:         Luke Middleton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "OP_RAM.h"
+
+// Linker and avr-libc symbols marking out RAM
+extern uint8_t  __data_start;                   // Start of .data, which is also the start of our RAM
+extern uint8_t  __data_end;
+extern uint8_t  __bss_start;
+extern uint8_t  __bss_end;
+extern uint8_t  __heap_start;                   // Heap begins right after .bss
+extern uint8_t  _end;
+extern uint8_t  __stack;                        // Top of RAM (RAMEND)
+extern char   * __brkval;                       // Top of the heap, 0 until malloc (or new) is first used
+
+// Static variables must be declared outside the class
+uint16_t        OP_RAM::FreeMin = 0xFFFF;
+uint8_t       * OP_RAM::HeapHigh = &__heap_start;
+uint16_t        OP_RAM::StackMax = 0;
+uint32_t        OP_RAM::LastScan_mS = 0;
+
+
+// Paint the free RAM. This runs in .init3, after the stack pointer is set up and before static variables are initialized or any 
+// constructors are called, and nothing has been pushed on the stack yet. It has to be naked (no prologue) and it can't use the stack, 
+// which is why it's in assembler. Fills from _end up to and including __stack with RAM_PAINT. 
+void OP_RAM_Paint(void) __attribute__ ((naked, used, section (".init3")));
+void OP_RAM_Paint(void)
+{
+    __asm volatile (
+        "    ldi r30, lo8(_end)         \n"
+        "    ldi r31, hi8(_end)         \n"
+        "    ldi r24, %0                \n"
+        "    ldi r25, hi8(__stack)      \n"
+        "    rjmp 2f                    \n"
+        "1:  st Z+, r24                 \n"
+        "2:  cpi r30, lo8(__stack)      \n"
+        "    cpc r31, r25               \n"
+        "    brlo 1b                    \n"
+        "    breq 1b                    \n"
+        :: "M" (RAM_PAINT));
+}
+
+
+uint8_t * OP_RAM::heapTop(void)
+{
+    return __brkval == 0 ? &__heap_start : (uint8_t *)__brkval;
+}
+
+uint16_t OP_RAM::freeNow(void)
+{
+uint8_t *sp = (uint8_t *)SP;
+uint8_t *top = heapTop();
+
+    return sp > top ? sp - top : 0;
+}
+
+void OP_RAM::update(void)
+{
+uint8_t *top = heapTop();
+
+    // The heap can shrink again (avr-libc lowers __brkval when the top chunk is freed, and the radio decoders come and go), so keep 
+    // our own high-water mark. This is only a compare, so it's done every loop rather than waiting for the scan. 
+    if (top > HeapHigh) HeapHigh = top;
+    if (millis() - LastScan_mS >= RAM_SCAN_mS) scan();
+}
+
+void OP_RAM::scan(void)
+{
+uint8_t *p;
+uint8_t *sp = (uint8_t *)SP;
+uint16_t count = 0;
+uint16_t stack;
+
+    LastScan_mS = millis();
+    p = heapTop();
+    if (p > HeapHigh) HeapHigh = p;
+
+    // Count painted bytes up from the highest the heap has ever been, not from where it is now - heap that has since been freed is no 
+    // longer painted and would look like stack. We stop at the first byte the stack has changed, or at the stack pointer itself in case 
+    // the paint happened to survive somewhere the stack is using right now. 
+    p = HeapHigh;
+    while (p < sp && *p == RAM_PAINT) { p++; count++; }
+    if (count < FreeMin) FreeMin = count;
+
+    // Everything from there up has been used by the stack
+    stack = (p < sp) ? (&__stack - p) + 1 : (&__stack - sp);
+    if (stack > StackMax) StackMax = stack;
+}
+
+void OP_RAM::getStats(ram_stats &rs)
+{
+uint8_t *top;
+
+    scan();
+    top = heapTop();
+    rs.DataBytes  = &__data_end - &__data_start;
+    rs.BssBytes   = &__bss_end - &__bss_start;
+    rs.HeapBytes  = top - &__heap_start;
+    rs.HeapMax    = HeapHigh - &__heap_start;
+    rs.StackBytes = &__stack - (uint8_t *)SP;
+    rs.StackMax   = StackMax;
+    rs.FreeBytes  = freeNow();
+    rs.FreeMin    = FreeMin;
+}
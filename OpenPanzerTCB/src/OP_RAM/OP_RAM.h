@@ -0,0 +1,68 @@
+/* OP_RAM.h         Open Panzer RAM - stack and heap high-water tracking
+ * Source:          openpanzer.org
+ * Authors:         Luke Middleton
+ *
+ * The Atmega2560 has 8K of RAM, shared by our static variables (the EEPROM ramcopy, IR buffer, timer slots, serial buffers and so on) 
+ * at the bottom, the heap above them, and the stack growing down from the top. Nothing stops the stack running into the heap, and if it 
+ * does we just crash. So we keep track of how close they have come. 
+ * 
+ * Before main() even runs, all the free RAM between the end of the static variables and the top of the stack is filled with RAM_PAINT. 
+ * Every so often update() starts at the top of the heap and counts how many bytes are still painted. Those bytes have never been touched 
+ * by the stack, so the count is the smallest gap there has ever been between stack and heap. The heap top is recorded at the same time. 
+ * The static RAM figures come from the linker symbols, so they are exact. For a breakdown by library look at the sketch's .map file. 
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef OP_RAM_h
+#define OP_RAM_h
+
+#include <Arduino.h>
+
+
+#define RAM_PAINT               0xC5            // Free RAM is filled with this at boot
+#define RAM_SCAN_mS             5000            // How often update() scans for the stack high-water mark. A scan reads each untouched byte once, 
+                                                // with 5K free that is about 2 mS.
+
+typedef struct ram_stats {
+    uint16_t DataBytes;                         // Initialized static variables (.data)
+    uint16_t BssBytes;                          // Zeroed static variables (.bss)
+    uint16_t HeapBytes;                         // Heap in use now
+    uint16_t HeapMax;                           // Most heap ever seen in use
+    uint16_t StackBytes;                        // Stack in use now
+    uint16_t StackMax;                          // Deepest the stack has ever been
+    uint16_t FreeBytes;                         // Gap between heap and stack now
+    uint16_t FreeMin;                           // Smallest that gap has ever been. If this ever reaches 0 we have probably already crashed
+} ram_stats;
+
+
+class OP_RAM
+{
+    public:
+        static void             update(void);                   // Call every loop, tracks the heap top and scans for the stack high-water mark every RAM_SCAN_mS
+        static void             scan(void);                     // Scan right now
+        static void             getStats(ram_stats &rs);        // Scans, then copies out the figures
+        static uint16_t         freeNow(void);                  // Quick check of the present gap between heap and stack, no scan
+
+    private:
+        static uint8_t        * heapTop(void);                  // First byte above the heap
+        static uint16_t         FreeMin;
+        static uint8_t        * HeapHigh;                       // Highest the top of the heap has ever been
+        static uint16_t         StackMax;
+        static uint32_t         LastScan_mS;
+};
+
+
+#endif
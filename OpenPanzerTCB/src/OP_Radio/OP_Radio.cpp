@@ -29,15 +29,28 @@ sf_channel                  OP_Radio::SpecialStick;                 // This hold
 PPMDecode                 * OP_Radio::PPMDecoder;                   // PPM Decoder object       
 SBusDecode                * OP_Radio::SBusDecoder;                  // SBus Decoder object
 iBusDecode                * OP_Radio::iBusDecoder;                  // iBus Decoder object
-boolean                     OP_Radio::PPMFailed;
-boolean                     OP_Radio::SBusFailed;
-boolean                     OP_Radio::iBusFailed;       
+CRSFDecode                * OP_Radio::CRSFDecoder;                  // CRSF Decoder object
+boolean                     OP_Radio::Detecting;
+RADIO_PROTOCOL              OP_Radio::DetectProtocol;
+RADIO_PROTOCOL              OP_Radio::LastProtocol;
+uint32_t                    OP_Radio::DetectWindow_mS;
+uint32_t                    OP_Radio::DetectProtocol_mS;
+uint8_t                     OP_Radio::DetectSlot;
+int8_t                      OP_Radio::DetectScores[RADIO_DETECT_WINDOWS];
+decoder_stats               OP_Radio::DetectBase;
+uint32_t                    OP_Radio::FailsafeStart_mS;
 RADIO_PROTOCOL              OP_Radio::Protocol;                     // Which protocol detected
 OP_SimpleTimer            * OP_Radio::radioTimer;
 uint8_t                     OP_Radio::channelCount;
 common_channel_settings     OP_Radio::ptrCommonChannelSettings[(STICKCHANNELS + AUXCHANNELS)];    // This array of pointers to common channel settings for all channels allows us to loop through them quickly, see GetPPMFrame() in RadioInputs tab. 
 int16_t                     OP_Radio::ignoreTurretDelay_mS;
 int                         OP_Radio::WatchdogTimerID;
+radio_stats                 OP_Radio::Stats;
+decoder_stats               OP_Radio::DecoderBase;
+decoder_stats               OP_Radio::DecoderLastFrame;
+uint32_t                    OP_Radio::AvgInterval_x16;
+boolean                     OP_Radio::HaveLastFrame;
+int16_t                   * OP_Radio::FrameCapture;
 
 
 
@@ -68,10 +81,18 @@ const __FlashStringHelper *TurretStickPosition(uint8_t TSP)
 const __FlashStringHelper *RadioProtocol(RADIO_PROTOCOL RP)          
 {
     if ( RP > LAST_RADIOPROTOCOL) RP = PROTOCOL_NONE;
-    const __FlashStringHelper *Names[LAST_RADIOPROTOCOL+1]={F("None Detected"),F("PPM"),F("SBus"),F("iBus")};
+    const __FlashStringHelper *Names[LAST_RADIOPROTOCOL+1]={F("None Detected"),F("PPM"),F("SBus"),F("iBus"),F("CRSF")};
     return Names[RP];
 }
 
+// Returns a pointer to a flash-stored character string that is the name of the failsafe reason
+const __FlashStringHelper *RadioFailsafeReason(uint8_t reason)
+{
+    if (reason >= RADIO_FS_REASONS) reason = RADIO_FS_NONE;
+    const __FlashStringHelper *Names[RADIO_FS_REASONS]={F("None"),F("Timeout"),F("Receiver"),F("Checksum"),F("Format"),F("Main loop")};
+    return Names[reason];
+}
+
 // ---------------------------------------------------------------------------------------------------------------------------------------------------->>
 // CONSTRUCT AND BEGIN (SETUPS)
 // ---------------------------------------------------------------------------------------------------------------------------------------------------->>
@@ -85,9 +106,8 @@ OP_Radio::OP_Radio()
     UsingSpecialPositions = false;
     InFailsafe = false;
     
-    PPMFailed = false;
-    SBusFailed = false;
-    iBusFailed = false;
+    Detecting = false;
+    LastProtocol = PROTOCOL_SBUS;   // Whatever you set here, will be the first protocol checked
 }
 
 
@@ -96,151 +116,166 @@ void OP_Radio::saveTimer(OP_SimpleTimer * t)
     radioTimer = t;
 }
 
+
+// ---------------------------------------------------------------------------------------------------------------------------------------------------->>
+// PROTOCOL DETECTION
+// ---------------------------------------------------------------------------------------------------------------------------------------------------->>
+// PPM (external interrupt 5) and the serial protocols (Serial 3 Rx) all come in on the same pin, so only one decoder can be listening at a time - 
+// with the PPM interrupt enabled every serial bit would set it off, at CRSF speeds that is an interrupt storm. We therefore give each protocol 
+// a turn on the pin in order, PPM, SBus, iBus, CRSF, and shut one decoder down before starting the next. 
+// The candidate is scored over a sliding window: every frame its decoder accepts counts for it, and so does every frame in which the receiver said 
+// it was in failsafe (right protocol, just no signal yet). Every format or checksum error counts against it. It wins once its decoder reaches 
+// READY_state with a score of at least RADIO_DETECT_MIN_SCORE. A protocol that hasn't scored anything after RADIO_DETECT_DWELL_mS makes way 
+// for the next one, but one that is scoring gets to keep the pin until it wins or RADIO_DETECT_MAX_DWELL_mS runs out. 
+// This keeps going so long as it's called, so the calling routine needs to also be checking OP_Radio.Status(). When status returns READY_state, 
+// a protocol has been successfully detected and the calling routine can check OP_Radio.getProtocol() to find out which one we found. 
 void OP_Radio::detect(void)
 {
-// This function tries to detect a radio signal (PPM, SBus, or iBus). It tries one, if it fails, it tries the next,
-// and keeps going until it tries the last one, and then returns to the first and starts over. It keeps trying so long as it's called, 
-// so the calling routine needs to also be checking OP_Radio.Status(). When status returns READY_state, then the calling routine knows a protocol
-// has been successfully detected. At that time the calling routine can check OP_Radio.getProtocol() to find out which one we found. 
+int16_t score;
 
-static RADIO_PROTOCOL tryProtocol = PROTOCOL_SBUS;     // Whatever you set here, will be the first one checked
-static boolean started = false;
+    if (Protocol != PROTOCOL_NONE) return;          // We already have one
 
-    // START TRYING A PROTOCOL
-    // ---------------------------------------------------------------------------->>
-    if (started == false)
-    {
-        switch (tryProtocol)
-        {
-            
-            case PROTOCOL_PPM:
-                if (!PPMFailed)
-                {   // Try to detect PPM
-                    PPMDecoder = new PPMDecode;
-                    PPMDecoder->begin();
-                    // Start a try timer
-                    radioTimer->setTimeout(PPM_TRY_TIME, failPPM);
-                    started = true;
-                    //Serial.println(F("Searching for PPM..."));
-                }
-                break;
-                
-            case PROTOCOL_SBUS:
-                if (!SBusFailed)
-                {   // See if we can detect SBus
-                    SBusDecoder = new SBusDecode;
-                    SBusDecoder->begin();
-                    // Start a try timer
-                    radioTimer->setTimeout(SBUS_TRY_TIME, failSBus);
-                    started = true;
-                    //Serial.println(F("Searching for SBus..."));
-                }
-                break;
+    if (!Detecting) StartDetect();
 
-            case PROTOCOL_iBUS:
-                if (!iBusFailed)
-                {   // See if we can detect iBus
-                    iBusDecoder = new iBusDecode;
-                    iBusDecoder->begin();
-                    // Start a try timer
-                    radioTimer->setTimeout(iBUS_TRY_TIME, failiBus);
-                    started = true;
-                    //Serial.println(F("Searching for iBus..."));
-                }
-                break;
+    // Serial decoders need to be polled, PPM updates itself
+    UpdateDecoder(DetectProtocol);
+
+    // Score the candidate for the present window
+    ScoreCandidate();
+    score = DetectScore();
+
+    // Do we have a winner? 
+    if (DecoderState(DetectProtocol) == READY_state && score >= RADIO_DETECT_MIN_SCORE)
+    {
+        Protocol = LastProtocol = DetectProtocol;   // Try this protocol first next time
+        Detecting = false;
+
+        if (didWeBegin)
+        {   // This is background detection after a failsafe. The receiver may have a different number of channels than the last one, 
+            // and its decoder has its own counters. 
+            SetupChannels();
+            GetDecoderStats(DecoderBase);
+            DecoderLastFrame = DecoderBase;
+            HaveLastFrame = false;
+            FailsafeStart_mS = millis();            // Give the new receiver a full RADIO_REDETECT_mS before we would go looking again
         }
+        return;
     }
-    // KEEP TRYING A PROTOCOL
-    // ---------------------------------------------------------------------------->>
-    else
+
+    // Roll the window along
+    if (millis() - DetectWindow_mS >= RADIO_DETECT_WINDOW_mS)
     {
-        switch (tryProtocol)
+        DetectWindow_mS = millis();
+        if (++DetectSlot >= RADIO_DETECT_WINDOWS) DetectSlot = 0;
+        DetectScores[DetectSlot] = 0;
+        GetDecoderStats(DetectProtocol, DetectBase);
+    }
+
+    // Give the next protocol a turn? The old decoder is shut down before the next one starts, so they never share the pin. 
+    if (((millis() - DetectProtocol_mS) >= RADIO_DETECT_DWELL_mS && score <= 0) || (millis() - DetectProtocol_mS) >= RADIO_DETECT_MAX_DWELL_mS)
+    {
+        StopDecoder(DetectProtocol);
+        switch (DetectProtocol)
         {
-            case PROTOCOL_PPM:
-                if (!PPMFailed && PPMDecoder->getState() == READY_state) Protocol = PROTOCOL_PPM;   // Set protocol to PPM
-                break;
-                
-            case PROTOCOL_SBUS:
-                if (!SBusFailed)
-                {   // SBus needs to be polled
-                    SBusDecoder->update();
-                    if (SBusDecoder->getState() == READY_state) { Protocol = PROTOCOL_SBUS; }       // Set protocol to SBUS
-                }
-                break;
-            
-            case PROTOCOL_iBUS:
-                if (!iBusFailed)
-                {   // iBus needs to be polled
-                    iBusDecoder->update();
-                    if (iBusDecoder->getState() == READY_state) { Protocol = PROTOCOL_iBUS; }       // Set protocol to iBUS
-                }
-                break;
+            case PROTOCOL_PPM:  DetectProtocol = PROTOCOL_SBUS; break;
+            case PROTOCOL_SBUS: DetectProtocol = PROTOCOL_iBUS; break;
+            case PROTOCOL_iBUS: DetectProtocol = PROTOCOL_CRSF; break;
+            default:            DetectProtocol = PROTOCOL_PPM;  break;
         }
+        StartCandidate();
     }
+}
 
-    // FAIL A PROTOCOL, AND TRY THE OTHER ONE INSTEAD
-    // ---------------------------------------------------------------------------->>
-    switch (tryProtocol)
-    {
-        case PROTOCOL_PPM:
-            if (PPMFailed)
-            {
-                // Shutdown and deconstruct object
-                PPMDecoder->shutdown();
-                delete PPMDecoder;      
+void OP_Radio::StartDetect(void)
+{
+    DetectProtocol = LastProtocol;
+    StartCandidate();
+    Detecting = true;
+}
 
-                // Try the next protocol - SBus
-                SBusFailed = started = false;
-                tryProtocol = PROTOCOL_SBUS;
-            }
-            break;
-            
-        case PROTOCOL_SBUS:
-            if (SBusFailed) 
-            {
-                // Shutdown and deconstruct object
-                SBusDecoder->shutdown();
-                delete SBusDecoder;             
-                
-                // Try the next protocol - iBus
-                iBusFailed = started = false;
-                tryProtocol = PROTOCOL_iBUS;    
-            }
-            break;
+void OP_Radio::StartCandidate(void)
+{
+    StartDecoder(DetectProtocol);
+    DetectProtocol_mS = DetectWindow_mS = millis();
+    DetectSlot = 0;
+    for (uint8_t i = 0; i < RADIO_DETECT_WINDOWS; i++) DetectScores[i] = 0;
+    GetDecoderStats(DetectProtocol, DetectBase);
+}
 
-        case PROTOCOL_iBUS:
-            if (iBusFailed) 
-            {
-                // Shutdown and deconstruct object
-                iBusDecoder->shutdown();
-                delete iBusDecoder;             
-                
-                // Try the next protocol - PPM
-                PPMFailed = started = false;
-                tryProtocol = PROTOCOL_PPM;   
-            }
-            break;
+void OP_Radio::Redetect(void)
+{
+    // Drop whatever we were using, detect() will start over and go through all the protocols. The one we had gets tried first, 
+    // so if the same receiver simply comes back we will find it again quickly.
+    LastProtocol = Protocol;
+    StopDecoder(Protocol);
+    Protocol = PROTOCOL_NONE;
+    Detecting = false;
+}
+
+void OP_Radio::ScoreCandidate(void)
+{
+decoder_stats ds;
+int16_t score;
+
+    // Score for the present window, from what the decoder has counted since the window started
+    GetDecoderStats(DetectProtocol, ds);
+    score = (int16_t)(uint16_t)(ds.Frames - DetectBase.Frames) + (int16_t)(uint16_t)(ds.RxFailsafe - DetectBase.RxFailsafe)
+          - (int16_t)(uint16_t)(ds.FormatErrors - DetectBase.FormatErrors) - (int16_t)(uint16_t)(ds.CRCErrors - DetectBase.CRCErrors);
+    DetectScores[DetectSlot] = constrain(score, -128, 127);
+}
+
+int16_t OP_Radio::DetectScore(void)
+{
+int16_t score = 0;
+
+    for (uint8_t i = 0; i < RADIO_DETECT_WINDOWS; i++) score += DetectScores[i];
+    return score;
+}
+
+void OP_Radio::StartDecoder(RADIO_PROTOCOL p)
+{
+    switch (p)
+    {
+        case PROTOCOL_PPM:  PPMDecoder = new PPMDecode;     PPMDecoder->begin();    break;
+        case PROTOCOL_SBUS: SBusDecoder = new SBusDecode;   SBusDecoder->begin();   break;
+        case PROTOCOL_iBUS: iBusDecoder = new iBusDecode;   iBusDecoder->begin();   break;
+        case PROTOCOL_CRSF: CRSFDecoder = new CRSFDecode;   CRSFDecoder->begin();   break;
     }
-    
-    // Every time this function is called, update the timer.
-    // We may be calling this from the PCComm class outside of the sketch, 
-    // so we can't count on the main loop updating it
-    radioTimer->run();
 }
 
-void OP_Radio::failPPM(void)
+void OP_Radio::StopDecoder(RADIO_PROTOCOL p)
 {
-    PPMFailed = true;
+    // Shutdown and deconstruct object
+    switch (p)
+    {
+        case PROTOCOL_PPM:  PPMDecoder->shutdown();     delete PPMDecoder;      break;
+        case PROTOCOL_SBUS: SBusDecoder->shutdown();    delete SBusDecoder;     break;
+        case PROTOCOL_iBUS: iBusDecoder->shutdown();    delete iBusDecoder;     break;
+        case PROTOCOL_CRSF: CRSFDecoder->shutdown();    delete CRSFDecoder;     break;
+    }
 }
 
-void OP_Radio::failSBus(void)
+void OP_Radio::UpdateDecoder(RADIO_PROTOCOL p)
 {
-    SBusFailed = true;
+    switch (p)
+    {
+        case PROTOCOL_SBUS: SBusDecoder->update();      break;
+        case PROTOCOL_iBUS: iBusDecoder->update();      break;
+        case PROTOCOL_CRSF: CRSFDecoder->update();      break;
+        default:                                        break;  // PPM doesn't need polling
+    }
 }
 
-void OP_Radio::failiBus(void)
+decodeState_t OP_Radio::DecoderState(RADIO_PROTOCOL p)
 {
-    iBusFailed = true;
+    switch (p)
+    {
+        case PROTOCOL_PPM:  return PPMDecoder->getState();
+        case PROTOCOL_SBUS: return SBusDecoder->getState();
+        case PROTOCOL_iBUS: return iBusDecoder->getState();
+        case PROTOCOL_CRSF: return CRSFDecoder->getState();
+        default:            return NOT_SYNCHED_state;
+    }
 }
 
 
@@ -248,37 +283,15 @@ void OP_Radio::failiBus(void)
 // This initializes our channels to the settings saved in eeprom. 
 void OP_Radio::begin(_eeprom_data *storage)
 {
-    // Run this so we know how many channels the radio even has
-    getChannelCount();
-    
-    // We assume the radio has at least 4 channels for the two sticks, and we are going to use them
-    ChannelsUtilized = 4;   // Later we will add any aux channels utilized as well
-
-    // Initialize all channels as present = false
-	Sticks.Throttle.present = false;
-	Sticks.Turn.present = false;
-	Sticks.Elevation.present = false;
-	Sticks.Azimuth.present = false;
-	for (uint8_t a=0; a<AUXCHANNELS; a++)
-	{
-		AuxChannel[a].present = false; 
-	}
-    
-    // All channels are initalized to present = false. If the actual channel number is within the number of channels
-    // detected in the PPM stream, we change the present flag to true. 
     // Load stick settings
-        Sticks.Throttle.Settings = &storage->ThrottleSettings;
-        Sticks.Throttle.ignore = false;
-        if (Sticks.Throttle.Settings->channelNum <= channelCount) { Sticks.Throttle.present = true; }
-        Sticks.Turn.Settings = &storage->TurnSettings;
-        Sticks.Turn.ignore = false;
-        if (Sticks.Turn.Settings->channelNum <= channelCount) { Sticks.Turn.present = true; }
-        Sticks.Elevation.Settings = &storage->ElevationSettings;
-        Sticks.Elevation.ignore = false;
-        if (Sticks.Elevation.Settings->channelNum <= channelCount) { Sticks.Elevation.present = true; }
-        Sticks.Azimuth.Settings = &storage->AzimuthSettings;
-        Sticks.Azimuth.ignore = false;
-        if (Sticks.Azimuth.Settings->channelNum <= channelCount) { Sticks.Azimuth.present = true; }
+    Sticks.Throttle.Settings = &storage->ThrottleSettings;
+    Sticks.Throttle.ignore = false;
+    Sticks.Turn.Settings = &storage->TurnSettings;
+    Sticks.Turn.ignore = false;
+    Sticks.Elevation.Settings = &storage->ElevationSettings;
+    Sticks.Elevation.ignore = false;
+    Sticks.Azimuth.Settings = &storage->AzimuthSettings;
+    Sticks.Azimuth.ignore = false;
 
     // Another adjustment that needs to be made - if we are using the turret stick for special commands (stick held to corners and such), then 
     // we need to adjust our pulse min/max values for those channels. The reason being, at some point close to the stick extreme 
@@ -309,17 +322,52 @@ void OP_Radio::begin(_eeprom_data *storage)
     // Initialize our abstract "special stick"
         SpecialStick.Position = MC;                  // Initialize to stick centered
     
-    // Load aux channel settings, and determine the total number of "utilized" channels
+    // Load aux channel settings
         for (uint8_t a=0; a<AUXCHANNELS; a++)
         {
             AuxChannel[a].Settings = &storage->Aux_ChannelSettings[a];
-            if (AuxChannel[a].Settings->channelNum > 0 && AuxChannel[a].Settings->channelNum <= channelCount) 
-            { 
-                AuxChannel[a].present = true; 
-                ChannelsUtilized++; 
-            }
         }
     
+    // Work out which channels are present in the radio stream
+    SetupChannels();
+    
+    // Start the frame statistics now that we know which decoder we're using
+    ClearStats();
+    
+    // The begin() function is done - set a flag so we know we don't have to come here again. We do this becasue multiple objects have access to this class, 
+    // namely the sketch and the OP_PCComm class. We won't know which one gets to it first, but whichever comes second will check to see if this flag has been
+    // set, and if so, won't call the begin function again. 
+    didWeBegin = true;
+}
+
+void OP_Radio::SetupChannels(void)
+{
+    // This depends on how many channels the radio has, so it is run by begin() and again whenever background detection finds a (possibly different) receiver. 
+    
+    // Run this so we know how many channels the radio even has
+    getChannelCount();
+    
+    // We assume the radio has at least 4 channels for the two sticks, and we are going to use them
+    ChannelsUtilized = 4;   // Later we will add any aux channels utilized as well
+
+    // All channels are initalized to present = false. If the actual channel number is within the number of channels
+    // detected in the PPM stream, we change the present flag to true. 
+    Sticks.Throttle.present =  (Sticks.Throttle.Settings->channelNum <= channelCount);
+    Sticks.Turn.present =      (Sticks.Turn.Settings->channelNum <= channelCount);
+    Sticks.Elevation.present = (Sticks.Elevation.Settings->channelNum <= channelCount);
+    Sticks.Azimuth.present =   (Sticks.Azimuth.Settings->channelNum <= channelCount);
+
+    // Determine the total number of "utilized" channels
+    for (uint8_t a=0; a<AUXCHANNELS; a++)
+    {
+        AuxChannel[a].present = false; 
+        if (AuxChannel[a].Settings->channelNum > 0 && AuxChannel[a].Settings->channelNum <= channelCount) 
+        { 
+            AuxChannel[a].present = true; 
+            ChannelsUtilized++; 
+        }
+    }
+    
     // The number of utilized channels is not necessarily the same as the number of channels detected, but for sure it can't be 
     // greater than the number of channels detected, nor can it be greater than the maximum allowed number (COUNT_OP_CHANNELS)
     // Constrain our utilized channels just to be safe
@@ -329,7 +377,7 @@ void OP_Radio::begin(_eeprom_data *storage)
         ClearAllChannelUpdates();
     
     // Finally we create an array of pointers to a few common variables for each channel. This is a lot of code here, 
-    // but it only gets run once. It will make reading the radio stream much quicker and shorter (see GetFrame)
+    // but it only gets run when the receiver changes. It will make reading the radio stream much quicker and shorter (see GetFrame)
     ptrCommonChannelSettings[0].pulse = &Sticks.Throttle.pulse;
     ptrCommonChannelSettings[0].channelNum = &Sticks.Throttle.Settings->channelNum;
     ptrCommonChannelSettings[0].updated = &Sticks.Throttle.updated;
@@ -361,12 +409,6 @@ void OP_Radio::begin(_eeprom_data *storage)
         ptrCommonChannelSettings[4 + i].updated = &AuxChannel[i].updated;
         ptrCommonChannelSettings[4 + i].present = &AuxChannel[i].present;
     }
-    
-    
-    // The begin() function is done - set a flag so we know we don't have to come here again. We do this becasue multiple objects have access to this class, 
-    // namely the sketch and the OP_PCComm class. We won't know which one gets to it first, but whichever comes second will check to see if this flag has been
-    // set, and if so, won't call the begin function again. 
-    didWeBegin = true;
 }
 
 void OP_Radio::AdjustTurretStickEndPoints(void)
@@ -394,6 +436,14 @@ boolean OP_Radio::GetCommands()
     // If we're using it, the iBusDecoder needs to be polled
     polliBus();     
 
+    // If we're using it, the CRSFDecoder needs to be polled
+    pollCRSF();
+
+    // If we have been in failsafe a long time, maybe the receiver was unplugged and a different one put in its place. Start looking for it again, 
+    // in the background. Until we find one Status() won't be READY_state, so we just stay in failsafe. 
+    if (Protocol == PROTOCOL_NONE) detect();
+    else if (RADIO_REDETECT_mS > 0 && InFailsafe && (millis() - FailsafeStart_mS) >= RADIO_REDETECT_mS) Redetect();
+
     if (Status() == READY_state)
     {   // We have a lock on the Rx. 
         RxReady = true;
@@ -535,20 +585,34 @@ void OP_Radio::GetFrame()
 {
     int16_t Pulse;                         // Temp var to save typing
     int16_t NewPulse[ChannelsUtilized];    // Temporary array of pulses
+    int16_t *Frame = NewPulse;             // Where the decoder puts them
+    uint8_t count = ChannelsUtilized;      // And how many
 
-    // Fill our NewPulse array with the new frame of data
+    // If the PC is streaming, read every channel straight into its buffer instead, we will still use the first ChannelsUtilized from there
+    if (FrameCapture != NULL)
+    {
+        Frame = FrameCapture;
+        count = channelCount > ChannelsUtilized ? channelCount : ChannelsUtilized;
+        if (count > COUNT_OP_CHANNELS) count = COUNT_OP_CHANNELS;
+    }
+
+    // Fill our Frame array with the new frame of data
     switch (Protocol)
     {
         case PROTOCOL_PPM:
-            PPMDecoder->GetPPM_Frame(NewPulse, ChannelsUtilized);
+            PPMDecoder->GetPPM_Frame(Frame, count);
             break;
             
         case PROTOCOL_SBUS:
-            SBusDecoder->GetSBus_Frame(NewPulse, ChannelsUtilized);
+            SBusDecoder->GetSBus_Frame(Frame, count);
             break;      
 
         case PROTOCOL_iBUS:
-            iBusDecoder->GetiBus_Frame(NewPulse, ChannelsUtilized);
+            iBusDecoder->GetiBus_Frame(Frame, count);
+            break;      
+
+        case PROTOCOL_CRSF:
+            CRSFDecoder->GetCRSF_Frame(Frame, count);
             break;      
         
         case PROTOCOL_NONE:
@@ -556,13 +620,14 @@ void OP_Radio::GetFrame()
             // Bad news bears, hope we don't end up here
             return;
     }
+    FrameConsumed();
     
     // Run through the number of channels being utilized
     for (uint8_t i=0; i<ChannelsUtilized; i++)
     {
         if (*ptrCommonChannelSettings[i].present == true)
         {
-            Pulse = NewPulse[*ptrCommonChannelSettings[i].channelNum-1];    // We subtract one because in the array the channel numbers start at 0, not 1
+            Pulse = Frame[*ptrCommonChannelSettings[i].channelNum-1];       // We subtract one because in the array the channel numbers start at 0, not 1
             if (*ptrCommonChannelSettings[i].pulse == Pulse) { *ptrCommonChannelSettings[i].updated = false; }
             else {*ptrCommonChannelSettings[i].updated = true; *ptrCommonChannelSettings[i].pulse = Pulse; }
         }
@@ -576,18 +641,23 @@ void OP_Radio::GetFrame()
 // ---------------------------------------------------------------------------------------------------------------------------------------------------->>
 // This is similar to the above in that it obtains a frame of pulse widths from either the PPM, SBus or iBus decoders, but instead of putting them into our channel objects, 
 // it assembles them into a string and passes them back to the calling function in the form of a character array. This is used to send pulse widths to the PC. 
+void OP_Radio::CaptureFrame(int16_t *buffer)
+{
+    FrameCapture = buffer;
+}
+
 void OP_Radio::GetStringFrame(char *chrArray, uint8_t buffer, uint8_t &StrLength, char delimiter, uint8_t HiLo)
 {
-// We only return 8 channels at a time. For SBus and iBus, you can request LOW or HIGH which will return either channels 1-8 or 9-16
+// We only return 8 channels at a time. For SBus, iBus and CRSF, you can request LOW or HIGH which will return either channels 1-8 or 9-16
 #define COUNT_STRING_CHANNELS 8    
     
     uint8_t StartChan;
     uint8_t EndChan;
     int16_t NewPulse[channelCount];        // Temporary array of pulses - in this case we always use all channels available, even if more than ChannelsUtilized
-    String str = "";                       // String
 
     // Initialize total length
     StrLength = 0;
+    chrArray[0] = '\0';
 
     // Fill our NewPulse array with the new frame of data
     switch (Protocol)
@@ -607,15 +677,18 @@ void OP_Radio::GetStringFrame(char *chrArray, uint8_t buffer, uint8_t &StrLength
             iBusDecoder->GetiBus_Frame(NewPulse, channelCount);
             break;      
 
+        case PROTOCOL_CRSF:
+            // Same for CRSF
+            CRSFDecoder->GetCRSF_Frame(NewPulse, channelCount);
+            break;      
+
         case PROTOCOL_NONE:
         default:
             // Bad news bears, hope we don't end up here
             return;
     }
+    FrameConsumed();
 
-    // reserve space for string
-    str.reserve(5*(COUNT_STRING_CHANNELS+1));   // Each channel can take up to 5 characters including delimiter. Set the string size 1 more than this to be safe.
-    
     // Decide which (up to) 8 channels to send
     if (channelCount <= COUNT_STRING_CHANNELS)
     {   // We can fit all channels into a single string
@@ -633,16 +706,14 @@ void OP_Radio::GetStringFrame(char *chrArray, uint8_t buffer, uint8_t &StrLength
         EndChan = channelCount;
     }
 
-    // Create a sring of channels 
+    // Create a string of channels directly in the array that was passed. Each channel takes up to 5 characters including the delimiter, 
+    // so 8 channels fit easily. If the buffer is too small we stop at the last channel that fits. 
     for (uint8_t i=StartChan; i<EndChan; i++)
     {
-        str.concat(String(NewPulse[i], DEC));
-        str.concat(delimiter);
+        if (StrLength + 7 > buffer) break;                      // Room for the longest pulse ("-1234"), the delimiter and the null
+        OP_Format::appendInt(chrArray, buffer, StrLength, NewPulse[i]);
+        OP_Format::appendChar(chrArray, buffer, StrLength, delimiter);
     }
-
-    // Convert string to char array and store in the array that was passed
-    str.toCharArray(chrArray, buffer); 
-    StrLength = str.length();
 }
 
 
@@ -941,9 +1012,128 @@ void OP_Radio::SetChannelsFailSafe()
         //}
         SetAllChannelUpdates();    // This sets the updated flag for every channel. We want the main code to read the new failsafe values we have just written above. 
         InFailsafe = true;         // Set the failsafe flag. The sketch will check this flag in order to take its own actions on failsafe. 
+        FailsafeStart_mS = millis();
+        
+        // Record why
+        Stats.LastFailsafe = FailsafeCause();
+        Stats.Failsafes[Stats.LastFailsafe]++;
+        Stats.Failsafes[RADIO_FS_NONE]++;           // Total
+        HaveLastFrame = false;                      // Don't count the time spent in failsafe as one long frame interval
     }
 }
 
+uint8_t OP_Radio::FailsafeCause(void)
+{
+decoder_stats ds;
+
+    // Compare what the decoder has counted since the last frame we used. Errors take priority, if there weren't any but the decoder 
+    // finished a good frame recently, then the frames were there and we just didn't get around to reading them. 
+    GetDecoderStats(ds);
+    if (ds.RxFailsafe   != DecoderLastFrame.RxFailsafe)     return RADIO_FS_RECEIVER;
+    if (ds.CRCErrors    != DecoderLastFrame.CRCErrors)      return RADIO_FS_CRC;
+    if (ds.FormatErrors != DecoderLastFrame.FormatErrors)   return RADIO_FS_FORMAT;
+    if (ds.FrameTime_uS != DecoderLastFrame.FrameTime_uS && (micros() - ds.FrameTime_uS) < ((uint32_t)RADIO_FAILSAFE_MS * 1000)) return RADIO_FS_LOOP;
+    return RADIO_FS_TIMEOUT;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------------------------------------->>
+// FRAME STATISTICS
+// ---------------------------------------------------------------------------------------------------------------------------------------------------->>
+void OP_Radio::FrameConsumed(void)
+{
+decoder_stats ds;
+uint32_t latency;
+uint32_t interval;
+uint32_t avg;
+uint32_t lost;
+uint8_t b;
+
+    GetDecoderStats(ds);
+    Stats.Frames++;
+
+    // How long the frame waited for us
+    latency = micros() - ds.FrameTime_uS;
+    for (b = 0; b < (RADIO_HIST_BUCKETS - 1) && latency >= RadioLatencyBucket_uS(b); b++);
+    if (Stats.LatencyHist[b] < 0xFFFF) Stats.LatencyHist[b]++;
+    if (latency > 0xFFFF) latency = 0xFFFF;
+    if (latency > Stats.MaxLatency_uS) Stats.MaxLatency_uS = latency;
+
+    // Time since the previous frame
+    if (HaveLastFrame)
+    {
+        interval = ds.FrameTime_uS - DecoderLastFrame.FrameTime_uS;
+        for (b = 0; b < (RADIO_HIST_BUCKETS - 1) && interval >= RadioIntervalBucket_uS(b); b++);
+        if (Stats.IntervalHist[b] < 0xFFFF) Stats.IntervalHist[b]++;
+
+        // If the interval is much longer than usual, work out how many frames must have gone missing, but leave it out of the average. 
+        avg = AvgInterval_x16 >> 4;
+        if (avg == 0) AvgInterval_x16 = interval << 4;
+        else if ((interval * 100) > (avg * RADIO_LOST_FRAME_PCT))
+        {
+            lost = Stats.LostFrames + ((interval + (avg / 2)) / avg) - 1;
+            Stats.LostFrames = lost > 0xFFFF ? 0xFFFF : lost;
+        }
+        else AvgInterval_x16 = AvgInterval_x16 + (interval << 1) - (AvgInterval_x16 >> 3);     // Filter 1/8th: x16 / 8 = x2
+
+        if (interval > 0xFFFF) interval = 0xFFFF;
+        if (interval < Stats.MinInterval_uS) Stats.MinInterval_uS = interval;
+        if (interval > Stats.MaxInterval_uS) Stats.MaxInterval_uS = interval;
+    }
+    
+    DecoderLastFrame = ds;
+    HaveLastFrame = true;
+}
+
+void OP_Radio::GetDecoderStats(decoder_stats &ds)
+{
+    GetDecoderStats(Protocol, ds);
+}
+
+void OP_Radio::GetDecoderStats(RADIO_PROTOCOL p, decoder_stats &ds)
+{
+    switch (p)
+    {
+        case PROTOCOL_PPM:  PPMDecoder->getStats(ds);   break;
+        case PROTOCOL_SBUS: SBusDecoder->getStats(ds);  break;
+        case PROTOCOL_iBUS: iBusDecoder->getStats(ds);  break;
+        case PROTOCOL_CRSF: CRSFDecoder->getStats(ds);  break;
+        default:            memset(&ds, 0, sizeof(ds)); break;
+    }
+}
+
+void OP_Radio::GetStats(radio_stats &rs)
+{
+decoder_stats ds;
+
+    rs = Stats;
+    rs.AvgInterval_uS = (AvgInterval_x16 >> 4) > 0xFFFF ? 0xFFFF : (AvgInterval_x16 >> 4);
+    if (rs.MinInterval_uS > rs.MaxInterval_uS) rs.MinInterval_uS = 0;          // No intervals measured yet
+    
+    // Decoder counters since we last cleared. While we are detecting there is no decoder to ask (its counters read zero and 
+    // DecoderBase belongs to the old one), so report none. 
+    if (Detecting || Protocol == PROTOCOL_NONE)
+    {
+        rs.DecodedFrames = rs.FormatErrors = rs.CRCErrors = rs.RxFailsafe = 0;
+        return;
+    }
+    GetDecoderStats(ds);
+    rs.DecodedFrames = ds.Frames - DecoderBase.Frames;
+    rs.FormatErrors =  ds.FormatErrors - DecoderBase.FormatErrors;
+    rs.CRCErrors =     ds.CRCErrors - DecoderBase.CRCErrors;
+    rs.RxFailsafe =    ds.RxFailsafe - DecoderBase.RxFailsafe;
+}
+
+void OP_Radio::ClearStats(void)
+{
+    memset(&Stats, 0, sizeof(Stats));
+    Stats.MinInterval_uS = 0xFFFF;
+    AvgInterval_x16 = 0;
+    HaveLastFrame = false;
+    GetDecoderStats(DecoderBase);
+    DecoderLastFrame = DecoderBase;
+}
+
 
 // ---------------------------------------------------------------------------------------------------------------------------------------------------->>
 // UTILITIES
@@ -975,6 +1165,11 @@ decodeState_t OP_Radio::Status(void)
             return iBusDecoder->getState();
             break;
 
+        case PROTOCOL_CRSF:
+            pollCRSF();     // CRSF needs polled
+            return CRSFDecoder->getState();
+            break;
+
         case PROTOCOL_NONE:
         default:
             return ACQUIRING_state;
@@ -998,6 +1193,11 @@ boolean OP_Radio::NewFrame(void)
             polliBus();     // iBus needs polled
             return iBusDecoder->NewFrame;
             break;
+
+        case PROTOCOL_CRSF:
+            pollCRSF();     // CRSF needs polled
+            return CRSFDecoder->NewFrame;
+            break;
             
         case PROTOCOL_NONE:
         default:
@@ -1022,6 +1222,10 @@ uint8_t OP_Radio::getChannelCount(void)
         case PROTOCOL_iBUS:
             channelCount = iBusDecoder->getChanCount();
             break;
+
+        case PROTOCOL_CRSF:
+            channelCount = CRSFDecoder->getChanCount();
+            break;
         
         case PROTOCOL_NONE:
         default:
@@ -1055,6 +1259,7 @@ void OP_Radio::Update(void)
 {   
     pollSBus();
     polliBus();
+    pollCRSF();
     // We don't need to update radioTimer because it is just a pointer to the sketch's timer, 
     // and the sketch will update that itself. 
 }
@@ -1069,6 +1274,11 @@ void OP_Radio::polliBus(void)
     if (Protocol == PROTOCOL_iBUS) { iBusDecoder->update(); }
 }
 
+void OP_Radio::pollCRSF(void)
+{   // This checks if we're using the CRSF protocol, and if so, updates it
+    if (Protocol == PROTOCOL_CRSF) { CRSFDecoder->update(); }
+}
+
 void OP_Radio::slowDownForPCComm(void)
 {
     // Some protocols may operate at a speed too fast for reliable streaming to the PC, 
@@ -1078,6 +1288,7 @@ void OP_Radio::slowDownForPCComm(void)
         case PROTOCOL_PPM:                                      break;   // No slow down implemented for PPM
         case PROTOCOL_SBUS: SBusDecoder->slowDownForPCComm();   break;
         case PROTOCOL_iBUS: iBusDecoder->slowDownForPCComm();   break;
+        case PROTOCOL_CRSF: CRSFDecoder->slowDownForPCComm();   break;
     }
 }
     
@@ -1089,6 +1300,20 @@ void OP_Radio::defaultSpeed(void)
         case PROTOCOL_PPM:                                      break;   // No change needed for PPM
         case PROTOCOL_SBUS: SBusDecoder->defaultSpeed();        break;
         case PROTOCOL_iBUS: iBusDecoder->defaultSpeed();        break;
+        case PROTOCOL_CRSF: CRSFDecoder->defaultSpeed();        break;
     }
 }
 
+boolean OP_Radio::GetLinkStats(crsf_link_stats &ls)
+{
+    if (Protocol == PROTOCOL_CRSF) return CRSFDecoder->getLinkStats(ls);
+    memset(&ls, 0, sizeof(ls));
+    return false;
+}
+
+void OP_Radio::SetTelemetry(uint16_t voltage_mV, uint8_t chargePct, uint8_t damagePct, boolean destroyed)
+{
+    // Only CRSF can send data back to the transmitter. For the others there's nothing to do.
+    if (Protocol == PROTOCOL_CRSF) CRSFDecoder->setTelemetry(voltage_mV, chargePct, damagePct, destroyed);
+}
+
@@ -26,6 +26,7 @@
 #include "../OP_PPMDecode/OP_PPMDecode.h"
 #include "../OP_SBusDecode/OP_SBusDecode.h"
 #include "../OP_IBusDecode/OP_iBusDecode.h"
+#include "../OP_CRSFDecode/OP_CRSFDecode.h"
 #include "../OP_Motors/OP_Motors.h"
 #include "../OP_SimpleTimer/OP_SimpleTimer.h"
 
@@ -34,8 +35,9 @@ typedef char RADIO_PROTOCOL;
 #define PROTOCOL_PPM    1                   // PPM protocol
 #define PROTOCOL_SBUS   2                   // SBus protocol
 #define PROTOCOL_iBUS   3                   // iBus protocol
+#define PROTOCOL_CRSF   4                   // CRSF protocol (TBS Crossfire, ExpressLRS)
 #define FIRST_RADIOPROTOCOL PROTOCOL_PPM    // So we know how to identify invalid values
-#define LAST_RADIOPROTOCOL  PROTOCOL_iBUS   // 
+#define LAST_RADIOPROTOCOL  PROTOCOL_CRSF   // 
 const __FlashStringHelper *RadioProtocol(RADIO_PROTOCOL RP); // Returns a pointer to a flash-stored character string that is the name of the radio protocol
 
 // This one is to print out turret stick positions
@@ -45,17 +47,65 @@ const __FlashStringHelper *TurretStickPosition(uint8_t TSP); // Returns a pointe
 const PROGMEM uint8_t TurretStickPositionStringLengths[SPECIALPOSITIONS+1] = { 7, 8, 9, 9, 11, 12, 12, 11, 12, 12 }; // We add one for "unknown"
 #define TS_PositionString_Length(p) pgm_read_byte_far(&TurretStickPositionStringLengths[p])
 
-                                    // From OP_PCComm.cpp we know we only have 800 mS to try all three protocols on the Read Radio routine (actually we can have up to 1 second but 
-                                    // the setting is 800mS). So we set these to something that will let us try all three in that time frame. 1/4 second should be enough. 
-#define PPM_TRY_TIME        250     // How long to try detecting a PPM signal, in mS. Only used in detect mode at startup. 
-#define SBUS_TRY_TIME       250     // How long to try detecting an SBus signal, in mS. Only used in detect mode at startup. 
-#define iBUS_TRY_TIME       250     // How long to try detecting an iBus signal, in mS. Only used in detect mode at startup. 
+// PROTOCOL DETECTION
+// -------------------------------------------------------------------------------------------------------------------------------------------->>
+// The PPM decoder listens the whole time detection is running, while the serial decoders take turns on Serial 3 (see detect() in OP_Radio.cpp). 
+// From OP_PCComm.cpp we know we only have 800 mS to find the radio on the Read Radio routine, so a full turn through the serial protocols needs to 
+// fit comfortably inside that. 
+#define RADIO_DETECT_WINDOW_mS      50      // Candidates are scored over a sliding window of RADIO_DETECT_WINDOWS of this many mS each (200 mS total)
+#define RADIO_DETECT_WINDOWS        4
+#define RADIO_DETECT_MIN_SCORE      4       // A candidate needs this score (good frames less errors in the window) and its decoder in READY_state to win
+#define RADIO_DETECT_DWELL_mS       150     // How long each protocol gets the Rx pin if it isn't seeing anything
+#define RADIO_DETECT_MAX_DWELL_mS   600     // And how long it can hang on to the port if it is seeing something but still hasn't won
+#define RADIO_REDETECT_mS           2000    // After this long in failsafe, start detecting again in the background in case the receiver was swapped. 0 to disable. 
 
 #define RADIO_FAILSAFE_MS   500     // If we exceed this amount of time in milliseconds without reading a valid radio frame, go into failsafe. 
                                     // 250 milliseconds is 1/4 second. That is a long time for an RC receiver, normally 12 PPM frames and over 25 SBus
                                     // frames would have arrived in that time (although we throw away every other SBus frame so in fact it's about the same as PPM). 
                                     // Nevertheless we give ourselves extra leeway with 1/2 second. 
 
+
+// FRAME STATISTICS
+// -------------------------------------------------------------------------------------------------------------------------------------------->>
+// OP_Radio keeps running statistics on the frames it reads, to help tell whether control lag is coming from the receiver (irregular or missing 
+// frames), the decoder (errors) or the main loop (frames sitting a long time before we get around to reading them). 
+// Interval is the time from one frame we use to the next, as timestamped by the decoder. Latency is the time from when the decoder finished a frame 
+// to when we actually read it. Both are kept as histograms. The buckets are set by the upper edges below, in microseconds, the last bucket catches everything else. 
+#define RADIO_HIST_BUCKETS  8
+const uint16_t RadioIntervalBuckets_uS[RADIO_HIST_BUCKETS - 1] PROGMEM_FAR = { 8000, 12000, 16000, 20000, 24000, 30000, 50000 };
+const uint16_t RadioLatencyBuckets_uS[RADIO_HIST_BUCKETS - 1]  PROGMEM_FAR = {  250,   500,  1000,  2000,  4000,  8000, 16000 };
+#define RadioIntervalBucket_uS(i)   pgm_read_word_far(pgm_get_far_address(RadioIntervalBuckets_uS) + ((i)*2))
+#define RadioLatencyBucket_uS(i)    pgm_read_word_far(pgm_get_far_address(RadioLatencyBuckets_uS) + ((i)*2))
+#define RADIO_LOST_FRAME_PCT 150    // An interval more than this percent of the average means frames went missing
+
+// Why we went into failsafe. Worked out when the watchdog expires, by looking at what the decoder counted since the last frame we used.
+#define RADIO_FS_NONE       0       // Never been in failsafe
+#define RADIO_FS_TIMEOUT    1       // Frames simply stopped arriving (receiver unplugged, unpowered, or one that goes silent on signal loss)
+#define RADIO_FS_RECEIVER   2       // The receiver reported lost signal or failsafe (SBus, CRSF)
+#define RADIO_FS_CRC        3       // Frames arrived but failed checksum, parity or framing
+#define RADIO_FS_FORMAT     4       // Frames arrived but were malformed (bad pulses, channel count changes, missing start/end bytes)
+#define RADIO_FS_LOOP       5       // Good frames arrived but the sketch didn't read them in time (main loop blocked)
+#define RADIO_FS_REASONS    6
+const __FlashStringHelper *RadioFailsafeReason(uint8_t reason); // Returns a pointer to a flash-stored character string that is the name of the failsafe reason
+
+typedef struct radio_stats {
+    uint32_t Frames;                                // Frames used
+    uint16_t LostFrames;                            // Estimated frames that never arrived, from gaps in the interval
+    uint16_t MinInterval_uS;                        // Intervals and latency are capped at 65535 uS
+    uint16_t AvgInterval_uS;                        
+    uint16_t MaxInterval_uS;
+    uint16_t MaxLatency_uS;
+    uint16_t IntervalHist[RADIO_HIST_BUCKETS];
+    uint16_t LatencyHist[RADIO_HIST_BUCKETS];
+    uint16_t Failsafes[RADIO_FS_REASONS];           // Count of failsafes by reason, Failsafes[RADIO_FS_NONE] is the total
+    uint8_t  LastFailsafe;                          // Reason for the most recent failsafe
+    uint16_t DecodedFrames;                         // These four are the decoder's own counters (see decoder_stats in OP_RadioDefines.h). DecodedFrames
+    uint16_t FormatErrors;                          // includes frames the decoder discards, so it can be higher than Frames
+    uint16_t CRCErrors;
+    uint16_t RxFailsafe;
+} radio_stats;
+
+
 class OP_Radio
 {
     public: 
@@ -63,7 +113,7 @@ class OP_Radio
         static void             saveTimer(OP_SimpleTimer * t);          // Get a reference to the sketch's SimpleTimer
         static void             begin(_eeprom_data *storage);           // This loads the save eeprom information into the radio object, and does basic initialization
         
-        static void             detect();                               // See what kind of signal is attached
+        static void             detect();                               // See what kind of signal is attached. Keep calling until Status() returns READY_state
         static boolean          hasBegun(void);                         // Did we already call the begin() function yet? 
         static boolean          GetCommands();                          // High level command handler
         static RADIO_PROTOCOL   getProtocol();                          // Return currently detected protocol
@@ -82,8 +132,13 @@ class OP_Radio
 
         static void             Update(void);                           // Update the radioTimer, and poll the SBus decoder if we're using it (PPM updates itself automatically)
         static void             GetStringFrame(char *chrArray, uint8_t buffer, uint8_t &StrLength, char delimiter, uint8_t HiLo = LOW); // Returns a string of pulses separated by delimiter. Used for PC comms
+        static void             CaptureFrame(int16_t *buffer);          // While set, GetCommands also copies every channel of each frame into buffer (COUNT_OP_CHANNELS long). Pass NULL to stop. Used for PC comms
         static void             slowDownForPCComm(void);                // Some protocols may operate at a speed too fast for reliable streaming to the PC, we can use this to slow them down temporarily when performing Read Radio from OP Config
         static void             defaultSpeed(void);                     // This reverts the protocol back to its default speed for normal operation
+        static void             GetStats(radio_stats &rs);              // Copy out the frame statistics
+        static void             ClearStats(void);                       // Start the statistics over
+        static boolean          GetLinkStats(crsf_link_stats &ls);      // Link statistics from a CRSF receiver, returns false if we aren't using CRSF or the receiver hasn't sent any
+        static void             SetTelemetry(uint16_t voltage_mV, uint8_t chargePct, uint8_t damagePct, boolean destroyed);  // Values to send back to the transmitter, if the protocol supports telemetry (CRSF)
 
     private:
     
@@ -92,6 +147,7 @@ class OP_Radio
         static                  PPMDecode *PPMDecoder;                  // PPM Decoder object       
         static                  SBusDecode *SBusDecoder;                // SBus Decoder object
         static                  iBusDecode *iBusDecoder;                // iBus Decoder object
+        static                  CRSFDecode *CRSFDecoder;                // CRSF Decoder object
         static void             GetFrame(void);                         // Request a frame from the PPM/SBus decoder
         static void             GetStickCommand(stick_channel &ch);     // Calculate the four stick channel positions
         static int              GetSpecialPosition(sf_channel &sfc);    // Calculate the abstract "special stick" position, if used
@@ -99,6 +155,7 @@ class OP_Radio
         static void             EnableAzimuthStick(void);               // Re-enable this stick after a brief ignore delay
         static void             GetSwitchPosition(int a);               // Calculate aux channel switch positions, if aux channel is set to digital input
     
+        static void             SetupChannels(void);                    // Work out which channels are present, for however many channels the radio has
         static void             SetChannelsFailSafe();                  // We lost connection with the radio. Set all channels to failsafe values. 
         static void             ClearAllChannelUpdates(void);           // Set all channels to "not updated"
         static void             SetAllChannelUpdates(void);             // Set all channels to "updated"
@@ -107,14 +164,27 @@ class OP_Radio
         static void             restartWatchdog(void);                  // Re-starts the watchdog timer. We call this every time we get a new frame of data from the radio. 
         static int              WatchdogTimerID;
         
-        static void             failPPM(void);                          // If we fail to read PPM
-        static void             failSBus(void);                         // If we fail to read SBus
-        static void             failiBus(void);                         // If we fail to read iBus
-        static boolean          PPMFailed;                              // Are we trying to detect PPM? 
-        static boolean          SBusFailed;                             // Are we trying to detect SBus?
-        static boolean          iBusFailed;                             // Are we trying to detect iBus?        
+        static void             StartDetect(void);                      // Start trying the first protocol
+        static void             StartCandidate(void);                   // Start the decoder for DetectProtocol and clear its scores
+        static void             Redetect(void);                         // Drop the present protocol and start detecting again
+        static int16_t          DetectScore(void);                      // Sum of the candidate's score over the sliding window
+        static void             ScoreCandidate(void);                   // Update the present window's score for the candidate
+        static void             StartDecoder(RADIO_PROTOCOL p);         // Create and begin the decoder for a protocol
+        static void             StopDecoder(RADIO_PROTOCOL p);          // Shutdown and delete it
+        static void             UpdateDecoder(RADIO_PROTOCOL p);        // Poll it if it is a serial decoder
+        static decodeState_t    DecoderState(RADIO_PROTOCOL p);
+        static boolean          Detecting;                              // Is detection running
+        static RADIO_PROTOCOL   DetectProtocol;                         // Protocol presently being tried on the Rx pin
+        static RADIO_PROTOCOL   LastProtocol;                           // Protocol to try first
+        static uint32_t         DetectWindow_mS;                        // When the present score window started
+        static uint32_t         DetectProtocol_mS;                      // When we started trying DetectProtocol
+        static uint8_t          DetectSlot;                             // Present window in the scores
+        static int8_t           DetectScores[RADIO_DETECT_WINDOWS];     // Candidate's score per window
+        static decoder_stats    DetectBase;                             // Decoder counters at the start of the present window
+        static uint32_t         FailsafeStart_mS;                       // When we went into failsafe
         static void             pollSBus(void);                         // SBus needs polling
         static void             polliBus(void);                         // iBus needs polling
+        static void             pollCRSF(void);                         // CRSF needs polling
         
         static OP_SimpleTimer * radioTimer;                             // Used for watchdog timer and other stuff. Pointer to the sketch's SimpleTimer, rather than creating a new instance of the class. 
         static uint8_t          channelCount;                           // How many channels were detected in the PPM stream
@@ -122,6 +192,17 @@ class OP_Radio
                                                                                                     // And yes, it says "ptr" but you see no *. But look in OP_RadioDefines.h for the struct definition, it is all pointers. 
         static int16_t          ignoreTurretDelay_mS;                   // Local copy of the user variable stored in eeprom
 
+        static void             GetDecoderStats(decoder_stats &ds);     // Get the counters from whichever decoder we are using
+        static void             GetDecoderStats(RADIO_PROTOCOL p, decoder_stats &ds);
+        static void             FrameConsumed(void);                    // Update statistics, call each time we read a frame from the decoder
+        static uint8_t          FailsafeCause(void);                    // Work out why the watchdog expired
+        static radio_stats      Stats;
+        static decoder_stats    DecoderBase;                            // Decoder counters when the statistics were last cleared
+        static decoder_stats    DecoderLastFrame;                       // Decoder counters as of the last frame we used
+        static uint32_t         AvgInterval_x16;                        // Filtered interval, kept x16 so the filter doesn't lose resolution
+        static boolean          HaveLastFrame;                          // Do we have a previous frame to measure the interval from
+        static int16_t        * FrameCapture;                           // See CaptureFrame()
+
 };
 
 
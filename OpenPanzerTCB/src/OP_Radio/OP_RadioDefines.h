@@ -290,6 +290,15 @@ typedef enum {
     FAILSAFE_state
  } decodeState_t;
 
+// Each decoder keeps these counters, OP_Radio reads them to build its frame statistics (see OP_Radio::GetStats)
+typedef struct decoder_stats {
+    uint32_t FrameTime_uS;                              // micros() when the last frame passed on to the sketch was finished decoding (not discarded ones)
+    uint16_t Frames;                                    // Good frames decoded (including any we discard), rolls over
+    uint16_t FormatErrors;                              // Bad pulse widths, channel count changes, bad start/end bytes, gaps in the middle of a frame
+    uint16_t CRCErrors;                                 // Checksum failures, and UART framing/parity/overrun errors
+    uint16_t RxFailsafe;                                // Frames in which the receiver itself reported lost signal or failsafe
+ } decoder_stats;
+
 
 
 #endif
@@ -44,6 +44,7 @@ decodeState_t           SBusDecode::State;                              // The c
 boolean                 SBusDecode::NewFrame;                           // Boolean variable to indicate a new complete PPM frame has arrived or been read. 
 uint8_t                 SBusDecode::frameCount;                         // 
 uint8_t                 SBusDecode::framesToDiscard;                    // How many frames to skip for every one read
+decoder_stats           SBusDecode::Stats;                              // Frame and error counters
 
 // Constructor
 SBusDecode::SBusDecode(){}
@@ -143,6 +144,7 @@ uint8_t UART_error;
         {   
             sbus_pointer = 0;                       // If there is a receive error, reset the frame
             State = FAILSAFE_state;                 // Set state to Failsafe
+            Stats.CRCErrors++;                      // SBus has no checksum, parity is the closest thing
         }
         else    
         { 
@@ -167,6 +169,7 @@ uint8_t UART_error;
                     // reset the count and start looking for start byte again. 
                     sbus_pointer = 0 ;              // Reset the frame
                     stateCount = 0;
+                    Stats.FormatErrors++;
                     if (State == READY_state) State = FAILSAFE_state;         // Set state to Failsafe if we were previously connected, otherwise leave in existing state (acquiring or not synched). 
                 }
                 else 
@@ -182,13 +185,16 @@ uint8_t UART_error;
                             if (SBusData[23] & (1<<2)) 
                             {   // SBus signal lost
                                 State = FAILSAFE_state; 
+                                Stats.RxFailsafe++;
                             }
                             else if (SBusData[23] & (1<<3)) 
                             {   // SBus signal failsafe
                                 State = FAILSAFE_state; 
+                                Stats.RxFailsafe++;
                             }   
                             else    // No SBus error                        
                             {
+                                Stats.Frames++;
                                 if ( State == ACQUIRING_state)  
                                 {   // If we are in ACQUIRING_state we have been collecting channel data. We keep collecting until we have ACQUISITION count of frames under our belt.
                                     // We are only in Acquiring state once - when the program first boots. After that we will only be either READY or FAILSAFE
@@ -207,6 +213,7 @@ uint8_t UART_error;
                                 {
                                     // Set the new frame flag
                                     NewFrame = true;
+                                    Stats.FrameTime_uS = micros();          // Only frames we pass on are timed, the sketch measures latency and intervals from this
                                     // Convert SBus data to individual channel pulse-widths
                                     ConvertSBus_to_PWM();
                                     frameCount = 0;
@@ -217,6 +224,7 @@ uint8_t UART_error;
                                 }
                             }
                         }
+                        else Stats.FormatErrors++;              // Wrong end byte
                         
                         // Regardless of what the outcome was, we reached SBUS_FRAME_BYTES, so reset the frame
                         sbus_pointer = 0;
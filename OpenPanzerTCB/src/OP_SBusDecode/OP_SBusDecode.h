@@ -152,6 +152,7 @@ class SBusDecode
         static boolean          NewFrame;                       // Has an unread frame of data arrived? 
         void                    update(void);
         void                    slowDownForPCComm(void);        // Adjust on the fly how many frames we choose to discard, this will set it to SBUS_PCCOMM_DISCARD_FRAMES
+        void                    getStats(decoder_stats &ds) { ds = Stats; }     // Copy out the frame and error counters
         void                    defaultSpeed(void);             // Revert to the default number of discarded frames SBUS_DEFAULT_DISCARD_FRAMES        
         
     private:
@@ -166,6 +167,7 @@ class SBusDecode
         static decodeState_t    State;                          // The current state
         static uint8_t          frameCount;                     // Used to keep track of frames for the purpose of discarding some
         static uint8_t          framesToDiscard;                // How many frames to discard for each frame we read
+        static decoder_stats    Stats;                          // Frame and error counters
 };
 
 
@@ -69,3 +69,161 @@ void OP_Scout::allStop() const
   motor(2, 0);
 }
 
+
+
+// ------------------------------------------------------------------------------------------------------------------>>
+// TELEMETRY
+// ------------------------------------------------------------------------------------------------------------------>>
+HardwareSerial  *OP_Scout::_telemPort = NULL;
+scout_telemetry  OP_Scout::_telem[SCOUT_MAX_BOARDS];
+boolean          OP_Scout::_enabled[SCOUT_MAX_BOARDS];
+boolean          OP_Scout::_present[SCOUT_MAX_BOARDS];
+boolean          OP_Scout::_unsupported[SCOUT_MAX_BOARDS];
+uint8_t          OP_Scout::_missRun[SCOUT_MAX_BOARDS];
+uint32_t         OP_Scout::_lastTry_mS[SCOUT_MAX_BOARDS];
+uint8_t          OP_Scout::_nextItem[SCOUT_MAX_BOARDS];
+int8_t           OP_Scout::_pendingSlot = -1;
+uint8_t          OP_Scout::_pendingItem;
+uint32_t         OP_Scout::_request_mS;
+uint8_t          OP_Scout::_lastSlot;
+uint8_t          OP_Scout::_rx[5];
+uint8_t          OP_Scout::_rxCount;
+int8_t           OP_Scout::_rxSlot = -1;
+
+int8_t OP_Scout::slotOf(byte address)
+{
+    if (address < SCOUT_ADDRESS_A || address >= SCOUT_ADDRESS_A + SCOUT_MAX_BOARDS) return -1;
+    return address - SCOUT_ADDRESS_A;
+}
+
+void OP_Scout::enableTelemetry(byte address, HardwareSerial *port)
+{
+    int8_t slot = slotOf(address);
+    if (slot < 0) return;
+    _telemPort = port;
+    if (_enabled[slot] || _unsupported[slot]) return;   // Both motor objects of a Scout will ask, and we don't go back to one that never answered
+    _enabled[slot] = true;
+    _present[slot] = true;          // Assume it will answer until it misses SCOUT_TELEM_MISSES in a row
+    _missRun[slot] = 0;
+    _nextItem[slot] = 0;
+    memset(&_telem[slot], 0, sizeof(scout_telemetry));
+}
+
+boolean OP_Scout::telemetryPresent(byte address)
+{
+    int8_t slot = slotOf(address);
+    return (slot >= 0 && _enabled[slot] && _present[slot] && _telem[slot].Replies > 0);
+}
+
+boolean OP_Scout::getTelemetry(byte address, scout_telemetry &t)
+{
+    if (!telemetryPresent(address)) return false;
+    t = _telem[slotOf(address)];
+    return true;
+}
+
+void OP_Scout::pollTelemetry(void)
+{
+uint32_t now;
+
+    if (_telemPort == NULL) return;
+
+    // Only what has already arrived, at most a buffer's worth
+    while (_telemPort->available()) parseTelemetry(_telemPort->read());
+
+    now = millis();
+    if (_pendingSlot >= 0)
+    {
+        if (now - _request_mS < SCOUT_TELEM_TIMEOUT_mS) return;     // Still waiting
+        
+        // No reply
+        _telem[_pendingSlot].Misses++;
+        if (_missRun[_pendingSlot] < 255) _missRun[_pendingSlot]++;
+        if (_missRun[_pendingSlot] >= SCOUT_TELEM_MISSES) 
+        {
+            _present[_pendingSlot] = false;
+            if (_telem[_pendingSlot].Replies == 0)
+            {   // It has never answered, so its firmware doesn't know the command. Stop asking, there is no point sending it requests it can't read. 
+                _enabled[_pendingSlot] = false;
+                _unsupported[_pendingSlot] = true;
+            }
+        }
+        _nextItem[_pendingSlot] = (_pendingItem + 1) % SCOUT_TELEM_ITEMS;  // Don't get stuck on an item older Scout firmware doesn't know
+        _pendingSlot = -1;
+    }
+
+    if (now - _request_mS >= SCOUT_TELEM_POLL_mS) requestNext(now);
+}
+
+void OP_Scout::requestNext(uint32_t now)
+{
+    // Take turns between the boards. A board that answered before but has stopped is only asked every SCOUT_TELEM_RETRY_mS.
+    for (uint8_t i = 1; i <= SCOUT_MAX_BOARDS; i++)
+    {
+        uint8_t slot = (_lastSlot + i) % SCOUT_MAX_BOARDS;
+        if (!_enabled[slot]) continue;
+        if (!_present[slot] && (now - _lastTry_mS[slot] < SCOUT_TELEM_RETRY_mS)) continue;
+
+        byte address = SCOUT_ADDRESS_A + slot;
+        _pendingItem = _nextItem[slot];
+        _telemPort->write(address);
+        _telemPort->write((byte)SCOUT_CMD_GET_TELEMETRY);
+        _telemPort->write(_pendingItem);
+        _telemPort->write((address + SCOUT_CMD_GET_TELEMETRY + _pendingItem) & B01111111);
+
+        _pendingSlot = slot;
+        _lastSlot = slot;
+        _lastTry_mS[slot] = now;
+        _request_mS = now;
+        return;
+    }
+    _request_mS = now;      // Nothing to ask, check again next period
+}
+
+void OP_Scout::parseTelemetry(uint8_t b)
+{
+    if (b & 0x80)
+    {   // Only an address has the high bit set, so this always starts a new reply
+        _rxSlot = slotOf(b);
+        _rxCount = 0;
+        return;
+    }
+    if (_rxSlot < 0) return;        // Not ours, or we lost our place. Wait for the next address.
+
+    _rx[_rxCount++] = b;
+    if (_rxCount < 5) return;
+
+    // Full reply: command, item, data low, data high, checksum
+    int8_t slot = _rxSlot;
+    _rxSlot = -1;
+    byte sum = SCOUT_ADDRESS_A + slot;
+    for (uint8_t i = 0; i < 4; i++) sum += _rx[i];
+    if (_rx[0] != SCOUT_CMD_GET_TELEMETRY || (sum & B01111111) != _rx[4] || _rx[1] >= SCOUT_TELEM_ITEMS)
+    {
+        _telem[slot].BadPackets++;
+        return;
+    }
+
+    uint16_t val = _rx[2] | ((uint16_t)_rx[3] << 7);
+    if (val > 6553) val = 6553;     // So the 10 mA and 10 mV units still fit in 16 bits
+    scout_telemetry &t = _telem[slot];
+    switch (_rx[1])
+    {
+        case SCOUT_TELEM_CURRENT_M1:    t.Current_mA[0] = val * 10;                     break;
+        case SCOUT_TELEM_CURRENT_M2:    t.Current_mA[1] = val * 10;                     break;
+        case SCOUT_TELEM_TEMPERATURE:   t.Temperature_C = (int16_t)val - SCOUT_TEMP_OFFSET; break;
+        case SCOUT_TELEM_VOLTAGE:       t.Voltage_mV = val * 10;                        break;
+        case SCOUT_TELEM_FAULTS:        t.Faults = (uint8_t)val;                        break;
+    }
+    t.Replies++;
+    t.LastReply_mS = millis();
+    _present[slot] = true;
+    _missRun[slot] = 0;
+
+    // If this is the answer we were waiting for, move that board on to its next item and free the port for the next request
+    if (slot == _pendingSlot && _rx[1] == _pendingItem)
+    {
+        _nextItem[slot] = (_pendingItem + 1) % SCOUT_TELEM_ITEMS;
+        _pendingSlot = -1;
+    }
+}
@@ -65,7 +65,7 @@
 #define SCOUT_CMD_BAUD_RATE                 0x0F    // 15
                                                     // 16       Reserved for future compatibility with Sabertooth ramping features
                                                     // 17       Reserved for future compatibility with Sabertooth deadband feature
-                                                    // 19   Unused
+#define SCOUT_CMD_GET_TELEMETRY             0x13    // 19   PROPOSED - ask for one telemetry item, the value is the item number (see SCOUT_TELEM_ below). The Scout answers with a reply packet. 
 #define SCOUT_CMD_SET_FAN_SPEED             0x14    // 20   Direct fan speed control (or use it as a third, uni-directional ESC)
 #define SCOUT_CMD_SET_AUTO_FAN_CONTROL      0x15    // 21   Revert fan control to Scout auto control (based on temperature)
 #define SCOUT_CMD_SET_MAX_CURRENT           0x16    // 22   Set maximum current
@@ -80,6 +80,48 @@
 #define SCOUT_BAUD_CODE_115200                 5    //
 #define SCOUT_BAUD_CODE_57600                  6    // The preceding codes are numbered identically to the codes used for Sabertooth controllers, which do not include 57600. That is why 57600 is number 6 and not number 5. 
 
+// Telemetry
+// PROPOSED, NOT YET IN ANY RELEASED SCOUT FIRMWARE. Command 19 and the reply below are what we are proposing to the Scout firmware 
+// (https://github.com/OpenPanzerProject/Scout-ESC), and are pending agreement there. Until a released Scout answers them they may still change, 
+// so the TCB only polls when the user turns on ScoutTelemetry (off by default, see OP_EEPROM_Struct.h). A Scout without it simply never replies 
+// and we stop asking (see SCOUT_TELEM_MISSES). 
+// The TCB sends SCOUT_CMD_GET_TELEMETRY with an item number and the Scout replies with the same four-byte framing it receives, plus two data bytes:
+//      [Address] [SCOUT_CMD_GET_TELEMETRY] [Item] [Data low 7 bits] [Data high 7 bits] [(sum of the preceding bytes) & 0x7F]
+// Only the address has the high bit set, so the reader can always find the start of the next reply even after losing bytes. 
+// Only one request is ever outstanding on the port, so two Scouts can share the TCB's receive line. 
+#define SCOUT_TELEM_CURRENT_M1                 0    // Motor 1 current in units of 10 mA
+#define SCOUT_TELEM_CURRENT_M2                 1    // Motor 2 current in units of 10 mA
+#define SCOUT_TELEM_TEMPERATURE                2    // Board temperature in degrees C, plus SCOUT_TEMP_OFFSET
+#define SCOUT_TELEM_VOLTAGE                    3    // Input voltage in units of 10 mV
+#define SCOUT_TELEM_FAULTS                     4    // Fault flags (see SCOUT_FAULT_ below)
+#define SCOUT_TELEM_ITEMS                      5
+#define SCOUT_TEMP_OFFSET                     40    // So temperatures below zero can still be sent
+
+#define SCOUT_FAULT_OVERCURRENT_M1          0x01    // Motor 1 is being held at the current limit
+#define SCOUT_FAULT_OVERCURRENT_M2          0x02    // Motor 2 is being held at the current limit
+#define SCOUT_FAULT_OVERTEMP                0x04    // Board is too hot, the Scout has cut the motors
+#define SCOUT_FAULT_LOW_VOLTAGE             0x08    // Input voltage below the minimum (see SetMinVoltage)
+#define SCOUT_FAULT_HIGH_VOLTAGE            0x10    // Input voltage above the maximum (see SetMaxVoltage)
+#define SCOUT_FAULT_WATCHDOG                0x20    // The serial watchdog has stopped the motors at least once since the last reply
+
+#define SCOUT_TELEM_POLL_mS                   20    // How often we ask for the next item. With both Scouts every value is refreshed about every 200 mS
+#define SCOUT_TELEM_TIMEOUT_mS                15    // How long we wait for a reply. A reply takes under 2 mS to send at 38400
+#define SCOUT_TELEM_MISSES                     5    // After this many unanswered requests in a row we consider the Scout's telemetry lost. If it has never answered at all 
+                                                    // its firmware doesn't support telemetry and we stop asking it until the next power-up. 
+#define SCOUT_TELEM_RETRY_mS                2000    // How often we ask a Scout that answered before but has stopped, in case it only needed a power cycle
+#define SCOUT_MAX_BOARDS                       2    // SCOUT_ADDRESS_A and SCOUT_ADDRESS_B
+
+typedef struct {
+    uint16_t Current_mA[2];                         // Motor 1 and motor 2 current
+    int16_t  Temperature_C;                         // Board temperature
+    uint16_t Voltage_mV;                            // Input voltage
+    uint8_t  Faults;                                // SCOUT_FAULT_ flags
+    uint32_t LastReply_mS;                          // Time of the last good reply
+    uint16_t Replies;                               // Good replies received
+    uint16_t Misses;                                // Requests that timed out
+    uint16_t BadPackets;                            // Replies with a bad checksum
+} scout_telemetry;
+
 class OP_Scout
 {
 public:
@@ -155,12 +197,46 @@ public:
         if (v >= 30 && v <= 140) command(SCOUT_CMD_MAX_VOLTAGE, v);
     }    
 
+    // Telemetry
+    // enableTelemetry adds this Scout to the boards that get polled. pollTelemetry must then be called often; it never waits on the port, 
+    // it only reads bytes that have already arrived and sends the next request when it is time. Both are shared by every Scout on the port. 
+    inline void enableTelemetry() const { enableTelemetry(_address, _port); }
+    static void enableTelemetry(byte address, HardwareSerial *port);
+    static void pollTelemetry(void);
+
+    // Returns true if the Scout at this address is answering, and if so copies its latest values into t
+    static boolean getTelemetry(byte address, scout_telemetry &t);
+    inline boolean getTelemetry(scout_telemetry &t) const { return getTelemetry(_address, t); }
+    static boolean telemetryPresent(byte address);
+    inline boolean telemetryPresent() const { return telemetryPresent(_address); }
+
 private:
     void throttleCommand(byte command, int speed) const;
     
     const byte      _address;
     HardwareSerial *_port;
 
+    // Telemetry, shared by all Scouts
+    static void     parseTelemetry(uint8_t b);
+    static void     requestNext(uint32_t now);
+    static int8_t   slotOf(byte address);
+    
+    static HardwareSerial  *_telemPort;
+    static scout_telemetry  _telem[SCOUT_MAX_BOARDS];
+    static boolean          _enabled[SCOUT_MAX_BOARDS];
+    static boolean          _present[SCOUT_MAX_BOARDS];
+    static boolean          _unsupported[SCOUT_MAX_BOARDS]; // Never answered, so no longer polled
+    static uint8_t          _missRun[SCOUT_MAX_BOARDS];     // Unanswered requests in a row
+    static uint32_t         _lastTry_mS[SCOUT_MAX_BOARDS];
+    static uint8_t          _nextItem[SCOUT_MAX_BOARDS];
+    static int8_t           _pendingSlot;                   // Board we are waiting on, -1 if none
+    static uint8_t          _pendingItem;
+    static uint32_t         _request_mS;
+    static uint8_t          _lastSlot;
+    static uint8_t          _rx[5];                         // Reply bytes after the address
+    static uint8_t          _rxCount;
+    static int8_t           _rxSlot;                        // Board the reply in progress is from, -1 if we are looking for an address
+
 };
 
 #endif
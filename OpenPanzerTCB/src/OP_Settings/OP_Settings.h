@@ -82,6 +82,8 @@
     // we never needed to use an LCD anyway. 
     // We've left the Serial 3 Tx connector on the TCB board for the fun of it, and it may be of some use in certain situations. But if you want to use an SBus receiver
     // and an LCD, you'll have to put the LCD on Serial1 (AuxSerial). 
+    // The exception is a CRSF (Crossfire/ExpressLRS) receiver. In that case Tx stays on at the CRSF baud rate and carries telemetry back to the receiver, 
+    // so connect Serial 3 Tx to the receiver's Rx pin if you want to see battery and damage on your transmitter. 
     #define Serial3Tx                   Serial3     // We call this Serial3Tx because we only have access to the Tx line, not the Rx (which is dedicated to SBus). 
 
     // At startup, before EEPROM is initalized, set default baud rate to: 
@@ -294,9 +296,9 @@
     // Main Sketch:     7       At least 14 slots but shouldn't be more than 7 active at any one time
     // OP_Radio:        3       4 slots but only up to 3 utilized at one time (radio detect, watchdog, elevation & azimuth ignore timers)
     // OP_Tank:         11      At least 15 slots but shouldn't be possible for more than 11 to be active at one time
-    // OP_TBS (sound):  5       Prop2, Prop3, plus 3 squeak slots, all could be active simultaneously
+    // OP_TBS (sound):  2       Prop2 and the throttle blip. Prop3 sounds and squeaks are polled from OP_TBS::update() and use no slots.
     //-----------------------
-    // TOTAL:           26   
+    // TOTAL:           23   
 
     #define MAX_SIMPLETIMER_SLOTS       30          // Based on the calculations above, this gives us a few extra slots in case we miscalculated or if we need to add more
                                                     // But any time you add more you should re-visit this list. Sometimes extra timer slots can be used that would only 
@@ -362,6 +364,26 @@
     // fast enough for a model to stop in the event of a disconnected cable. 
     
     // Final note: Pololu controllers don't implement a serial watchdog, and as mentioned some Sabertooth don't either, but it won't hurt them to receive the same signal repeated at routine intervals.
+
+    // Start-up:
+    // Serial controllers are set up from their update() after begin(), so setup() and radio detection never wait on them. Each refuses any speed but zero until it is ready. 
+    // The Sabertooth and Qik are ready SerialESC_Settle_mS after the autobaud character. A controller that was still booting when that went out will have missed it, so it 
+    // is sent once more SerialESC_Reautobaud_mS after power-up (to the Qik only if it isn't answering error polls). 
+    #define SerialESC_Settle_mS           20    // in milliseconds
+    #define SerialESC_Reautobaud_mS     1500    // in milliseconds, since power-up
+
+    // Stop repeat:
+    // A stop command that gets lost to noise leaves a tread running after the stick is centered, until the next routine repeat above. So when a serial controller 
+    // is told to stop, we send the stop once more this long after. 
+    #define SerialStop_Repeat_mS          40    // in milliseconds
+
+    // Scout thermal derating:
+    // Scouts with telemetry report their board temperature (see OP_Scout.h). Rather than run at full power until the Scout's own over-temperature cutoff stops the 
+    // model dead, we scale back the speed range as the board heats up, from full speed at OPScout_DerateStart_C down to OPScout_DerateMin_Pct at OPScout_DerateFull_C 
+    // and above. Scouts that don't answer telemetry requests are never derated. 
+    #define OPScout_DerateStart_C         70    // in degrees C
+    #define OPScout_DerateFull_C          90    // in degrees C
+    #define OPScout_DerateMin_Pct         40    // in percent of full speed
    
 
 // ------------------------------------------------------------------------------------------------------------------------------------------------------->>
@@ -442,23 +464,15 @@
         #define MG_PORT                  PORTD    // Port D
         #define MG_DDR                   DDRD     // Data direction register for Port D
         #define MG_PORTPIN               PD1      // The specific port pin for the machine gun LED (ATmega D1)
-		
-		// We keep track of the unused one as well so we can initialize it correctly
-		#define UNUSED_MG_PORT			 PORTE
-		#define UNUSED_MG_DDR			 DDRE
-		#define UNUSED_MG_PIN			 PE2		
 #else
         //Machine Gun light output - slightly different. This is on Atmega pin 4, but it does not have an Arduino pin number! 
         // Therefore we have to manipulate the port directly, we can't use pinMode() or digitalWrite() functions
         #define MG_PORT                  PORTE    // Port E
         #define MG_DDR                   DDRE     // Data direction register for Port E 
         #define MG_PORTPIN               PE2      // The specific port pin for the machine gun LED (ATmega E2)
-		
-		// We keep track of the unused one as well so we can initialize it correctly
-		#define UNUSED_MG_PORT			 PORTD
-		#define UNUSED_MG_DDR			 DDRD
-		#define UNUSED_MG_PIN			 PD1		
 #endif
+        // The machine gun pin of each board, and the other board's pin that we leave unused, are also listed in the DeviceCapabilities table 
+        // (OP_Devices.cpp). SetupPins works from the table, these defines are for the code that flashes the LED and needs to be fast.
         
     // Mechanical Recoil 
         #define pin_MechRecoilMotor      43       // Output   - Controls the mechanical recoil motor (on/off) (ATmega L6)
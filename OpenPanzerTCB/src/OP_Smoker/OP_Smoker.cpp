@@ -71,12 +71,11 @@ void OP_Smoker::begin(void)
 
     // Smoker effect - none right now
         smoker_effect = NONE;
-
-	// Set the update interval to default to begin with
-		UpdateInterval = smoker_update_rate_mS;
-	
-	// No effects yet, set the step to 0
-		curStep = 0;
+        curFrame = 0;
+        LastTick_mS = millis();
+        
+    // No speed commands yet
+        lastCommand = 0;
 		
     // Reversed - no
         reversed = false;
@@ -137,13 +136,28 @@ void OP_Smoker::begin(void)
     }
 }
 
-void OP_Smoker::setSpeed(int s)
+void OP_Smoker::setSpeed(int s, boolean engineLinked)
 {
     int f; 
     int h; 
     
 	if (smoker_effect == STARTUP) return;
 	
+    if (smoker_effect == BURST)
+    {   // Let the burst run its course, we will resume from the most recent command when it is done
+        lastCommand = s;
+        return;
+    }
+    
+    // Manual control sets the output directly, the burst only follows the engine
+    if (Smoker_Accel_Burst && engineLinked && smoker_effect == NONE && (abs(s) - abs(lastCommand)) > Smoker_Burst_Threshold)
+    {   // Throttle was opened quickly, give a puff of smoke. Reference is the top of the present ranges, which may have been cut by battle damage. 
+        lastCommand = s;
+        startEffect(BURST, i_maxspeed, i_maxheat);
+        return;
+    }
+    lastCommand = s;
+    
     clearSmokerEffect();                    // Clear any special effect - they only run when manual commands are not being given
 
     switch (SmokerType)
@@ -183,49 +197,6 @@ void OP_Smoker::setSpeed(int s)
     LastUpdate_mS = millis();               // Save the time
 }
 
-void OP_Smoker::setSpeed_Shutdown(int s)
-{   // The only difference here from setSpeed is that we don't clear the smoker effect, and we also don't call this function publicly, 
-    // only privately
-    int f; 
-    int h; 
-
-    switch (SmokerType)
-    {
-        case SMOKERTYPE_ONBOARD_STANDARD:    
-            f = map_RangeFan(abs(s));       // Make sure we are using the internal range. We don't do reverse so negative values are converted to positive with abs()
-            
-            // Set the PWM duty cycle of the combined fan and heat output
-            OB_SMOKER_OCR = f;              // OB_SMOKER_OCR is defined in OP_Settings.h
-            curspeed = f;                   // Save the speed, it is the same for fan and heat
-            curheat = f;
-            break;
-        
-        case SMOKERTYPE_ONBOARD_SEPARATE:
-			f = s;							// We don't need (or want) to map the passed value, which will have already been mapped from the beginning level that it starts from for the shutdown
-			h = 0;							// During shutdown, heat always goes straight to zero. 
-
-            // Set the PWM duty cycle of the individual fan and heat outputs
-            analogWrite(pin_AuxOutput, f);  // Fan - Aux output
-            OB_SMOKER_OCR = h;              // Heat- Smoker output (OB_SMOKER_OCR is defined in OP_Settings.h)
-            curspeed = f;                   // Fan - speed
-            curheat = h;                    // Heat - level
-            break;
-            
-        case SMOKERTYPE_SERIAL:
-            f = map_RangeFan(abs(s));       // Make sure we are using the internal range. We don't do reverse so negative values are converted to positive with abs()
-			h = 0;							// During shutdown, heat always goes straight to zero. 
-
-            // Send the serial commands for hte individual fan and heat outputs 
-            OP_Smoker::setLevelSerial(SMOKER_CMD_FAN_SPEED, f);
-            OP_Smoker::setLevelSerial(SMOKER_CMD_HEATER_LEVEL, h);
-            curspeed = f;
-            curheat = h;
-            break;
-    }       
-
-    LastUpdate_mS = millis();               // Save the time
-}
-
 void OP_Smoker::setSpeed_Absolutes(int f, int h)
 {
     switch (SmokerType)
@@ -321,9 +292,8 @@ void OP_Smoker::Startup(boolean engaged)
 
 	if (Smoker_Startup_Pulse && SmokerType != SMOKERTYPE_SERIAL)
 	{
-		smoker_effect = STARTUP;
-		LastUpdate_mS = millis();			// Save the time
-		UpdateInterval = 0;					// Start right away
+        // Puff at full fan output, the AUX output has a different scale than the others. Heater is also at full. 
+		startEffect(STARTUP, (SmokerType == SMOKERTYPE_ONBOARD_SEPARATE) ? AUX_PWM_TOP : MOTOR_MAX_FWDSPEED, MOTOR_MAX_FWDSPEED);
 	}
 	else
 	{
@@ -375,6 +345,7 @@ void OP_Smoker::Shutdown(boolean engaged)
     // and set our internal variables to zero. 
     if (SmokerType == SMOKERTYPE_SERIAL) 
     {
+        clearSmokerEffect();
         OP_Smoker::command(SMOKER_CMD_SHUTDOWN); 
         curspeed = 0;
         curheat = 0;
@@ -389,103 +360,138 @@ void OP_Smoker::Shutdown(boolean engaged)
         // Restore the internal range to full so we can actually get down to zero speed
         restore_Speed();    // This restores both the fan and heater ranges
 
-        // But now we need to modify our curspeed variable so the shutdown effect knows where to start from. Under normal operation we modify the internal speed range of the 
-        // smoker object, setting the minimum to something greater than zero, which becomes idle. Under that scheme, curspeed of 0 actually represents some non-zero smoker speed. 
-        // Now that we are using the full speed scale range where 0 actually means 0 (stopped), we need to adjust our prior curspeed variable to the new range. The adjustment 
-        // depends on whether the transmission was engaged or not. We don't need to do this to the heat level variable because that one goes straight to full off on shutdown with 
-        // no gradual slowing down. 
+        // If for some reason we don't have a current speed, start from idle (or fast idle) so there is still something to taper off. 
+        // We don't need to do this to the heat level because that one goes straight to full off on shutdown. 
         if (curspeed == 0)
         {
             engaged == true ? curspeed = Idle : curspeed = FastIdle; 
         }
 
-        // Set the active effect
-        smoker_effect = SHUTDOWN;
-
-        // Set the update rate
-        UpdateInterval = smoker_update_rate_mS;
+        // The shutdown keyframes are relative to wherever the fan is right now
+        startEffect(SHUTDOWN, curspeed, 0);
         
         // Now the sketch will poll the update() function which will take care of the effect
     }
 }
 
+void OP_Smoker::Destroyed(int s)
+{
+    // The sketch should have restored the full speed range before calling this. The plume billows around the user's destroyed speed setting.
+    if (s == 0) { stop(); return; }
+    startEffect(DESTROYED, map_RangeFan(abs(s)), map_RangeHeat(abs(s)));
+}
+
+void OP_Smoker::startEffect(smoker_effect_t e, int fanRef, int heatRef)
+{
+    smoker_effect = e;
+    curFrame = 0;
+    refFan = fanRef;
+    refHeat = heatRef;
+    startFan = curspeed;                    // The first keyframe is reached from wherever we are now
+    startHeat = curheat;
+    FrameStart_mS = millis();
+    LastTick_mS = FrameStart_mS - smoker_update_rate_mS;    // Apply the first tick right away
+}
+
+void OP_Smoker::endEffect(boolean engaged)
+{
+    smoker_effect_t e = smoker_effect;
+    smoker_effect = NONE;
+    curFrame = 0;
+    
+    switch (e)
+    {
+        case STARTUP:   
+            // Now set idle speed depending on the transmission engaged status
+            engaged ? OP_Smoker::setIdle() : OP_Smoker::setFastIdle();      
+            break;
+        
+        case SHUTDOWN:  
+            OP_Smoker::stop();                      
+            break;
+        
+        case BURST:     
+            OP_Smoker::setSpeed(lastCommand);       // Go back to whatever the throttle is asking for now
+            break;
+        
+        default:        
+            break;
+    }
+}
+
 void OP_Smoker::update(boolean engaged)
 {
-	int fullOn; 
-	
+    uint8_t first, count, loop;
+    uint8_t f;
+    uint16_t t;
+    uint32_t elapsed;
+    int targetFan, targetHeat;
+    int fan, heat;
+    
     if (smoker_effect != NONE)
     {   
-        if (millis() - LastUpdate_mS > UpdateInterval)		
+        if (millis() - LastTick_mS >= smoker_update_rate_mS)
         {
-            switch (smoker_effect)
+            LastTick_mS = millis();
+            
+            first = SmokerEffectFirst(smoker_effect - 1);
+            count = SmokerEffectCount(smoker_effect - 1);
+            loop  = SmokerEffectLoop(smoker_effect - 1);
+
+            // Skip past any keyframes we have already reached. A segment is finished once its time has elapsed, then the next one starts
+            // from the level we just reached. We can pass through several in one tick if they are short (or 0, an instant jump), but never 
+            // more than the length of the effect so a badly-made looping table can't hang us here. 
+            for (uint8_t i = 0; i <= count; i++)
             {
-                case STARTUP: 
-					if (curStep >= smoker_startup_steps)
-					{
-						// Startup is done
-						smoker_effect = NONE;
-						curStep = 0;
-						UpdateInterval = smoker_update_rate_mS;		// Revert this to default
-						
-						// Now set idle speed depending on the transmission engaged status
-						engaged ? OP_Smoker::setIdle() : OP_Smoker::setFastIdle();
-
-						LastUpdate_mS = millis();               // Save the time   						
-					}
-					else
-					{	
-						if (SmokerType == SMOKERTYPE_ONBOARD_SEPARATE) fullOn = AUX_PWM_TOP; 
-						else										   fullOn = MOTOR_MAX_FWDSPEED;
-						
-						switch (curStep)
-						{
-							case 0:		setSpeed_Absolutes(fullOn, e_maxspeed);		UpdateInterval = 250; 	break;		// Fan on	- in all cases heater is at max
-							case 1:		setSpeed_Absolutes(0, e_maxspeed);			UpdateInterval = 180; 	break;		// Fan off
-							case 2:		setSpeed_Absolutes(fullOn, e_maxspeed);		UpdateInterval = 250; 	break;		// Fan on
-							case 3:		setSpeed_Absolutes(0, e_maxspeed);			UpdateInterval = 180; 	break;		// Fan off
-							case 4:		setSpeed_Absolutes(fullOn, e_maxspeed);		UpdateInterval = 250; 	break;		// Fan on
-							case 5:		setSpeed_Absolutes(0, e_maxspeed);			UpdateInterval = 180; 	break;		// Fan off							
-							case 6:		setSpeed_Absolutes(fullOn, e_maxspeed);		UpdateInterval = 250; 	break;		// Fan on
-							case 7:		setSpeed_Absolutes(0, e_maxspeed);			UpdateInterval = 180; 	break;		// Fan off								
-						}
-						curStep += 1; 						// Increment step
-					}
-					break;
-			
-                case SHUTDOWN:
-                    // This effect simply turns off the smoker gradually instead of all at once. Each update through we reduce the speed by 1 (or 4 if AUX). 
-                    // In most cases we assume the user decides to turn off the engine while the tank is stopped, so already the smoker should 
-                    // probably be down to idle speed, which is not very fast to begin with. Therefore even with only reducing the speed slightly each step
-                    // per pass it won't take long to get to zero.
-                    // As for heat, when the user wants to stop the smoker, we turn off the heater immediately (no ramping down)
-                    if (SmokerType == SMOKERTYPE_ONBOARD_SEPARATE) curspeed -= 4;
-					else										   curspeed -= 1; 
-                    curheat   = 0;
-                    if (curspeed <= 0) 
-                    {
-                        OP_Smoker::stop(); // Stop the smoker - this will also clear the effect so we don't keep coming back here. 
-                    }
-                    else
+                f = first + curFrame;
+                t = SmokerFrameTime(f);
+                elapsed = LastTick_mS - FrameStart_mS;
+                if (elapsed < t) break;
+                
+                startFan  = ((int32_t)SmokerFrameFan(f)  * refFan)  / 255;
+                startHeat = ((int32_t)SmokerFrameHeat(f) * refHeat) / 255;
+                FrameStart_mS += t;
+                
+                if (++curFrame >= count)
+                {
+                    if (loop == SMOKER_NO_LOOP)
                     {
-                        OP_Smoker::setSpeed_Shutdown(curspeed); 	// We use the shutdown version of setSpeed so it doesn't clear the effect
+                        setSpeed_Absolutes(startFan, startHeat);    // Land exactly on the last keyframe
+                        endEffect(engaged);
+                        return;
                     }
-                    break;
-                
-                default:
-                    break;
+                    curFrame = loop;
+                }
+            }
+            
+            // Now interpolate (fixed point) between the level at the start of this segment and the level of the keyframe we are heading to
+            f = first + curFrame;
+            t = SmokerFrameTime(f);
+            elapsed = LastTick_mS - FrameStart_mS;
+            targetFan  = ((int32_t)SmokerFrameFan(f)  * refFan)  / 255;
+            targetHeat = ((int32_t)SmokerFrameHeat(f) * refHeat) / 255;
+            if (t == 0 || elapsed >= t) 
+            {
+                fan  = targetFan;
+                heat = targetHeat;
+            }
+            else
+            {
+                fan  = startFan  + (((int32_t)(targetFan  - startFan)  * (int32_t)elapsed) / t);
+                heat = startHeat + (((int32_t)(targetHeat - startHeat) * (int32_t)elapsed) / t);
             }
+            
+            // Only write the outputs if something changed. The serial smoker still gets its keep-alive below. 
+            if (fan != curspeed || heat != curheat) setSpeed_Absolutes(fan, heat);
         }
-        // LastUpdate_mS will get updated through either the stop() or setSpeed_Shutdown() functions called above
     }
-    else 
+
+    // We also send a routine speed/level update if this is a serial smoker and we are nearing the watchdog timeout time
+    if (SmokerType == SMOKERTYPE_SERIAL && (millis() - LastUpdate_mS > (OP_Smoker_WatchdogTimeout_mS - 100)))
     {
-        // No effect active - but we also send a routine speed/level update if this is a serial smoker and we are nearing the watchdog timeout time
-        if (SmokerType == SMOKERTYPE_SERIAL && (millis() - LastUpdate_mS > (OP_Smoker_WatchdogTimeout_mS - 100)))
-        {
-            OP_Smoker::setLevelSerial(SMOKER_CMD_FAN_SPEED, curspeed);
-            OP_Smoker::setLevelSerial(SMOKER_CMD_HEATER_LEVEL, curheat);
-            LastUpdate_mS = millis();               // Save the time    
-        }
+        OP_Smoker::setLevelSerial(SMOKER_CMD_FAN_SPEED, curspeed);
+        OP_Smoker::setLevelSerial(SMOKER_CMD_HEATER_LEVEL, curheat);
+        LastUpdate_mS = millis();               // Save the time    
     }
 }
 
@@ -59,11 +59,86 @@ const __FlashStringHelper *ptrSmokerType(Smoker_t sType); //Returns a character
 
 // Startup pulsing
 #define Smoker_Startup_Pulse				 true	  // Attempts to create a pulsing (puffing) effect on startup.
+// Acceleration burst
+#define Smoker_Accel_Burst                   true     // Give a brief puff of smoke when the throttle is opened quickly
+#define Smoker_Burst_Threshold               64       // How much the (external, 0-255) speed must jump in a single command to trigger the burst effect
+
+
+// SMOKER EFFECT KEYFRAMES
+// -------------------------------------------------------------------------------------------------------------------------------------------->> 
+// Each smoker effect is described by a short list of keyframes. A keyframe gives a fan and heat level (0-255) and the time in mS it takes to 
+// get there from the prior keyframe. The update() routine interpolates linearly between keyframes, so a time of 0 is an instant jump and two 
+// keyframes with the same level make a hold. Levels are not absolute output values, they are scaled against a reference fan and heat level that 
+// is chosen when the effect starts (see OP_Smoker::startEffect). For example 255 in the shutdown effect means "whatever speed the fan was at when 
+// the engine was turned off". This lets the same table serve the onboard smoker (0-255), the AUX fan output (0-1023) and the serial smoker. 
+// To change the look of an effect, change the numbers here - no code changes are needed so long as SmokerEffects below is kept in step. 
+typedef struct {
+    uint16_t Time_mS;       // Time to reach this keyframe from the prior one
+    uint8_t  Fan;           // Fan level  (0-255 of reference)
+    uint8_t  Heat;          // Heat level (0-255 of reference)
+} SmokerKeyframe;
+
+#define SMOKER_NUM_KEYFRAMES    26
+const SmokerKeyframe SmokerFrames[SMOKER_NUM_KEYFRAMES] PROGMEM_FAR = {
+// Startup puffs - 0. Reference is full output for fan and heat. Heat is held at max throughout while the fan puffs four times.
+{60,   255, 255},   // 0    Fan on
+{190,  255, 255},   // 1    hold
+{0,      0, 255},   // 2    Fan off
+{180,    0, 255},   // 3    hold
+{60,   255, 255},   // 4    Fan on
+{190,  255, 255},   // 5    hold
+{0,      0, 255},   // 6    Fan off
+{180,    0, 255},   // 7    hold
+{60,   255, 255},   // 8    Fan on
+{190,  255, 255},   // 9    hold
+{0,      0, 255},   // 10   Fan off
+{180,    0, 255},   // 11   hold
+{60,   255, 255},   // 12   Fan on
+{190,  255, 255},   // 13   hold
+{0,      0, 255},   // 14   Fan off
+{180,    0, 255},   // 15   hold
+// Shutdown trail - 16. Reference is the fan speed when shutdown began. Heat cuts immediately, fan tapers off quickly at first then more slowly.
+{0,    255,   0},   // 16   Heat off
+{450,  170,   0},   // 17
+{600,   85,   0},   // 18
+{900,    0,   0},   // 19   Off
+// Acceleration burst - 20. Reference is the maximum of the present (possibly damage-reduced) fan and heat ranges.
+{80,   255, 255},   // 20   Fan and heat up fast
+{320,  255, 255},   // 21   hold
+{250,  140, 255},   // 22   Ease back before handing control back to the throttle
+// Destroyed plume - 23. Reference is the user's destroyed smoker level. Loops from keyframe 24 so the plume billows for as long as we are destroyed.
+{300,  255, 255},   // 23   Build up
+{900,  140, 255},   // 24   Fade
+{700,  255, 255}    // 25   Billow
+};
+// As with Prop3 in OP_TBS.h, we can't refer to array elements and struct members directly when using far addresses. Each keyframe is 4 bytes wide. 
+#define SmokerFrameTime(f)      pgm_read_word_far(pgm_get_far_address(SmokerFrames) + ((f)*4))
+#define SmokerFrameFan(f)       pgm_read_byte_far(pgm_get_far_address(SmokerFrames) + ((f)*4) + 2)
+#define SmokerFrameHeat(f)      pgm_read_byte_far(pgm_get_far_address(SmokerFrames) + ((f)*4) + 3)
+
+// Where each effect lives in the keyframe table. Effects are listed in the same order as smoker_effect_t (less NONE). 
+#define SMOKER_NO_LOOP          0xFF        // Effect ends after the last keyframe
+typedef struct {
+    uint8_t First;          // First keyframe
+    uint8_t Count;          // Number of keyframes
+    uint8_t Loop;           // Keyframe (relative to First) to jump back to after the last one, or SMOKER_NO_LOOP
+} SmokerEffectSettings;
+
+#define SMOKER_NUM_EFFECTS      4
+const SmokerEffectSettings SmokerEffects[SMOKER_NUM_EFFECTS] PROGMEM_FAR = {
+{0,  16, SMOKER_NO_LOOP},   // Startup
+{16,  4, SMOKER_NO_LOOP},   // Shutdown
+{20,  3, SMOKER_NO_LOOP},   // Acceleration burst
+{23,  3, 1}                 // Destroyed
+};
+#define SmokerEffectFirst(e)    pgm_read_byte_far(pgm_get_far_address(SmokerEffects) + ((e)*3))
+#define SmokerEffectCount(e)    pgm_read_byte_far(pgm_get_far_address(SmokerEffects) + ((e)*3) + 1)
+#define SmokerEffectLoop(e)     pgm_read_byte_far(pgm_get_far_address(SmokerEffects) + ((e)*3) + 2)
 
 class OP_Smoker {
   public:
     OP_Smoker(int min, int max, int middle, int idle, int fastIdle, int maxSpeed, int idleHeat, int fastIdleHeat, int maxHeat, HardwareSerial *port, uint32_t *baud, Smoker_t st, uint8_t preheat) : e_minspeed(min), e_maxspeed(max), e_middlespeed(middle), Idle(idle), FastIdle(fastIdle), MaxSpeed(maxSpeed), HeatAmtIdle(idleHeat), HeatAmtFastIdle(fastIdleHeat), HeatAmtMax(maxHeat), smokerPort(port), smokerBaud(baud), SmokerType(st), preHeat_Seconds(preheat) {}
-    void setSpeed(int s);
+    void setSpeed(int s, boolean engineLinked = false);    // engineLinked is true when the speed comes from the engine (auto control), only then can a throttle jump cause a burst
     int getSpeed(void) { return this->curspeed; }
     void begin(void);   
     void stop(void);
@@ -73,6 +148,7 @@ class OP_Smoker {
     void update(boolean);           // Actually we will use the update routine on the smoker for special effects (boolean for whether the transmission is engaged or not)
     void Startup(boolean);          // This will trigger the startup  smoker effect (boolean for whether the transmission is engaged or not)
     void Shutdown(boolean);         // This will trigger the shutdown smoker effect (boolean for whether the transmission is engaged or not - the effect slowly turns off smoker)
+    void Destroyed(int);            // This will trigger the looping destroyed plume effect, pass the (external range) smoker speed to billow around
 
     // SERIAL FUNCTIONS
     // ---------------------------------------------------------------->>
@@ -176,21 +252,27 @@ private:
     uint32_t *smokerBaud;
     const Smoker_t SmokerType;
     uint8_t preHeat_Seconds;
-    uint32_t LastUpdate_mS;                         // Last smoker update timestamp
-    uint16_t UpdateInterval;                        // How long to wait until the next update for effects	
-	uint8_t curStep;								// What step are we on - for effects
+    uint32_t LastUpdate_mS;                         // Last time we sent a level to the smoker (used for the serial watchdog)
   
-    // These can be used for special smoker effects. The main sketch will poll the update() function routinely, 
-    // which can then create changes in smoker speeds over time.
-    #define smoker_update_rate_mS   15              // Default update rate, but we can also specify something different if we want
-    #define smoker_startup_steps    8               // How many steps in the startup effect	
+    // These can be used for special smoker effects. The main sketch will poll the update() function routinely, which steps through
+    // the keyframes of the active effect (see SmokerFrames above) on a fixed tick and sets the outputs accordingly.
+    #define smoker_update_rate_mS   15              // Effect tick
     enum smoker_effect_t
-    {   NONE = 0,
+    {   NONE = 0,                                   // The order of the remaining effects must match SmokerEffects above
+        STARTUP,
         SHUTDOWN,
-		STARTUP
+        BURST,
+        DESTROYED
     };
     smoker_effect_t smoker_effect;
-    void setSpeed_Shutdown(int s);   				// The update() routine can call this version of setSpeed without clearing the special effect
+    uint32_t LastTick_mS;                           // Last effect tick
+    uint32_t FrameStart_mS;                         // Time the current keyframe segment began
+    uint8_t  curFrame;                              // Current keyframe, relative to the start of the effect
+    int      startFan, startHeat;                   // Output levels at the start of the current segment
+    int      refFan, refHeat;                       // Output levels that a keyframe level of 255 represents for this effect
+    int      lastCommand;                           // Last speed passed to setSpeed, used to detect throttle jumps and to resume after a burst
+    void startEffect(smoker_effect_t e, int fanRef, int heatRef);
+    void endEffect(boolean engaged);                // Whatever should happen when a non-looping effect runs out of keyframes
 	void setSpeed_Absolutes(int f, int h);			// No mapping to internal ranges, no accounting for idle being "zero", this just sets it to whatever you pass
     void clearSmokerEffect(void) { if (smoker_effect != NONE) smoker_effect = NONE; }
     
@@ -62,9 +62,13 @@ enum switch_action : uint8_t {
 }; 
 
 class OP_Sound {
+  protected:
+    const SOUND_DEVICE soundDevice;                     // Which device this really is (SD_BENEDINI_TBSMINI, SD_OP_SOUND_CARD...), see SoundUpdate() below
   public:
-    OP_Sound() {}                                       // Constructor
+    OP_Sound(SOUND_DEVICE d) : soundDevice(d) {}        // Constructor
+    SOUND_DEVICE getDevice(void) { return soundDevice; }
     virtual void begin() =0;                            // Setups
+    virtual void update(void) =0;                       // Polled each time through the main loop, for devices that need to do work in the background
     
     // Engine sound functions   
     virtual void StartEngine(void) =0;  
@@ -142,8 +146,9 @@ class OP_Sound {
 
 class BenediniTBS: public OP_Sound, public OP_TBS {
   public:
-    BenediniTBS(OP_SimpleTimer * t, boolean m) : OP_Sound(), OP_TBS(t, m)  {} // TBS requires pointer to SimpleTimer object, plus a boolean to indicate Micro (true) or Mini (false)
+    BenediniTBS(OP_SimpleTimer * t, boolean m) : OP_Sound(m ? SD_BENEDINI_TBSMICRO : SD_BENEDINI_TBSMINI), OP_TBS(t, m)  {} // TBS requires pointer to SimpleTimer object, plus a boolean to indicate Micro (true) or Mini (false)
     void begin()                                                { OP_TBS::begin();                     }
+    void update(void)                                           { OP_TBS::update();                    }   // Ramps engine speed, sends queued Prop3 sounds and plays squeaks
 
   // Engine sound functions
     void StartEngine(void)                                      { OP_TBS::StartEngine();               }   // TBS doesn't have start/stop, just toggle. But we use independent functions anyway
@@ -285,8 +290,9 @@ class BenediniTBS: public OP_Sound, public OP_TBS {
 
 class OP_SoundCard: public OP_Sound {
   public:
-    OP_SoundCard(HardwareSerial *p) : OP_Sound(), _port(p) {} 
+    OP_SoundCard(HardwareSerial *p) : OP_Sound(SD_OP_SOUND_CARD), _port(p) {} 
     void begin(void); 
+    void update(void)                                           { return;                                                   }   // Nothing to poll, the sound card handles its own timing
     
   // Engine sound functions   
     void StartEngine(void)                                      { command(OPSC_CMD_ENGINE_START);                           }   
@@ -436,8 +442,9 @@ class OP_SoundCard: public OP_Sound {
 
 class OP_TaigenSound: public OP_Sound {
   public:
-    OP_TaigenSound() : OP_Sound() {} 
+    OP_TaigenSound() : OP_Sound(SD_TAIGEN_SOUND) {} 
     void begin(void); 
+    void update(void)                                           { return;                                                   }   // Nothing to poll
 
   // Functions the sound card can actually respond to 
   // ----------------------------------------------------------------------------------------------
@@ -529,5 +536,19 @@ class OP_TaigenSound: public OP_Sound {
       
 };
 
+
+// Of all the sound functions only update() is called every time through the loop, the rest are called when something happens (a trigger, 
+// a change in speed) and are left on the virtual table. Only the TBS has any work to do in update(), so this calls it directly from the 
+// device tag, and for the other devices it costs one compare and no call at all. 
+inline void SoundUpdate(OP_Sound * s)
+{
+    switch (s->getDevice())
+    {
+        case SD_BENEDINI_TBSMINI:
+        case SD_BENEDINI_TBSMICRO:  static_cast<BenediniTBS *>(s)->BenediniTBS::update();     break;
+        default:                                                                            break;     // Nothing to poll on the sound card or Taigen
+    }
+}
+
 #endif // OP_SOUND_H
 
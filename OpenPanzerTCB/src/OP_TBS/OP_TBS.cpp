@@ -31,13 +31,17 @@
 OP_SimpleTimer * OP_TBS::TBSTimer;
 OP_Servos      * OP_TBS::TBSProp;
 boolean         OP_TBS::Micro;
+int             OP_TBS::Prop1Target;
+int             OP_TBS::Prop1Pulse;
+unsigned long   OP_TBS::Prop1Tick_mS;
 int             OP_TBS::TBSProp2TimerID;
 boolean         OP_TBS::Prop2TimerComplete;
 boolean         OP_TBS::EngineRunning;
-int             OP_TBS::TBSProp3TimerID;
-boolean         OP_TBS::Prop3TimerComplete;
+OP_TBS::prop3_request OP_TBS::Prop3Queue[PROP3_QUEUE_SIZE];
+OP_TBS::prop3_state   OP_TBS::Prop3State;
+unsigned long   OP_TBS::Prop3StateTime;
 uint8_t         OP_TBS::currentProp3SoundNum;
-uint8_t         OP_TBS::previousProp3SoundNum;
+uint8_t         OP_TBS::heldProp3SoundNum;
 // Squeaky stuff
 boolean         OP_TBS::Squeak1_Enabled;
 boolean         OP_TBS::Squeak2_Enabled;
@@ -46,9 +50,9 @@ boolean         OP_TBS::Squeak1_Active;
 boolean         OP_TBS::Squeak2_Active;
 boolean         OP_TBS::Squeak3_Active;
 boolean         OP_TBS::AllSqueaks_Active;
-int             OP_TBS::Squeak1TimerID;
-int             OP_TBS::Squeak2TimerID;
-int             OP_TBS::Squeak3TimerID;
+unsigned long   OP_TBS::Squeak1Next_mS;
+unsigned long   OP_TBS::Squeak2Next_mS;
+unsigned long   OP_TBS::Squeak3Next_mS;
 unsigned int    OP_TBS::SQUEAK1_MIN_mS;
 unsigned int    OP_TBS::SQUEAK1_MAX_mS;
 unsigned int    OP_TBS::SQUEAK2_MIN_mS;
@@ -67,12 +71,16 @@ OP_TBS::OP_TBS(OP_SimpleTimer * t, boolean m)
     TBSProp = new OP_Servos; 
     
     // Initialize
+    Prop1Target = PROP1_IDLE;
+    Prop1Pulse = PROP1_IDLE;
+    Prop1Tick_mS = 0;
     Prop2TimerComplete = true;
-    Prop3TimerComplete = true;
     TBSProp2TimerID = 0;
-    TBSProp3TimerID = 0;
+    for (uint8_t i = 0; i < PROP3_QUEUE_SIZE; i++) Prop3Queue[i].Sound = SOUND_OFF;
+    Prop3State = PROP3_IDLE;
+    Prop3StateTime = 0;
     currentProp3SoundNum = SOUND_OFF;
-    previousProp3SoundNum = SOUND_OFF;
+    heldProp3SoundNum = SOUND_OFF;
     
     // The engine is not running
     EngineRunning = false;
@@ -92,9 +100,9 @@ OP_TBS::OP_TBS(OP_SimpleTimer * t, boolean m)
     Squeak2_Active = false;
     Squeak3_Active = false;
     AllSqueaks_Active = false;
-    Squeak1TimerID = 0;
-    Squeak2TimerID = 0;
-    Squeak3TimerID = 0;
+    Squeak1Next_mS = 0;
+    Squeak2Next_mS = 0;
+    Squeak3Next_mS = 0;
     
     // Initialize these as well, but again, they will in the end be set by the user's preference
     HeadlightSound_Enabled = true;
@@ -113,12 +121,11 @@ void OP_TBS::begin()
 
 void OP_TBS::InitializeOutputs(void)
 {
-    TBSProp->writeMicroseconds(PROP1, PROP1_IDLE);          // Initialize to speed = 0
+    WriteProp1(PROP1_IDLE);                                 // Initialize to speed = 0
     TBSProp->writeMicroseconds(PROP2, PROP2_SWITCH_OFF);    // Initialize to engine off
     if (Micro == false)
     {   
-        TBSProp->writeMicroseconds(PROP3, Prop3SoundPulse(SOUND_OFF));  // Initialize to no special sounds, only if using Mini
-        ClearProp3Timer();
+        ClearProp3();                                       // Initialize to no special sounds, only if using Mini
     }
 }
 
@@ -130,19 +137,51 @@ void OP_TBS::SetEngineSpeed(int speed)
 {
     // speed will be somewhere in the range from MOTOR_MAX_REVSPEED (-255) to MOTOR_MAX_FWDSPEED (255) 
     // Map it to the TBS throttle range:
+    speed = constrain(speed, MOTOR_MAX_REVSPEED, MOTOR_MAX_FWDSPEED);
     speed = map(speed, 0, MOTOR_MAX_FWDSPEED, PROP1_IDLE, PROP1_FULL_SPEED);
-    // Now send it to the TBS
-    TBSProp->writeMicroseconds(PROP1, speed);
+    // We don't send it to the TBS here, update() will ramp the output to it. Small changes are ignored, 
+    // except when asked for idle or full speed exactly, so we always settle on the end points. 
+    if (abs(speed - Prop1Target) >= PROP1_DEADBAND_uS || speed == PROP1_IDLE || speed == PROP1_FULL_SPEED) 
+    {
+        if (Prop1Pulse == Prop1Target) Prop1Tick_mS = millis();     // Engine was holding steady, time the ramp from now
+        Prop1Target = speed;
+    }
 }
 
 void OP_TBS::IdleEngine(void)
-{   // This is a faster way than SetEngineSpeed to put the engine to idle
-    TBSProp->writeMicroseconds(PROP1, PROP1_IDLE);
+{   // This is a faster way than SetEngineSpeed to put the engine to idle, it skips the ramp
+    WriteProp1(PROP1_IDLE);
 }
 
 void OP_TBS::ClearThrottleBlip(void)
 {   // Same as IdleEngine which however we can't call from this static function since it is public, and we need this one static so it can be used with SimpleTimer...
-    TBSProp->writeMicroseconds(PROP1, PROP1_IDLE);  // Return the throttle to idle from our brief blip (only used with Micro)
+    WriteProp1(PROP1_IDLE);  // Return the throttle to idle from our brief blip (only used with Micro)
+}
+
+void OP_TBS::WriteProp1(int pulse)
+{
+    Prop1Target = pulse;
+    Prop1Pulse = pulse;
+    TBSProp->writeMicroseconds(PROP1, pulse);
+}
+
+void OP_TBS::ServiceProp1(void)
+{
+    unsigned long now = millis();
+    if (Prop1Pulse == Prop1Target || now - Prop1Tick_mS < PROP1_TICK_mS) return;
+    
+    // Step once for every tick that has gone by, so a slow pass through the loop doesn't slow the ramp down. 
+    // But cap it, or after a long blocking call the whole ramp would happen in one jump. 
+    unsigned long ticks = (now - Prop1Tick_mS) / PROP1_TICK_mS;
+    if (ticks > 5) ticks = 5;
+    Prop1Tick_mS = now - ((now - Prop1Tick_mS) % PROP1_TICK_mS);
+
+    int pulse = Prop1Pulse;
+    if (Prop1Target > pulse) pulse = min(Prop1Target, pulse + (int)(ticks * PROP1_RAMP_UP_uS));
+    else                     pulse = max(Prop1Target, pulse - (int)(ticks * PROP1_RAMP_DOWN_uS));
+    
+    Prop1Pulse = pulse;
+    TBSProp->writeMicroseconds(PROP1, pulse);   // Only written when the pulse actually changes
 }
 
 //------------------------------------------------------------------------------------------------------------------------>>
@@ -188,7 +227,7 @@ void OP_TBS::StartEngine(void)
     // and we will blip the throttle instead. 
     if (Micro)
     {
-        SetEngineSpeed(75); // Not full throttle, but enough it should be registered
+        WriteProp1(map(75, 0, MOTOR_MAX_FWDSPEED, PROP1_IDLE, PROP1_FULL_SPEED)); // Not full throttle, but enough it should be registered. Skip the ramp or the blip would be over before it got anywhere.
         TBSTimer->setTimeout(TBS_SIGNAL_mS, ClearThrottleBlip); // After a brief time the blip will be reverted to idle
     }
     else 
@@ -257,57 +296,162 @@ void OP_TBS::StopRepairSound(void)
 // let the turret traverse sound start. The only foolproof way around this would be to hard-code the exact lengths of every sound into
 // this class, but that isn't practical. 
 // Another oddity that could happen, which we have programmed around, is that when firing the machine gun while moving, a squeak
-// will interrup the machine gun sound, which is fine because squeaks are very short, but the machine gun would not re-start after
-// the squeak, even though it might still be firing (the light will still blink). We have worked around this very case by setting
-// the machine gun to be a "constant-on" sound (until specifically turned off - that is why you must set both an MG on trigger AND
-// and MG off trigger). And we also set the MG sound to be a higher priority than squeaks. So now when you start the MG sound, it stays on,
-// and no sound with a lower priority will play until it is turned off. 
-void OP_TBS::StartProp3Timer(void)
+// will interrupt the machine gun sound, which is fine because squeaks are very short, but the machine gun would not re-start after
+// the squeak, even though it might still be firing (the light will still blink). We handle that by making the machine gun a "held"
+// sound (until specifically turned off - that is why you must set both an MG on trigger AND an MG off trigger). When a higher priority
+// one-time sound interrupts it, the held sound is restored as soon as the one-time pulse and the gap after it are done. 
+//
+// One-time sounds are not sent the moment they are requested. They go into Prop3Queue and ServiceProp3() sends them one at a time, so 
+// two sounds requested in the same instant (a squeak and a user sound fired by the same function trigger, say) both get played instead 
+// of one of them silently vanishing. A request that waits longer than the MaxWait set for its sound in the Prop3 table is dropped. 
+void OP_TBS::update(void)
 {
+    ServiceProp1();     // Engine speed, used by both the Mini and the Micro
+
     if (Micro) return;
-    // Start the timer to briefly send a special sound signal. 
-    Prop3TimerComplete = false;
-    TBSProp3TimerID = TBSTimer->setTimeout(TBS_SIGNAL_mS, ClearProp3Timer);    
+
+    ServiceProp3();
+
+    // Squeaks keep their own schedule, and just get queued like any other one-time sound when they come due
+    if (AllSqueaks_Active)
+    {
+        unsigned long now = millis();
+        if (Squeak1_Active && (long)(now - Squeak1Next_mS) >= 0) Squeak1();
+        if (Squeak2_Active && (long)(now - Squeak2Next_mS) >= 0) Squeak2();
+        if (Squeak3_Active && (long)(now - Squeak3Next_mS) >= 0) Squeak3();
+    }
+}
+
+void OP_TBS::WriteProp3(uint8_t soundNum, prop3_state state)
+{
+    if (soundNum != currentProp3SoundNum) TBSProp->writeMicroseconds(PROP3, Prop3SoundPulse(soundNum));
+    currentProp3SoundNum = soundNum;
+    Prop3State = state;
+    Prop3StateTime = millis();
 }
 
-void OP_TBS::ClearProp3Timer(void)
+void OP_TBS::QueueProp3(uint8_t soundNum)
+{
+    unsigned long deadline = millis() + ((unsigned long)Prop3SoundMaxWait(soundNum) * 10);
+    int8_t slot = -1;
+    
+    for (uint8_t i = 0; i < PROP3_QUEUE_SIZE; i++)
+    {
+        // If this sound is already waiting there is no point playing it twice, just give it the later deadline
+        if (Prop3Queue[i].Sound == soundNum) { Prop3Queue[i].Deadline = deadline; return; }
+        if (Prop3Queue[i].Sound == SOUND_OFF && slot < 0) slot = i;
+    }
+
+    if (slot < 0)
+    {   // Queue is full. Bump the lowest priority request, but only if the new sound outranks it.
+        slot = 0;
+        for (uint8_t i = 1; i < PROP3_QUEUE_SIZE; i++)
+        {
+            if (Prop3SoundPriority(Prop3Queue[i].Sound) < Prop3SoundPriority(Prop3Queue[slot].Sound)) slot = i;
+        }
+        if (Prop3SoundPriority(Prop3Queue[slot].Sound) >= Prop3SoundPriority(soundNum)) return;
+    }
+    
+    Prop3Queue[slot].Sound = soundNum;
+    Prop3Queue[slot].Deadline = deadline;
+}
+
+void OP_TBS::ServiceProp3(void)
+{
+    unsigned long now = millis();
+    int8_t next = -1;
+    uint8_t nextPriority = 0;
+    
+    // One-time pulses and the gap after them run their full length, nothing interrupts them
+    switch (Prop3State)
+    {
+        case PROP3_PULSE:
+            if (now - Prop3StateTime < TBS_SIGNAL_mS) return;
+            WriteProp3(SOUND_OFF, PROP3_GAP);
+            return;
+            
+        case PROP3_GAP:
+            if (now - Prop3StateTime < PROP3_GAP_mS) return;
+            Prop3State = PROP3_IDLE;
+            break;
+            
+        default: 
+            break;
+    }
+
+    // Drop requests that have gone stale, and find the one to send next: highest priority, then the one closest to going stale
+    for (uint8_t i = 0; i < PROP3_QUEUE_SIZE; i++)
+    {
+        if (Prop3Queue[i].Sound == SOUND_OFF) continue;
+        if ((long)(now - Prop3Queue[i].Deadline) > 0) { Prop3Queue[i].Sound = SOUND_OFF; continue; }
+        uint8_t p = Prop3SoundPriority(Prop3Queue[i].Sound);
+        if (next < 0 || p > nextPriority || (p == nextPriority && (long)(Prop3Queue[i].Deadline - Prop3Queue[next].Deadline) < 0))
+        {
+            next = i;
+            nextPriority = p;
+        }
+    }
+
+    // A held sound can only be interrupted by a one-time sound with a higher priority
+    if (next >= 0 && nextPriority > Prop3SoundPriority(heldProp3SoundNum))
+    {
+        WriteProp3(Prop3Queue[next].Sound, PROP3_PULSE);
+        Prop3Queue[next].Sound = SOUND_OFF;
+    }
+    else if (heldProp3SoundNum != SOUND_OFF)
+    {
+        if (Prop3State != PROP3_HELD || currentProp3SoundNum != heldProp3SoundNum) WriteProp3(heldProp3SoundNum, PROP3_HELD);
+    }
+    else if (Prop3State == PROP3_HELD)
+    {   // Held sound was stopped, give the TBS the same gap before anything else is sent
+        WriteProp3(SOUND_OFF, PROP3_GAP);
+    }
+}
+
+void OP_TBS::ClearProp3(void)
 {
     if (Micro) return;
-    // Quit sending the special sound signal
+    for (uint8_t i = 0; i < PROP3_QUEUE_SIZE; i++) Prop3Queue[i].Sound = SOUND_OFF;
+    heldProp3SoundNum = SOUND_OFF;
     TBSProp->writeMicroseconds(PROP3, Prop3SoundPulse(SOUND_OFF));
-    Prop3TimerComplete = true;
     currentProp3SoundNum = SOUND_OFF;
-    previousProp3SoundNum = SOUND_OFF;
+    Prop3State = PROP3_IDLE;
+    Prop3StateTime = millis();
 }
 
 void OP_TBS::TriggerSpecialSound(int soundNum, boolean oneTime /* = true */)
 {
     if (Micro) return;
-    // Only send a special sound if it has a higher priority than the sound currently playing.
-    // If no sound is playing the actual current sound will be SOUND_OFF. We made sure to set 
-    // SOUND_OFF at priority 0 and all other sounds at least to priority 1, so they will always supersede SOUND_OFF. 
-    if (Prop3SoundPriority(soundNum) > Prop3SoundPriority(currentProp3SoundNum))
-    {   
-        // If another sound was playing and its stop timer was still running, clear it so it won't stop this new sound
-        if (TBSTimer->isEnabled(TBSProp3TimerID)) TBSTimer->deleteTimer(TBSProp3TimerID);
-        // Now set the new pulse
-        TBSProp->writeMicroseconds(PROP3, Prop3SoundPulse(soundNum));
-        previousProp3SoundNum = currentProp3SoundNum;
-        currentProp3SoundNum = soundNum;
-        if (oneTime)    StartProp3Timer();  // If it's just a one-time sound, we start a brief timer so the pulse has time to register with the TBS, then it will turn the pulse off. 
+    if (soundNum <= SOUND_OFF || soundNum >= PROP3_NUM_SOUNDS) return;
+    
+    if (oneTime) QueueProp3(soundNum);
+    else 
+    {   // A repeating sound replaces the held sound unless the held sound has a higher priority. 
+        // We made sure to set SOUND_OFF at priority 0 and all other sounds at least to priority 1, so they will always supersede SOUND_OFF. 
+        if (Prop3SoundPriority(soundNum) >= Prop3SoundPriority(heldProp3SoundNum)) heldProp3SoundNum = soundNum;
     }
+    
+    // Don't wait for the next pass through the loop if the output is free now
+    ServiceProp3();
 }
 
 void OP_TBS::StopSpecialSounds(int soundNum)
 {   
     if (Micro) return;
-    // If the priority of the sound we want to stop is equal to or greater than the current sound,
-    // stop the current sound. We need the equal-to check because we are probably trying to stop the 
-    // current sound, in other words, it will be equal. 
-    if (Prop3SoundPriority(soundNum) >= Prop3SoundPriority(currentProp3SoundNum))
+    uint8_t p = Prop3SoundPriority(soundNum);
+    
+    // If the priority of the sound we want to stop is equal to or greater than the held sound, stop the held sound.
+    // We need the equal-to check because we are probably trying to stop the held sound itself, in other words, it will be equal. 
+    if (heldProp3SoundNum != SOUND_OFF && p >= Prop3SoundPriority(heldProp3SoundNum)) heldProp3SoundNum = SOUND_OFF;
+    
+    // Anything still waiting to play with the same or lower priority is no longer wanted either. We let a pulse already 
+    // on the output finish though, cutting it short could leave the TBS with a garbled reading.
+    for (uint8_t i = 0; i < PROP3_QUEUE_SIZE; i++)
     {
-        ClearProp3Timer();
+        if (Prop3Queue[i].Sound != SOUND_OFF && Prop3SoundPriority(Prop3Queue[i].Sound) <= p) Prop3Queue[i].Sound = SOUND_OFF;
     }
+    
+    ServiceProp3();
 }
 
 
@@ -604,8 +748,8 @@ void OP_TBS::Squeak1(void)
     {
         // Play the squeak sound
         TriggerSpecialSound(SOUND_SQUEAK_1);
-        // Wait some random amount of time, then call me again
-        Squeak1TimerID = TBSTimer->setTimeout(random(SQUEAK1_MIN_mS,SQUEAK1_MAX_mS), Squeak1);    
+        // Wait some random amount of time, then update() will call me again
+        Squeak1Next_mS = millis() + random(SQUEAK1_MIN_mS,SQUEAK1_MAX_mS);    
     }
 }
 void OP_TBS::Squeak1_Activate(void)
@@ -621,7 +765,6 @@ void OP_TBS::Squeak1_Activate(void)
 void OP_TBS::Squeak1_Pause(void)
 {
     if (Micro) return;
-    TBSTimer->deleteTimer(Squeak1TimerID);
     Squeak1_Active = false;
 }
 
@@ -633,8 +776,8 @@ void OP_TBS::Squeak2(void)
     {
         // Play the squeak sound
         TriggerSpecialSound(SOUND_SQUEAK_2);
-        // Wait some random amount of time, then call me again
-        Squeak2TimerID = TBSTimer->setTimeout(random(SQUEAK2_MIN_mS,SQUEAK2_MAX_mS), Squeak2);       
+        // Wait some random amount of time, then update() will call me again
+        Squeak2Next_mS = millis() + random(SQUEAK2_MIN_mS,SQUEAK2_MAX_mS);       
     }
 }
 void OP_TBS::Squeak2_Activate(void)
@@ -650,7 +793,6 @@ void OP_TBS::Squeak2_Activate(void)
 void OP_TBS::Squeak2_Pause(void)
 {
     if (Micro) return;
-    TBSTimer->deleteTimer(Squeak2TimerID);
     Squeak2_Active = false;
 }
 
@@ -662,8 +804,8 @@ void OP_TBS::Squeak3(void)
     {
         // Play the squeak sound
         TriggerSpecialSound(SOUND_SQUEAK_3);
-        // Wait some random amount of time, then call me again
-        Squeak3TimerID = TBSTimer->setTimeout(random(SQUEAK3_MIN_mS,SQUEAK3_MAX_mS), Squeak3);    
+        // Wait some random amount of time, then update() will call me again
+        Squeak3Next_mS = millis() + random(SQUEAK3_MIN_mS,SQUEAK3_MAX_mS);    
     }
 }
 void OP_TBS::Squeak3_Activate(void)
@@ -679,7 +821,6 @@ void OP_TBS::Squeak3_Activate(void)
 void OP_TBS::Squeak3_Pause(void)
 {
     if (Micro) return;
-    TBSTimer->deleteTimer(Squeak3TimerID);
     Squeak3_Active = false;
 }
 
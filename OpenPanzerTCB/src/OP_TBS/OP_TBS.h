@@ -43,6 +43,12 @@
 #define PROP1_IDLE          1500                // Idle throttle
 #define PROP1_JUST_MOVING   1550                // What throttle value do we change from idle to moving sound (above 1500 which is center). No longer used since TBS Flash v3.0 and later. 
 #define PROP1_FULL_SPEED    2000                // Full speed
+// SetEngineSpeed only sets a target. update() moves the Prop1 pulse toward it on a fixed tick so the engine revs the same no matter how fast
+// the main loop runs, and the servo output is only rewritten when the pulse actually changes. 
+#define PROP1_TICK_mS       20                  // How often the Prop1 pulse is stepped toward the target, one servo frame
+#define PROP1_RAMP_UP_uS    12                  // Max pulse increase per tick. 12 uS every 20 mS takes idle to full speed in a bit under a second
+#define PROP1_RAMP_DOWN_uS  8                   // Max pulse decrease per tick. Engines spool down slower than they rev up, full speed to idle takes 1.25 seconds
+#define PROP1_DEADBAND_uS   4                   // Target changes smaller than this are ignored, so throttle noise doesn't wobble the engine pitch
 
 // Prop2 - 2 sounds in direct control mode, you must emulate a 3-position switch
 #define PROP2_SWITCH_OFF    1500                // Off position for Prop2 Function 1/2 (default)
@@ -73,17 +79,21 @@
 #define PROP3_NUM_SOUNDS     17         // How many sounds are there in total in the Prop3 register, including the SOUND_OFF "sound"
 // The Prop3 numbers above refer to positions in the array below.
 // The array holds the actual PWM values for each of the sound slots, plus one more for SOUND_OFF (1500)
-// Each sound also has a priority number associated with it. If a sound is playing, and second sound is triggered, the second
-// sound will only interrupt the first one if it has a higher priority. However, note that most sounds will be considered over 
-// after TBS_SIGNAL_mS long (see the define below, very short), even though the actual sound may play longer than that. So it is 
-// still possible for a lower priority sound to interrupt a higher priority sound if it is triggered TBS_SIGNAL_mS after the first one
-// was triggered, unless we specifically told the first sound to remain on indefinitely, ie repeat (by pass true to TriggerSpecialSound). 
-// Anyway, this is all sort of complicated, but the main reason for all of it is so that when the machine gun is firing, other sounds
-// won't stop it (like squeaks). But you can tweak the priorities to create other effects as well. The important thing to remember is
-// make sure SOUND_OFF has priority = 0 and every other sound has at least priority = 1. 
+// Each sound also has a priority number and a maximum wait associated with it. Requests for one-time sounds go into a small queue, and
+// update() sends them to the TBS one at a time: the pulse is held for TBS_SIGNAL_mS, then Prop3 returns to SOUND_OFF for at least
+// PROP3_GAP_mS so the TBS sees the next pulse as a new trigger. When several sounds are waiting the highest priority goes first, and
+// among equal priorities the one whose wait runs out soonest. A sound that can't get out within its maximum wait (in 10 mS units)
+// is dropped, because by then it would sound out of place - a squeak half a second after the squeak it was meant to be is just noise.
+// Repeating sounds (passing false to TriggerSpecialSound) stay on until explicitly stopped or replaced by another repeating sound of
+// equal or higher priority. A one-time sound with a higher priority interrupts the repeating sound, which resumes once the one-time
+// pulse and gap are done. One-time sounds with a lower priority wait in the queue until the repeating sound stops, or until they go stale.
+// The main reason for all of this is so that when the machine gun is firing, other sounds (like squeaks) won't stop it. But you can
+// tweak the priorities to create other effects as well. The important thing to remember is make sure SOUND_OFF has priority = 0 and
+// every other sound has at least priority = 1.
 typedef struct {
     int16_t Pulse;
     uint8_t Priority;
+    uint8_t MaxWait;                    // How long a one-time request for this sound may wait in the queue, in 10 mS units
 } Prop3Settings;
 
 // Benedini uses an odd spread of pulses from 800uS to 2280uS. This means an even center is not 1500 but rather 1540, although in the case
@@ -93,29 +103,32 @@ typedef struct {
 // Values were tweaked to correspond as closely to whole integers from 0-255 as possible (since that is actually how the TBS Mini reads the pulses
 // apparently). The small tweaks are probably unnecessary and irrelevant once you account for all the variability in creating and reading PWM signals. 
 const Prop3Settings Prop3[PROP3_NUM_SOUNDS] PROGMEM_FAR = {
-{1531, 0},  // Sound 0:  Prop3 default (off - no sound) - this is the odd Benedini center value
-{864,  1},  // Sound 1:  Turret rotation
-{945,  1},  // Sound 2:  Barrel elevation
-{1026, 1},  // Sound 3:  Cannon fire
-{1108, 2},  // Sound 4:  Machine gun fire - higher priority because it needs to repeat
-{1189, 1},  // Sound 5:  Received cannon hit - damage
-{1270, 1},  // Sound 6:  Received machine gun hit - damage
-{1351, 4},  // Sound 7:  Received hit - vehicle destroyed - set to high priority though it shouldn't matter, nothing else will be playing at this time anyway
-{1433, 1},  // Sound 8:  Headlights on/off
-{1630, 3},  // Sound 9:  Custom User Sound 1 - even higher priority than MG 
-{1711, 3},  // Sound 10: Custom User Sound 2 - even higher priority than MG (also used for pre-heat sound)
-{1793, 3},  // Sound 11: Custom User Sound 3 - even higher priority than MG (also used for Second MG)
-{1874, 3},  // Sound 12: Squeak 1 / Custom User Sound 4
-{1955, 3},  // Sound 13: Squeak 2 / Custom User Sound 5
-{2036, 3},  // Sound 14: Squeak 3 / Custom User Sound 6
-{2117, 9},  // Sound 15: Increase volume - highest priority
-{2199, 9}   // Sound 16: Decrease volume - highest priority
+{1531, 0,  0},  // Sound 0:  Prop3 default (off - no sound) - this is the odd Benedini center value
+{864,  1, 20},  // Sound 1:  Turret rotation
+{945,  1, 20},  // Sound 2:  Barrel elevation
+{1026, 1, 50},  // Sound 3:  Cannon fire
+{1108, 2, 30},  // Sound 4:  Machine gun fire - higher priority because it needs to repeat
+{1189, 1, 50},  // Sound 5:  Received cannon hit - damage
+{1270, 1, 30},  // Sound 6:  Received machine gun hit - damage
+{1351, 4, 100}, // Sound 7:  Received hit - vehicle destroyed - set to high priority though it shouldn't matter, nothing else will be playing at this time anyway
+{1433, 1, 30},  // Sound 8:  Headlights on/off
+{1630, 3, 100}, // Sound 9:  Custom User Sound 1 - even higher priority than MG 
+{1711, 3, 100}, // Sound 10: Custom User Sound 2 - even higher priority than MG (also used for pre-heat sound)
+{1793, 3, 100}, // Sound 11: Custom User Sound 3 - even higher priority than MG (also used for Second MG)
+{1874, 3, 30},  // Sound 12: Squeak 1 / Custom User Sound 4
+{1955, 3, 30},  // Sound 13: Squeak 2 / Custom User Sound 5
+{2036, 3, 30},  // Sound 14: Squeak 3 / Custom User Sound 6
+{2117, 9, 20},  // Sound 15: Increase volume - highest priority
+{2199, 9, 20}   // Sound 16: Decrease volume - highest priority
 };
-// We can't refer directly to array elements and struct members when using far addresses. For some reason, even using s*sizeof(Prop3) instead of (s*3) doesn't work. 
-#define Prop3SoundPulse(s)      pgm_read_word_far(pgm_get_far_address(Prop3) + (s*3))       // Get address of Prop3 array, then skip ahead to the s-th element, since each struct is 3 bytes wide
-#define Prop3SoundPriority(s)   pgm_read_byte_far(pgm_get_far_address(Prop3) + (s*3) + 2)   // Get address of Prop3 array, then skip ahead to the s-th element, then skip the next 2 bytes to get to the 3rd byte in the struct (Priority)
+// We can't refer directly to array elements and struct members when using far addresses. For some reason, even using s*sizeof(Prop3) instead of (s*4) doesn't work. 
+#define Prop3SoundPulse(s)      pgm_read_word_far(pgm_get_far_address(Prop3) + (s*4))       // Get address of Prop3 array, then skip ahead to the s-th element, since each struct is 4 bytes wide
+#define Prop3SoundPriority(s)   pgm_read_byte_far(pgm_get_far_address(Prop3) + (s*4) + 2)   // Get address of Prop3 array, then skip ahead to the s-th element, then skip the next 2 bytes to get to the 3rd byte in the struct (Priority)
+#define Prop3SoundMaxWait(s)    pgm_read_byte_far(pgm_get_far_address(Prop3) + (s*4) + 3)   // 4th byte in the struct (MaxWait, in 10 mS units)
 
 #define TBS_SIGNAL_mS         50        // How long to send a temporary signal for TBS to get it. 20ms didn't seem stable, so it needs to be greater than that, but as small as possible. 
+#define PROP3_GAP_mS          30        // Minimum time Prop3 is held at SOUND_OFF between two one-time sounds, otherwise the TBS may not notice the second one
+#define PROP3_QUEUE_SIZE      6         // How many one-time Prop3 sounds can be waiting at once. There are only 16 sounds and most are rarely requested together.
 #define TBS_SIGNAL_PROP2_mS   500       // Prop2 is used to toggle the engine. We find it works better with a longer signal, and because it doesn't interfere with other sounds it's fine to set it long. 
 
 #define DEFAULT_SQUEAK_MIN_mS 800       // Min time between squeaks defaults to 0.8 seconds
@@ -160,6 +173,7 @@ public:
     OP_TBS(OP_SimpleTimer * t, boolean Micro);              // Constructor
     void begin();                                           // Attach servo outputs and initialize
     void InitializeOutputs(void);                           // Initialize
+    static void update(void);                               // Must be called each time through the main loop. Ramps engine speed, sends queued Prop3 sounds and plays squeaks.
                 
     // PROP1: Engine speed sound                
     void SetEngineSpeed(int);                               // Send the engine speed to TBS
@@ -216,6 +230,11 @@ public:
 
     // PROP 1
     static void         ClearThrottleBlip(void);            // We will send a brief throttle signal to the Mini when the engine is started so it knows to wake up
+    static void         WriteProp1(int);                    // Set the Prop1 pulse immediately, no ramping
+    static void         ServiceProp1(void);                 // Step the Prop1 pulse toward the target, called from update()
+    static int          Prop1Target;                        // Pulse SetEngineSpeed has asked for
+    static int          Prop1Pulse;                         // Pulse on the output right now
+    static unsigned long Prop1Tick_mS;                      // Time of the last ramp step
 
     // PROP 2
     static int          TBSProp2TimerID;
@@ -230,12 +249,25 @@ public:
                                                             // to keep the sound on indefinitely, rather than triggering it once (if nothing is passed, it will trigger once)
     static void         StopSpecialSounds(int);             // Most special sounds only run once, but for repeated sounds (like machine gun), we can use this to turn them off.
     
-    static int          TBSProp3TimerID;
-    static boolean      Prop3TimerComplete; 
-    static void         StartProp3Timer(void);
-    static void         ClearProp3Timer(void);
-    static uint8_t      currentProp3SoundNum;               // Which sound number is currently playing
-    static uint8_t      previousProp3SoundNum;              // Which sound was playing before
+    typedef struct {
+        uint8_t         Sound;                              // SOUND_OFF means the slot is free
+        unsigned long   Deadline;                           // Drop the request if it hasn't been sent by this time
+    } prop3_request;
+    enum prop3_state : uint8_t {
+        PROP3_IDLE = 0,                                     // SOUND_OFF, free to send the next sound
+        PROP3_PULSE,                                        // Holding a one-time sound pulse for TBS_SIGNAL_mS
+        PROP3_GAP,                                          // Holding SOUND_OFF for PROP3_GAP_mS after a one-time sound
+        PROP3_HELD                                          // Holding a repeating sound until it is stopped or interrupted
+    };
+    static prop3_request Prop3Queue[PROP3_QUEUE_SIZE];
+    static prop3_state  Prop3State;
+    static unsigned long Prop3StateTime;                    // When we entered the current state
+    static uint8_t      currentProp3SoundNum;               // Which sound number is currently on the Prop3 output
+    static uint8_t      heldProp3SoundNum;                  // Repeating sound that should be on whenever no one-time sound is being sent (SOUND_OFF if none)
+    static void         QueueProp3(uint8_t);
+    static void         ClearProp3(void);                   // Empty the queue, drop the held sound and return Prop3 to SOUND_OFF
+    static void         ServiceProp3(void);
+    static void         WriteProp3(uint8_t, prop3_state);
     boolean             HeadlightSound_Enabled;
     boolean             TurretSound_Enabled;
     boolean             BarrelSound_Enabled;
@@ -257,9 +289,9 @@ public:
     static boolean      Squeak1_Active;                     // Active means, is this sqeak now sqeaking, or is it waiting to sqeak
     static boolean      Squeak2_Active;                     // Squeaks are only active while the tank is moving. 
     static boolean      Squeak3_Active;
-    static int          Squeak1TimerID;
-    static int          Squeak2TimerID;
-    static int          Squeak3TimerID;
+    static unsigned long Squeak1Next_mS;                    // When each squeak is next due
+    static unsigned long Squeak2Next_mS;
+    static unsigned long Squeak3Next_mS;
     static unsigned int SQUEAK1_MIN_mS;
     static unsigned int SQUEAK1_MAX_mS;
     static unsigned int SQUEAK2_MIN_mS;
@@ -47,9 +47,17 @@ int             OP_Tank::MG_BlinkTimerID;
 int             OP_Tank::MG_FireTimerID;
 uint8_t         OP_Tank::CannonHitsTaken;
 uint8_t         OP_Tank::MGHitsTaken;
-float           OP_Tank::DamagePct;
-float           OP_Tank::DamagePctPerCannonHit;
-float           OP_Tank::DamagePctPerMGHit;
+damageProfile   OP_Tank::Profile;
+uint32_t        OP_Tank::DamageUnits;
+uint32_t        OP_Tank::FullDamageUnits;
+uint32_t        OP_Tank::CannonHitUnits;
+uint32_t        OP_Tank::MGHitUnits;
+uint32_t        OP_Tank::RepairUnits;
+uint32_t        OP_Tank::LastHit_mS;
+uint8_t         OP_Tank::RotationCut;
+uint8_t         OP_Tank::ElevationCut;
+Motor         * OP_Tank::DamageMotor[4];
+DRIVETYPE       OP_Tank::DamageDriveType;
 boolean         OP_Tank::RepairOngoing;
 int             OP_Tank::RepairTimerID;
 IRTYPES         OP_Tank::_lastHit;
@@ -78,10 +86,19 @@ const __FlashStringHelper *ptrWeightClassName(WEIGHTCLASS wClass) {
 // Return a character string of the name of the damage profile, used for printing
 const __FlashStringHelper *ptrDamageProfile(DAMAGEPROFILES dProfile) {
   if(dProfile>LAST_DAMAGE_PROFILE) dProfile = LAST_DAMAGE_PROFILE+1;
-  const __FlashStringHelper *Names[LAST_DAMAGE_PROFILE+2]={F("Tamiya Spec"), F("Open Panzer"), F("None"), F("Unknown")};
+  const __FlashStringHelper *Names[LAST_DAMAGE_PROFILE+2]={F("Tamiya Spec"), F("Open Panzer"), F("None"), F("Custom"), F("Unknown")};
   return Names[dProfile];
 };
 
+// Copy one of the built-in damage profiles out of far progmem
+void LoadDamageProfile(DAMAGEPROFILES dProfile, damageProfile *dest)
+{
+    if (dProfile < 0 || dProfile >= NUM_BUILTIN_DAMAGE_PROFILES) dProfile = TAMIYA_DAMAGE;
+    uint32_t address = pgm_get_far_address(DamageProfiles) + ((uint32_t)dProfile * DAMAGE_PROFILE_SIZE);
+    for (uint8_t i = 0; i < DAMAGE_PROFILE_SIZE; i++) { ((uint8_t *)dest)[i] = pgm_read_byte_far(address + i); }
+}
+static_assert(sizeof(damageProfile) == DAMAGE_PROFILE_SIZE, "DAMAGE_PROFILE_SIZE must match the damageProfile struct");
+
 
 
 // Constructor
@@ -109,6 +126,9 @@ void OP_Tank::begin(battle_settings BS, boolean mbwc, boolean airsoft, boolean r
     
     // Battle Settings
     BattleSettings = BS;
+
+    // Pick up the battle log where we left off
+    OP_BattleLog::begin();
     
     // Do a quick sanity check on the IR_Team value
     if (BattleSettings.IR_Team != IR_TEAM_NONE)
@@ -154,57 +174,32 @@ void OP_Tank::begin(battle_settings BS, boolean mbwc, boolean airsoft, boolean r
         }
 
         // Setup damage settings
-        if (BattleSettings.IR_FireProtocol != IR_DISABLED && BattleSettings.IR_MGProtocol != IR_DISABLED && BattleSettings.Accept_MG_Damage)
-        {
-            // The vehicle will take damage from both cannon fire and machine gun fire. 
-            DamagePctPerCannonHit = 100.0 / (float)BattleSettings.ClassSettings.maxHits;
-            DamagePctPerMGHit =     100.0 / (float)BattleSettings.ClassSettings.maxMGHits;
-        }
-        else if (BattleSettings.IR_FireProtocol != IR_DISABLED)
-        {
-            // The vehicle will take damage from cannon fire only
-            DamagePctPerCannonHit = 100.0 / (float)BattleSettings.ClassSettings.maxHits;
-            DamagePctPerMGHit = 0.0;
-        }
-        else
-        {
-            // The vhicle will only take damage from machine gun fire (unlikely you would want this scenario)
-            DamagePctPerCannonHit = 0.0;
-            DamagePctPerMGHit = 100.0 / (float)BattleSettings.ClassSettings.maxMGHits;      
-        }
+        SetupDamage();
     }
-    //Serial.print(F("Damage per Cannon Hit: "));   Serial.println(DamagePctPerCannonHit,2);
-    //Serial.print(F("Damage per MG Hit: "));       Serial.println(DamagePctPerMGHit,2);
 
     // Clear hit count and enable IR reception immediately. 
     ResetBattleImmediate();
 
 
+    // Set up an external interrupt to read the mechanical airsoft or recoil trigger switch
+    // SETUP EXTERNAL INTERRUPT PIN
+    // ------------------------------------------------------------------------------------------------------------------------>>
+    // On the TCB this is a pin that is not brought out on the Arduino Mega board, so we can NOT USE ARDUINO PIN FUNCTIONS! It is Atmega pin 8 
+    // which is Port E6. The DIY version, for use with an off-the-shelf Arduino MEGA, uses Port D0 (INT0) instead. Which one is in the 
+    // DeviceCapabilities table (OP_Devices.cpp). We want the pin to be an input with pullups enabled, and the other board's pin is unused 
+    // but we still want it set to input with pull-ups enabled. 
+    // See this page for a useful tutorial on direct port manipulation: http://maxembedded.com/2011/06/port-operations-in-avr/
+    OP_Devices::setPinInputPullup(OP_Devices::capabilities().RecoilSw_Port, OP_Devices::capabilities().RecoilSw_Bit);
+    OP_Devices::setPinInputPullup(OP_Devices::capabilities().UnusedRecoilSw_Port, OP_Devices::capabilities().UnusedRecoilSw_Bit);
+
 #ifdef TCB_DIY
-    // DIY version of TCB, for use with off-the shelf Arduino MEGA
-    // Same commentary as below, only we are using INT0 (PORT D PIN D0)
-    DDRD  &= ~(1 << DDD0);      // Set PD0 to input
-    PORTD |=  (1 << PD0);       // Input pullups on
+    // Same commentary as below, only we are using INT0
     EIMSK &= ~(1 << INT0);      // Disable INT0 interrupt for now
     EICRA =  (EICRA & ~((1 << ISC00) | (1 << ISC01)));                  // Clear interrupt sense control to start
     if (_Airsoft)   { EICRA |= (AIRSOFT_TRIGGER_MODE    << ISC00); }    // Now set appropriately
     else            { EICRA |= (MECHRECOIL_TRIGGER_MODE << ISC00); }
 	
-	// In this case we won't be using PORTE6 but we still want it set to input with pull-ups enabled
-    DDRE  &= ~(1 << DDE6);      // Set PE6 to input. We "and-not" a 1 with bit DDE6 of the Port E Data Direction Register. This sets it to Zero, which means, input. 
-    PORTE |=  (1 << PE6);       // Set input pullups on. We accomplish this by writing a 1 to the PE6 bit of the PORTE register. 
-	
 #else   
-    // Set up an external interrupt to read the mechanical airsoft or recoil trigger switch
-    // SETUP EXTERNAL INTERRUPT PIN
-    // ------------------------------------------------------------------------------------------------------------------------>>
-    // We are using a pin that is not brought out on the Arduino Mega board, so we can NOT USE ARDUINO PIN FUNCTIONS! 
-    // The pin is Atmega pin 8 which is Port E6. We want the pin to be an input with pullups enabled.
-    // See this page for a useful tutorial on direct port manipulation: http://maxembedded.com/2011/06/port-operations-in-avr/
-    DDRE  &= ~(1 << DDE6);      // Set PE6 to input. We "and-not" a 1 with bit DDE6 of the Port E Data Direction Register. This sets it to Zero, which means, input. 
-    PORTE |=  (1 << PE6);       // Set input pullups on. We accomplish this by writing a 1 to the PE6 bit of the PORTE register. 
-    
-
     // START WITH INTERRUPT DISABLED 
     // ------------------------------------------------------------------------------------------------------------------------>>
     // We don't want the interrupt enabled for now, so we clear the INT6 bit in the External Interrupt Mask Register (EIMSK). 
@@ -341,6 +336,7 @@ void OP_Tank::Fire(void)
             // This is a repair tank. We skip mechanical/servo recoil and airsoft. We do have a repair sound, and we also do a
             // special light effect on the hit notification LEDs (in the apple). And of course we also send the repair IR code. 
             RepairOngoing = true;   // Set the repair flag. It is the same flag if we are being repaired as it is if we are repairing someone else. 
+            OP_BattleLog::log(LOG_EVENT_SHOT_REPAIR, BattleSettings.IR_RepairProtocol, IR_TEAM_NONE, PctDamaged());
             _TankSound->Repair();       // Start playing the repair sound
             Repair_BlinkHandler();      // Do the special repair light effect (start blinking slow and gradually increase faster and faster)
             // Start the repair timer. During this time we can not fire the repair signal again, nor can we move (the move disabling is handled by the sketch)
@@ -351,6 +347,7 @@ void OP_Tank::Fire(void)
         // Or is this a fighting tank? 
         else 
         {   
+            OP_BattleLog::log(LOG_EVENT_SHOT_CANNON, BattleSettings.IR_FireProtocol, BattleSettings.IR_Team, PctDamaged());
             if (_MechBarrelWithCannon)
             {
                 if (_Airsoft)
@@ -501,6 +498,7 @@ void OP_Tank::MachineGun()
     {
         MG_BlinkTimerID = TankTimer->setInterval(_MGLightBlink_mS, MG_BlinkLight);
         _TankSound->MachineGun();           // Start the machine gun sound 
+        OP_BattleLog::log(LOG_EVENT_SHOT_MG, BattleSettings.Use_MG_Protocol ? BattleSettings.IR_MGProtocol : IR_DISABLED, IR_TEAM_NONE, PctDamaged());
         // Now also start a timer to send the IR code repeatedly, if specified
         if (BattleSettings.Use_MG_Protocol && !TankTimer->isEnabled(MG_FireTimerID))
         {
@@ -909,6 +907,8 @@ boolean TwoShotHit = false;
                         case FOV_TEAM_4_VALUE: _lastTeam = IR_TEAM_FOV_4; if (BattleSettings.IR_Team == IR_TEAM_FOV_4) { hit = false; } break;
                     }
                 }
+                // Log it if we ignored the hit because it came from our own team
+                if (!hit) OP_BattleLog::log(LOG_EVENT_HIT_FRIENDLY, _lastHit, _lastTeam, PctDamaged());
             }
 
             
@@ -923,23 +923,25 @@ boolean TwoShotHit = false;
                 
                 CannonHitsTaken += 1;       // Increment number of cannon hits taken
                 
-                // Increment our overall damage percent 
+                // Increment our overall damage
                 if (TwoShotHit)
                 {
-                    DamagePct += 50;    // Two-shot hits increase damage by 50 percent each time
+                    AddDamage((FullDamageUnits * Profile.TwoShotPct) / 100);    // Two-shot hits do a fixed percent of damage each time (50 in the Tamiya spec)
                 }
                 else
                 {
-                    DamagePct += DamagePctPerCannonHit; // Regular hits increase by the amount-per-cannon-hit
+                    AddDamage(CannonHitUnits);  // Regular hits increase by the amount-per-cannon-hit
                 }
+                OP_BattleLog::log(LOG_EVENT_HIT_CANNON, _lastHit, _lastTeam, PctDamaged());
                 
-                if (DamagePct >= 100.0)
+                if (DamageFatal())
                 {
                     // We've been destroyed. 
                     _TankSound->Destroyed();
+                    OP_BattleLog::log(LOG_EVENT_DESTROYED, _lastHit, _lastTeam, 100);
                                         
-                    // Don't let damage go above 100%
-                    DamagePct = 100.0;
+                    // Whatever the profile's destroy level, a destroyed vehicle counts as fully damaged
+                    DamageUnits = FullDamageUnits;
                                         
                     // After destruction, the tank becomes inoperative for some period of time (15 seconds is the Tamiya spec - NOT the same as recovery/invulnerability time!)
                     // After that time it will automatically recover itself. During invulnerability time, the tank can fire but is impervious to enemy fire. 
@@ -976,15 +978,17 @@ boolean TwoShotHit = false;
                 
                 // Unlike cannon fire, we don't disable IR reception, because we allow multiple MG hits to occur in quick succession
                 MGHitsTaken += 1;               // Increment number of machine gun hits taken
-                DamagePct += DamagePctPerMGHit; // Increment our overall damage percent
+                AddDamage(MGHitUnits);          // Increment our overall damage
+                OP_BattleLog::log(LOG_EVENT_HIT_MG, _lastHit, IR_TEAM_NONE, PctDamaged());
                 
-                if (DamagePct >= 100.0)
+                if (DamageFatal())
                 {
                     // We've been destroyed. 
                     _TankSound->Destroyed();
+                    OP_BattleLog::log(LOG_EVENT_DESTROYED, _lastHit, IR_TEAM_NONE, 100);
                     
-                    // Don't let damage go above 100%
-                    DamagePct = 100.0;
+                    // Whatever the profile's destroy level, a destroyed vehicle counts as fully damaged
+                    DamageUnits = FullDamageUnits;
                     
                     // After destruction, the tank becomes inoperative for some period of time (15 seconds is the Tamiya spec - NOT the same as recovery/invulnerability time!)
                     // After that time it will automatically recover itself. During invulnerability time, the tank can fire but is impervious to enemy fire. 
@@ -1009,10 +1013,11 @@ boolean TwoShotHit = false;
             // If that didn't match, we may still have been hit, but by a repair tank. 
             // Check but only if we haven't sustained any damage yet (otherwise there is no repair needed)
             // And also ignore it if we are already in the process of being repaired
-            else if (DamagePct > 0.0 && !RepairOngoing && IR_Decoder.decode(BattleSettings.IR_RepairProtocol))
+            else if (DamageUnits > 0 && !RepairOngoing && IR_Decoder.decode(BattleSettings.IR_RepairProtocol))
             {
                 _lastHit = BattleSettings.IR_RepairProtocol;// Save the protocol to the _lastHit variable
                 RepairOngoing = true;       // Set the repair flag
+                OP_BattleLog::log(LOG_EVENT_REPAIR_START, _lastHit, IR_TEAM_NONE, PctDamaged());
                 _TankSound->Repair();       // Play the repair sound
                 Repair_BlinkHandler();      // Do the special repair light effect (start blinking slow and gradually increase faster and faster)
                 // Reenable hit reception immediately. The point is that while being repaired, the tank is vulnerable. 
@@ -1058,8 +1063,8 @@ void OP_Tank::RepairOver(void)
     RepairOngoing = false;
 
     // Now we do the opposite of taking damage.
-    DamagePct -= DamagePctPerCannonHit;     // Subtract a cannon hit
-    if (DamagePct < 0.0) DamagePct = 0.0;   // But don't go below zero      
+    RemoveDamage(RepairUnits);              // Subtract a cannon hit (or whatever the profile says a repair is worth)
+    OP_BattleLog::log(LOG_EVENT_REPAIR_DONE, 0, 0, PctDamaged());
 
     // Call the repair blink hander, it will turn off the lights. 
     Repair_BlinkHandler();
@@ -1073,6 +1078,7 @@ void OP_Tank::StopRepair(void)
     if (RepairOngoing) 
     { 
         RepairOngoing = false;
+        OP_BattleLog::log(LOG_EVENT_REPAIR_CANCEL, 0, 0, PctDamaged());
         
         // Call the repair blink hander, it will turn off the lights. 
         Repair_BlinkHandler();
@@ -1086,12 +1092,14 @@ boolean OP_Tank::isRepairOngoing()
 
 uint8_t OP_Tank::PctDamaged(void)
 {
-    return round(DamagePct);
+    if (FullDamageUnits == 0) return 0;
+    if (DamageUnits >= FullDamageUnits) return 100;
+    return (uint8_t)(((DamageUnits * 100) + (FullDamageUnits / 2)) / FullDamageUnits);   // Rounded
 }
 
 uint8_t OP_Tank::PctHealthRemaining(void)
 {
-    return (100 - constrain(round(DamagePct),0,100));
+    return (100 - PctDamaged());
 }
 
 void OP_Tank::DisableHitReception(void)
@@ -1120,94 +1128,182 @@ void OP_Tank::EnableHitReception(void)
 }
 
 
-// Cut speed to motors (ie, "damage"). 
-void OP_Tank::Damage(Motor* Right_orRear, Motor* Left_orSteering, Motor* elevation, Motor* azimuth, OP_Smoker* smoke, boolean includeSmoker, DRIVETYPE driveType)
+//------------------------------------------------------------------------------------------------------------------------>>
+// DAMAGE PROFILES
+//------------------------------------------------------------------------------------------------------------------------>>
+void OP_Tank::SetupDamage(void)
+{
+uint8_t maxHits;
+uint8_t maxMGHits;
+uint8_t mgFactor;
+boolean cannonDamage;
+boolean mgDamage;
+
+    // Pick the profile. The custom profile comes from EEPROM via the battle settings, the rest are built in. 
+    if (BattleSettings.DamageProfile == CUSTOM_DAMAGE) Profile = BattleSettings.CustomDamage;
+    else LoadDamageProfile(BattleSettings.DamageProfile, &Profile);
+    
+    maxHits =   BattleSettings.ClassSettings.maxHits   > 0 ? BattleSettings.ClassSettings.maxHits   : 1;
+    maxMGHits = BattleSettings.ClassSettings.maxMGHits > 0 ? BattleSettings.ClassSettings.maxMGHits : 1;
+    cannonDamage = (BattleSettings.IR_FireProtocol != IR_DISABLED);
+    mgDamage = (BattleSettings.IR_MGProtocol != IR_DISABLED && BattleSettings.Accept_MG_Damage);
+
+    // We want a standard cannon hit to be a whole number of units (1/maxHits of full), and a standard machine gun hit as well (1/maxMGHits of full), 
+    // and since profiles count hits in eighths, each of those must divide evenly by 8 as well. So full damage is 8 * maxHits * maxMGHits. 
+    // If we don't take machine gun damage we can leave maxMGHits out of it. Even at the 255 hit limit this is well within 32 bits, and 
+    // Damage * 100 (for percent) stays within 32 bits too. 
+    mgFactor = mgDamage ? maxMGHits : 1;
+    FullDamageUnits = (uint32_t)DAMAGE_HIT_STANDARD * maxHits * mgFactor;
+    CannonHitUnits  = cannonDamage ? (uint32_t)Profile.CannonHit * mgFactor : 0;   // The vehicle will take damage from cannon fire...
+    MGHitUnits      = mgDamage ? (uint32_t)Profile.MGHit * maxHits : 0;           // ...and/or from machine gun fire
+    RepairUnits     = (uint32_t)Profile.Repair * mgFactor;                       // A repair is counted in cannon hits even if we only take machine gun damage
+    
+    DamageUnits = 0;
+    LastHit_mS = millis();
+}
+
+void OP_Tank::AddDamage(uint32_t units)
+{
+    DamageUnits += units;
+    if (DamageUnits > FullDamageUnits) DamageUnits = FullDamageUnits;     // Don't let damage go above 100%
+    LastHit_mS = millis();                                                  // Start the regeneration wait over
+}
+
+void OP_Tank::RemoveDamage(uint32_t units)
+{
+    if (units >= DamageUnits) DamageUnits = 0;                              // But don't go below zero
+    else DamageUnits -= units;
+}
+
+boolean OP_Tank::DamageFatal(void)
 {
-int cut_Pct;
+    // DestroyPct lets a profile destroy the vehicle before it reaches full damage. A DestroyPct of 0 would make every hit fatal, so treat it as 100. 
+    uint8_t destroyPct = (Profile.DestroyPct > 0 && Profile.DestroyPct < 100) ? Profile.DestroyPct : 100;
+    return (DamageUnits * 100) >= (FullDamageUnits * destroyPct);
+}
+
+void OP_Tank::TierCuts(uint8_t &drive, uint8_t &rotation, uint8_t &elevation)
+{
+uint16_t d10;       // Damage in tenths of a percent
+int8_t tier = -1;
+int8_t next = -1;
+uint16_t lo, hi;
+
+    drive = rotation = elevation = 0;
+    if (DamageUnits == 0 || FullDamageUnits == 0) return;                   // Full health, no cut
+    
+    d10 = DamageUnits >= FullDamageUnits ? 1000 : (uint16_t)((DamageUnits * 1000) / FullDamageUnits);
+
+    // Find the highest tier we are above. Tiers are in increasing order, unused ones are skipped. 
+    for (uint8_t i = 0; i < DAMAGE_TIERS; i++)
+    {
+        if (Profile.Tier[i].AbovePct == DAMAGE_TIER_UNUSED) continue;
+        if (((uint16_t)Profile.Tier[i].AbovePct * 10) < d10) tier = i;
+        else { next = i; break; }
+    }
+    if (tier >= 0)
+    {
+        drive =     Profile.Tier[tier].DriveCutPct;
+        rotation =  Profile.Tier[tier].RotationCutPct;
+        elevation = Profile.Tier[tier].ElevationCutPct;
+
+        // If the profile is smooth, slide from this tier's cuts toward the next one's as damage goes from one threshold to the other
+        if ((Profile.Flags & DAMAGE_FLAG_SMOOTH) && next > tier)
+        {
+            lo = (uint16_t)Profile.Tier[tier].AbovePct * 10;
+            hi = (uint16_t)Profile.Tier[next].AbovePct * 10;
+            drive =     drive     + (int16_t)(((int32_t)((int16_t)Profile.Tier[next].DriveCutPct     - drive)     * (d10 - lo)) / (hi - lo));
+            rotation =  rotation  + (int16_t)(((int32_t)((int16_t)Profile.Tier[next].RotationCutPct  - rotation)  * (d10 - lo)) / (hi - lo));
+            elevation = elevation + (int16_t)(((int32_t)((int16_t)Profile.Tier[next].ElevationCutPct - elevation) * (d10 - lo)) / (hi - lo));
+        }
+    }
+    if (isDestroyed) drive = 100;                                           // A destroyed vehicle doesn't move at all, whatever the profile says
 
+    if (drive > 100) drive = 100;
+    if (rotation > 100) rotation = 100;
+    if (elevation > 100) elevation = 100;
+}
+
+// Cut speed to motors (ie, "damage"). 
+void OP_Tank::Damage(Motor* Right_orRear, Motor* Left_orSteering, Motor* rotation, Motor* elevation, OP_Smoker* smoke, boolean includeSmoker, DRIVETYPE driveType)
+{
     // If driveType = DT_CAR or DT_DKLM, then "Right_orRear" will be the rear axle/propulsion motor, and "Left_OrSteering" will be the steering servo/motor.
     // But if driveType = DT_TANK or DT_HALFTRACK, then "Right_orRear" will be the right tread, and "Left_OrSteering" will be the left tread. 
+    
+    // Hang on to the motors so regeneration can apply the profile again on its own later
+    DamageMotor[0] = Right_orRear;
+    DamageMotor[1] = Left_orSteering;
+    DamageMotor[2] = rotation;
+    DamageMotor[3] = elevation;
+    DamageDriveType = driveType;
+    
+    // The smoker is not part of any profile yet. If it ever is, remember it must be left alone unless includeSmoker is true, 
+    // because otherwise it is being used for other purposes by the user. 
+    
+    ApplyDamage();
+}
 
-    // We can define multiple damage characteristics, aka "damage profiles" 
-    switch (BattleSettings.DamageProfile)
-    {
-        // Open Panzer damage profile
-        case OPENPANZER_DAMAGE:
-            // This has not yet been defined. But note we have available in this function the speed of both treads as well as turret rotation and elevation and the smoker.
-            // (Note the smoker includes another variable called "includeSmoker" - if that is false we should NOT modify the smoker motor because it is being used for 
-            //  other purposes by the user)
-            // In the case of a car, we also have the steering servo object.  We can also access in addition to the total DamagePct, the number of cannon vs MG hits. 
-            // So there are lots of possibilities for creative damage effects. We could setup a tier system like Tamiya, but make it more gradual 
-            // (rather than just 50%, 75%, Destroyed). We could also randomly damage, or apply damage to a single tread, or the turret, or whatever. 
-            // 
-            // But this feature will be added at a later time. For now we just fall through to TAMIYA_DAMAGE...
-            
-        case TAMIYA_DAMAGE:
-            // For reference, see the package insert to Tamiya #53447 "Hop Up Options: Battle System".
-            // When a Tamiya tank is hit, the drive motor speed is reduced. Tamiya follows a consistent formula based on the number of hits
-            // taken compared to the max number of hits the given weight class can take before being destroyed. The formula is as follows: 
-            // 1. Subtract 1 from the number of max hits (because the last hit destroys the tank, it doesn't damage it)
-            // 2. Divide the remaining number of hits by 2. If an odd number, round up to the nearest integer. We will call this Halfway.
-            // 3. If the number of hits taken so far is less than or equal to Halfway, reduce the speed of the drive motors to 50%. 
-            // 4. If the number of hits taken is greater than Halfway, reduce the speed of the drive motors to 25%. 
-            // 5. If the number of hits taken equals the max number of hits allowed, the tank is destroyed. 
-            // Because this formula only needs to know the max number of hits allowed, we can easily apply it to any custom weight class the
-            // user may create, as well as the standard Tamiya classes: 
-            /*
-            MaxHits = BattleSettings.ClassSettings.maxHits;     // The max number of hits for this weight class
-            Halfway = round(float(MaxHits-1)/2.0);              // The Tamiya formula to calculate Halfway
-            if      (hitsTaken <= Halfway) { cut_Pct = 50;  }   // Reduce speed to 50%
-            else if (hitsTaken <  MaxHits) { cut_Pct = 75;  }   // Reduce speed to 25% (cut by 75%)
-            else                           { cut_Pct = 100; }   // Destroyed (cut by 100%)
-            */
-            
-            // EDIT: Well, that's the way Tamiya does it, but if you want to include machine gun damage, we need a slightly different approach. 
-            // This should give us the same result as the Tamiya approach, but also allow damage due to machine gun fire. 
-            if      (DamagePct <= 0.0)                          cut_Pct = 0;
-            else if (DamagePct >  0.0 && DamagePct <= 50.0 )    cut_Pct = 50;
-            else if (DamagePct > 50.0 && DamagePct <  100.0)    cut_Pct = 75;
-            else                                                cut_Pct = 100;
-                    
-            // Serial.print(F("Speed cut to "));
-            // Serial.print(100-cut_Pct);
-            // Serial.println(F("%"));
-            if (driveType == DT_TANK || driveType == DT_HALFTRACK)
-            {   // Two independent treads, we cut/restore them both
-                if (cut_Pct > 0)
-                {
-                    Right_orRear->cut_SpeedPct(cut_Pct);
-                    Left_orSteering->cut_SpeedPct(cut_Pct);
-                }
-                else    
-                {   // If the tank is repaired enough, it is possible that it returns to full health, in which case, cut_Pct will equal 0
-                    // In that case, we just call the restore_Speed function
-                    Right_orRear->restore_Speed();
-                    Left_orSteering->restore_Speed();
-                }
-            }
-            else if (driveType == DT_CAR || driveType == DT_DKLM || driveType == DT_DMD)
-            {   // A single rear axle or drive motor
-                if (cut_Pct > 0) Right_orRear->cut_SpeedPct(cut_Pct);
-                else             Right_orRear->restore_Speed(); 
-                // In this case, we leave the steering servo alone because Tamiya has no damage setting specified for steering servos. 
-                // We also leave the steering motor alone in the case of DKLM gearbox. 
-            }
-            break;
-        
-        case NO_DAMAGE:
-            // We do nothing here
-            break;
+void OP_Tank::ApplyDamage(void)
+{
+uint8_t driveCut, rotationCut, elevationCut;
+
+    if (DamageMotor[0] == NULL) return;                                     // Damage() has not been called yet
+    
+    // For reference on the stock Tamiya behavior, see the package insert to Tamiya #53447 "Hop Up Options: Battle System" and the 
+    // TAMIYA_DAMAGE entry in the DamageProfiles table (OP_Tank.h). All the profiles are now just different tables applied by the same code. 
+    TierCuts(driveCut, rotationCut, elevationCut);
+
+    // Serial.print(F("Speed cut to "));
+    // Serial.print(100-driveCut);
+    // Serial.println(F("%"));
+    if (DamageDriveType == DT_TANK || DamageDriveType == DT_HALFTRACK)
+    {   // Two independent treads, we cut/restore them both
+        if (driveCut > 0)
+        {
+            DamageMotor[0]->cut_SpeedPct(driveCut);
+            DamageMotor[1]->cut_SpeedPct(driveCut);
+        }
+        else    
+        {   // If the tank is repaired enough, it is possible that it returns to full health, in which case, the cut will equal 0
+            // In that case, we just call the restore_Speed function
+            DamageMotor[0]->restore_Speed();
+            DamageMotor[1]->restore_Speed();
+        }
+    }
+    else if (DamageDriveType == DT_CAR || DamageDriveType == DT_DKLM || DamageDriveType == DT_DMD)
+    {   // A single rear axle or drive motor
+        if (driveCut > 0) DamageMotor[0]->cut_SpeedPct(driveCut);
+        else              DamageMotor[0]->restore_Speed(); 
+        // In this case, we leave the steering servo alone because Tamiya has no damage setting specified for steering servos. 
+        // We also leave the steering motor alone in the case of DKLM gearbox. 
     }
 
+    // Turret motors are only touched if the profile actually cuts them, or did before, so profiles without turret damage 
+    // leave them exactly as they always were. 
+    if (rotationCut != RotationCut && DamageMotor[2] != NULL)
+    {
+        if (rotationCut > 0) DamageMotor[2]->cut_SpeedPct(rotationCut);
+        else                 DamageMotor[2]->restore_Speed();
+        RotationCut = rotationCut;
+    }
+    if (elevationCut != ElevationCut && DamageMotor[3] != NULL)
+    {
+        if (elevationCut > 0) DamageMotor[3]->cut_SpeedPct(elevationCut);
+        else                  DamageMotor[3]->restore_Speed();
+        ElevationCut = elevationCut;
+    }
 }
+
 void OP_Tank::ResetBattle(void)
 {
     // This function is called when the tank is "regenerating" or "recovering" after being destroyed (or when the TCB has just rebooted). 
     // During invulnerability time the tank is invulnerable to enemy fire for a length of time dependent on its class. 
+    if (isDestroyed) OP_BattleLog::log(LOG_EVENT_RECOVERED);
     isDestroyed = false;        // We are no longer destroyed
     CannonHitsTaken = 0;        // Reset the hit counter
     MGHitsTaken = 0;
-    DamagePct = 0;
+    DamageUnits = 0;
+    RotationCut = ElevationCut = 0;     // The sketch restores all the motor speeds on recovery
     DisableHitReception();      // Ignore enemy fire
     TankTimer->setTimeout(BattleSettings.ClassSettings.recoveryTime, EnableHitReception);    // Enable hits after recovery (invulnerability) time has passed
 }
@@ -1218,7 +1314,9 @@ void OP_Tank::ResetBattleImmediate(void)
     isDestroyed = false;        // We are not longer destroyed
     CannonHitsTaken = 0;        // We have not been hit by anything yet
     MGHitsTaken = 0;
-    DamagePct = 0;              // We have no damage yet
+    DamageUnits = 0;            // We have no damage yet
+    RotationCut = ElevationCut = 0;
+    LastHit_mS = millis();
     EnableHitReception();       // Enable hits right now
 }
 
@@ -1525,9 +1623,23 @@ void OP_Tank::HitLEDs_Repair(void)
 // The sketch will call this function every loop
 void OP_Tank::Update(void)
 {
-    AppleLEDs.update();
-    
+    // AppleLEDs are advanced along with every other LedHandler by LedHandler::updateAll(), called from the sketch
+
+    // Copy any new battle log events to EEPROM
+    OP_BattleLog::update();
     
+    // Passive regeneration, if the profile has it. Every RegenInterval_S that goes by without a hit removes some damage. 
+    if (Profile.RegenInterval_S > 0 && Profile.RegenPct > 0 && DamageUnits > 0 && !isDestroyed && !RepairOngoing)
+    {
+        if (millis() - LastHit_mS >= ((uint32_t)Profile.RegenInterval_S * 1000))
+        {
+            LastHit_mS = millis();
+            RemoveDamage((FullDamageUnits * Profile.RegenPct) / 100);
+            ApplyDamage();
+            OP_BattleLog::log(LOG_EVENT_REGEN, 0, 0, PctDamaged());
+            if (DamageUnits == 0) _TankSound->SetVehicleDamaged(false);
+        }
+    }
 }
 
 
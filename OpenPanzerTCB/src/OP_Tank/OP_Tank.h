@@ -22,6 +22,7 @@
 
 #include <Arduino.h>
 #include "../OP_Settings/OP_Settings.h"
+#include "../OP_Devices/OP_Devices.h"
 #include "../OP_Driver/OP_Driver.h"
 #include "../OP_IRLib/OP_IRLib.h"
 #include "../OP_SimpleTimer/OP_SimpleTimer.h"
@@ -29,6 +30,7 @@
 #include "../OP_Smoker/OP_Smoker.h"
 #include "../OP_Sound/OP_Sound.h"
 #include "../LedHandler/LedHandler.h"
+#include "../OP_BattleLog/OP_BattleLog.h"
 #include "OP_BattleTimes.h"
 
 #define MECHRECOIL_TRIGGER_MODE     RISING  // Arduino defines these as:
@@ -76,15 +78,59 @@ typedef char WEIGHTCLASS;
 const __FlashStringHelper *ptrWeightClassName(WEIGHTCLASS wClass); //Returns a character string that is name of tank class (see OP_Tank.cpp)
 
 
-// See the Damage function in OP_Tank.cpp for definitions
+// DAMAGE PROFILES
+// -------------------------------------------------------------------------------------------------------------------------------------------->>
+// A damage profile sets how much damage each kind of hit does, what it takes to be destroyed, how repairs and regeneration work, and how the 
+// vehicle is slowed down as damage builds up. The built-in profiles are in the DamageProfiles table below, and one more (CUSTOM_DAMAGE) is kept 
+// in EEPROM so it can be changed from the PC without rebuilding the firmware. 
+//
+// All damage math is integer. Damage is counted in units where a standard hit from the weight class - a cannon hit, or if machine gun damage 
+// is accepted, a machine gun hit - is always a whole number of units, so the Tamiya tiers come out exactly. See SetupDamage() in OP_Tank.cpp. 
 typedef char DAMAGEPROFILES;
 #define TAMIYA_DAMAGE       0       // Stock Tamiya damage profile
 #define OPENPANZER_DAMAGE   1       // Open Panzer damage profile
 #define NO_DAMAGE           2       // No damage
-//#define ADDITIONAL (number)
-#define LAST_DAMAGE_PROFILE NO_DAMAGE
+#define CUSTOM_DAMAGE       3       // User-defined profile stored in EEPROM
+#define LAST_DAMAGE_PROFILE CUSTOM_DAMAGE
+#define NUM_BUILTIN_DAMAGE_PROFILES 3
 const __FlashStringHelper *ptrDamageProfile(DAMAGEPROFILES dProfile); //Returns a character string that is name of the damage profile 
 
+#define DAMAGE_TIERS                4       // Number of degradation tiers in a profile
+#define DAMAGE_TIER_UNUSED          0xFF    // Set AbovePct to this to skip a tier
+#define DAMAGE_FLAG_SMOOTH          0x01    // Slide smoothly from one tier to the next rather than stepping
+#define DAMAGE_HIT_STANDARD         8       // Hit and repair amounts are in eighths of a standard hit, so 8 is one standard hit
+
+typedef struct damageTier {
+    uint8_t  AbovePct;          // This tier applies once damage is above this percent (tiers must be in increasing order)
+    uint8_t  DriveCutPct;       // Cut drive speed by this percent
+    uint8_t  RotationCutPct;    // Cut turret rotation speed by this percent
+    uint8_t  ElevationCutPct;   // Cut barrel elevation speed by this percent
+};
+typedef struct damageProfile {
+    uint8_t  CannonHit;         // Damage done by a cannon hit, in eighths of a standard cannon hit for the weight class
+    uint8_t  MGHit;             // Damage done by a machine gun hit, in eighths of a standard machine gun hit for the weight class
+    uint8_t  TwoShotPct;        // Damage done by the Tamiya 2-shot kill code, in percent of full health
+    uint8_t  DestroyPct;        // The vehicle is destroyed once damage reaches this percent
+    uint8_t  Repair;            // Damage removed by a completed repair, in eighths of a standard cannon hit
+    uint8_t  RegenPct;          // Damage removed by passive regeneration, in percent of full health...
+    uint16_t RegenInterval_S;   // ...each time this many seconds go by without taking a hit (0 = no regeneration)
+    uint8_t  Flags;             // DAMAGE_FLAG_
+    damageTier Tier[DAMAGE_TIERS];
+};
+#define DAMAGE_PROFILE_SIZE         25      // Bytes in a damageProfile, for reading the table below
+
+const damageProfile DamageProfiles[NUM_BUILTIN_DAMAGE_PROFILES] PROGMEM_FAR = {
+// For reference on the Tamiya profile, see the package insert to Tamiya #53447 "Hop Up Options: Battle System". Any damage cuts drive speed to
+// 50%, more than half damage cuts it to 25%, and the turret is left alone. A repair removes one cannon hit. 
+//  Cannon  MG  2-Shot  Destroy  Repair  Regen  Interval  Flags    Tiers: {Above%, Drive, Rotation, Elevation}
+{   8,      8,  50,     100,     8,      0,     0,        0,       { {0, 50, 0, 0}, {50, 75, 0, 0}, {DAMAGE_TIER_UNUSED, 0, 0, 0}, {DAMAGE_TIER_UNUSED, 0, 0, 0} } },  // TAMIYA_DAMAGE
+// The Open Panzer profile is the same as Tamiya for now, but being a table it can be changed without touching the code
+{   8,      8,  50,     100,     8,      0,     0,        0,       { {0, 50, 0, 0}, {50, 75, 0, 0}, {DAMAGE_TIER_UNUSED, 0, 0, 0}, {DAMAGE_TIER_UNUSED, 0, 0, 0} } },  // OPENPANZER_DAMAGE
+// Hits still count toward destruction, but there is no loss of performance along the way
+{   8,      8,  50,     100,     8,      0,     0,        0,       { {DAMAGE_TIER_UNUSED, 0, 0, 0}, {DAMAGE_TIER_UNUSED, 0, 0, 0}, {DAMAGE_TIER_UNUSED, 0, 0, 0}, {DAMAGE_TIER_UNUSED, 0, 0, 0} } }   // NO_DAMAGE
+};
+void LoadDamageProfile(DAMAGEPROFILES dProfile, damageProfile *dest);  // Copy one of the built-in profiles into RAM (see OP_Tank.cpp)
+
 
 // All the types of IR receptions possible
 typedef char HIT_TYPE;
@@ -114,6 +160,7 @@ typedef struct battle_settings{
     char     DamageProfile;     // Which Damage Profile are we using
     boolean  SendTankID;        // Do we include the Tank ID in the cannon IR transmission
     uint16_t TankID;            // What is this tank's ID number
+    damageProfile CustomDamage; // Profile to use if DamageProfile is CUSTOM_DAMAGE
 };
 
 
@@ -143,7 +190,7 @@ class OP_Tank
         static uint8_t  PctDamaged(void);           // Returns a number from 0-100 of the percent damage taken
         static uint8_t  PctHealthRemaining(void);   // Returns a number from 0-100 of the percent of health remaining
         static boolean  isRepairOngoing(void);      // Returns the status of a repair operation
-        static void     Damage(Motor*, Motor*, Motor*, Motor*, OP_Smoker*, boolean, DRIVETYPE); // Pass 5 motor objects - left tread, right tread, turret elevation, turret azimuth, smoker, plus we pass the drive type and whether the smoker should be included or not
+        static void     Damage(Motor*, Motor*, Motor*, Motor*, OP_Smoker*, boolean, DRIVETYPE); // Pass 5 motor objects - right tread (or drive motor), left tread (or steering), turret rotation, barrel elevation, smoker, plus we pass the drive type and whether the smoker should be included or not
         static battle_settings BattleSettings;      // Battle settings struct
         static boolean  isInvulnerable;             // Is the tank presently invulnerable to incoming fire
         static boolean  isDestroyed;                // Is the tank destroyed
@@ -162,7 +209,7 @@ class OP_Tank
         static void     MachineGun_Stop(void);
         
         // Misc
-        static void     Update(void);               // For actions that need to be polled by the sketch for updating
+        static void     Update(void);               // For actions that need to be polled by the sketch for updating (also writes the battle log to EEPROM)
         static boolean  isRepairTank(void);         // Returns status of fight/repair switch on the TCB.
         static void     StopRepair(void);           // The only time the sketch might need to call this is a failsafe, LVC or other dire situation occured, and we want to
                                                     // shut everything down. Some functions check for a repair before they actually do anything (ie EngineOn/EngineOff in the sketch).
@@ -254,9 +301,23 @@ class OP_Tank
         // Damage/Repair
         static uint8_t  HitsTaken_Cannon;           // How many hits have we sustained
         static uint8_t  HitsTaken_MG;               // How many machine gun hits have we sustained      
-        static float    DamagePct;                  // Damage the vehicle has sustained, in percent
-        static float    DamagePctPerCannonHit;      // How many damage does a single cannon hit inflict
-        static float    DamagePctPerMGHit;          // How many damage does a single round of machine gun fire inflict
+        static damageProfile Profile;               // The damage profile in use
+        static void     SetupDamage(void);          // Works out the damage units for the weight class and profile
+        static void     AddDamage(uint32_t units);  // Take damage, and work out if we've been destroyed
+        static void     RemoveDamage(uint32_t units);
+        static boolean  DamageFatal(void);          // Has damage reached the profile's destroy level
+        static void     ApplyDamage(void);          // Cut motor speeds according to the profile tiers
+        static void     TierCuts(uint8_t &drive, uint8_t &rotation, uint8_t &elevation);    // Speed cuts at the present level of damage
+        static uint32_t DamageUnits;                // Damage the vehicle has sustained
+        static uint32_t FullDamageUnits;            // Damage units at 100 percent
+        static uint32_t CannonHitUnits;             // Damage units a single cannon hit inflicts
+        static uint32_t MGHitUnits;                 // Damage units a single round of machine gun fire inflicts
+        static uint32_t RepairUnits;                // Damage units removed by a completed repair
+        static uint8_t  RotationCut;                // Present cut of the turret motors, so we only touch them when the profile calls for it
+        static uint8_t  ElevationCut;
+        static uint32_t LastHit_mS;                 // For regeneration, when did we last take damage (or regenerate)
+        static Motor *  DamageMotor[4];             // Motors passed to the last Damage() call, so regeneration can update them itself
+        static DRIVETYPE DamageDriveType;
         static boolean  RepairOngoing;              // Flag gets set if tank receives a repair code, and remains set until the operation is completed (see REPAIR_TIME_mS)
         static void     CancelRepair(void);         // If the model receive an enemy hit in the middle of a repair operation, we cancel the repair operation, do not increase the
                                                     // the health level, and apply damage as usual. 
@@ -0,0 +1,206 @@
+/* battery_test.cpp - host-side check of the battery estimator (OP_Battery) on synthetic LiPo and NiMH packs
+ *
+ * Builds the real OP_Battery.cpp on the PC and feeds it a simulated pack: a resting voltage that follows the chemistry's discharge
+ * curve as the charge drains, less an internal resistance sag proportional to the motor load, plus a little noise. The load steps
+ * between stopped, half and full throttle every few seconds, the way driving does. We check that the estimator counts the cells,
+ * learns the sag, keeps the state of charge close to the truth through the load steps, predicts the runtime, and only calls the
+ * cutoff when the resting voltage really gets there.
+ *
+ *      g++ -std=gnu++11 -Itools/stub -o battery_test tools/battery_test.cpp && ./battery_test
+ *
+ * Run from the root of the repository. Prints each check and exits 1 if any of them failed.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ARDUINO STAND-INS
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+// Defining the include guard keeps the real OP_Settings header out, we only need PROGMEM_FAR from it. tools/stub/Arduino.h is empty.
+#define OP_SETTINGS_H
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define PROGMEM_FAR
+#define pgm_get_far_address(var)    ((uintptr_t)&(var))
+#define pgm_read_word_far(addr)     (*(const uint16_t *)(addr))
+
+#include "../OpenPanzerTCB/src/OP_Battery/OP_Battery.cpp"
+
+
+// TESTS
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+static int Failures = 0;
+
+static void check(boolean ok, const char *what)
+{
+    printf("%s  %s\n", ok ? "pass" : "FAIL", what);
+    if (!ok) Failures++;
+}
+
+// Resting voltage of one cell at a charge in tenths of a percent, from the same curve the estimator uses
+static double cellVoltage(uint8_t type, double tenths)
+{
+    if (tenths <= 0)    return BatteryCurve[type][0];
+    if (tenths >= 1000) return BatteryCurve[type][BATTERY_CURVE_POINTS - 1];
+    int i = (int)(tenths / 100);
+    double f = (tenths - (i * 100)) / 100.0;
+    return BatteryCurve[type][i] + f * (BatteryCurve[type][i + 1] - BatteryCurve[type][i]);
+}
+
+// Charge in tenths from a cell voltage, the inverse of the above
+static double cellTenths(uint8_t type, double mV)
+{
+    if (mV <= BatteryCurve[type][0]) return 0;
+    for (int i = 1; i < BATTERY_CURVE_POINTS; i++)
+    {
+        if (mV < BatteryCurve[type][i]) return ((i - 1) * 100) + (100.0 * (mV - BatteryCurve[type][i - 1]) / (BatteryCurve[type][i] - BatteryCurve[type][i - 1]));
+    }
+    return 1000;
+}
+
+typedef struct {
+    const char *name;
+    uint8_t  type;
+    uint8_t  cells;             // In the pack
+    uint8_t  setCells;          // As the user set BatteryCells, 0 to count
+    double   startTenths;       // Charge when plugged in
+    uint16_t sagFull_mV;        // Sag of the whole pack at full load
+    uint16_t cutoff_mV;         // LVC cutoff for the pack
+    double   drainTenths_min;   // Charge used per minute at full load
+    double   socTol_Pct;        // How close the estimate must stay to the truth
+} pack;
+
+typedef struct {
+    uint8_t  cells;
+    uint16_t sag_mV;
+    double   worstSoc_Pct;      // Largest difference from the true charge once settled
+    double   worstRaw_Pct;      // The same, had we used the measured voltage with no sag correction
+    double   runtimeErr_Pct;    // Runtime prediction against what was left, taken halfway through
+    boolean  cutoffEarly;       // Cutoff called while the resting voltage was still clearly above it
+    boolean  cutoffLate;        // Not called once the resting voltage was clearly below it
+    boolean  lowWarned;
+} result;
+
+// True charge rescaled so the cutoff is 0%, the way the estimator reports it
+static double truthPct(const pack &p, double tenths)
+{
+    double zero = cellTenths(p.type, (double)p.cutoff_mV / p.cells);
+    if (tenths <= zero) return 0;
+    return 100.0 * (tenths - zero) / (1000.0 - zero);
+}
+
+#define SETTLE_mS       60000UL
+
+// Drive the pack down from its starting charge to past the cutoff. The load holds each level for 2-8 seconds.
+static result runPack(const pack &p)
+{
+    OP_Battery b;
+    result r;
+    uint32_t now = 0, nextStep = 0;
+    uint8_t load = 0;
+    double tenths = p.startTenths;
+    boolean runtimeTaken = false;
+    static const uint8_t levels[] = { 0, 128, 255, 200, 64 };
+
+    memset(&r, 0, sizeof(r));
+    b.begin(p.cutoff_mV, p.type, p.setCells);
+
+    while (now < 3600000UL)
+    {
+        if (now >= nextStep) { load = levels[rand() % 5]; nextStep = now + 2000 + (rand() % 6000); }
+
+        double rest = cellVoltage(p.type, tenths) * p.cells;
+        double measured = rest - ((double)p.sagFull_mV * load / 255) + ((rand() % 21) - 10);
+        b.update((uint16_t)measured, load, now);
+        if (now == 0) r.cells = b.cells();
+        if (b.lowWarning()) r.lowWarned = true;
+
+        // Give the filters and the sag a minute of driving to settle before we hold the estimate to the truth
+        if (now >= SETTLE_mS)
+        {
+            double truth = truthPct(p, tenths);
+            double d = b.stateOfCharge() - truth;
+            if (d < 0) d = -d;
+            if (d > r.worstSoc_Pct) r.worstSoc_Pct = d;
+
+            double raw = truthPct(p, cellTenths(p.type, measured / p.cells)) - truth;
+            if (raw < 0) raw = -raw;
+            if (raw > r.worstRaw_Pct) r.worstRaw_Pct = raw;
+
+            // Runtime halfway down, compared with how long the same average load would take to use what is left
+            if (!runtimeTaken && truth < truthPct(p, p.startTenths) / 2 && b.runtimeMinutes() != BATTERY_RUNTIME_UNKNOWN)
+            {
+                double avgLoad = (0 + 128 + 255 + 200 + 64) / 5.0 / 255.0;
+                double zero = cellTenths(p.type, (double)p.cutoff_mV / p.cells);
+                double left = (tenths - zero) / (p.drainTenths_min * avgLoad);
+                r.runtimeErr_Pct = 100.0 * (b.runtimeMinutes() - left) / left;
+                runtimeTaken = true;
+            }
+
+            double restCell = rest / p.cells, cutCell = (double)p.cutoff_mV / p.cells;
+            if (b.belowCutoff() && restCell > cutCell + 30) r.cutoffEarly = true;
+            if (!b.belowCutoff() && restCell < cutCell - 30) r.cutoffLate = true;
+        }
+
+        if (rest < p.cutoff_mV * 0.9) break;                // Well past the cutoff, done
+        tenths -= p.drainTenths_min * load / 255.0 * (BATTERY_SAMPLE_mS / 60000.0);
+        now += BATTERY_SAMPLE_mS;
+    }
+    r.sag_mV = b.sag_mV();
+    if (!runtimeTaken) r.runtimeErr_Pct = 1000;
+    return r;
+}
+
+static void report(const pack &p, const result &r)
+{
+    char line[200];
+    printf("\n%s\n", p.name);
+    snprintf(line, sizeof(line), "Cells %d (pack has %d)", r.cells, p.cells);
+    check(r.cells == p.cells, line);
+    snprintf(line, sizeof(line), "Sag learned %d mV (true %d mV), within 20%%", r.sag_mV, p.sagFull_mV);
+    check(r.sag_mV > p.sagFull_mV * 0.8 && r.sag_mV < p.sagFull_mV * 1.2, line);
+    snprintf(line, sizeof(line), "Charge within %.0f%% of the truth through the load steps (worst %.1f%%, uncorrected would be %.1f%%)", p.socTol_Pct, r.worstSoc_Pct, r.worstRaw_Pct);
+    check(r.worstSoc_Pct <= p.socTol_Pct, line);
+    snprintf(line, sizeof(line), "Runtime halfway down within 35%% of what was left (%+.0f%%)", r.runtimeErr_Pct);
+    check(r.runtimeErr_Pct > -35 && r.runtimeErr_Pct < 35, line);
+    check(!r.cutoffEarly, "Cutoff not called under load while resting above it");
+    check(!r.cutoffLate, "Cutoff called once resting below it");
+    check(r.lowWarned, "Low battery warning given on the way down");
+}
+
+int main(void)
+{
+    srand(1);
+
+    // Name, chemistry, cells, BatteryCells, start charge, sag at full load, cutoff, drain per minute at full load, tolerance
+    pack packs[] = {
+        { "LiPo 2S, full, counted",          BATTERY_LIPO, 2, 0, 1000, 500,  6400,  60, 5 },
+        { "LiPo 3S, full, counted",          BATTERY_LIPO, 3, 0, 1000, 900,  9600,  50, 5 },
+        { "LiPo 3S, half charged, counted",  BATTERY_LIPO, 3, 0,  500, 900,  9600,  50, 5 },
+        { "LiPo 4S, tired pack, counted",    BATTERY_LIPO, 4, 0,  900, 2000, 12800, 50, 5 },
+        { "NiMH 6 cell, full, set",          BATTERY_NIMH, 6, 6, 1000, 600,  6000,  50, 10 },
+        { "NiMH 7 cell, full, set",          BATTERY_NIMH, 7, 7, 1000, 700,  7000,  50, 10 },
+        { "NiMH 7 cell, half, counted",      BATTERY_NIMH, 7, 0,  500, 700,  7000,  50, 10 },
+    };
+
+    for (unsigned i = 0; i < sizeof(packs) / sizeof(packs[0]); i++) report(packs[i], runPack(packs[i]));
+
+    // What NiMH cell counting can't do: a fresh 6 cell pack reads like 7 cells at mid charge. This is why BatteryCells is there.
+    {
+        OP_Battery b;
+        b.begin(6000, BATTERY_NIMH, 0);
+        b.update(6 * 1420, 0, 0);
+        printf("\nNiMH counting limits\n");
+        check(b.cells() == 7, "A fresh 6 cell NiMH pack, counted, is taken as 7 cells (set BatteryCells for NiMH)");
+        b.begin(6000, BATTERY_NIMH, 6);
+        b.update(6 * 1420, 0, 0);
+        check(b.cells() == 6 && b.stateOfCharge() == 100, "The same pack with BatteryCells = 6 reads 6 cells and full");
+    }
+
+    printf("\n%s\n", Failures ? "FAILED" : "All passed");
+    return Failures ? 1 : 0;
+}
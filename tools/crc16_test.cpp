@@ -0,0 +1,130 @@
+/* crc16_test.cpp - host-side check that the table driven OP_CRC16::calc gives the same answer as the bit loop OP_PCComm used to have
+ *
+ * Builds the real OP_CRC16.cpp on the PC and runs it side by side with the old OP_PCComm::calcrc, copied here as it was, over the
+ * XMODEM check string, empty input, every single byte, and a pile of random buffers (which will include plenty of bytes >= 0x80, where
+ * a signed char could trip up either version).
+ *
+ *      g++ -std=gnu++11 -o crc16_test tools/crc16_test.cpp && ./crc16_test
+ *
+ * Run from the root of the repository. Prints each check and exits 1 if any of them failed.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ARDUINO STAND-INS
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+// Defining the include guard keeps the real OP_CRC16.h (and through it Arduino.h) out, so the class is declared again here exactly
+// as it is there.
+#define OP_CRC16_h
+
+typedef bool boolean;
+
+#define PROGMEM_FAR
+#define pgm_get_far_address(var)    ((uintptr_t)&(var))
+#define pgm_read_word_far(addr)     (*(const uint16_t *)(addr))
+
+#define CRC16_INIT              0x0000
+
+class OP_CRC16
+{
+    public:
+        static uint16_t     update(uint16_t crc, uint8_t b);
+        static uint16_t     calc(const char *ptr, uint16_t count, uint16_t crc = CRC16_INIT);
+};
+
+#include "../OpenPanzerTCB/src/OP_CRC16/OP_CRC16.cpp"
+
+
+// THE OLD ONE
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+// OP_PCComm::calcrc before it used OP_CRC16. On the AVR an int is 16 bits and char is signed, the casts to int16_t here give
+// the same result with the PC's 32 bit int.
+static int16_t oldCalcrc(char *ptr, int16_t count)
+{
+    int16_t crc;
+    uint8_t i;
+
+    crc = 0;
+    while (--count >= 0)
+    {
+        crc = crc ^ (int16_t) *ptr++ << 8;
+        i = 8;
+        do
+        {
+            if (crc & 0x8000)
+                crc = crc << 1 ^ 0x1021;
+            else
+                crc = crc << 1;
+        } while(--i);
+    }
+    return (crc);
+}
+
+
+// TESTS
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+static int Failures = 0;
+
+static void check(boolean ok, const char *what)
+{
+    printf("%s  %s\n", ok ? "pass" : "FAIL", what);
+    if (!ok) Failures++;
+}
+
+int main(void)
+{
+    char buf[70];
+    char line[100];
+    long mismatches;
+    srand(1);
+
+    // The standard check value for this CRC
+    strcpy(buf, "123456789");
+    check(OP_CRC16::calc(buf, 9) == 0x31C3, "\"123456789\" gives the XMODEM check value 0x31C3");
+    check((uint16_t)oldCalcrc(buf, 9) == 0x31C3, "The old bit loop agrees on the check value");
+
+    // Nothing in, nothing out
+    check(OP_CRC16::calc(buf, 0) == 0 && oldCalcrc(buf, 0) == 0, "Empty input gives 0 from both");
+
+    // Every single byte, which covers every table entry
+    mismatches = 0;
+    for (int b = 0; b < 256; b++)
+    {
+        buf[0] = (char)b;
+        if (OP_CRC16::calc(buf, 1) != (uint16_t)oldCalcrc(buf, 1)) mismatches++;
+    }
+    snprintf(line, sizeof(line), "All 256 single bytes match (%ld differ)", mismatches);
+    check(mismatches == 0, line);
+
+    // Random buffers up to the longest sentence OP_PCComm handles, every byte value equally likely
+    mismatches = 0;
+    for (long n = 0; n < 200000; n++)
+    {
+        int len = rand() % (int)sizeof(buf);
+        for (int i = 0; i < len; i++) buf[i] = (char)(rand() & 0xFF);
+        if (OP_CRC16::calc(buf, len) != (uint16_t)oldCalcrc(buf, len)) mismatches++;
+    }
+    snprintf(line, sizeof(line), "200000 random buffers of 0-69 bytes match (%ld differ)", mismatches);
+    check(mismatches == 0, line);
+
+    // Buffers that are nothing but high bytes
+    mismatches = 0;
+    for (long n = 0; n < 10000; n++)
+    {
+        int len = 1 + rand() % (int)(sizeof(buf) - 1);
+        for (int i = 0; i < len; i++) buf[i] = (char)(0x80 | (rand() & 0x7F));
+        if (OP_CRC16::calc(buf, len) != (uint16_t)oldCalcrc(buf, len)) mismatches++;
+    }
+    snprintf(line, sizeof(line), "10000 buffers of only bytes >= 0x80 match (%ld differ)", mismatches);
+    check(mismatches == 0, line);
+
+    // Running a buffer through in two pieces is the same as all at once
+    strcpy(buf, "123456789");
+    check(OP_CRC16::calc(buf + 4, 5, OP_CRC16::calc(buf, 4)) == 0x31C3, "Running CRC over two pieces gives the same check value");
+
+    printf("%s\n", Failures ? "FAILED" : "All passed");
+    return Failures ? 1 : 0;
+}
@@ -0,0 +1,221 @@
+/* format_test.cpp - host-side check of the bounded append functions in OP_Format
+ *
+ * Builds the real OP_Format.cpp on the PC and runs appendInt, appendUInt, appendChar, appendStr and appendStr_P into buffers of every
+ * size from 1 to 24 bytes, starting empty, part full and exactly full, with things that fit exactly, are one too long, or are far
+ * too long (including a string of more than 255 characters). After every call the buffer must be null-terminated within buffLen,
+ * nothing past buffLen may be touched, len must match the string, and the return value must say whether it was added.
+ * malloc, calloc and realloc are replaced here and the test fails if OP_Format ever calls one of them.
+ *
+ *      g++ -std=gnu++11 -o format_test tools/format_test.cpp && ./format_test
+ *
+ * Run from the root of the repository, on Linux (the real allocator is reached through glibc's __libc_ functions). Prints each check
+ * and exits 1 if any of them failed.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ALLOCATOR WATCH
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+// Anything in the program that allocates comes through here. Only calls made while Watching are counted, so printf can still
+// set up its own buffers.
+extern "C" void * __libc_malloc(size_t);
+extern "C" void * __libc_calloc(size_t, size_t);
+extern "C" void * __libc_realloc(void *, size_t);
+
+static volatile bool Watching = false;
+static volatile long Allocations = 0;
+
+extern "C" void * malloc(size_t n)              { if (Watching) Allocations++; return __libc_malloc(n); }
+extern "C" void * calloc(size_t c, size_t n)    { if (Watching) Allocations++; return __libc_calloc(c, n); }
+extern "C" void * realloc(void *p, size_t n)    { if (Watching) Allocations++; return __libc_realloc(p, n); }
+
+
+// ARDUINO STAND-INS
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+// Defining the include guard keeps the real OP_Format.h (and through it Arduino.h) out, so the class is declared again here exactly
+// as it is there.
+#define OP_Format_h
+
+typedef bool boolean;
+typedef const char * PGM_P;
+#define PSTR(s)                 (s)
+#define strlen_P(s)             strlen(s)
+#define memcpy_P(d,s,n)         memcpy(d,s,n)
+
+#define FORMAT_NUMBER_BUFF      12
+
+class OP_Format
+{
+    public:
+        static boolean  appendInt(char *buf, uint8_t buffLen, uint8_t &len, int32_t val);
+        static boolean  appendUInt(char *buf, uint8_t buffLen, uint8_t &len, uint32_t val);
+        static boolean  appendChar(char *buf, uint8_t buffLen, uint8_t &len, char c);
+        static boolean  appendStr(char *buf, uint8_t buffLen, uint8_t &len, const char *str);
+        static boolean  appendStr_P(char *buf, uint8_t buffLen, uint8_t &len, PGM_P str);
+};
+
+// avr-libc has these, glibc doesn't. Written out by hand so nothing in here allocates either. The values OP_Format passes are 32 bits.
+static char * ultoa(unsigned long val, char *s, int radix)
+{
+    char tmp[FORMAT_NUMBER_BUFF];
+    int i = 0, j = 0;
+    val &= 0xFFFFFFFFUL;
+    do { tmp[i++] = '0' + (val % radix); val /= radix; } while (val);
+    while (i) s[j++] = tmp[--i];
+    s[j] = '\0';
+    return s;
+}
+static char * ltoa(long val, char *s, int radix)
+{
+    if (val < 0) { s[0] = '-'; ultoa(0UL - (unsigned long)val, s + 1, radix); }
+    else ultoa((unsigned long)val, s, radix);
+    return s;
+}
+
+#include "../OpenPanzerTCB/src/OP_Format/OP_Format.cpp"
+
+
+// TESTS
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+static int Failures = 0;
+
+static void check(boolean ok, const char *what)
+{
+    printf("%s  %s\n", ok ? "pass" : "FAIL", what);
+    if (!ok) Failures++;
+}
+
+#define MAX_BUFF        24
+#define GUARD           0xA5            // Fills the bytes past buffLen, they must never change
+
+enum { ADD_INT, ADD_UINT, ADD_CHAR, ADD_STR, ADD_STR_P, ADD_KINDS };
+static const char *KindName[ADD_KINDS] = { "appendInt", "appendUInt", "appendChar", "appendStr", "appendStr_P" };
+
+static char LongStr[258];               // 257 characters, which a uint8_t length would wrap to 1
+
+// One call of the given kind, and the text it should add if it fits
+static boolean add(int kind, int which, char *buf, uint8_t buffLen, uint8_t &len, char *expect)
+{
+    static const int32_t  ints[]  = { 0, 7, -7, 12345, -2147483647L - 1, 2147483647L };
+    static const uint32_t uints[] = { 0, 9, 65535, 4294967295UL };
+    static const char    *strs[]  = { "", "A", "OP_Config", "0123456789ABCDEFGHIJ" };
+    boolean r = false;
+
+    // Only the OP_Format call itself is watched
+    #define WATCHED(call)   do { Watching = true; r = call; Watching = false; } while (0)
+    switch (kind)
+    {
+        case ADD_INT:   { int32_t v = ints[which % 6];   snprintf(expect, 400, "%ld", (long)v);           WATCHED(OP_Format::appendInt(buf, buffLen, len, v));  break; }
+        case ADD_UINT:  { uint32_t v = uints[which % 4]; snprintf(expect, 400, "%lu", (unsigned long)v);  WATCHED(OP_Format::appendUInt(buf, buffLen, len, v)); break; }
+        case ADD_CHAR:  { char c = "|,;\x80"[which % 4]; expect[0] = c; expect[1] = '\0';                 WATCHED(OP_Format::appendChar(buf, buffLen, len, c)); break; }
+        case ADD_STR:   { const char *s = (which % 5 == 4) ? LongStr : strs[which % 5]; strcpy(expect, s); WATCHED(OP_Format::appendStr(buf, buffLen, len, s)); break; }
+        case ADD_STR_P: { const char *s = (which % 5 == 4) ? LongStr : strs[which % 5]; strcpy(expect, s); WATCHED(OP_Format::appendStr_P(buf, buffLen, len, PSTR(s))); break; }
+    }
+    return r;
+}
+
+int main(void)
+{
+    char mem[MAX_BUFF + 8];
+    char model[MAX_BUFF + 400];         // What the buffer should hold
+    char expect[400];
+    char line[160];
+    long calls = 0, bad[ADD_KINDS] = { 0 };
+    long filled = 0, refused = 0;
+
+    memset(LongStr, 'x', sizeof(LongStr) - 1);
+    LongStr[sizeof(LongStr) - 1] = '\0';
+
+    // Every buffer size, every starting fill, every kind of append and value. Each run keeps appending the same thing until it is
+    // refused, then once more, so fits-exactly, one-too-many and full-already all come up.
+    for (int buffLen = 1; buffLen <= MAX_BUFF; buffLen++)
+    {
+        for (int start = 0; start < buffLen; start++)
+        {
+            for (int kind = 0; kind < ADD_KINDS; kind++)
+            {
+                for (int which = 0; which < 6; which++)
+                {
+                    uint8_t len = start;
+                    memset(mem, GUARD, sizeof(mem));
+                    memset(mem, 'p', start);
+                    mem[start] = '\0';
+                    memcpy(model, mem, start + 1);
+
+                    int refusals = 0;
+                    for (int step = 0; step < 40 && refusals < 2; step++)
+                    {
+                        uint8_t before = len;
+                        boolean r = add(kind, which, mem, buffLen, len, expect);
+                        boolean fits = (before + strlen(expect) < (size_t)buffLen);
+                        boolean ok = true;
+                        calls++;
+
+                        if (fits) strcat(model, expect);
+                        else refusals++;
+                        if (r) filled++; else refused++;
+
+                        if (r != fits) ok = false;                                          // Return value
+                        if (len != (fits ? before + strlen(expect) : before)) ok = false;   // len
+                        if (memchr(mem, '\0', buffLen) == NULL) ok = false;                 // Terminated within buffLen
+                        else if (strcmp(mem, model) != 0) ok = false;                       // Holds what it should
+                        if (strlen(mem) != len) ok = false;
+                        for (int g = buffLen; g < (int)sizeof(mem); g++) if ((uint8_t)mem[g] != GUARD) ok = false;  // Nothing past the end
+
+                        if (!ok) bad[kind]++;
+                    }
+                }
+            }
+        }
+    }
+
+    for (int kind = 0; kind < ADD_KINDS; kind++)
+    {
+        snprintf(line, sizeof(line), "%s: terminated, len and return right, nothing past buffLen touched (%ld wrong)", KindName[kind], bad[kind]);
+        check(bad[kind] == 0, line);
+    }
+    snprintf(line, sizeof(line), "%ld calls into buffers of 1-%d bytes, %ld added and %ld refused", calls, MAX_BUFF, filled, refused);
+    check(filled > 0 && refused > 0, line);
+
+    // A few spot checks on the number formatting itself
+    {
+        uint8_t len = 0;
+        char buf[FORMAT_NUMBER_BUFF];
+        OP_Format::appendInt(buf, sizeof(buf), len, -2147483647L - 1);
+        check(strcmp(buf, "-2147483648") == 0 && len == 11, "Most negative int32 fits FORMAT_NUMBER_BUFF exactly");
+        len = 0;
+        OP_Format::appendUInt(buf, sizeof(buf), len, 4294967295UL);
+        check(strcmp(buf, "4294967295") == 0 && len == 10, "Largest uint32 prints in full");
+    }
+
+    // A string too long for any uint8_t buffer is refused, it must not wrap around and look short
+    {
+        char buf[MAX_BUFF];
+        uint8_t len = 0;
+        buf[0] = 'q';
+        Watching = true;
+        boolean r = OP_Format::appendStr(buf, sizeof(buf), len, LongStr);
+        Watching = false;
+        check(!r && len == 0 && buf[0] == '\0', "A 257 character string is refused and leaves an empty, terminated buffer");
+    }
+
+    // Make sure the watch really sees allocations, or the check below proves nothing
+    {
+        long was = Allocations;
+        Watching = true;
+        void * volatile p = malloc(16);
+        Watching = false;
+        free(p);
+        check(Allocations == was + 1, "The malloc watch counts a call made while watching");
+        Allocations = was;
+    }
+
+    snprintf(line, sizeof(line), "No heap allocation in any call (%ld)", Allocations);
+    check(Allocations == 0, line);
+
+    printf("%s\n", Failures ? "FAILED" : "All passed");
+    return Failures ? 1 : 0;
+}
@@ -0,0 +1,236 @@
+/* ppm_filter_test.cpp - host-side check and timing of the PPM glitch filter (PPMDecode::FilterFrame)
+ *
+ * Builds the real OP_PPMDecode.cpp on the PC and runs FilterFrame over eight channels of stick movement: slow sweeps, a held stick,
+ * and switch channels flipping end to end, once clean and once with single-frame spikes and dropped channels mixed in. We check that
+ * no spike ever reaches the output, that the output trails the clean input by exactly one frame, that a full-throw switch flip takes
+ * two frames, and that the glitch count matches the spikes. Then FilterFrame is timed.
+ *
+ * The stick movement is generated here rather than recorded, but at the rates a real radio produces: a frame every 22 mS, sticks
+ * taking a little over a second to cross their full throw.
+ *
+ *      g++ -std=gnu++11 -O2 -Itools/stub -o ppm_filter_test tools/ppm_filter_test.cpp && ./ppm_filter_test
+ *
+ * Run from the root of the repository. Prints each check and exits 1 if any of them failed. The time reported is for the PC running
+ * the test, it says nothing directly about the 16 MHz Atmega2560.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ARDUINO STAND-INS
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+// Defining the include guard keeps the real OP_Settings header out. tools/stub/Arduino.h and avr/interrupt.h are empty, the registers
+// and calls the decoder uses in begin(), shutdown() and the ISR are stood in for here (none of them are run).
+#define OP_SETTINGS_H
+#define PPM_TICKS_PER_uS        2
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+static uint8_t  EICRB, EIMSK, EIFR, SREG;
+static uint16_t TCNT1;
+#define ISC50   0
+#define ISC51   1
+#define INT5    5
+#define INTF5   5
+#define RISING  3
+#define INPUT_PULLUP 2
+#define ISR(vect)   void vect(void)
+static void cli(void) {}
+static void pinMode(uint8_t, uint8_t) {}
+static unsigned long micros(void) { return 0; }
+
+// FilterFrame and its state are private to PPMDecode
+#define private public
+#include "../OpenPanzerTCB/src/OP_PPMDecode/OP_PPMDecode.cpp"
+#undef private
+
+
+// TESTS
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+static int Failures = 0;
+
+static void check(boolean ok, const char *what)
+{
+    printf("%s  %s\n", ok ? "pass" : "FAIL", what);
+    if (!ok) Failures++;
+}
+
+#define FRAMES      5000
+#define CH          MAX_PPM_CHANNELS
+
+static int16_t Clean[FRAMES][CH];               // What the transmitter sent
+static int16_t Spiky[FRAMES][CH];               // What the receiver passed on
+static boolean Spiked[FRAMES][CH];
+
+// Eight channels of driving. 0-3 are sticks sweeping back and forth at different speeds with pauses, 4-5 are switches that flip
+// end to end now and then, 6 is a held stick, 7 a slow knob.
+static void makeFrames(void)
+{
+    int t[4] = { 0, 11, 22, 33 };
+    for (int f = 0; f < FRAMES; f++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            int period = 60 + c * 37;                       // Frames per sweep, the quickest crosses 1000-2000 in 60 frames
+            if ((f / 200) % 3 != c % 3) t[c]++;             // Now and then hold still
+            int p = t[c] % (period * 2);
+            int v = (p < period) ? p : (period * 2 - p);    // Triangle
+            Clean[f][c] = 1000 + (v * 1000) / period;
+        }
+        Clean[f][4] = ((f / 97) % 2) ? 2000 : 1000;
+        Clean[f][5] = ((f / 151) % 3 == 0) ? 1000 : (((f / 151) % 3 == 1) ? 1500 : 2000);
+        Clean[f][6] = 1520;
+        Clean[f][7] = 1000 + (f * 1000) / FRAMES;
+    }
+
+    // One frame in 40, one channel gets a spike to somewhere random in the valid range, or goes missing (out of range, as the
+    // ISR leaves it when a channel doesn't arrive). Never two frames in a row on the same channel, the median can't fix that.
+    // And not right beside a switch flip either, where the flip and the spike together look like two glitches to the counter. 
+    memcpy(Spiky, Clean, sizeof(Spiky));
+    memset(Spiked, 0, sizeof(Spiked));
+    for (int f = 2; f < FRAMES - 2; f++)
+    {
+        if (rand() % 40) continue;
+        int c = rand() % CH;
+        if (Spiked[f - 1][c] || Spiked[f - 2][c]) continue;
+        boolean flip = false;
+        for (int k = f - 2; k <= f + 1; k++) if (abs(Clean[k + 1][c] - Clean[k][c]) > PPM_GLITCH_uS) flip = true;
+        if (flip) continue;
+        Spiky[f][c] = (rand() % 5 == 0) ? 0 : (MIN_POSSIBLE_PULSE + rand() % (MAX_POSSIBLE_PULSE - MIN_POSSIBLE_PULSE + 1));
+        Spiked[f][c] = true;
+    }
+}
+
+static void runFilter(int16_t in[FRAMES][CH], int16_t out[FRAMES][CH])
+{
+    int16_t raw[CH];
+    PPMDecode::resetFilter();
+    for (int f = 0; f < FRAMES; f++)
+    {
+        memcpy(raw, in[f], sizeof(raw));
+        PPMDecode::FilterFrame(raw);
+        memcpy(out[f], PPMDecode::Filtered, sizeof(raw));
+    }
+}
+
+static int16_t Out[FRAMES][CH];
+static int16_t OutSpiky[FRAMES][CH];
+
+int main(void)
+{
+    char line[160];
+    long lagMiss = 0, leaks = 0, spikes = 0, worstLeak = 0;
+    srand(1);
+    makeFrames();
+
+    // Clean input. The median of three samples on a moving stick is the middle one, so the output is the input one frame late.
+    // Where a stick turns round the middle sample is the peak, and the median clips it to the samples either side.
+    runFilter(Clean, Out);
+    for (int f = 2; f < FRAMES; f++)
+    {
+        for (int c = 0; c < CH; c++)
+        {
+            if (c == 4 || c == 5) continue;
+            int a = Clean[f - 2][c], b = Clean[f - 1][c], n = Clean[f][c];
+            boolean turning = (b > a && b > n) || (b < a && b < n);
+            if (!turning && Out[f][c] != b) lagMiss++;
+            if (turning && Out[f][c] != ((b > a) ? (a > n ? a : n) : (a < n ? a : n))) lagMiss++;
+        }
+    }
+    snprintf(line, sizeof(line), "Sticks come out exactly one frame late, turning points clipped to their neighbours (%ld frames differ)", lagMiss);
+    check(lagMiss == 0, line);
+    snprintf(line, sizeof(line), "No glitches counted on clean input (%u)", PPMDecode::Glitches);
+    check(PPMDecode::Glitches == 0, line);
+
+    // A switch flip: the median holds the old value for the first frame after, the slew limit takes it half way on the next,
+    // and it arrives on the one after that
+    {
+        int flips = 0, wrong = 0;
+        for (int f = 3; f < FRAMES - 2; f++)
+        {
+            if (Clean[f][4] == Clean[f - 1][4] || Clean[f][4] != Clean[f + 1][4] || Clean[f][4] != Clean[f + 2][4]) continue;
+            int from = Clean[f - 1][4], to = Clean[f][4];
+            int half = from + ((to > from) ? PPM_MAX_DELTA_uS : -PPM_MAX_DELTA_uS);
+            flips++;
+            if (Out[f][4] != from || Out[f + 1][4] != half || Out[f + 2][4] != to) wrong++;
+        }
+        snprintf(line, sizeof(line), "Full-throw switch flip: held one frame, half way on the next, there on the one after (%d of %d wrong)", wrong, flips);
+        check(flips > 0 && wrong == 0, line);
+    }
+
+    // Spiky input. Every output must lie between the clean values of the frames the filter is looking at, so nothing of a spike
+    // gets through; with one bad sample in three the median always picks a good one.
+    runFilter(Spiky, OutSpiky);
+    for (int f = 0; f < FRAMES; f++)
+        for (int c = 0; c < CH; c++) if (Spiked[f][c]) spikes++;
+    for (int f = 3; f < FRAMES; f++)
+    {
+        for (int c = 0; c < CH; c++)
+        {
+            int lo = Clean[f][c], hi = Clean[f][c];
+            for (int k = 1; k <= 3; k++) { if (Clean[f - k][c] < lo) lo = Clean[f - k][c]; if (Clean[f - k][c] > hi) hi = Clean[f - k][c]; }
+            int v = OutSpiky[f][c];
+            long over = (v < lo) ? lo - v : ((v > hi) ? v - hi : 0);
+            if (over) { leaks++; if (over > worstLeak) worstLeak = over; }
+        }
+    }
+    snprintf(line, sizeof(line), "%ld spikes and dropped channels, none reach the output (%ld leaks, worst %ld uS)", spikes, leaks, worstLeak);
+    check(spikes > 50 && leaks == 0, line);
+
+    // Away from the spikes the output is just as it was without them
+    {
+        long differ = 0;
+        for (int f = 3; f < FRAMES; f++)
+            for (int c = 0; c < CH; c++)
+                if (!Spiked[f][c] && !Spiked[f - 1][c] && !Spiked[f - 2][c] && OutSpiky[f][c] != Out[f][c]) differ++;
+        snprintf(line, sizeof(line), "Frames more than two away from a spike are unchanged (%ld differ)", differ);
+        check(differ == 0, line);
+    }
+
+    // Glitches counts samples that stood out more than PPM_GLITCH_uS from both neighbours, and dropped channels. A spike that
+    // happens to land close to where the stick is doesn't count.
+    {
+        long big = 0;
+        for (int f = 1; f < FRAMES; f++)
+        {
+            for (int c = 0; c < CH; c++)
+            {
+                if (!Spiked[f][c]) continue;
+                if (f == FRAMES - 1) { if (Spiky[f][c] == 0) big++; continue; }     // The last frame has no next one to judge it by
+                int d1 = Spiky[f][c] - Clean[f - 1][c], d2 = Spiky[f][c] - Clean[f + 1][c];
+                if (Spiky[f][c] == 0 || (d1 > PPM_GLITCH_uS && d2 > PPM_GLITCH_uS) || (d1 < -PPM_GLITCH_uS && d2 < -PPM_GLITCH_uS)) big++;
+            }
+        }
+        snprintf(line, sizeof(line), "Glitch count %u, the same as the spikes that stood out (%ld)", PPMDecode::Glitches, big);
+        check(PPMDecode::Glitches == big, line);
+    }
+
+    // Timing. Run the spiky frames through many times and take the best of a few runs.
+    {
+        const int passes = 200;
+        double best = 1e9;
+        volatile int16_t sink = 0;
+        for (int run = 0; run < 5; run++)
+        {
+            struct timespec t0, t1;
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            for (int p = 0; p < passes; p++)
+            {
+                PPMDecode::resetFilter();
+                for (int f = 0; f < FRAMES; f++) PPMDecode::FilterFrame(Spiky[f]);
+                sink += PPMDecode::Filtered[0];
+            }
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            double ns = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / ((double)passes * FRAMES);
+            if (ns < best) best = ns;
+        }
+        printf("info  FilterFrame on this PC: %.1f nS per %d-channel frame, %.1f nS per channel\n", best, CH, best / CH);
+    }
+
+    printf("%s\n", Failures ? "FAILED" : "All passed");
+    return Failures ? 1 : 0;
+}
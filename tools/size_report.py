@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""size_report.py - where the TCB firmware's flash and RAM go, by library and by sketch tab
+
+Reads the .elf the Arduino IDE leaves in its build folder (turn on File > Preferences > "Show verbose output during compilation"
+to see where that is) and adds up the size of every symbol, grouped by the src/ library or .ino tab it came from:
+
+    text    code and near PROGMEM constants (flash)
+    far     PROGMEM_FAR tables, which live in .fini7 at the top of flash (see OP_Settings.h)
+    data    initialized static variables (flash and RAM)
+    bss     zeroed static variables (RAM)
+
+The source file for each symbol comes from the debug line info, which the Arduino build always includes (-g), so tabs are told
+apart even though the IDE joins them into one .cpp. Anything from the Arduino core or avr-libc is grouped as "core", symbols with
+no line info (mostly compiler generated) as "other".
+
+    python3 size_report.py OpenPanzerTCB.ino.elf                        print the report
+    python3 size_report.py OpenPanzerTCB.ino.elf --save baseline.json   ... and save it as the baseline
+    python3 size_report.py OpenPanzerTCB.ino.elf --baseline baseline.json [--tolerance 16]
+                                                                        compare to the baseline, exit 1 if any group grew by more than tolerance bytes
+
+Needs avr-nm and avr-objdump on the path (they are in hardware/tools/avr/bin of the Arduino install), or pass --prefix with the
+full path, eg --prefix "C:/Arduino/hardware/tools/avr/bin/avr-".
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+CATEGORIES = ("text", "far", "data", "bss")
+FAR_SECTION = ".fini7"
+
+
+def run(cmd):
+    return subprocess.run(cmd, check=True, stdout=subprocess.PIPE, universal_newlines=True).stdout
+
+
+def symbol_sections(prefix, elf):
+    """(name, address) -> (section, size) from the symbol table"""
+    syms = {}
+    # 00800200 l     O .bss   00000002 _ZN8OP_Radio10didWeBeginE
+    pat = re.compile(r"^([0-9a-fA-F]+)\s+.{7}\s+(\S+)\s+([0-9a-fA-F]+)\s+(.+)$")
+    for line in run([prefix + "objdump", "-t", "-C", elf]).splitlines():
+        m = pat.match(line)
+        if not m:
+            continue
+        section, size, name = m.group(2), int(m.group(3), 16), m.group(4).strip()
+        if size == 0 or section in ("*ABS*", "*UND*"):
+            continue
+        syms[(name, int(m.group(1), 16))] = (section, size)
+    return syms
+
+
+def symbol_files(prefix, elf):
+    """(name, address) -> source file, from the debug line info"""
+    files = {}
+    # 00000a2c 00000012 T OP_Radio::Status()	/path/src/OP_Radio/OP_Radio.cpp:1144
+    pat = re.compile(r"^([0-9a-fA-F]+)\s+[0-9a-fA-F]+\s+\S\s+(.*?)(?:\t(.*):\d+)?$")
+    for line in run([prefix + "nm", "-S", "-C", "-l", elf]).splitlines():
+        m = pat.match(line)
+        if m and m.group(3):
+            files[(m.group(2).strip(), int(m.group(1), 16))] = m.group(3)
+    return files
+
+
+def group_of(path):
+    if path is None:
+        return "other"
+    path = path.replace("\\", "/")
+    m = re.search(r"/src/([^/]+)/", path)
+    if m:
+        return m.group(1)
+    if path.endswith(".ino"):
+        return os.path.basename(path)
+    return "core"
+
+
+def category_of(section):
+    if section == FAR_SECTION:
+        return "far"
+    if section.startswith(".text") or section.startswith(".progmem"):
+        return "text"
+    if section.startswith(".data"):
+        return "data"
+    if section.startswith(".bss") or section.startswith(".noinit"):
+        return "bss"
+    return None
+
+
+def build_report(prefix, elf):
+    report = {}
+    files = symbol_files(prefix, elf)
+    for key, (section, size) in symbol_sections(prefix, elf).items():
+        cat = category_of(section)
+        if cat is None:
+            continue
+        group = report.setdefault(group_of(files.get(key)), dict.fromkeys(CATEGORIES, 0))
+        group[cat] += size
+    return report
+
+
+def print_report(report, baseline=None):
+    # With a baseline, each figure is followed by its change
+    pad = "       " if baseline is not None else ""
+    print("%-24s" % "group" + "".join("%10s" % c + pad for c in CATEGORIES))
+    totals = dict.fromkeys(CATEGORIES, 0)
+    for name in sorted(report, key=lambda n: -sum(report[n].values())):
+        row = "%-24s" % name
+        for c in CATEGORIES:
+            totals[c] += report[name][c]
+            row += "%10d" % report[name][c]
+            if baseline is not None:
+                diff = report[name][c] - baseline.get(name, {}).get(c, 0)
+                row += "%+7d" % diff if diff else pad
+        print(row)
+    print("%-24s" % "TOTAL" + "".join("%10d" % totals[c] + pad for c in CATEGORIES))
+    print("flash %d bytes (text + far + data), static RAM %d bytes (data + bss)"
+          % (totals["text"] + totals["far"] + totals["data"], totals["data"] + totals["bss"]))
+
+
+def regressions(report, baseline, tolerance):
+    found = []
+    for name in sorted(set(report) | set(baseline)):
+        for c in CATEGORIES:
+            old = baseline.get(name, {}).get(c, 0)
+            new = report.get(name, {}).get(c, 0)
+            if new - old > tolerance:
+                found.append("%s %s grew %d bytes (%d -> %d)" % (name, c, new - old, old, new))
+    return found
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Flash and RAM use of the TCB firmware by library and sketch tab")
+    ap.add_argument("elf", help="the sketch .elf from the Arduino build folder")
+    ap.add_argument("--prefix", default="avr-", help="toolchain prefix (default avr-)")
+    ap.add_argument("--save", metavar="FILE", help="save this report as a baseline")
+    ap.add_argument("--baseline", metavar="FILE", help="compare against a saved baseline")
+    ap.add_argument("--tolerance", type=int, default=0, help="bytes any group may grow before it counts as a regression")
+    args = ap.parse_args()
+
+    report = build_report(args.prefix, args.elf)
+    baseline = None
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+    print_report(report, baseline)
+
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump(report, f, indent=1, sort_keys=True)
+
+    if baseline is not None:
+        found = regressions(report, baseline, args.tolerance)
+        for r in found:
+            print("REGRESSION: " + r)
+        return 1 if found else 0
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,6 @@
+/* Arduino.h - empty stand-in for the host-side tests in tools/
+ *
+ * Some libraries include <Arduino.h> before anything else. Building a test with -Itools/stub lets that include succeed, and the test
+ * itself defines whatever small part of the Arduino core the library under test actually uses, before including it. The avr/ headers 
+ * here are the same.
+ */
@@ -0,0 +1,4 @@
+/* avr/interrupt.h - empty stand-in for the host-side tests in tools/, see tools/stub/Arduino.h
+ *
+ * A test that builds a library with interrupt handlers defines ISR(), cli() and the registers it touches itself.
+ */
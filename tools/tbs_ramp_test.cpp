@@ -0,0 +1,184 @@
+/* tbs_ramp_test.cpp - host-side check of the TBS Prop1 engine speed ramp (OP_TBS::SetEngineSpeed and OP_TBS::update)
+ *
+ * Builds the real OP_TBS.cpp on the PC against small stand-ins for the Arduino core, the servo class and SimpleTimer, then drives
+ * it with a fake millis() and compares every pulse written to Prop1 against the reference curve: PROP1_RAMP_UP_uS per PROP1_TICK_mS
+ * going up and PROP1_RAMP_DOWN_uS going down, straight to the target, no overshoot.
+ *
+ *      g++ -std=gnu++11 -o tbs_ramp_test tools/tbs_ramp_test.cpp && ./tbs_ramp_test
+ *
+ * Run from the root of the repository. Prints each check and exits 1 if any of them failed.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ARDUINO STAND-INS
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+// Defining the include guards keeps the real Arduino, OP_Settings, OP_Servo, OP_Motors and OP_SimpleTimer headers out,
+// we only need what OP_TBS uses from them.
+#define OP_SETTINGS_H
+#define OP_Servo_H
+#define OP_Motors_h
+#define OP_SIMPLETIMER_H
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+static unsigned long FakeMillis = 0;
+unsigned long millis(void) { return FakeMillis; }
+long random(long lo, long hi) { return lo + (rand() % (hi - lo)); }
+long map(long x, long in_min, long in_max, long out_min, long out_max) { return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min; }
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#ifndef min
+#define min(a,b) ((a)<(b)?(a):(b))
+#endif
+#ifndef max
+#define max(a,b) ((a)>(b)?(a):(b))
+#endif
+
+#define PROGMEM_FAR
+#define pgm_get_far_address(var)    ((uintptr_t)&(var))
+#define pgm_read_word_far(addr)     (*(const uint16_t *)(addr))
+#define pgm_read_byte_far(addr)     (*(const uint8_t *)(addr))
+
+// From OP_Settings.h
+#define SERVONUM_PROP3              5
+#define SERVONUM_PROP2              6
+#define SERVONUM_PROP1              7
+#define MOTOR_MAX_FWDSPEED          255
+#define MOTOR_MAX_REVSPEED          -255
+
+// Records what gets written to Prop1
+class OP_Servos
+{
+public:
+    static int      Prop1;                  // Last pulse written
+    static uint16_t Prop1Writes;            // Number of writes
+    void attach(uint8_t) {}
+    void writeMicroseconds(uint8_t servo, int pulse)
+    {
+        if (servo == SERVONUM_PROP1) { Prop1 = pulse; Prop1Writes++; }
+    }
+};
+int      OP_Servos::Prop1 = 0;
+uint16_t OP_Servos::Prop1Writes = 0;
+
+// OP_TBS only starts timeouts with it, which these tests never need to fire
+class OP_SimpleTimer
+{
+public:
+    int setTimeout(long, void (*)(void)) { return 0; }
+};
+
+#include "../OpenPanzerTCB/src/OP_TBS/OP_TBS.cpp"
+
+
+// TESTS
+// -------------------------------------------------------------------------------------------------------------------------------------------------->
+static int Failures = 0;
+
+static void check(boolean ok, const char *what)
+{
+    printf("%s  %s\n", ok ? "pass" : "FAIL", what);
+    if (!ok) Failures++;
+}
+
+// Reference pulse a given time after a ramp from 'from' toward 'to' started
+static int reference(int from, int to, unsigned long elapsed_mS)
+{
+    long steps = elapsed_mS / PROP1_TICK_mS;
+    if (to > from) return (int)min((long)to, from + steps * PROP1_RAMP_UP_uS);
+    else           return (int)max((long)to, from - steps * PROP1_RAMP_DOWN_uS);
+}
+
+// Run the main loop for run_mS, stepping time by 1 to maxLoop_mS each pass, with the throttle at 'speed' plus up to +-jitter. The ramp 
+// starts at the first pass, when SetEngineSpeed is first given the new speed. Returns the largest distance from the reference ramp, 
+// and notes any overshoot past the target.
+static int runRamp(OP_TBS &tbs, int speed, int jitter, int from, int to, unsigned long run_mS, int maxLoop_mS, boolean &overshoot)
+{
+    unsigned long start = 0, until = FakeMillis + run_mS;
+    int worst = 0;
+    while (FakeMillis < until)
+    {
+        FakeMillis += 1 + (maxLoop_mS > 1 ? rand() % maxLoop_mS : 0);
+        if (start == 0) start = FakeMillis;
+        tbs.SetEngineSpeed(speed + (jitter ? (rand() % (2 * jitter + 1)) - jitter : 0));
+        OP_TBS::update();
+        int d = abs(OP_Servos::Prop1 - reference(from, to, FakeMillis - start));
+        if (d > worst) worst = d;
+        if ((to > from && OP_Servos::Prop1 > to) || (to < from && OP_Servos::Prop1 < to)) overshoot = true;
+    }
+    return worst;
+}
+
+int main(void)
+{
+    OP_SimpleTimer timer;
+    OP_TBS tbs(&timer, false);
+    boolean overshoot;
+    int worst;
+    char line[100];
+    srand(1);
+
+    tbs.begin();
+    check(OP_Servos::Prop1 == PROP1_IDLE, "Prop1 starts at idle");
+
+    // A steady 1 mS loop should follow the reference exactly
+    overshoot = false;
+    worst = runRamp(tbs, MOTOR_MAX_FWDSPEED, 0, PROP1_IDLE, PROP1_FULL_SPEED, 1500, 1, overshoot);
+    snprintf(line, sizeof(line), "Idle to full, 1 mS loop, follows the reference (worst %d uS)", worst);
+    check(worst == 0 && !overshoot, line);
+    check(OP_Servos::Prop1 == PROP1_FULL_SPEED, "Settles exactly on full speed");
+
+    overshoot = false;
+    worst = runRamp(tbs, 0, 0, PROP1_FULL_SPEED, PROP1_IDLE, 2000, 1, overshoot);
+    snprintf(line, sizeof(line), "Full to idle, 1 mS loop, follows the reference (worst %d uS)", worst);
+    check(worst == 0 && !overshoot, line);
+    check(OP_Servos::Prop1 == PROP1_IDLE, "Settles exactly on idle");
+
+    // A loop time that wanders between 1 and 15 mS, with +-1 of throttle noise. The only difference allowed from the reference is
+    // where the ramp falls within a tick, which is one step. Jitter can't leave it off the end points.
+    overshoot = false;
+    worst = runRamp(tbs, MOTOR_MAX_FWDSPEED - 1, 1, PROP1_IDLE, PROP1_FULL_SPEED, 1500, 15, overshoot);
+    snprintf(line, sizeof(line), "Idle to full, 1-15 mS loop with jitter, within one step (worst %d uS)", worst);
+    check(worst <= PROP1_RAMP_UP_uS && !overshoot, line);
+
+    tbs.SetEngineSpeed(MOTOR_MAX_FWDSPEED);
+    FakeMillis += 200;
+    OP_TBS::update();
+    check(OP_Servos::Prop1 == PROP1_FULL_SPEED, "Full speed reached once asked for exactly");
+
+    overshoot = false;
+    worst = runRamp(tbs, 1, 1, PROP1_FULL_SPEED, PROP1_IDLE, 2000, 15, overshoot);
+    snprintf(line, sizeof(line), "Full to idle, 1-15 mS loop with jitter, within one step (worst %d uS)", worst);
+    check(worst <= PROP1_RAMP_DOWN_uS && !overshoot, line);
+
+    // Holding steady with throttle noise shouldn't wobble the output
+    tbs.SetEngineSpeed(128);
+    for (int i = 0; i < 200; i++) { FakeMillis += 5; OP_TBS::update(); }
+    uint16_t writes = OP_Servos::Prop1Writes;
+    int held = OP_Servos::Prop1;
+    for (int i = 0; i < 500; i++)
+    {
+        FakeMillis += 1 + rand() % 15;
+        tbs.SetEngineSpeed(128 + (rand() % 3) - 1);
+        OP_TBS::update();
+    }
+    check(OP_Servos::Prop1Writes == writes && OP_Servos::Prop1 == held, "Steady throttle with +-1 noise, no writes to Prop1");
+
+    // A long stall only makes up PROP1_TICK_mS * 5 worth of ramp at once
+    tbs.SetEngineSpeed(MOTOR_MAX_FWDSPEED);
+    FakeMillis += 500;
+    int before = OP_Servos::Prop1;
+    OP_TBS::update();
+    check(OP_Servos::Prop1 - before == 5 * PROP1_RAMP_UP_uS, "A 500 mS stall catches up at most 5 ticks");
+
+    // IdleEngine skips the ramp
+    tbs.IdleEngine();
+    check(OP_Servos::Prop1 == PROP1_IDLE, "IdleEngine goes straight to idle");
+
+    printf("%s\n", Failures ? "FAILED" : "All passed");
+    return Failures ? 1 : 0;
+}